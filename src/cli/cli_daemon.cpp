@@ -0,0 +1,175 @@
+#include "cli_daemon.h"
+#include "utils/ipc_channel.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace NirUI {
+
+static void AppendU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AppendString(std::string& out, const std::string& value) {
+    AppendU32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+static bool ReadU32(const std::string& in, size_t& pos, uint32_t& value) {
+    if (in.size() - pos < sizeof(value)) return false;
+    memcpy(&value, in.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+static bool ReadString(const std::string& in, size_t& pos, std::string& value) {
+    uint32_t length = 0;
+    if (!ReadU32(in, pos, length) || in.size() - pos < length) return false;
+    value.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+int CliDaemon::Run(bool verbose) {
+    m_verbose = verbose;
+
+    IpcServer server;
+    if (!server.Listen(CHANNEL_NAME)) {
+        std::cerr << "Error: A NirUI daemon is already running (or " << GetIpcEndpoint(CHANNEL_NAME)
+                  << " could not be created)." << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    m_session.WarmUp();
+    m_session.EnableCoalescing();
+    m_session.SetLiveProgress(false);
+    double warmUpMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "NirUI daemon listening on " << GetIpcEndpoint(CHANNEL_NAME)
+              << " (warm-up " << warmUpMs << " ms)." << std::endl;
+    std::cout << "Use --stop-daemon to stop it." << std::endl;
+
+    server.Serve([this](const std::string& request, bool& stop) { return HandleRequest(request, stop); });
+
+    std::cout << "NirUI daemon stopped." << std::endl;
+    return 0;
+}
+
+std::string CliDaemon::HandleRequest(const std::string& request, bool& stop) {
+    size_t pos = 0;
+    uint32_t version = 0;
+    uint32_t argc = 0;
+    std::string cwd;
+    if (!ReadU32(request, pos, version) || version != PROTOCOL_VERSION ||
+        !ReadString(request, pos, cwd) || !ReadU32(request, pos, argc) || argc == 0) {
+        return std::string();
+    }
+
+    std::vector<std::string> args(argc);
+    for (auto& arg : args) {
+        if (!ReadString(request, pos, arg)) return std::string();
+    }
+
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+
+    CliParser parser;
+    CliOptions options = parser.Parse(static_cast<int>(argv.size()), argv.data());
+
+    std::string response;
+    if (options.stopDaemon) {
+        stop = true;
+        AppendU32(response, 0);
+        AppendString(response, "NirUI daemon stopped.\n");
+        AppendString(response, std::string());
+        return response;
+    }
+    if (!CliSession::HandlesOptions(options)) {
+        return std::string();
+    }
+
+    // Scheduled commands wait until this request is done, so they neither
+    // run concurrently with it nor print into its captured output
+    std::lock_guard<std::mutex> lock(m_session.GetMutex());
+
+    std::error_code ec;
+    std::filesystem::current_path(std::filesystem::path(std::u8string(cwd.begin(), cwd.end())), ec);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Commands print straight to std::cout/std::cerr; capture both for the client
+    std::ostringstream out;
+    std::ostringstream err;
+    std::ios outFormat(nullptr);
+    std::ios errFormat(nullptr);
+    outFormat.copyfmt(std::cout);
+    errFormat.copyfmt(std::cerr);
+    std::streambuf* oldOut = std::cout.rdbuf(out.rdbuf());
+    std::streambuf* oldErr = std::cerr.rdbuf(err.rdbuf());
+
+    int exitCode = 1;
+    try {
+        exitCode = m_session.Run(parser, options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+
+    std::cout.rdbuf(oldOut);
+    std::cerr.rdbuf(oldErr);
+    std::cout.copyfmt(outFormat);
+    std::cerr.copyfmt(errFormat);
+    std::cout.clear();
+    std::cerr.clear();
+    m_session.SaveCosts();
+
+    if (m_verbose) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[" << ms << " ms] exit " << exitCode << ":";
+        for (size_t i = 1; i < args.size(); ++i) {
+            std::cout << " " << args[i];
+        }
+        std::cout << std::endl;
+    }
+
+    AppendU32(response, static_cast<uint32_t>(exitCode));
+    AppendString(response, out.str());
+    AppendString(response, err.str());
+    return response;
+}
+
+bool CliDaemon::Forward(int argc, char* argv[], int& exitCode) {
+    std::string request;
+    AppendU32(request, PROTOCOL_VERSION);
+    std::error_code ec;
+    std::u8string cwd = std::filesystem::current_path(ec).u8string();
+    AppendString(request, std::string(cwd.begin(), cwd.end()));
+    AppendU32(request, static_cast<uint32_t>(argc));
+    for (int i = 0; i < argc; ++i) {
+        AppendString(request, argv[i]);
+    }
+
+    std::string response;
+    if (!IpcRequest(CHANNEL_NAME, request, response)) return false;
+
+    size_t pos = 0;
+    uint32_t code = 0;
+    std::string out;
+    std::string err;
+    if (!ReadU32(response, pos, code) || !ReadString(response, pos, out) || !ReadString(response, pos, err)) {
+        return false;
+    }
+
+    std::cout << out << std::flush;
+    std::cerr << err << std::flush;
+    exitCode = static_cast<int>(code);
+    return true;
+}
+
+} // namespace NirUI
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cli_session.h"
+#include <cstdint>
+#include <string>
+
+namespace NirUI {
+
+// Resident CLI server. Run() keeps one CliSession warm and executes command
+// lines forwarded by other NirUI invocations over the local IPC channel, one at
+// a time, in the caller's working directory.
+//
+// Request: { u32 version, str cwd, u32 argc, argc x str }
+// Response: { i32 exit code, str stdout, str stderr }, or empty if the daemon
+// declines the request and the client should run it itself.
+// Strings are { u32 length, bytes }.
+class CliDaemon {
+public:
+    static constexpr const char* CHANNEL_NAME = "NirUI";
+    static constexpr uint32_t PROTOCOL_VERSION = 1;
+
+    // Blocks until a client sends --stop-daemon
+    int Run(bool verbose);
+
+    // Runs the command line in the daemon if one is listening and prints its
+    // output. Returns false if nothing was forwarded.
+    static bool Forward(int argc, char* argv[], int& exitCode);
+
+private:
+    std::string HandleRequest(const std::string& request, bool& stop);
+
+    CliSession m_session;
+    bool m_verbose = false;
+};
+
+} // namespace NirUI
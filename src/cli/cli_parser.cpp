@@ -3,6 +3,7 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
 
 namespace NirUI {
 
@@ -103,6 +104,52 @@ CliOptions CliParser::Parse(int argc, char* argv[]) {
                 options.appGroupAction = argv[++i];
             }
         }
+        else if (arg == "--repl") {
+            options.runRepl = true;
+        }
+        else if (arg == "--daemon") {
+            options.runDaemon = true;
+        }
+        else if (arg == "--stop-daemon") {
+            options.stopDaemon = true;
+        }
+        else if (arg == "--no-daemon") {
+            options.noDaemon = true;
+        }
+        else if (arg == "--script") {
+            if (i + 1 < argc) {
+                options.scriptPath = argv[++i];
+            }
+        }
+        else if (arg == "--template") {
+            if (i + 1 < argc) {
+                options.templateText = argv[++i];
+            }
+        }
+        else if (arg == "--rows") {
+            if (i + 1 < argc) {
+                options.rowsPath = argv[++i];
+            }
+        }
+        else if (arg == "--dry-run") {
+            options.dryRun = true;
+        }
+        else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                options.tracePath = argv[++i];
+            }
+        }
+        else if (arg == "--coalesce") {
+            options.coalesce = true;
+        }
+        else if (arg == "--stats") {
+            options.showStats = true;
+        }
+        else if (arg == "-j" || arg == "--jobs") {
+            if (i + 1 < argc) {
+                options.scriptJobs = std::max(1, std::atoi(argv[++i]));
+            }
+        }
         else if (arg[0] != '-') {
             if (options.command.empty()) {
                 options.command = arg;
@@ -139,6 +186,13 @@ void CliParser::PrintHelp() const {
     std::cout << "  -d, --download          Download NirCmd from NirSoft\n";
     std::cout << "  --info COMMAND          Show detailed info about a command\n";
     std::cout << "  --verbose               Show verbose output\n";
+    std::cout << "  --repl                  Start an interactive shell with warm caches\n";
+    std::cout << "  --script FILE           Run the commands in FILE, one per line\n";
+    std::cout << "  --template TEXT         Run TEXT once per CSV row, e.g. \"setappvolume {proc} {level}\"\n";
+    std::cout << "  --rows FILE             CSV rows for --template (default: stdin)\n";
+    std::cout << "  --dry-run               Print the expanded commands instead of running them\n";
+    std::cout << "  -j, --jobs N            Run up to N script or template lines at once (default 1)\n";
+    std::cout << "  --trace FILE            Write a Chrome trace (chrome://tracing, Perfetto) of this run to FILE\n";
     std::cout << "\n";
     std::cout << "APP GROUP OPTIONS:\n";
     std::cout << "  --groups                List all app groups\n";
@@ -151,6 +205,13 @@ void CliParser::PrintHelp() const {
     std::cout << "  --run-group GROUP ACTION\n";
     std::cout << "                          Run action on group (min|max|close|hide|show|freeze|unfreeze)\n";
     std::cout << "\n";
+    std::cout << "DAEMON OPTIONS:\n";
+    std::cout << "  --daemon                Stay resident and serve commands from other invocations\n";
+    std::cout << "  --stop-daemon           Stop the running daemon\n";
+    std::cout << "  --no-daemon             Run locally even if a daemon is running\n";
+    std::cout << "  --coalesce              Queue volume, brightness and cursor steps in the daemon and return at once\n";
+    std::cout << "  --stats                 Print command latency percentiles (the daemon's when it runs)\n";
+    std::cout << "\n";
     std::cout << "EXAMPLES:\n";
     std::cout << "  " << m_programName << "                           Launch GUI\n";
     std::cout << "  " << m_programName << " -l                        List categories\n";
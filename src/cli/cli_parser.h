@@ -32,6 +32,20 @@ struct CliOptions {
     std::string appTargetValue;
     std::string appGroupAction;
     bool appRecursive = false;
+
+    bool runRepl = false;
+    bool runDaemon = false;
+    bool stopDaemon = false;
+    bool noDaemon = false;
+    bool coalesce = false;
+
+    std::string scriptPath;
+    size_t scriptJobs = 1;
+    std::string templateText;
+    std::string rowsPath;
+    bool dryRun = false;
+    bool showStats = false;
+    std::string tracePath;
 };
 
 class CliParser {
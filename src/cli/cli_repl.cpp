@@ -0,0 +1,159 @@
+#include "cli_repl.h"
+#include "core/command_tokenizer.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <conio.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace NirUI {
+
+#ifdef _WIN32
+
+namespace {
+
+// Console line editor with history (Up/Down) and Tab completion
+class ConsoleLineReader : public ReplLineReader {
+public:
+    ConsoleLineReader(const ReplShell& shell, std::vector<std::string>& history)
+        : m_shell(shell), m_lineHistory(history) {}
+
+    bool ReadLine(std::string& line) override;
+
+private:
+    const ReplShell& m_shell;
+    std::vector<std::string>& m_lineHistory;
+};
+
+bool ConsoleLineReader::ReadLine(std::string& line) {
+    line.clear();
+    std::cout << "nirui> " << std::flush;
+    size_t historyPos = m_lineHistory.size();
+
+    auto replaceLine = [&](const std::string& text) {
+        for (size_t i = 0; i < line.size(); ++i) std::cout << "\b \b";
+        line = text;
+        std::cout << line << std::flush;
+    };
+
+    while (true) {
+        int ch = _getch();
+        if (ch == '\r' || ch == '\n') {
+            std::cout << std::endl;
+            if (!line.empty() && (m_lineHistory.empty() || m_lineHistory.back() != line)) {
+                m_lineHistory.push_back(line);
+            }
+            return true;
+        }
+        if (ch == 4 || ch == 26) {  // Ctrl+D / Ctrl+Z on an empty line ends the session
+            if (line.empty()) {
+                std::cout << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (ch == 3) {  // Ctrl+C discards the line
+            std::cout << "^C" << std::endl << "nirui> " << std::flush;
+            line.clear();
+            historyPos = m_lineHistory.size();
+            continue;
+        }
+        if (ch == 0 || ch == 0xE0) {
+            int key = _getch();
+            if (key == 72 && historyPos > 0) replaceLine(m_lineHistory[--historyPos]);
+            else if (key == 80 && historyPos < m_lineHistory.size()) {
+                ++historyPos;
+                replaceLine(historyPos < m_lineHistory.size() ? m_lineHistory[historyPos] : std::string());
+            }
+            continue;
+        }
+        if (ch == '\b') {
+            if (!line.empty()) {
+                line.pop_back();
+                std::cout << "\b \b" << std::flush;
+            }
+            continue;
+        }
+        if (ch == '\t') {
+            std::vector<std::string> matches;
+            std::string completed = m_shell.CompleteLine(line, matches);
+            if (completed != line) {
+                replaceLine(completed);
+            } else if (matches.size() > 1) {
+                std::cout << std::endl;
+                for (const auto& match : matches) std::cout << "  " << match << std::endl;
+                std::cout << "nirui> " << line << std::flush;
+            }
+            continue;
+        }
+        if (ch >= 32) {
+            line.push_back(static_cast<char>(ch));
+            std::cout << static_cast<char>(ch) << std::flush;
+        }
+    }
+}
+
+} // namespace
+
+#endif
+
+CliRepl::CliRepl(const CliParser& parser) : m_parser(parser), m_shell(*this, std::cout, std::cerr) {
+#ifdef _WIN32
+    DWORD mode = 0;
+    m_interactive = GetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), &mode) != 0;
+#else
+    m_interactive = isatty(STDIN_FILENO) != 0;
+#endif
+}
+
+int CliRepl::Run() {
+    auto start = std::chrono::steady_clock::now();
+    m_session.WarmUp();
+
+    if (m_interactive) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "NirUI REPL (warm-up " << std::fixed << std::setprecision(1) << ms << " ms). "
+                  << "Type 'help' for commands, 'exit' to quit." << std::endl;
+    }
+
+#ifdef _WIN32
+    if (m_interactive) {
+        ConsoleLineReader console(m_shell, m_lineHistory);
+        m_shell.Run(console);
+        return 0;
+    }
+#endif
+    StreamLineReader reader(std::cin, m_interactive ? &std::cout : nullptr);
+    m_shell.Run(reader);
+    return 0;
+}
+
+void CliRepl::RunOptions(const std::string& line) {
+    CommandTokens tokens(line);
+    std::vector<std::string> args{"NirUI"};
+    for (size_t i = 0; i < tokens.GetCount(); ++i) {
+        args.emplace_back(tokens[i]);
+    }
+
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+
+    CliParser parser;
+    CliOptions options = parser.Parse(static_cast<int>(argv.size()), argv.data());
+    if (CliSession::HandlesOptions(options)) {
+        m_session.Run(m_parser, options);
+    } else if (options.showHelp) {
+        m_parser.PrintHelp();
+    } else {
+        std::cerr << "Not available in the REPL: " << line << std::endl;
+    }
+}
+
+} // namespace NirUI
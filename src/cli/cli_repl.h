@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cli_session.h"
+#include "repl_shell.h"
+#include <string>
+#include <vector>
+
+namespace NirUI {
+
+// Interactive shell over one warm CliSession. Lines use the GUI command box
+// syntax: nircmd commands, the "group ..." and "win freeze/unfreeze"
+// meta-commands, and CLI options such as "--search mute". Every command reports
+// its latency. On a console, Tab completes from the command index; piped input
+// is read line by line without prompts. The line handling itself is ReplShell.
+class CliRepl : private ReplBackend {
+public:
+    explicit CliRepl(const CliParser& parser);
+
+    int Run();
+
+private:
+    std::mutex& GetMutex() override { return m_session.GetMutex(); }
+    void Prepare() override { m_session.Prepare(); }
+    MetaCommandHandlers GetMetaCommandHandlers() override { return m_session.GetMetaCommandHandlers(); }
+    void RunOptions(const std::string& line) override;
+    bool IsNirCmdAvailable() override { return m_session.GetManager().IsAvailable(); }
+    ExecutionResult ExecuteNirCmd(const std::string& line) override { return m_session.GetManager().Execute(line); }
+
+    const CliParser& m_parser;
+    CliSession m_session;
+    ReplShell m_shell;
+    std::vector<std::string> m_lineHistory;
+    bool m_interactive = false;
+};
+
+} // namespace NirUI
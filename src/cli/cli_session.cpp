@@ -0,0 +1,746 @@
+#include "cli_session.h"
+#include "core/command_template.h"
+#include "core/nircmd_commands.h"
+#include "core/param_validator.h"
+#include "utils/latency_stats.h"
+#include "utils/trace_recorder.h"
+#include <windows.h>
+#include <tlhelp32.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+namespace NirUI {
+
+static bool PathStartsWithFolder(const std::string& path, const std::string& folder, bool recursive) {
+    std::string normPath = path;
+    std::string normFolder = folder;
+    for (char& c : normPath) if (c == '/') c = '\\';
+    for (char& c : normFolder) if (c == '/') c = '\\';
+    while (!normFolder.empty() && normFolder.back() == '\\') normFolder.pop_back();
+
+    if (normPath.length() <= normFolder.length()) return false;
+
+    std::string pathLower = normPath;
+    std::string folderLower = normFolder;
+    std::transform(pathLower.begin(), pathLower.end(), pathLower.begin(), ::tolower);
+    std::transform(folderLower.begin(), folderLower.end(), folderLower.begin(), ::tolower);
+
+    if (pathLower.substr(0, folderLower.length()) != folderLower) return false;
+    if (normPath[folderLower.length()] != '\\') return false;
+
+    if (!recursive) {
+        std::string remainder = normPath.substr(folderLower.length() + 1);
+        if (remainder.find('\\') != std::string::npos) return false;
+    }
+    return true;
+}
+
+static std::string WideToNarrow(const wchar_t* wide) {
+    if (!wide) return "";
+    int len = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+    if (len <= 0) return "";
+    std::string result(len - 1, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wide, -1, &result[0], len, nullptr, nullptr);
+    return result;
+}
+
+static std::string QueryProcessPath(DWORD pid) {
+    TraceZone zone("OpenProcess");
+    std::string result;
+    HANDLE hProc = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (hProc) {
+        char path[MAX_PATH] = {};
+        DWORD size = MAX_PATH;
+        if (QueryFullProcessImageNameA(hProc, 0, path, &size)) {
+            result = path;
+        }
+        CloseHandle(hProc);
+    }
+    return result;
+}
+
+const std::vector<ProcessInfo>& ProcessCache::Refresh() {
+    TraceZone zone("ProcessCache::Refresh");
+    m_processes.clear();
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE) return m_processes;
+
+    PROCESSENTRY32W pe;
+    pe.dwSize = sizeof(pe);
+
+    std::unordered_map<uint32_t, CachedPath> paths;
+    paths.reserve(m_paths.size());
+
+    if (Process32FirstW(snapshot, &pe)) {
+        do {
+            ProcessInfo info;
+            info.pid = pe.th32ProcessID;
+            info.name = WideToNarrow(pe.szExeFile);
+
+            // A reused pid almost always comes with a different parent or image name
+            auto it = m_paths.find(info.pid);
+            if (it != m_paths.end() && it->second.parentPid == pe.th32ParentProcessID && it->second.name == info.name) {
+                info.path = it->second.path;
+            } else {
+                info.path = QueryProcessPath(pe.th32ProcessID);
+            }
+
+            paths[info.pid] = { pe.th32ParentProcessID, info.name, info.path };
+            m_processes.push_back(std::move(info));
+        } while (Process32NextW(snapshot, &pe));
+    }
+    CloseHandle(snapshot);
+
+    m_paths = std::move(paths);
+    return m_processes;
+}
+
+bool CliSession::HandlesOptions(const CliOptions& options) {
+    if (options.listCategories || options.listCommands || !options.searchQuery.empty() ||
+        (options.showHelp && !options.command.empty())) {
+        return true;
+    }
+    if (options.downloadNirCmd) return false;
+    return options.listAppGroups || options.createAppGroup || options.deleteAppGroup ||
+           options.addToAppGroup || options.removeFromAppGroup || options.runOnAppGroup ||
+           !options.command.empty() || !options.scriptPath.empty() || !options.templateText.empty() ||
+           options.showStats;
+}
+
+CliSession::CliSession() {
+    DWORD mode = 0;
+    m_liveProgress = GetConsoleMode(GetStdHandle(STD_ERROR_HANDLE), &mode) != 0;
+}
+
+CliSession::~CliSession() {
+    if (m_costStore) {
+        m_costs.Save(*m_costStore);
+    }
+}
+
+void CliSession::SaveCosts() {
+    if (!m_costStore) return;
+    m_costs.Save(*m_costStore);
+    m_costStore->ScheduleSave();
+}
+
+void CliSession::Prepare() {
+    if (!m_manager) {
+        TraceZone zone("CliSession::Prepare");
+        m_manager = std::make_unique<NirCmdManager>();
+        TraceZone costsZone("LoadCosts");
+        m_costStore = std::make_unique<SettingsStore>(m_manager->GetAppDataPath() / "command_costs.store");
+        m_costStore->Load();
+        m_costs.Load(*m_costStore);
+        m_manager->SetCostModel(&m_costs);
+        costsZone.End();
+        TraceZone groupsZone("LoadAppGroups");
+        m_appGroups = std::make_unique<AppGroupsManager>();
+        m_appGroups->SetDataPath(m_manager->GetAppDataPath());
+        m_appGroups->Load();
+        return;
+    }
+
+    m_appGroups->Refresh();
+    if (!m_manager->IsAvailable()) {
+        m_manager->Discover();
+    }
+}
+
+void CliSession::WarmUp() {
+    Prepare();
+    NirCmdCommands::GetCategories();
+    m_processes.Refresh();
+}
+
+int CliSession::Run(const CliParser& parser, const CliOptions& options) {
+    if (options.listCategories) {
+        parser.PrintCategories();
+        return 0;
+    }
+
+    if (options.listCommands) {
+        parser.PrintCommands(options.category);
+        return 0;
+    }
+
+    if (!options.searchQuery.empty()) {
+        parser.PrintSearchResults(options.searchQuery);
+        return 0;
+    }
+
+    if (options.showHelp && !options.command.empty()) {
+        parser.PrintCommandDetails(options.command);
+        return 0;
+    }
+
+    Prepare();
+
+    int exitCode = 0;
+    if (!options.scriptPath.empty()) {
+        exitCode = RunScript(options);
+    } else if (!options.templateText.empty()) {
+        exitCode = RunTemplate(options);
+    } else if (options.listAppGroups || options.createAppGroup || options.deleteAppGroup ||
+               options.addToAppGroup || options.removeFromAppGroup || options.runOnAppGroup) {
+        exitCode = RunAppGroupCommand(options);
+    } else if (!options.command.empty()) {
+        exitCode = RunNirCmdCommand(options);
+    }
+
+    // After the work above, so a script run with --stats reports on itself
+    if (options.showStats) {
+        PrintLatencyStats();
+    }
+    return exitCode;
+}
+
+void CliSession::PrintLatencyStats() {
+    auto summaries = LatencyStats::Get().GetSummaries();
+    if (summaries.empty()) {
+        std::cout << "No command latencies recorded yet.\n";
+        std::cout << "Statistics cover this process, or the daemon's lifetime when one is running.\n";
+        return;
+    }
+    std::cout << FormatLatencyTable(summaries);
+}
+
+int CliSession::RunAppGroupCommand(const CliOptions& options) {
+    AppGroupsManager& appGroups = *m_appGroups;
+
+    if (options.listAppGroups) {
+        std::cout << "\nApp Groups:\n";
+        std::cout << "===========\n\n";
+
+        if (appGroups.GetGroups().empty()) {
+            std::cout << "No app groups defined.\n";
+            std::cout << "Use --create-group NAME to create one.\n";
+        } else {
+            for (const auto& group : appGroups.GetGroups()) {
+                std::cout << group.name << " (" << group.apps.size() << " apps):\n";
+                for (const auto& app : group.apps) {
+                    std::cout << "  - " << app.name << " [" << app.targetType << ": " << app.targetValue << "]\n";
+                }
+                std::cout << "\n";
+            }
+        }
+        return 0;
+    }
+
+    if (options.createAppGroup) {
+        if (options.appGroupName.empty()) {
+            std::cerr << "Error: Group name required.\n";
+            return 1;
+        }
+        if (appGroups.CreateGroup(options.appGroupName)) {
+            std::cout << "Created group: " << options.appGroupName << std::endl;
+            return 0;
+        } else {
+            std::cerr << "Error: Group already exists or creation failed.\n";
+            return 1;
+        }
+    }
+
+    if (options.deleteAppGroup) {
+        if (options.appGroupName.empty()) {
+            std::cerr << "Error: Group name required.\n";
+            return 1;
+        }
+        if (appGroups.DeleteGroup(options.appGroupName)) {
+            std::cout << "Deleted group: " << options.appGroupName << std::endl;
+            return 0;
+        } else {
+            std::cerr << "Error: Group not found.\n";
+            return 1;
+        }
+    }
+
+    if (options.addToAppGroup) {
+        if (options.appGroupName.empty() || options.appName.empty() ||
+            options.appTargetType.empty() || options.appTargetValue.empty()) {
+            std::cerr << "Error: Missing parameters.\n";
+            std::cerr << "Usage: --add-app GROUP NAME TYPE VALUE [--recursive]\n";
+            return 1;
+        }
+        if (appGroups.AddApp(options.appGroupName, options.appName,
+                            options.appTargetType, options.appTargetValue,
+                            options.appRecursive)) {
+            std::string recursiveStr = (options.appTargetType == "folder" && options.appRecursive) ? " (recursive)" : "";
+            std::cout << "Added '" << options.appName << "' to group '" << options.appGroupName << "'" << recursiveStr << "\n";
+            return 0;
+        } else {
+            std::cerr << "Error: Group not found.\n";
+            return 1;
+        }
+    }
+
+    if (options.removeFromAppGroup) {
+        if (options.appGroupName.empty() || options.appName.empty()) {
+            std::cerr << "Error: Missing parameters.\n";
+            std::cerr << "Usage: --remove-app GROUP NAME\n";
+            return 1;
+        }
+        if (appGroups.RemoveApp(options.appGroupName, options.appName)) {
+            std::cout << "Removed '" << options.appName << "' from group '" << options.appGroupName << "'\n";
+            return 0;
+        } else {
+            std::cerr << "Error: Group or app not found.\n";
+            return 1;
+        }
+    }
+
+    if (options.appGroupName.empty() || options.appGroupAction.empty()) {
+        std::cerr << "Error: Missing parameters.\n";
+        std::cerr << "Usage: --run-group GROUP ACTION\n";
+        return 1;
+    }
+    if (!m_manager->IsAvailable()) {
+        std::cerr << "Error: NirCmd not found. Use --download first.\n";
+        return 1;
+    }
+    ExecuteOnGroup(options.appGroupName, options.appGroupAction);
+    return 0;
+}
+
+void CliSession::ExecuteOnGroup(const std::string& groupName, const std::string& action) {
+    TraceZone zone("CliSession::ExecuteOnGroup", groupName);
+    NirCmdManager& manager = *m_manager;
+    auto snapshot = m_appGroups->GetSnapshot();
+    const AppGroup* group = snapshot->Find(groupName);
+    if (!group) {
+        std::cerr << "Group not found: " << groupName << std::endl;
+        return;
+    }
+
+    bool isFreeze = (action == "freeze");
+    bool isUnfreeze = (action == "unfreeze");
+
+    const auto& runningProcesses = m_processes.Refresh();
+    int totalAffected = 0;
+
+    // Steps run one after another here, so say up front when that takes a while
+    std::string step = isFreeze ? "win hide" : isUnfreeze ? "win show" : "win " + action;
+    double estimateMs = EstimateCommandMs(m_costs, step) * group->apps.size();
+    if (estimateMs >= 1000) {
+        std::cout << "Applying '" << action << "' to " << group->apps.size() << " apps, estimated "
+                  << FormatEstimate(estimateMs) << std::endl;
+    }
+
+    for (const auto& app : group->apps) {
+        if (app.targetType == "folder") {
+            std::set<DWORD> matchedPIDs;
+            for (const auto& proc : runningProcesses) {
+                if (!proc.path.empty() && PathStartsWithFolder(proc.path, app.targetValue, app.recursive)) {
+                    matchedPIDs.insert(proc.pid);
+                }
+            }
+
+            for (DWORD pid : matchedPIDs) {
+                if (isFreeze) {
+                    manager.Execute("suspendprocess /" + std::to_string(pid));
+                    std::cout << "  Frozen PID " << pid << std::endl;
+                } else if (isUnfreeze) {
+                    manager.Execute("resumeprocess /" + std::to_string(pid));
+                    std::cout << "  Unfrozen PID " << pid << std::endl;
+                }
+            }
+
+            if (!isFreeze && !isUnfreeze) {
+                for (const auto& proc : runningProcesses) {
+                    if (!proc.path.empty() && PathStartsWithFolder(proc.path, app.targetValue, app.recursive)) {
+                        std::string cmd = "win " + action + " process \"" + proc.name + "\"";
+                        manager.Execute(cmd);
+                        std::cout << "  " << action << ": " << proc.name << std::endl;
+                    }
+                }
+            }
+            totalAffected += static_cast<int>(matchedPIDs.size());
+        } else {
+            if (isFreeze) {
+                std::string hideCmd = "win hide " + app.targetType + " \"" + app.targetValue + "\"";
+                manager.Execute(hideCmd);
+
+                if (app.targetType == "process") {
+                    std::string suspendCmd = "suspendprocess " + app.targetValue;
+                    manager.Execute(suspendCmd);
+                }
+                std::cout << "  Frozen: " << app.name << std::endl;
+            }
+            else if (isUnfreeze) {
+                if (app.targetType == "process") {
+                    std::string resumeCmd = "resumeprocess " + app.targetValue;
+                    manager.Execute(resumeCmd);
+                }
+
+                std::string showCmd = "win show " + app.targetType + " \"" + app.targetValue + "\"";
+                manager.Execute(showCmd);
+                std::cout << "  Unfrozen: " << app.name << std::endl;
+            }
+            else {
+                std::string cmd = "win " + action + " " + app.targetType + " \"" + app.targetValue + "\"";
+                manager.Execute(cmd);
+                std::cout << "  " << action << ": " << app.name << std::endl;
+            }
+            totalAffected++;
+        }
+    }
+
+    std::cout << "Applied '" << action << "' to " << totalAffected << " items in '" << groupName << "'" << std::endl;
+}
+
+int CliSession::RunNirCmdCommand(const CliOptions& options) {
+    NirCmdManager& manager = *m_manager;
+
+    if (!manager.IsAvailable()) {
+        std::cerr << "Error: NirCmd not found. Use --download to download it." << std::endl;
+        return 1;
+    }
+
+    std::string cmdLine = NirCmdManager::BuildCommandLine(options.command, options.commandArgs);
+
+    // The parser consumes --recursive as an option; hand it back to the meta-command
+    std::string fullLine = options.appRecursive ? cmdLine + " --recursive" : cmdLine;
+    std::string validationError;
+    if (!ParamValidators::Validate(fullLine, validationError)) {
+        std::cerr << "Error: " << validationError << std::endl;
+        return 1;
+    }
+
+    ExecutionResult metaResult;
+    if (DispatchMetaCommand(fullLine, GetMetaCommandHandlers(), metaResult)) {
+        if (!metaResult.output.empty()) {
+            (metaResult.success ? std::cout : std::cerr) << metaResult.output << std::endl;
+        }
+        return metaResult.exitCode;
+    }
+
+    // Only on request: the caller gets exit code 0 before nircmd has run, and a
+    // failure is reported by the daemon rather than to the caller
+    if (options.coalesce && m_coalescer && m_coalescer->Push(cmdLine)) {
+        if (options.verbose) {
+            std::cout << "Queued: nircmd " << cmdLine << std::endl;
+        }
+        return 0;
+    }
+
+    if (options.verbose) {
+        std::cout << "Executing: nircmd " << cmdLine << std::endl;
+    }
+
+    auto result = manager.Execute(cmdLine);
+
+    if (!result.output.empty()) {
+        std::cout << result.output;
+    }
+
+    if (!result.error.empty()) {
+        std::cerr << result.error;
+    }
+
+    if (options.verbose) {
+        std::cout << "\nExecution time: " << result.executionTimeMs << " ms" << std::endl;
+        std::cout << "Exit code: " << result.exitCode << std::endl;
+    }
+
+    return result.exitCode;
+}
+
+static void PrintScriptSummary(const ScriptSummary& summary) {
+    std::vector<double> latencies = summary.latenciesMs;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        size_t rank = static_cast<size_t>(p * latencies.size() + 0.5);
+        return latencies[std::min(latencies.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+
+    double seconds = summary.wallTimeMs / 1000.0;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "\nScript: " << summary.commands << " commands in " << seconds << " s";
+    if (seconds > 0) std::cout << " (" << summary.commands / seconds << " commands/s)";
+    std::cout << ", " << summary.commands - summary.failed << " succeeded, " << summary.failed << " failed\n";
+    if (latencies.empty()) return;
+
+    double total = 0;
+    for (double ms : latencies) total += ms;
+    std::cout << std::setprecision(2);
+    std::cout << "Latency: min " << latencies.front() << " ms, avg " << total / latencies.size()
+              << " ms, p50 " << percentile(0.50) << " ms, p95 " << percentile(0.95)
+              << " ms, p99 " << percentile(0.99) << " ms, max " << latencies.back() << " ms" << std::endl;
+}
+
+int CliSession::RunScript(const CliOptions& options) {
+    ScriptRunner runner;
+    std::string error;
+    if (!runner.Load(options.scriptPath, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    return RunScriptLines(runner, options.scriptPath, options);
+}
+
+int CliSession::RunTemplate(const CliOptions& options) {
+    CommandTemplate commandTemplate;
+    std::string error;
+    if (!commandTemplate.Compile(options.templateText, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    bool fromStdin = options.rowsPath.empty() || options.rowsPath == "-";
+    std::string sourceName = fromStdin ? "<stdin>" : options.rowsPath;
+    MappedFile rowsFile;
+    std::string input;
+    if (fromStdin) {
+        input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    } else if (!rowsFile.Open(options.rowsPath)) {
+        std::cerr << "Error: Cannot open rows: " << options.rowsPath << std::endl;
+        return 1;
+    }
+
+    CsvReader reader(fromStdin ? std::string_view(input) : rowsFile.GetView());
+    std::vector<std::string_view> fields;
+    if (commandTemplate.HasNamedPlaceholders()) {
+        if (!reader.Next(fields)) {
+            std::cerr << "Error: " << sourceName << " has no header row" << std::endl;
+            return 1;
+        }
+        if (!commandTemplate.Bind(fields, error)) {
+            std::cerr << "Error: " << sourceName << ": " << error << std::endl;
+            return 1;
+        }
+    }
+
+    std::string commands;
+    std::vector<uint32_t> sourceLines;
+    while (reader.Next(fields)) {
+        size_t start = commands.size();
+        commandTemplate.Expand(fields.data(), fields.size(), commands);
+        if (commands.find_first_of("\r\n", start) != std::string::npos) {
+            std::cerr << "Error: " << sourceName << ": line " << reader.GetLineNumber()
+                      << ": values cannot contain line breaks" << std::endl;
+            return 1;
+        }
+        commands += '\n';
+        sourceLines.push_back(static_cast<uint32_t>(reader.GetLineNumber()));
+    }
+
+    if (options.dryRun) {
+        std::cout << commands << std::flush;
+        return 0;
+    }
+
+    ScriptRunner runner;
+    runner.LoadText(std::move(commands), std::move(sourceLines));
+    return RunScriptLines(runner, sourceName, options);
+}
+
+int CliSession::RunScriptLines(const ScriptRunner& runner, const std::string& sourceName, const CliOptions& options) {
+    // Nothing runs unless every line is valid
+    std::vector<std::string> problems = runner.Validate();
+    if (!problems.empty()) {
+        for (const auto& problem : problems) {
+            std::cerr << sourceName << ": " << problem << "\n";
+        }
+        std::cerr << "Script not run: " << problems.size() << " problem(s) found." << std::endl;
+        return 1;
+    }
+
+    if (!m_manager->IsAvailable()) {
+        std::cerr << "Error: NirCmd not found. Use --download to download it." << std::endl;
+        return 1;
+    }
+
+    // Estimated cost of each line drives the ETA; the runner also uses the
+    // model to start slow lines first
+    const auto& lines = runner.GetLines();
+    std::vector<double> estimates;
+    estimates.reserve(lines.size());
+    ProgressTracker progress;
+    for (const auto& line : lines) {
+        estimates.push_back(line.command.empty() ? 0.0 : EstimateCommandMs(m_costs, line.command));
+        if (!line.command.empty()) progress.Add(estimates.back());
+    }
+    size_t jobs = std::max<size_t>(options.scriptJobs, 1);
+    if (options.verbose) {
+        std::cout << "Running " << progress.GetTotal() << " commands, estimated "
+                  << FormatEstimate(progress.GetRemainingMs(0, jobs)) << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto lastProgress = start;
+    bool progressShown = false;
+    auto clearProgress = [&]() {
+        if (!progressShown) return;
+        std::cerr << "\r" << std::string(60, ' ') << "\r";
+        progressShown = false;
+    };
+
+    NirCmdManager& manager = *m_manager;
+    MetaCommandHandlers handlers = GetMetaCommandHandlers();
+    ScriptSummary summary = runner.Run(
+        options.scriptJobs,
+        [&manager](const std::string& command) { return manager.Execute(command); },
+        [&handlers](const std::string& command, ExecutionResult& result) {
+            return DispatchMetaCommand(command, handlers, result);
+        },
+        [&](const ScriptLine& line, const ExecutionResult& result) {
+            progress.Complete(estimates[&line - lines.data()]);
+            if (options.verbose || !result.output.empty() || !result.success) {
+                clearProgress();
+            }
+            if (options.verbose) {
+                std::cout << "line " << line.lineNumber << ": " << line.command << "\n";
+            }
+            if (!result.output.empty()) {
+                (result.success ? std::cout : std::cerr) << result.output
+                                                         << (result.output.back() == '\n' ? "" : "\n");
+            }
+            if (!result.success) {
+                std::cerr << "line " << line.lineNumber << ": failed (exit code " << result.exitCode << "): "
+                          << line.command << "\n" << result.error;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (m_liveProgress && progress.IsActive() && now - lastProgress >= std::chrono::milliseconds(250)) {
+                double elapsedMs = std::chrono::duration<double, std::milli>(now - start).count();
+                std::cout << std::flush;
+                std::cerr << "\r[" << progress.GetDone() << "/" << progress.GetTotal() << "] "
+                          << static_cast<int>(progress.GetFraction() * 100) << "%, about "
+                          << FormatEstimate(progress.GetRemainingMs(elapsedMs, jobs))
+                          << " left   " << std::flush;
+                progressShown = true;
+                lastProgress = now;
+            }
+        },
+        &m_costs);
+    clearProgress();
+
+    PrintScriptSummary(summary);
+    return summary.failed == 0 ? 0 : 1;
+}
+
+CommandScheduler& CliSession::GetScheduler() {
+    if (!m_scheduler) {
+        m_scheduler = std::make_unique<CommandScheduler>([this](const std::string& command) {
+            RunScheduledCommand(command);
+        });
+        m_scheduler->Start();
+    }
+    return *m_scheduler;
+}
+
+void CliSession::RunScheduledCommand(const std::string& command) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Prepare();
+    std::cout << "Scheduled: " << command << std::endl;
+
+    ExecutionResult result;
+    if (!DispatchMetaCommand(command, GetMetaCommandHandlers(), result)) {
+        if (!m_manager->IsAvailable()) {
+            std::cerr << "Error: NirCmd not found. Use --download to download it." << std::endl;
+            return;
+        }
+        result = m_manager->Execute(command);
+        std::cerr << result.error;
+    }
+    if (!result.output.empty()) {
+        (result.success ? std::cout : std::cerr) << result.output << (result.output.back() == '\n' ? "" : "\n");
+    }
+    if (!result.success) {
+        std::cerr << "Scheduled command failed (exit code " << result.exitCode << "): " << command << std::endl;
+    }
+}
+
+void CliSession::EnableCoalescing() {
+    if (m_coalescer) return;
+    m_coalescer = std::make_unique<CommandCoalescer>();
+    m_coalescer->Start([this](const std::string& command) {
+        RunCoalescedCommand(command);
+    });
+}
+
+void CliSession::RunCoalescedCommand(const std::string& command) {
+    // Runs without the session lock so requests keep arriving (and merging)
+    // meanwhile; the manager is safe to share, printing is not
+    ExecutionResult result = m_manager->Execute(command);
+    if (result.success) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cerr << result.error;
+    std::cerr << "Queued command failed (exit code " << result.exitCode << "): " << command << std::endl;
+}
+
+void CliSession::WaitForScheduledCommands() {
+    if (!m_scheduler) return;
+    size_t pending = m_scheduler->GetTaskCount();
+    if (pending == 0) return;
+    std::cout << "Waiting for " << pending << " scheduled command(s); press Ctrl+C to stop." << std::endl;
+    m_scheduler->WaitUntilIdle();
+}
+
+MetaCommandHandlers CliSession::GetMetaCommandHandlers() {
+    MetaCommandHandlers handlers;
+    handlers.appGroups = m_appGroups.get();
+    handlers.getScheduler = [this]() { return &GetScheduler(); };
+    handlers.costs = &m_costs;
+    handlers.freeze = [this](const std::string& findType, const std::string& findValue, bool recursive) {
+        Freeze(true, findType, findValue, recursive);
+        return std::string();
+    };
+    handlers.unfreeze = [this](const std::string& findType, const std::string& findValue, bool recursive) {
+        Freeze(false, findType, findValue, recursive);
+        return std::string();
+    };
+    handlers.runGroup = [this](const std::string& groupName, const std::string& action) {
+        ExecuteOnGroup(groupName, action);
+        return std::string();
+    };
+    return handlers;
+}
+
+void CliSession::Freeze(bool isFreeze, const std::string& findType, const std::string& findValue, bool recursive) {
+    TraceZone zone(isFreeze ? "CliSession::Freeze" : "CliSession::Unfreeze", findValue);
+    NirCmdManager& manager = *m_manager;
+
+    if (findType == "folder" || findType == "process") {
+        const auto& runningProcesses = m_processes.Refresh();
+        int affected = 0;
+        for (const auto& proc : runningProcesses) {
+            bool matches = findType == "folder"
+                ? !proc.path.empty() && PathStartsWithFolder(proc.path, findValue, recursive)
+                : _stricmp(proc.name.c_str(), findValue.c_str()) == 0;
+            if (!matches) continue;
+
+            if (isFreeze) {
+                manager.Execute("win hide handle /" + std::to_string(proc.pid));
+                manager.Execute("suspendprocess /" + std::to_string(proc.pid));
+            } else {
+                manager.Execute("resumeprocess /" + std::to_string(proc.pid));
+                manager.Execute("win show handle /" + std::to_string(proc.pid));
+            }
+            std::cout << (isFreeze ? "Frozen: " : "Unfrozen: ") << proc.name << " (PID " << proc.pid << ")" << std::endl;
+            affected++;
+        }
+        std::cout << "Total affected: " << affected << " process(es)" << std::endl;
+        return;
+    }
+
+    if (isFreeze) {
+        manager.Execute("win hide " + findType + " \"" + findValue + "\"");
+        if (findType == "handle") {
+            manager.Execute("suspendprocess /" + findValue);
+        }
+    } else {
+        if (findType == "handle") {
+            manager.Execute("resumeprocess /" + findValue);
+        }
+        manager.Execute("win show " + findType + " \"" + findValue + "\"");
+    }
+    std::cout << (isFreeze ? "Frozen" : "Unfrozen") << ": " << findValue << std::endl;
+}
+
+} // namespace NirUI
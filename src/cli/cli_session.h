@@ -0,0 +1,128 @@
+#pragma once
+
+#include "cli_parser.h"
+#include "core/app_groups.h"
+#include "core/command_coalescer.h"
+#include "core/command_scheduler.h"
+#include "core/cost_model.h"
+#include "core/meta_commands.h"
+#include "core/nircmd_manager.h"
+#include "core/script_runner.h"
+#include "core/settings_store.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NirUI {
+
+struct ProcessInfo {
+    uint32_t pid = 0;
+    std::string name;
+    std::string path;
+};
+
+// Running processes with their image paths. Every Refresh() takes a fresh
+// snapshot, but paths are remembered per process (pid, parent and exe name), so
+// a long-lived session only opens processes it has not seen before.
+class ProcessCache {
+public:
+    const std::vector<ProcessInfo>& Refresh();
+    const std::vector<ProcessInfo>& GetProcesses() const { return m_processes; }
+
+private:
+    struct CachedPath {
+        uint32_t parentPid = 0;
+        std::string name;
+        std::string path;
+    };
+
+    std::vector<ProcessInfo> m_processes;
+    std::unordered_map<uint32_t, CachedPath> m_paths;
+};
+
+// State behind one CLI invocation: the NirCmd manager, the app groups, the
+// process cache and the command scheduler. A normal run builds a session for a
+// single command; the daemon keeps one warm and runs every forwarded command
+// through it. Scheduled commands run on the scheduler's thread, so callers
+// hold GetMutex() while using the session.
+class CliSession {
+public:
+    CliSession();
+    // Saves the command cost model
+    ~CliSession();
+
+    // True if the options ask for work a session performs (as opposed to help,
+    // version, download or launching the GUI)
+    static bool HandlesOptions(const CliOptions& options);
+
+    // Loads the manager and app groups on first use and picks up app group
+    // changes made by other processes since the last call
+    void Prepare();
+    // Prepares the session and fills the command registry and process cache
+    void WarmUp();
+    // Runs one parsed command line, printing to std::cout and std::cerr.
+    // Returns the process exit code.
+    int Run(const CliParser& parser, const CliOptions& options);
+
+    // Valid after Prepare()
+    NirCmdManager& GetManager() { return *m_manager; }
+    AppGroupsManager& GetAppGroups() { return *m_appGroups; }
+
+    // Hides and suspends (or resumes and shows) the target. Folder and process
+    // targets are matched against the running processes.
+    void Freeze(bool freeze, const std::string& findType, const std::string& findValue, bool recursive);
+    void ExecuteOnGroup(const std::string& groupName, const std::string& action);
+    // Meta-command hooks that print straight to std::cout. Valid after Prepare().
+    MetaCommandHandlers GetMetaCommandHandlers();
+
+    // From now on, coalescible nircmd commands (volume, brightness and cursor
+    // steps) run with --coalesce are queued and merged instead of run before
+    // Run() returns. The daemon turns this on for hotkey tools that call it in
+    // bursts.
+    void EnableCoalescing();
+
+    // Live progress lines for scripts, on by default when stderr is a console.
+    // The daemon captures output and turns them off.
+    void SetLiveProgress(bool enabled) { m_liveProgress = enabled; }
+    // Queues a save of the command cost model
+    void SaveCosts();
+
+    std::mutex& GetMutex() { return m_mutex; }
+    // Blocks while commands scheduled by this session are pending. Call without
+    // holding GetMutex().
+    void WaitForScheduledCommands();
+
+private:
+    int RunAppGroupCommand(const CliOptions& options);
+    int RunNirCmdCommand(const CliOptions& options);
+    int RunScript(const CliOptions& options);
+    int RunTemplate(const CliOptions& options);
+    // Validates, runs and summarizes a loaded script; sourceName prefixes errors
+    int RunScriptLines(const ScriptRunner& runner, const std::string& sourceName, const CliOptions& options);
+    // Started on first use
+    CommandScheduler& GetScheduler();
+    void RunScheduledCommand(const std::string& command);
+    void RunCoalescedCommand(const std::string& command);
+    // Percentiles of every command run in this process
+    void PrintLatencyStats();
+
+    // First, so it outlives everything that records into it
+    CostModel m_costs;
+    std::unique_ptr<SettingsStore> m_costStore;
+    bool m_liveProgress = false;
+
+    std::unique_ptr<NirCmdManager> m_manager;
+    std::unique_ptr<AppGroupsManager> m_appGroups;
+    ProcessCache m_processes;
+
+    std::mutex m_mutex;
+    // Runs what is still queued when the session goes away
+    std::unique_ptr<CommandCoalescer> m_coalescer;
+    // Last, so its thread stops before the rest of the session goes away
+    std::unique_ptr<CommandScheduler> m_scheduler;
+};
+
+} // namespace NirUI
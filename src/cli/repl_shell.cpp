@@ -0,0 +1,222 @@
+#include "repl_shell.h"
+#include "core/command_tokenizer.h"
+#include "core/nircmd_commands.h"
+#include "core/param_validator.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <set>
+
+namespace NirUI {
+
+static const char* const REPL_OPTIONS[] = {
+    "--search", "--info", "--commands", "--category", "--list-categories", "--groups", "--help"
+};
+
+static char ToLower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+static bool StartsWithNoCase(const std::string& value, const std::string& prefix) {
+    if (prefix.size() > value.size()) return false;
+    for (size_t i = 0; i < prefix.size(); ++i) {
+        if (ToLower(value[i]) != ToLower(prefix[i])) return false;
+    }
+    return true;
+}
+
+static std::vector<std::string> SplitWords(std::string_view line) {
+    CommandTokens tokens(line);
+    std::vector<std::string> words;
+    for (size_t i = 0; i < tokens.GetCount(); ++i) {
+        words.emplace_back(tokens[i]);
+    }
+    return words;
+}
+
+// Separates the word being typed (without its opening quote) from the words before it
+static size_t FindPartialWord(const std::string& line) {
+    size_t start = 0;
+    bool inQuotes = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '"') inQuotes = !inQuotes;
+        else if (line[i] == ' ' && !inQuotes) start = i + 1;
+    }
+    return start;
+}
+
+// Positions where the values differ only in case become lowercase
+static std::string CommonPrefix(const std::vector<std::string>& values) {
+    if (values.empty()) return std::string();
+    std::string prefix = values.front();
+    for (const auto& value : values) {
+        size_t length = 0;
+        while (length < prefix.size() && length < value.size() && ToLower(prefix[length]) == ToLower(value[length])) {
+            if (prefix[length] != value[length]) prefix[length] = ToLower(prefix[length]);
+            length++;
+        }
+        prefix.resize(length);
+    }
+    return prefix;
+}
+
+StreamLineReader::StreamLineReader(std::istream& in, std::ostream* prompt) : m_in(in), m_prompt(prompt) {
+}
+
+bool StreamLineReader::ReadLine(std::string& line) {
+    line.clear();
+    if (m_prompt) *m_prompt << "nirui> " << std::flush;
+    return static_cast<bool>(std::getline(m_in, line));
+}
+
+ReplShell::ReplShell(ReplBackend& backend, std::ostream& out, std::ostream& err)
+    : m_backend(backend), m_out(out), m_err(err) {
+    for (const auto& category : NirCmdCommands::GetCategories()) {
+        for (const auto& cmd : category.commands) {
+            m_commandIndex.push_back(cmd.name);
+        }
+    }
+    std::sort(m_commandIndex.begin(), m_commandIndex.end());
+}
+
+void ReplShell::Run(ReplLineReader& reader) {
+    std::string line;
+    while (reader.ReadLine(line)) {
+        if (!Execute(line)) break;
+    }
+}
+
+bool ReplShell::Execute(const std::string& rawLine) {
+    size_t first = rawLine.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return true;
+    std::string line = rawLine.substr(first, rawLine.find_last_not_of(" \t\r\n") - first + 1);
+
+    if (line == "exit" || line == "quit") return false;
+    if (line == "help") {
+        PrintHelp();
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_backend.GetMutex());
+    auto start = std::chrono::steady_clock::now();
+    m_backend.Prepare();
+    if (!m_handlers.appGroups) m_handlers = m_backend.GetMetaCommandHandlers();
+
+    ExecutionResult result;
+    std::string validationError;
+    if (line[0] == '-') {
+        m_backend.RunOptions(line);
+    } else if (!ParamValidators::Validate(line, validationError)) {
+        m_err << "Error: " << validationError << std::endl;
+    } else if (DispatchMetaCommand(line, m_handlers, result)) {
+        if (!result.output.empty()) {
+            (result.success ? m_out : m_err) << result.output << (result.output.back() == '\n' ? "" : "\n");
+        }
+    } else if (!m_backend.IsNirCmdAvailable()) {
+        m_err << "Error: NirCmd not found. Use --download to download it." << std::endl;
+    } else {
+        result = m_backend.ExecuteNirCmd(line);
+        m_out << result.output;
+        m_err << result.error;
+        if (!result.success) {
+            m_err << "Command failed (exit code " << result.exitCode << ")" << std::endl;
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_out << "[" << std::fixed << std::setprecision(2) << ms << " ms]" << std::endl;
+    return true;
+}
+
+void ReplShell::PrintHelp() const {
+    m_out << "\n";
+    m_out << "  COMMAND [ARGS...]               Run a NirCmd command, e.g. monitor off\n";
+    m_out << "  win freeze TYPE VALUE [recursive=1]\n";
+    m_out << "  win unfreeze TYPE VALUE         Hide and suspend, or resume and show\n";
+    m_out << "  group list|create|delete|add|remove|run ...\n";
+    m_out << "                                  Manage and run app groups\n";
+    m_out << "  schedule in|every|cron WHEN COMMAND..., schedule list, schedule cancel ID|all\n";
+    m_out << "                                  Run commands later while the REPL is open\n";
+    m_out << "  --search QUERY, --info COMMAND, --commands, --groups, ...\n";
+    m_out << "                                  Any CLI option that inspects or runs commands\n";
+    m_out << "  help, exit\n";
+    m_out << "\n";
+    m_out << "Tab completes command names, choices and group names.\n\n";
+}
+
+std::vector<std::string> ReplShell::Complete(const std::string& line) const {
+    size_t partialStart = FindPartialWord(line);
+    std::string partial = line.substr(partialStart);
+    if (!partial.empty() && partial[0] == '"') partial.erase(0, 1);
+    std::vector<std::string> words = SplitWords(line.substr(0, partialStart));
+
+    std::set<std::string> candidates;
+    auto addGroupNames = [&]() {
+        if (!m_handlers.appGroups) return;
+        for (const auto& group : m_handlers.appGroups->GetSnapshot()->groups) {
+            candidates.insert(group->name);
+        }
+    };
+
+    if (words.empty()) {
+        for (const auto& name : m_commandIndex) {
+            candidates.insert(name.substr(0, name.find(' ')));
+        }
+        for (const char* option : REPL_OPTIONS) candidates.insert(option);
+        candidates.insert("help");
+        candidates.insert("exit");
+    } else if (words.size() == 1 && (words[0] == "--info" || words[0] == "-s" || words[0] == "--search")) {
+        if (words[0] == "--info") candidates.insert(m_commandIndex.begin(), m_commandIndex.end());
+    } else if (words.size() == 1 && (words[0] == "--category" || words[0] == "-c")) {
+        for (const auto& category : NirCmdCommands::GetCategories()) candidates.insert(category.name);
+    } else {
+        // Second word of two-word commands such as "win close"
+        if (words.size() == 1) {
+            std::string head = words[0] + " ";
+            auto it = std::lower_bound(m_commandIndex.begin(), m_commandIndex.end(), head);
+            for (; it != m_commandIndex.end() && it->compare(0, head.size(), head) == 0; ++it) {
+                candidates.insert(it->substr(head.size()));
+            }
+        }
+
+        const Command* cmd = words.size() > 1 ? NirCmdCommands::FindCommand(words[0] + " " + words[1]) : nullptr;
+        size_t slot = words.size() - 2;
+        if (!cmd) {
+            cmd = NirCmdCommands::FindCommand(words[0]);
+            slot = words.size() - 1;
+        }
+        if (cmd && slot < cmd->parameters.size()) {
+            const Parameter& param = cmd->parameters[slot];
+            if (param.name == "group" || (cmd->name == "group delete" && param.name == "name")) {
+                addGroupNames();
+            }
+            candidates.insert(param.choices.begin(), param.choices.end());
+            if (param.type == ParamType::Boolean) {
+                candidates.insert("1");
+                candidates.insert("0");
+            }
+        }
+    }
+
+    std::vector<std::string> matches;
+    for (const auto& candidate : candidates) {
+        if (!StartsWithNoCase(candidate, partial)) continue;
+        matches.push_back(candidate.find(' ') != std::string::npos ? "\"" + candidate + "\"" : candidate);
+    }
+    return matches;
+}
+
+std::string ReplShell::CompleteLine(const std::string& line, std::vector<std::string>& matches) const {
+    matches = Complete(line);
+    if (matches.empty()) return line;
+
+    size_t partialStart = FindPartialWord(line);
+    std::string completion = matches.size() == 1 ? matches[0] + " " : CommonPrefix(matches);
+    if (completion.size() <= line.size() - partialStart) return line;
+    return line.substr(0, partialStart) + completion;
+}
+
+} // namespace NirUI
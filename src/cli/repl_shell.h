@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/meta_commands.h"
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace NirUI {
+
+// Where the REPL gets its lines: the Windows console line editor, or a plain
+// stream when input is piped
+class ReplLineReader {
+public:
+    virtual ~ReplLineReader() = default;
+    // Returns false at the end of the input
+    virtual bool ReadLine(std::string& line) = 0;
+};
+
+// Reads lines from a stream, printing a prompt before each one if given one
+class StreamLineReader : public ReplLineReader {
+public:
+    explicit StreamLineReader(std::istream& in, std::ostream* prompt = nullptr);
+
+    bool ReadLine(std::string& line) override;
+
+private:
+    std::istream& m_in;
+    std::ostream* m_prompt;
+};
+
+// What the REPL runs commands against. CliRepl implements it over a warm
+// CliSession; tests use a stand-in.
+class ReplBackend {
+public:
+    virtual ~ReplBackend() = default;
+
+    // Held while a line runs, since scheduled commands use the backend too
+    virtual std::mutex& GetMutex() = 0;
+    // Called with the mutex held before every line
+    virtual void Prepare() = 0;
+    // Valid after Prepare(); fetched once and kept for completion
+    virtual MetaCommandHandlers GetMetaCommandHandlers() = 0;
+    // CLI options such as "--search mute"
+    virtual void RunOptions(const std::string& line) = 0;
+    virtual bool IsNirCmdAvailable() = 0;
+    virtual ExecutionResult ExecuteNirCmd(const std::string& line) = 0;
+};
+
+// Line handling behind the REPL, independent of the console: built-ins, input
+// validation, meta-command dispatch, latency reporting and Tab completion.
+class ReplShell {
+public:
+    ReplShell(ReplBackend& backend, std::ostream& out, std::ostream& err);
+
+    // Runs lines until the reader ends or one of them is "exit"
+    void Run(ReplLineReader& reader);
+    // Runs one line; returns false when the REPL should exit
+    bool Execute(const std::string& line);
+    // Completions for the last (possibly empty) word of line
+    std::vector<std::string> Complete(const std::string& line) const;
+    // What Tab turns line into: a single match completes the word, several
+    // extend it by their common prefix, compared without case. Returns line
+    // unchanged when there is nothing to add; matches lists the candidates.
+    std::string CompleteLine(const std::string& line, std::vector<std::string>& matches) const;
+    void PrintHelp() const;
+
+private:
+    ReplBackend& m_backend;
+    std::ostream& m_out;
+    std::ostream& m_err;
+    MetaCommandHandlers m_handlers;
+    std::vector<std::string> m_commandIndex;
+};
+
+} // namespace NirUI
@@ -1,45 +1,257 @@
 #include "app_groups.h"
+#include "utils/atomic_file.h"
+#include "utils/mapped_file.h"
 #include <fstream>
 #include <algorithm>
+#include <cstdlib>
 
 namespace NirUI {
 
+// Compact once the journal holds this many more records than a snapshot would
+static constexpr size_t COMPACTION_SLACK = 64;
+
+static void AppendEscaped(std::string& out, std::string_view value) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c; break;
+        }
+    }
+}
+
+static std::string Unescape(std::string_view value) {
+    std::string out;
+    out.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        char c = value[i];
+        if (c == '\\' && i + 1 < value.size()) {
+            char next = value[++i];
+            if (next == 't') c = '\t';
+            else if (next == 'n') c = '\n';
+            else if (next == 'r') c = '\r';
+            else c = next;
+        }
+        out += c;
+    }
+    return out;
+}
+
+static void SplitFields(std::string_view line, std::vector<std::string>& fields) {
+    fields.clear();
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(Unescape(line.substr(start, tab == std::string_view::npos ? std::string_view::npos : tab - start)));
+        if (tab == std::string_view::npos) break;
+        start = tab + 1;
+    }
+}
+
+static void AppendLine(std::string& out, std::initializer_list<std::string_view> fields) {
+    bool first = true;
+    for (std::string_view field : fields) {
+        if (!first) out += '\t';
+        AppendEscaped(out, field);
+        first = false;
+    }
+    out += '\n';
+}
+
+static bool IsJournal(std::string_view text, size_t& bodyStart) {
+    size_t lineEnd = text.find('\n');
+    std::string_view header = text.substr(0, lineEnd);
+    if (!header.empty() && header.back() == '\r') header.remove_suffix(1);
+    
+    bodyStart = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+    return header == AppGroupsManager::JOURNAL_HEADER;
+}
+
+static bool SameApps(const std::vector<AppEntry>& a, const std::vector<AppEntry>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const AppEntry& x, const AppEntry& y) {
+        return x.name == y.name && x.targetType == y.targetType &&
+               x.targetValue == y.targetValue && x.recursive == y.recursive;
+    });
+}
+
+const AppGroup* AppGroupsSnapshot::Find(const std::string& name) const {
+    if (!nameIndex) return nullptr;
+    
+    auto it = nameIndex->find(name);
+    return it == nameIndex->end() ? nullptr : groups[it->second].get();
+}
+
 AppGroupsManager::AppGroupsManager() {
+    Publish();
 }
 
 void AppGroupsManager::SetDataPath(const std::filesystem::path& path) {
     m_dataPath = path;
 }
 
+std::filesystem::path AppGroupsManager::GetJournalPath() const {
+    return m_dataPath / "app_groups.txt";
+}
+
 void AppGroupsManager::Load() {
     if (m_dataPath.empty()) return;
     
-    std::filesystem::path savePath = m_dataPath / "app_groups.txt";
-    std::ifstream file(savePath);
-    if (!file) return;
+    MappedFile file;
+    if (!file.Open(GetJournalPath())) return;
     
     m_groups.clear();
-    AppGroup* currentGroup = nullptr;
+    RebuildIndexes();
+    m_journalRecords = 0;
+    m_replaying = true;
     
-    std::string line;
-    while (std::getline(file, line)) {
+    std::string_view text = file.GetView();
+    size_t bodyStart = 0;
+    if (!IsJournal(text, bodyStart)) {
+        LoadLegacy(text);
+        RebuildIndexes();
+        m_replaying = false;
+        RebuildSharedGroups();
+        file.Close();
+        Save();
+        return;
+    }
+    
+    // Only newline-terminated records count; a partial last line means an append
+    // was interrupted, and compacting drops it so later appends start cleanly.
+    size_t applied = 0;
+    size_t end = ReplayRecords(text, bodyStart, applied);
+    bool needsCompaction = end < text.size();
+    m_journalFileId = file.GetFileId();
+    m_journalOffset = end;
+    
+    m_replaying = false;
+    RebuildSharedGroups();
+    
+    RecountLiveRecords();
+    if (needsCompaction || m_journalRecords > m_liveRecords * 2 + COMPACTION_SLACK) {
+        file.Close();
+        Save();
+    }
+}
+
+size_t AppGroupsManager::ReplayRecords(std::string_view text, size_t pos, size_t& applied) {
+    std::vector<std::string> fields;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) break;
+        
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        
+        SplitFields(line, fields);
+        if (ApplyRecord(fields)) applied++;
+        m_journalRecords++;
+    }
+    return pos;
+}
+
+bool AppGroupsManager::Refresh() {
+    if (m_dataPath.empty()) return false;
+    
+    // A missing file keeps the groups in memory; the next change recreates it
+    MappedFile file;
+    if (!file.Open(GetJournalPath())) return false;
+    
+    std::string_view text = file.GetView();
+    bool sameFile = m_journalFileId != 0 && file.GetFileId() == m_journalFileId;
+    if (sameFile && text.size() == m_journalOffset) return false;
+    
+    if (sameFile && text.size() > m_journalOffset) {
+        // Records appended by another process: replay just the new lines
+        size_t applied = 0;
+        m_journalOffset = ReplayRecords(text, static_cast<size_t>(m_journalOffset), applied);
+        if (applied > 0) Publish();
+        return applied > 0;
+    }
+    
+    // The file was replaced or truncated; read it in full and merge by name
+    AppGroupsManager disk;
+    disk.m_replaying = true;
+    size_t bodyStart = 0;
+    size_t end = text.size();
+    if (IsJournal(text, bodyStart)) {
+        size_t applied = 0;
+        end = disk.ReplayRecords(text, bodyStart, applied);
+    } else {
+        disk.LoadLegacy(text);
+        disk.RebuildIndexes();
+    }
+    
+    disk.CompactGroups();
+    bool changed = MergeFrom(disk);
+    m_journalFileId = file.GetFileId();
+    m_journalOffset = end;
+    m_journalRecords = disk.m_journalRecords;
+    if (changed) Publish();
+    RecountLiveRecords();
+    return changed;
+}
+
+bool AppGroupsManager::MergeFrom(const AppGroupsManager& other) {
+    bool changed = false;
+    
+    for (size_t i = m_groups.size(); i-- > 0;) {
+        if (m_denseToSlot[i] == UINT32_MAX) continue;
+        if (!other.FindGroup(m_groups[i].name)) {
+            DoDeleteGroup(std::string(m_groups[i].name));
+            changed = true;
+        }
+    }
+    
+    for (const auto& source : other.m_groups) {
+        if (DoCreateGroup(source.name)) changed = true;
+        
+        uint32_t group = FindDenseIndex(source.name);
+        if (SameApps(m_groups[group].apps, source.apps)) continue;
+        
+        m_groups[group].apps = source.apps;
+        m_appIndexes[group].clear();
+        for (uint32_t app = 0; app < source.apps.size(); ++app) {
+            IndexApp(group, app);
+        }
+        ShareGroup(group);
+        changed = true;
+    }
+    return changed;
+}
+
+void AppGroupsManager::LoadLegacy(std::string_view text) {
+    // Pre-journal format: "[GROUP]name" lines followed by "name|type|value|recursive"
+    AppGroup* currentGroup = nullptr;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        
         if (line.substr(0, 7) == "[GROUP]") {
             m_groups.push_back(AppGroup());
             currentGroup = &m_groups.back();
-            currentGroup->name = line.substr(7);
+            currentGroup->name = std::string(line.substr(7));
         } else if (currentGroup && !line.empty()) {
             size_t pos1 = line.find('|');
             size_t pos2 = line.find('|', pos1 + 1);
             size_t pos3 = line.find('|', pos2 + 1);
-            if (pos1 != std::string::npos && pos2 != std::string::npos) {
+            if (pos1 != std::string_view::npos && pos2 != std::string_view::npos) {
                 AppEntry entry;
-                entry.name = line.substr(0, pos1);
-                entry.targetType = line.substr(pos1 + 1, pos2 - pos1 - 1);
-                if (pos3 != std::string::npos) {
-                    entry.targetValue = line.substr(pos2 + 1, pos3 - pos2 - 1);
+                entry.name = std::string(line.substr(0, pos1));
+                entry.targetType = std::string(line.substr(pos1 + 1, pos2 - pos1 - 1));
+                if (pos3 != std::string_view::npos) {
+                    entry.targetValue = std::string(line.substr(pos2 + 1, pos3 - pos2 - 1));
                     entry.recursive = (line.substr(pos3 + 1) == "1");
                 } else {
-                    entry.targetValue = line.substr(pos2 + 1);
+                    entry.targetValue = std::string(line.substr(pos2 + 1));
                     entry.recursive = false;
                 }
                 currentGroup->apps.push_back(entry);
@@ -48,77 +260,408 @@ void AppGroupsManager::Load() {
     }
 }
 
+bool AppGroupsManager::ApplyRecord(const std::vector<std::string>& fields) {
+    if (fields.empty() || fields[0].size() != 1) return false;
+    
+    switch (fields[0][0]) {
+        case 'C':
+            return fields.size() == 2 && DoCreateGroup(fields[1]);
+        case 'D':
+            return fields.size() == 2 && DoDeleteGroup(fields[1]);
+        case 'N':
+            return fields.size() == 3 && DoRenameGroup(fields[1], fields[2]);
+        case 'A': {
+            if (fields.size() != 6) return false;
+            AppEntry entry;
+            entry.name = fields[2];
+            entry.targetType = fields[3];
+            entry.targetValue = fields[4];
+            entry.recursive = (fields[5] == "1");
+            return DoAddApp(fields[1], std::move(entry));
+        }
+        case 'R': {
+            if (fields.size() != 4) return false;
+            size_t index = static_cast<size_t>(std::strtoull(fields[3].c_str(), nullptr, 10));
+            return DoRemoveApp(fields[1], fields[2], index);
+        }
+        default:
+            return false;
+    }
+}
+
 void AppGroupsManager::Save() {
     if (m_dataPath.empty()) return;
     
-    std::filesystem::path savePath = m_dataPath / "app_groups.txt";
-    std::ofstream file(savePath);
-    if (!file) return;
-    
+    std::string text = JOURNAL_HEADER;
+    text += '\n';
     for (const auto& group : m_groups) {
-        file << "[GROUP]" << group.name << "\n";
+        AppendLine(text, { "C", group.name });
         for (const auto& app : group.apps) {
-            file << app.name << "|" << app.targetType << "|" << app.targetValue << "|" << (app.recursive ? "1" : "0") << "\n";
+            AppendLine(text, { "A", group.name, app.name, app.targetType, app.targetValue, app.recursive ? "1" : "0" });
         }
     }
+    
+    std::error_code ec;
+    std::filesystem::create_directories(m_dataPath, ec);
+    if (WriteFileAtomically(GetJournalPath(), text)) {
+        RecountLiveRecords();
+        m_journalRecords = m_liveRecords;
+        m_journalFileId = MappedFile(GetJournalPath()).GetFileId();
+        m_journalOffset = text.size();
+    }
 }
 
-AppGroup* AppGroupsManager::FindGroup(const std::string& name) {
-    for (auto& group : m_groups) {
-        if (group.name == name) {
-            return &group;
+void AppGroupsManager::AppendRecord(std::initializer_list<std::string_view> fields) {
+    if (m_dataPath.empty()) return;
+    
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(GetJournalPath(), ec);
+    if (ec) {
+        Save();
+        return;
+    }
+    
+    // Another writer got in after the mutator refreshed; a snapshot keeps both
+    // changes consistent where an append would land after unreplayed records
+    if (size != m_journalOffset) {
+        Save();
+        return;
+    }
+    
+    std::string line;
+    AppendLine(line, fields);
+    
+    {
+        std::ofstream file(GetJournalPath(), std::ios::binary | std::ios::app);
+        if (!file) return;
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+        if (!file) return;
+    }
+    m_journalRecords++;
+    m_journalOffset += line.size();
+    
+    if (m_journalRecords > m_liveRecords * 2 + COMPACTION_SLACK) {
+        Save();
+    }
+}
+
+void AppGroupsManager::RecountLiveRecords() {
+    m_liveRecords = m_groups.size();
+    for (const auto& group : m_groups) {
+        m_liveRecords += group.apps.size();
+    }
+}
+
+void AppGroupsManager::RebuildIndexes() {
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_nameIndex.clear();
+    m_denseToSlot.clear();
+    m_appIndexes.clear();
+    m_deadGroups = 0;
+    
+    m_slots.resize(m_groups.size());
+    m_denseToSlot.resize(m_groups.size());
+    m_appIndexes.resize(m_groups.size());
+    for (uint32_t i = 0; i < m_groups.size(); ++i) {
+        m_slots[i].dense = i;
+        m_denseToSlot[i] = i;
+        m_nameIndex.emplace(m_groups[i].name, i);
+        for (uint32_t app = 0; app < m_groups[i].apps.size(); ++app) {
+            IndexApp(i, app);
         }
     }
-    return nullptr;
 }
 
-bool AppGroupsManager::CreateGroup(const std::string& name) {
-    if (FindGroup(name)) return false;
+void AppGroupsManager::IndexApp(uint32_t group, uint32_t app) {
+    m_appIndexes[group].emplace(m_groups[group].apps[app].name, app);
+}
+
+void AppGroupsManager::UnindexApp(uint32_t group, uint32_t app) {
+    auto& index = m_appIndexes[group];
+    auto range = index.equal_range(m_groups[group].apps[app].name);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == app) {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
+void AppGroupsManager::ShareGroup(uint32_t group) {
+    if (m_replaying) return;
+    m_sharedGroups[group] = std::make_shared<const AppGroup>(m_groups[group]);
+}
+
+void AppGroupsManager::CompactGroups() {
+    if (m_deadGroups == 0) return;
     
-    AppGroup group;
-    group.name = name;
-    m_groups.push_back(group);
-    return true;
+    // One stable pass over the tombstones left by DoDeleteGroup. The shared
+    // groups are only kept in step outside replay.
+    bool shared = m_sharedGroups.size() == m_groups.size();
+    uint32_t live = 0;
+    for (uint32_t i = 0; i < m_groups.size(); ++i) {
+        uint32_t slot = m_denseToSlot[i];
+        if (slot == UINT32_MAX) continue;
+        if (i != live) {
+            m_groups[live] = std::move(m_groups[i]);
+            m_appIndexes[live] = std::move(m_appIndexes[i]);
+            m_denseToSlot[live] = slot;
+            if (shared) m_sharedGroups[live] = std::move(m_sharedGroups[i]);
+        }
+        m_slots[slot].dense = live++;
+    }
+    m_groups.resize(live);
+    m_appIndexes.resize(live);
+    m_denseToSlot.resize(live);
+    if (shared) m_sharedGroups.resize(live);
+    m_deadGroups = 0;
 }
 
-bool AppGroupsManager::DeleteGroup(const std::string& name) {
-    auto it = std::find_if(m_groups.begin(), m_groups.end(),
-        [&name](const AppGroup& g) { return g.name == name; });
+void AppGroupsManager::RebuildSharedGroups() {
+    m_sharedGroups.clear();
+    CompactGroups();
+    m_sharedGroups.reserve(m_groups.size());
+    for (const auto& group : m_groups) {
+        m_sharedGroups.push_back(std::make_shared<const AppGroup>(group));
+    }
+    m_namesChanged = true;
+    Publish();
+}
+
+void AppGroupsManager::Publish() {
+    if (m_replaying) return;
+    CompactGroups();
     
-    if (it != m_groups.end()) {
-        m_groups.erase(it);
-        return true;
+    if (m_namesChanged || !m_sharedNameIndex) {
+        auto nameIndex = std::make_shared<NameIndex>();
+        nameIndex->reserve(m_sharedGroups.size());
+        for (size_t i = 0; i < m_sharedGroups.size(); ++i) {
+            nameIndex->emplace(m_sharedGroups[i]->name, i);
+        }
+        m_sharedNameIndex = std::move(nameIndex);
+        m_namesChanged = false;
     }
-    return false;
+    
+    auto snapshot = std::make_shared<AppGroupsSnapshot>();
+    snapshot->version = ++m_version;
+    snapshot->groups = m_sharedGroups;
+    snapshot->nameIndex = m_sharedNameIndex;
+    m_snapshot.Store(std::move(snapshot));
+}
+
+uint32_t AppGroupsManager::FindDenseIndex(const std::string& name) const {
+    auto it = m_nameIndex.find(name);
+    if (it == m_nameIndex.end()) return UINT32_MAX;
+    return m_slots[it->second].dense;
+}
+
+AppGroup* AppGroupsManager::FindGroup(const std::string& name) {
+    uint32_t index = FindDenseIndex(name);
+    return index == UINT32_MAX ? nullptr : &m_groups[index];
+}
+
+const AppGroup* AppGroupsManager::FindGroup(const std::string& name) const {
+    uint32_t index = FindDenseIndex(name);
+    return index == UINT32_MAX ? nullptr : &m_groups[index];
+}
+
+AppGroupHandle AppGroupsManager::FindGroupHandle(const std::string& name) const {
+    uint32_t index = FindDenseIndex(name);
+    return index == UINT32_MAX ? AppGroupHandle() : GetHandle(index);
+}
+
+AppGroupHandle AppGroupsManager::GetHandle(size_t index) const {
+    AppGroupHandle handle;
+    if (index >= m_denseToSlot.size()) return handle;
+    
+    handle.slot = m_denseToSlot[index];
+    handle.generation = m_slots[handle.slot].generation;
+    return handle;
+}
+
+AppGroup* AppGroupsManager::Get(AppGroupHandle handle) {
+    return const_cast<AppGroup*>(static_cast<const AppGroupsManager*>(this)->Get(handle));
+}
+
+const AppGroup* AppGroupsManager::Get(AppGroupHandle handle) const {
+    if (handle.slot >= m_slots.size()) return nullptr;
+    
+    const Slot& slot = m_slots[handle.slot];
+    if (slot.generation != handle.generation || slot.dense == UINT32_MAX) return nullptr;
+    return &m_groups[slot.dense];
+}
+
+bool AppGroupsManager::CreateGroup(const std::string& name) {
+    Refresh();
+    if (!DoCreateGroup(name)) return false;
+    Publish();
+    AppendRecord({ "C", name });
+    return true;
+}
+
+bool AppGroupsManager::DeleteGroup(const std::string& name) {
+    Refresh();
+    if (!DoDeleteGroup(name)) return false;
+    Publish();
+    AppendRecord({ "D", name });
+    return true;
+}
+
+bool AppGroupsManager::RenameGroup(const std::string& name, const std::string& newName) {
+    Refresh();
+    if (!DoRenameGroup(name, newName)) return false;
+    Publish();
+    AppendRecord({ "N", name, newName });
+    return true;
 }
 
 bool AppGroupsManager::AddApp(const std::string& groupName, const std::string& appName,
                               const std::string& targetType, const std::string& targetValue,
                               bool recursive) {
-    AppGroup* group = FindGroup(groupName);
-    if (!group) return false;
+    Refresh();
     
     AppEntry entry;
     entry.name = appName;
     entry.targetType = targetType;
     entry.targetValue = targetValue;
     entry.recursive = recursive;
-    group->apps.push_back(entry);
+    if (!DoAddApp(groupName, entry)) return false;
+    
+    Publish();
+    AppendRecord({ "A", groupName, appName, targetType, targetValue, recursive ? "1" : "0" });
     return true;
 }
 
 bool AppGroupsManager::RemoveApp(const std::string& groupName, const std::string& appName) {
+    Refresh();
+    uint32_t group = FindDenseIndex(groupName);
+    if (group == UINT32_MAX) return false;
+    
+    // Any entry with the name will do; RemoveAppAt records its index for replay
+    auto it = m_appIndexes[group].find(appName);
+    if (it == m_appIndexes[group].end()) return false;
+    
+    return RemoveAppAt(groupName, it->second);
+}
+
+bool AppGroupsManager::RemoveAppAt(const std::string& groupName, size_t index) {
+    Refresh();
     AppGroup* group = FindGroup(groupName);
-    if (!group) return false;
+    if (!group || index >= group->apps.size()) return false;
+    
+    std::string appName = group->apps[index].name;
+    if (!DoRemoveApp(groupName, appName, index)) return false;
+    
+    Publish();
+    AppendRecord({ "R", groupName, appName, std::to_string(index) });
+    return true;
+}
+
+bool AppGroupsManager::DoCreateGroup(const std::string& name) {
+    if (m_nameIndex.count(name)) return false;
     
-    auto it = std::find_if(group->apps.begin(), group->apps.end(),
-        [&appName](const AppEntry& e) { return e.name == appName; });
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
     
-    if (it != group->apps.end()) {
-        group->apps.erase(it);
-        return true;
+    AppGroup group;
+    group.name = name;
+    m_slots[slot].dense = static_cast<uint32_t>(m_groups.size());
+    m_groups.push_back(std::move(group));
+    m_denseToSlot.push_back(slot);
+    m_appIndexes.emplace_back();
+    m_nameIndex.emplace(name, slot);
+    m_liveRecords++;
+    
+    if (!m_replaying) {
+        m_sharedGroups.push_back(std::make_shared<const AppGroup>(m_groups.back()));
+        m_namesChanged = true;
     }
-    return false;
+    return true;
+}
+
+bool AppGroupsManager::DoDeleteGroup(const std::string& name) {
+    auto it = m_nameIndex.find(name);
+    if (it == m_nameIndex.end()) return false;
+    
+    uint32_t slot = it->second;
+    uint32_t index = m_slots[slot].dense;
+    m_liveRecords -= 1 + m_groups[index].apps.size();
+    
+    // Leave a tombstone so the groups after it keep their order; the next
+    // Publish() or RebuildSharedGroups() compacts them all in one pass
+    m_groups[index] = AppGroup();
+    m_appIndexes[index].clear();
+    m_denseToSlot[index] = UINT32_MAX;
+    m_deadGroups++;
+    if (!m_replaying) {
+        m_sharedGroups[index].reset();
+        m_namesChanged = true;
+    }
+    
+    m_slots[slot].dense = UINT32_MAX;
+    m_slots[slot].generation++;
+    m_freeSlots.push_back(slot);
+    m_nameIndex.erase(it);
+    return true;
+}
+
+bool AppGroupsManager::DoRenameGroup(const std::string& name, const std::string& newName) {
+    if (name == newName || m_nameIndex.count(newName)) return false;
+    
+    auto it = m_nameIndex.find(name);
+    if (it == m_nameIndex.end()) return false;
+    
+    uint32_t slot = it->second;
+    m_nameIndex.erase(it);
+    m_nameIndex.emplace(newName, slot);
+    m_groups[m_slots[slot].dense].name = newName;
+    ShareGroup(m_slots[slot].dense);
+    m_namesChanged = true;
+    return true;
+}
+
+bool AppGroupsManager::DoAddApp(const std::string& groupName, AppEntry entry) {
+    uint32_t group = FindDenseIndex(groupName);
+    if (group == UINT32_MAX) return false;
+    
+    m_groups[group].apps.push_back(std::move(entry));
+    IndexApp(group, static_cast<uint32_t>(m_groups[group].apps.size()) - 1);
+    m_liveRecords++;
+    ShareGroup(group);
+    return true;
+}
+
+bool AppGroupsManager::DoRemoveApp(const std::string& groupName, const std::string& appName, size_t index) {
+    uint32_t group = FindDenseIndex(groupName);
+    if (group == UINT32_MAX) return false;
+    
+    auto& apps = m_groups[group].apps;
+    
+    // Prefer the recorded position so duplicate names replay to the same entry
+    if (index >= apps.size() || apps[index].name != appName) {
+        auto it = m_appIndexes[group].find(appName);
+        if (it == m_appIndexes[group].end()) return false;
+        index = it->second;
+    }
+    
+    // Erasing keeps the order; ShareGroup() copies the whole group anyway, so
+    // shifting the entries after it does not change the cost
+    uint32_t app = static_cast<uint32_t>(index);
+    UnindexApp(group, app);
+    apps.erase(apps.begin() + app);
+    for (auto& entry : m_appIndexes[group]) {
+        if (entry.second > app) entry.second--;
+    }
+    m_liveRecords--;
+    ShareGroup(group);
+    return true;
 }
 
 } // namespace NirUI
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
+#include <initializer_list>
 
 namespace NirUI {
 
@@ -18,28 +24,166 @@ struct AppGroup {
     std::vector<AppEntry> apps;
 };
 
+// Immutable view of all groups at one point in time. Groups that did not change
+// between versions are shared, not copied.
+struct AppGroupsSnapshot {
+    uint64_t version = 0;
+    std::vector<std::shared_ptr<const AppGroup>> groups;
+    std::shared_ptr<const std::unordered_map<std::string, size_t>> nameIndex;
+
+    const AppGroup* Find(const std::string& name) const;
+};
+
+using AppGroupsSnapshotPtr = std::shared_ptr<const AppGroupsSnapshot>;
+
+// Refers to a group independently of its position in GetGroups(). A handle stays
+// valid until the group is deleted; after that it never resolves again, even if
+// the storage slot is reused.
+struct AppGroupHandle {
+    uint32_t slot = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return slot != UINT32_MAX; }
+    bool operator==(const AppGroupHandle& other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const AppGroupHandle& other) const { return !(*this == other); }
+};
+
+// The manager itself is single-writer: only the owning thread may call the
+// mutating methods or touch GetGroups(). Every mutation publishes a new
+// snapshot, and other threads read through GetSnapshot(), which stays valid
+// for as long as the caller holds it. Reads are not lock-free: the snapshot
+// pointer sits behind a mutex held only to copy or swap it, so a read can wait
+// for another thread's pointer copy but never for the writer to build or free
+// a snapshot, which happens outside the lock.
+//
+// Groups and apps keep the order they were added in. Groups are stored in a
+// vector with a slot table for handles and hash indexes for group and app
+// names. Deleting a group leaves a tombstone that the next published snapshot
+// compacts away, so replaying many deletes costs one pass, not one per delete.
+//
+// Groups are persisted as an append-only journal in app_groups.txt. Every
+// mutation appends one line once a data path is set, and the journal is
+// rewritten as a snapshot when it grows well past the live data. The file
+// starts with a version header; fields are tab separated and escaped, so
+// names may contain any character.
+//
+// Refresh() picks up changes made by other processes: records appended to the
+// journal are replayed from the last known offset, and a replaced file is
+// re-read and merged by group name, so handles to surviving groups stay valid.
+// Mutators refresh first so they never append after records they have not seen.
 class AppGroupsManager {
 public:
+    static constexpr const char* JOURNAL_HEADER = "#nirui-app-groups 2";
+
     AppGroupsManager();
-    
+
     void SetDataPath(const std::filesystem::path& path);
     void Load();
+    // Rewrites the journal as a compact snapshot of the current groups
     void Save();
-    
+    // Brings the groups in line with app_groups.txt; returns true if anything changed
+    bool Refresh();
+
+    // Names and app lists should be changed through the methods below so the
+    // indexes and the journal stay in sync
     std::vector<AppGroup>& GetGroups() { return m_groups; }
     const std::vector<AppGroup>& GetGroups() const { return m_groups; }
-    
+
     AppGroup* FindGroup(const std::string& name);
+    const AppGroup* FindGroup(const std::string& name) const;
+    AppGroupHandle FindGroupHandle(const std::string& name) const;
+    AppGroupHandle GetHandle(size_t index) const;
+    AppGroup* Get(AppGroupHandle handle);
+    const AppGroup* Get(AppGroupHandle handle) const;
+
+    AppGroupsSnapshotPtr GetSnapshot() const { return m_snapshot.Load(); }
     bool CreateGroup(const std::string& name);
     bool DeleteGroup(const std::string& name);
-    bool AddApp(const std::string& groupName, const std::string& appName, 
+    bool RenameGroup(const std::string& name, const std::string& newName);
+    bool AddApp(const std::string& groupName, const std::string& appName,
                 const std::string& targetType, const std::string& targetValue,
                 bool recursive = false);
     bool RemoveApp(const std::string& groupName, const std::string& appName);
-    
+    bool RemoveAppAt(const std::string& groupName, size_t index);
+
 private:
+    std::filesystem::path GetJournalPath() const;
+    bool ApplyRecord(const std::vector<std::string>& fields);
+    size_t ReplayRecords(std::string_view text, size_t pos, size_t& applied);
+    bool MergeFrom(const AppGroupsManager& other);
+    void LoadLegacy(std::string_view text);
+    void AppendRecord(std::initializer_list<std::string_view> fields);
+    void RecountLiveRecords();
+
+    bool DoCreateGroup(const std::string& name);
+    bool DoDeleteGroup(const std::string& name);
+    bool DoRenameGroup(const std::string& name, const std::string& newName);
+    bool DoAddApp(const std::string& groupName, AppEntry entry);
+    bool DoRemoveApp(const std::string& groupName, const std::string& appName, size_t index);
+
+    uint32_t FindDenseIndex(const std::string& name) const;
+    void RebuildIndexes();
+    void IndexApp(uint32_t group, uint32_t app);
+    void UnindexApp(uint32_t group, uint32_t app);
+    void ShareGroup(uint32_t group);
+    void CompactGroups();
+    void RebuildSharedGroups();
+    void Publish();
+
+    struct Slot {
+        uint32_t dense = UINT32_MAX;
+        uint32_t generation = 1;
+    };
+
+    using AppIndex = std::unordered_multimap<std::string, uint32_t>;
+    using NameIndex = std::unordered_map<std::string, size_t>;
+
+    // A mutex is not movable, but the manager is moved after background loads.
+    // The lock only covers copying or swapping the pointer.
+    struct PublishedSnapshot {
+        mutable std::mutex mutex;
+        AppGroupsSnapshotPtr value;
+
+        PublishedSnapshot() = default;
+        PublishedSnapshot(PublishedSnapshot&& other) noexcept : value(other.Load()) {}
+        PublishedSnapshot& operator=(PublishedSnapshot&& other) noexcept {
+            Store(other.Load());
+            return *this;
+        }
+
+        AppGroupsSnapshotPtr Load() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return value;
+        }
+        void Store(AppGroupsSnapshotPtr snapshot) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                value.swap(snapshot);
+            }
+            // The old snapshot, if this was its last reference, is freed unlocked
+        }
+    };
+
     std::vector<AppGroup> m_groups;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<AppIndex> m_appIndexes;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    // Tombstones in m_groups, marked by UINT32_MAX in m_denseToSlot
+    size_t m_deadGroups = 0;
+    std::unordered_map<std::string, uint32_t> m_nameIndex;
     std::filesystem::path m_dataPath;
+    size_t m_journalRecords = 0;
+    size_t m_liveRecords = 0;
+    uint64_t m_journalFileId = 0;
+    uint64_t m_journalOffset = 0;
+
+    std::vector<std::shared_ptr<const AppGroup>> m_sharedGroups;
+    std::shared_ptr<const NameIndex> m_sharedNameIndex;
+    bool m_namesChanged = true;
+    bool m_replaying = false;
+    uint64_t m_version = 0;
+    PublishedSnapshot m_snapshot;
 };
 
 } // namespace NirUI
@@ -0,0 +1,219 @@
+#include "command_coalescer.h"
+#include "command_tokenizer.h"
+#include "nircmd_manager.h"
+#include "param_validator.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace NirUI {
+
+namespace {
+
+bool ParseInteger(std::string_view text, int64_t& value) {
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && end == text.data() + text.size();
+}
+
+bool ParseReal(std::string_view text, double& value) {
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && end == text.data() + text.size() && std::isfinite(value);
+}
+
+// Fixed notation without trailing zeros; nircmd does not read exponents
+std::string FormatReal(double value) {
+    if (std::fabs(value) < 1e-9) return "0";
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.6f", value);
+    std::string text = buffer;
+    text.erase(text.find_last_not_of('0') + 1);
+    if (text.back() == '.') text.pop_back();
+    return text;
+}
+
+bool IsNumber(const Parameter& param, std::string_view text) {
+    int64_t integer = 0;
+    double real = 0;
+    return param.type == ParamType::Integer ? ParseInteger(text, integer) : ParseReal(text, real);
+}
+
+bool ParseEntryCommand(std::string_view line, const Command*& command, std::vector<std::string>& args) {
+    CommandTokens tokens(line);
+    if (tokens.IsEmpty()) return false;
+    const CommandValidator* validator = ParamValidators::Find(tokens[0]);
+    if (!validator || validator->GetCommand().coalesce == CoalesceMode::None) return false;
+
+    command = &validator->GetCommand();
+    args.clear();
+    for (size_t i = 1; i < tokens.GetCount(); ++i) {
+        args.emplace_back(tokens[i]);
+    }
+
+    // Deltas must be present and numeric to be summed
+    if (command->coalesce == CoalesceMode::Sum) {
+        for (size_t i = 0; i < command->parameters.size(); ++i) {
+            const Parameter& param = command->parameters[i];
+            if (param.coalesced && (i >= args.size() || !IsNumber(param, args[i]))) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+CommandCoalescer::~CommandCoalescer() {
+    Stop();
+}
+
+bool CommandCoalescer::CanCoalesce(std::string_view command) {
+    const Command* parsed = nullptr;
+    std::vector<std::string> args;
+    return ParseEntryCommand(command, parsed, args);
+}
+
+bool CommandCoalescer::Push(std::string_view command) {
+    Entry entry;
+    if (!ParseEntryCommand(command, entry.command, entry.args)) return false;
+
+    // The target is the coalescing target plus every argument that is not
+    // merged, with defaults filled in so "changesysvolume 100" and
+    // "changesysvolume 100 master" agree
+    const auto& params = entry.command->parameters;
+    entry.target = entry.command->coalesceTarget;
+    for (size_t i = 0; i < std::max(params.size(), entry.args.size()); ++i) {
+        if (i < params.size() && params[i].coalesced) continue;
+        entry.target += '\x1f';
+        entry.target += i < entry.args.size() ? entry.args[i] : params[i].defaultValue;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.requested++;
+
+    if (entry.command->coalesce == CoalesceMode::Replace) {
+        std::erase_if(m_pending, [&](const Entry& pending) { return pending.target == entry.target; });
+        m_pending.push_back(std::move(entry));
+    } else {
+        auto last = std::find_if(m_pending.rbegin(), m_pending.rend(),
+                                 [&](const Entry& pending) { return pending.target == entry.target; });
+        if (last == m_pending.rend() || last->command != entry.command || !AddDeltas(*last, entry)) {
+            m_pending.push_back(std::move(entry));
+        }
+    }
+    m_changed.notify_all();
+    return true;
+}
+
+bool CommandCoalescer::AddDeltas(Entry& entry, const Entry& next) {
+    const auto& params = entry.command->parameters;
+    std::vector<std::string> sums = entry.args;
+    for (size_t i = 0; i < params.size(); ++i) {
+        const Parameter& param = params[i];
+        if (!param.coalesced) continue;
+
+        if (param.type == ParamType::Integer) {
+            int64_t a = 0;
+            int64_t b = 0;
+            if (!ParseInteger(entry.args[i], a) || !ParseInteger(next.args[i], b) || (a < 0) != (b < 0)) return false;
+            int64_t sum = b > 0 && a > std::numeric_limits<int64_t>::max() - b ? std::numeric_limits<int64_t>::max()
+                        : b < 0 && a < std::numeric_limits<int64_t>::min() - b ? std::numeric_limits<int64_t>::min()
+                        : a + b;
+            sums[i] = std::to_string(std::clamp(sum, param.minValue, param.maxValue));
+        } else {
+            double a = 0;
+            double b = 0;
+            if (!ParseReal(entry.args[i], a) || !ParseReal(next.args[i], b) || (a < 0) != (b < 0)) return false;
+            sums[i] = FormatReal(a + b);
+        }
+    }
+    entry.args = std::move(sums);
+    return true;
+}
+
+std::string CommandCoalescer::BuildCommand(const Entry& entry) {
+    std::string command = entry.command->name;
+    for (const auto& arg : entry.args) {
+        command += ' ';
+        NirCmdManager::AppendQuotedArgument(command, arg);
+    }
+    return command;
+}
+
+bool CommandCoalescer::IsInFlight(const std::string& target) const {
+    return std::find(m_inFlight.begin(), m_inFlight.end(), target) != m_inFlight.end();
+}
+
+bool CommandCoalescer::TakeNext(std::string& command, std::string& target) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_pending.begin(), m_pending.end(),
+                           [&](const Entry& pending) { return !IsInFlight(pending.target); });
+    if (it == m_pending.end()) return false;
+
+    command = BuildCommand(*it);
+    target = std::move(it->target);
+    m_pending.erase(it);
+    m_inFlight.push_back(target);
+    m_stats.issued++;
+    return true;
+}
+
+void CommandCoalescer::Finish(const std::string& target) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find(m_inFlight.begin(), m_inFlight.end(), target);
+    if (it != m_inFlight.end()) m_inFlight.erase(it);
+    m_changed.notify_all();
+}
+
+size_t CommandCoalescer::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+CommandCoalescer::Stats CommandCoalescer::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void CommandCoalescer::Start(Runner runner) {
+    if (m_thread.joinable()) return;
+    m_runner = std::move(runner);
+    m_stopping = false;
+    m_thread = std::thread([this]() { ThreadMain(); });
+}
+
+void CommandCoalescer::Stop() {
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+}
+
+void CommandCoalescer::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [&]() { return m_pending.empty() && m_inFlight.empty(); });
+}
+
+void CommandCoalescer::ThreadMain() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_changed.wait(lock, [&]() { return m_stopping || !m_pending.empty(); });
+            if (m_pending.empty()) return;
+        }
+
+        // Commands pushed while this one runs merge into the queue behind it
+        std::string command;
+        std::string target;
+        if (!TakeNext(command, target)) continue;
+        m_runner(command);
+        Finish(target);
+    }
+}
+
+} // namespace NirUI
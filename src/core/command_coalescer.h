@@ -0,0 +1,88 @@
+#pragma once
+
+#include "nircmd_commands.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace NirUI {
+
+// Queue for rapid-fire relative commands such as volume, brightness and cursor
+// steps. Registry commands marked with a coalescing mode merge while they wait:
+// deltas for the same target add up (clamped to the parameter range) and an
+// absolute setter drops everything queued before it for that target. Only one
+// command per target is handed out at a time, so a burst of key repeats turns
+// into one nircmd call per target while the previous one is still running.
+//
+// Deltas only merge while they point the same way. Steps in one direction
+// clamp at the end of a range the same way whether they run one by one or
+// summed; a step back after hitting the end would not.
+class CommandCoalescer {
+public:
+    using Runner = std::function<void(const std::string& command)>;
+
+    struct Stats {
+        uint64_t requested = 0;  // commands pushed
+        uint64_t issued = 0;     // merged commands handed out
+    };
+
+    CommandCoalescer() = default;
+    ~CommandCoalescer();
+
+    CommandCoalescer(const CommandCoalescer&) = delete;
+    CommandCoalescer& operator=(const CommandCoalescer&) = delete;
+
+    // True if the registry allows the command to merge with others
+    static bool CanCoalesce(std::string_view command);
+
+    // Queues the command; false (nothing queued) if it cannot coalesce and
+    // should run directly
+    bool Push(std::string_view command);
+    // Takes the oldest queued command whose target has nothing in flight. Pass
+    // the target to Finish() once the command has run.
+    bool TakeNext(std::string& command, std::string& target);
+    void Finish(const std::string& target);
+
+    size_t GetPendingCount() const;
+    Stats GetStats() const;
+
+    // Runs queued commands one at a time on a background thread until Stop(),
+    // which first runs whatever is still queued
+    void Start(Runner runner);
+    void Stop();
+    // Blocks until nothing is queued or running. Needs the background thread.
+    void Flush();
+
+private:
+    struct Entry {
+        const Command* command = nullptr;
+        std::string target;
+        std::vector<std::string> args;
+    };
+
+    // Adds the coalesced arguments of next into entry; false, leaving entry
+    // untouched, if a value is not a number or the two point different ways
+    static bool AddDeltas(Entry& entry, const Entry& next);
+    static std::string BuildCommand(const Entry& entry);
+    bool IsInFlight(const std::string& target) const;
+    void ThreadMain();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    // Few targets are ever queued at once, so lookups scan
+    std::deque<Entry> m_pending;
+    std::vector<std::string> m_inFlight;
+    Stats m_stats;
+
+    Runner m_runner;
+    std::thread m_thread;
+    bool m_stopping = false;
+};
+
+} // namespace NirUI
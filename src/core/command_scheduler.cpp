@@ -0,0 +1,362 @@
+#include "command_scheduler.h"
+#include "utils/duration.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+namespace NirUI {
+
+namespace {
+
+bool ToLocalTime(std::time_t time, std::tm& local) {
+#ifdef _WIN32
+    return localtime_s(&local, &time) == 0;
+#else
+    return localtime_r(&time, &local) != nullptr;
+#endif
+}
+
+bool ParseNumber(std::string_view text, int& value) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && ec == std::errc() && end == text.data() + text.size();
+}
+
+// One cron field into a bitmask of the values it allows. any is set for
+// "*" or "*/N", which matters for the day fields.
+bool ParseCronField(std::string_view field, int min, int max, uint64_t& bits, bool& any) {
+    bits = 0;
+    any = !field.empty() && field[0] == '*';
+    while (!field.empty()) {
+        size_t comma = field.find(',');
+        std::string_view item = field.substr(0, comma);
+        field = comma == std::string_view::npos ? std::string_view() : field.substr(comma + 1);
+
+        int step = 1;
+        size_t slash = item.find('/');
+        if (slash != std::string_view::npos) {
+            if (!ParseNumber(item.substr(slash + 1), step) || step < 1) return false;
+            item = item.substr(0, slash);
+        }
+
+        int first = min;
+        int last = max;
+        if (item != "*") {
+            size_t dash = item.find('-');
+            if (!ParseNumber(item.substr(0, dash), first)) return false;
+            last = first;
+            if (dash != std::string_view::npos && !ParseNumber(item.substr(dash + 1), last)) return false;
+            // "5/15" means from 5 to the end in steps of 15
+            if (dash == std::string_view::npos && slash != std::string_view::npos) last = max;
+        }
+        if (first < min || last > max || first > last) return false;
+
+        for (int value = first; value <= last; value += step) {
+            bits |= 1ull << value;
+        }
+    }
+    return bits != 0;
+}
+
+uint64_t SteadyNowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+int64_t WallNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool CronSpec::Parse(std::string_view text, std::string& error) {
+    std::string_view fields[5];
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t start = text.find_first_not_of(" \t", pos);
+        if (start == std::string_view::npos) break;
+        size_t end = std::min(text.find_first_of(" \t", start), text.size());
+        if (count == 5) {
+            error = "Cron expression has more than 5 fields";
+            return false;
+        }
+        fields[count++] = text.substr(start, end - start);
+        pos = end;
+    }
+    if (count != 5) {
+        error = "Cron expression needs 5 fields (minute hour day month weekday)";
+        return false;
+    }
+
+    static const char* const NAMES[] = { "minute", "hour", "day of month", "month", "day of week" };
+    static const int LIMITS[][2] = { { 0, 59 }, { 0, 23 }, { 1, 31 }, { 1, 12 }, { 0, 7 } };
+    uint64_t bits[5] = {};
+    bool any[5] = {};
+    for (size_t i = 0; i < 5; ++i) {
+        if (!ParseCronField(fields[i], LIMITS[i][0], LIMITS[i][1], bits[i], any[i])) {
+            error = "Invalid " + std::string(NAMES[i]) + " field '" + std::string(fields[i]) + "'";
+            return false;
+        }
+    }
+
+    minutes = bits[0];
+    hours = static_cast<uint32_t>(bits[1]);
+    daysOfMonth = static_cast<uint32_t>(bits[2]);
+    months = static_cast<uint16_t>(bits[3]);
+    daysOfWeek = static_cast<uint8_t>((bits[4] | (bits[4] >> 7)) & 0x7F);
+    anyDayOfMonth = any[2];
+    anyDayOfWeek = any[4];
+    return true;
+}
+
+std::time_t CronSpec::NextAfter(std::time_t time) const {
+    // Every date pattern recurs within 8 years, Feb 29 being the worst case
+    const std::time_t limit = time + std::time_t(9) * 366 * 24 * 3600;
+    std::time_t next = time - time % 60 + 60;
+    std::tm local = {};
+    while (next <= limit && ToLocalTime(next, local)) {
+        // Skip whole months, days and hours before trying single minutes
+        if (!((months >> (local.tm_mon + 1)) & 1)) {
+            local.tm_mon++;
+            local.tm_mday = 1;
+            local.tm_hour = local.tm_min = local.tm_sec = 0;
+            local.tm_isdst = -1;
+            next = std::mktime(&local);
+            continue;
+        }
+
+        bool domMatch = (daysOfMonth >> local.tm_mday) & 1;
+        bool dowMatch = (daysOfWeek >> local.tm_wday) & 1;
+        bool dayMatch = anyDayOfMonth || anyDayOfWeek ? domMatch && dowMatch : domMatch || dowMatch;
+        if (!dayMatch) {
+            local.tm_mday++;
+            local.tm_hour = local.tm_min = local.tm_sec = 0;
+            local.tm_isdst = -1;
+            next = std::mktime(&local);
+            continue;
+        }
+
+        if (!((hours >> local.tm_hour) & 1)) {
+            next += 3600 - local.tm_min * 60 - local.tm_sec;
+            continue;
+        }
+        if (!((minutes >> local.tm_min) & 1)) {
+            next += 60 - local.tm_sec;
+            continue;
+        }
+        return next;
+    }
+    return -1;
+}
+
+CommandScheduler::CommandScheduler(Runner runner, Clock clock, WallClock wallClock)
+    : m_runner(std::move(runner)),
+      m_clock(clock ? std::move(clock) : Clock(SteadyNowMs)),
+      m_wallClock(wallClock ? std::move(wallClock) : WallClock(WallNowMs)),
+      m_wheel(m_clock()) {
+}
+
+CommandScheduler::~CommandScheduler() {
+    Stop();
+}
+
+CommandScheduler::TaskId CommandScheduler::ScheduleOnce(uint64_t delayMs, std::string command) {
+    Task task;
+    task.kind = Kind::Once;
+    task.schedule = "in " + FormatDuration(delayMs);
+    task.command = std::move(command);
+    task.dueMs = m_clock() + delayMs;
+    return AddTask(std::move(task));
+}
+
+CommandScheduler::TaskId CommandScheduler::ScheduleEvery(uint64_t intervalMs, std::string command) {
+    Task task;
+    task.kind = Kind::Every;
+    task.schedule = "every " + FormatDuration(intervalMs);
+    task.command = std::move(command);
+    task.intervalMs = std::max<uint64_t>(intervalMs, 1);
+    task.dueMs = m_clock() + task.intervalMs;
+    return AddTask(std::move(task));
+}
+
+CommandScheduler::TaskId CommandScheduler::ScheduleCron(const CronSpec& spec, std::string_view specText,
+                                                        std::string command) {
+    Task task;
+    task.kind = Kind::Cron;
+    task.schedule = "cron " + std::string(specText);
+    task.command = std::move(command);
+    task.cron = spec;
+    if (!ScheduleNextCron(task, m_clock())) return 0;
+    return AddTask(std::move(task));
+}
+
+CommandScheduler::TaskId CommandScheduler::AddTask(Task task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TaskId id = m_nextId++;
+    task.timer = m_wheel.Add(task.dueMs, id);
+    m_tasks.emplace(id, std::move(task));
+    m_changed.notify_all();
+    return id;
+}
+
+bool CommandScheduler::ScheduleNextCron(Task& task, uint64_t nowMs) const {
+    int64_t wallMs = m_wallClock();
+    // Never the minute that just ran, even if the wall clock is a little behind
+    std::time_t after = std::max<std::time_t>(static_cast<std::time_t>(wallMs / 1000), task.cronTime);
+    std::time_t next = task.cron.NextAfter(after);
+    if (next < 0) return false;
+
+    task.cronTime = next;
+    int64_t untilMs = static_cast<int64_t>(next) * 1000 - wallMs;
+    task.dueMs = nowMs + static_cast<uint64_t>(std::max<int64_t>(untilMs, 0));
+    return true;
+}
+
+bool CommandScheduler::Cancel(TaskId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end()) return false;
+    m_wheel.Cancel(it->second.timer);
+    m_tasks.erase(it);
+    m_changed.notify_all();
+    return true;
+}
+
+size_t CommandScheduler::CancelAll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = m_tasks.size();
+    for (const auto& [id, task] : m_tasks) {
+        m_wheel.Cancel(task.timer);
+    }
+    m_tasks.clear();
+    m_changed.notify_all();
+    return count;
+}
+
+std::vector<CommandScheduler::TaskInfo> CommandScheduler::GetTasks() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t now = m_clock();
+    std::vector<TaskInfo> tasks;
+    tasks.reserve(m_tasks.size());
+    for (const auto& [id, task] : m_tasks) {
+        TaskInfo info;
+        info.id = id;
+        info.kind = task.kind;
+        info.schedule = task.schedule;
+        info.command = task.command;
+        info.dueInMs = task.dueMs > now ? task.dueMs - now : 0;
+        info.runs = task.runs;
+        info.averageLatenessMs = task.runs ? static_cast<double>(task.totalLatenessMs) / task.runs : 0;
+        info.maxLatenessMs = task.maxLatenessMs;
+        tasks.push_back(std::move(info));
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const TaskInfo& a, const TaskInfo& b) { return a.id < b.id; });
+    return tasks;
+}
+
+size_t CommandScheduler::GetTaskCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_tasks.size();
+}
+
+size_t CommandScheduler::RunDue() {
+    std::vector<std::string> commands;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t now = m_clock();
+        if (m_wheel.GetNextTick() > now) return 0;
+
+        std::vector<TimerWheel::Expired> expired;
+        m_wheel.Advance(now, expired);
+        for (const auto& timer : expired) {
+            TaskId id = static_cast<TaskId>(timer.payload);
+            auto it = m_tasks.find(id);
+            if (it == m_tasks.end()) continue;
+
+            Task& task = it->second;
+            uint64_t lateness = now - std::min(task.dueMs, now);
+            task.runs++;
+            task.totalLatenessMs += lateness;
+            task.maxLatenessMs = std::max(task.maxLatenessMs, lateness);
+            commands.push_back(task.command);
+
+            bool again = false;
+            if (task.kind == Kind::Every) {
+                task.dueMs += (lateness / task.intervalMs + 1) * task.intervalMs;
+                again = true;
+            } else if (task.kind == Kind::Cron) {
+                again = ScheduleNextCron(task, now);
+            }
+
+            if (again) {
+                task.timer = m_wheel.Add(task.dueMs, id);
+            } else {
+                m_tasks.erase(it);
+            }
+        }
+        m_running += commands.size();
+    }
+
+    for (const auto& command : commands) {
+        m_runner(command);
+    }
+
+    if (!commands.empty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running -= commands.size();
+        m_changed.notify_all();
+    }
+    return commands.size();
+}
+
+uint64_t CommandScheduler::GetWaitMsLocked() const {
+    uint64_t next = m_wheel.GetNextTick();
+    if (next == TimerWheel::NEVER) return UINT64_MAX;
+    uint64_t now = m_clock();
+    return next > now ? next - now : 0;
+}
+
+uint64_t CommandScheduler::GetWaitMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetWaitMsLocked();
+}
+
+void CommandScheduler::Start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_thread.joinable()) return;
+    m_stopping = false;
+    m_thread = std::thread(&CommandScheduler::ThreadMain, this);
+}
+
+void CommandScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_changed.notify_all();
+    }
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void CommandScheduler::WaitUntilIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this]() { return m_stopping || (m_tasks.empty() && m_running == 0); });
+}
+
+void CommandScheduler::ThreadMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        uint64_t waitMs = GetWaitMsLocked();
+        if (waitMs == UINT64_MAX) {
+            m_changed.wait(lock);
+        } else if (waitMs > 0) {
+            m_changed.wait_for(lock, std::chrono::milliseconds(waitMs));
+        } else {
+            lock.unlock();
+            RunDue();
+            lock.lock();
+        }
+    }
+}
+
+} // namespace NirUI
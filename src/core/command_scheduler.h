@@ -0,0 +1,135 @@
+#pragma once
+
+#include "utils/timer_wheel.h"
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NirUI {
+
+// Five-field cron expression: minute hour day-of-month month day-of-week. Each
+// field is *, N, A-B, */S, A-B/S or a comma list of those; day-of-week is 0-6
+// with 7 also meaning Sunday. As in cron, when both day fields are restricted
+// a day matching either one qualifies.
+struct CronSpec {
+    uint64_t minutes = 0;
+    uint32_t hours = 0;
+    uint32_t daysOfMonth = 0;
+    uint16_t months = 0;
+    uint8_t daysOfWeek = 0;
+    bool anyDayOfMonth = true;
+    bool anyDayOfWeek = true;
+
+    bool Parse(std::string_view text, std::string& error);
+    // First matching minute strictly after the given local time, or -1 if the
+    // expression never matches (e.g. "0 0 31 2 *")
+    std::time_t NextAfter(std::time_t time) const;
+};
+
+// Runs commands later: once after a delay, every interval, or on a cron
+// schedule. Due times live in a TimerWheel with 1 ms ticks, so hundreds of
+// timers cost nothing while idle. Periodic tasks are rescheduled from their
+// previous due time rather than from when they ran, so lateness never
+// accumulates; runs missed while the runner was busy are skipped, not queued.
+//
+// The runner is called without the scheduler lock held, either from RunDue()
+// on the caller's thread (the GUI calls it every frame) or from the background
+// thread started by Start().
+class CommandScheduler {
+public:
+    using TaskId = uint32_t;
+    using Runner = std::function<void(const std::string& command)>;
+    // Milliseconds on a monotonic clock, and since the epoch on the wall clock
+    // that cron expressions follow. Tests inject virtual clocks.
+    using Clock = std::function<uint64_t()>;
+    using WallClock = std::function<int64_t()>;
+
+    enum class Kind { Once, Every, Cron };
+
+    struct TaskInfo {
+        TaskId id = 0;
+        Kind kind = Kind::Once;
+        std::string schedule;   // "in 5m", "every 10s" or "cron */5 * * * *"
+        std::string command;
+        uint64_t dueInMs = 0;
+        uint64_t runs = 0;
+        // How long after its due time each run started
+        double averageLatenessMs = 0;
+        uint64_t maxLatenessMs = 0;
+    };
+
+    explicit CommandScheduler(Runner runner, Clock clock = {}, WallClock wallClock = {});
+    ~CommandScheduler();
+
+    CommandScheduler(const CommandScheduler&) = delete;
+    CommandScheduler& operator=(const CommandScheduler&) = delete;
+
+    TaskId ScheduleOnce(uint64_t delayMs, std::string command);
+    // The first run comes one interval from now
+    TaskId ScheduleEvery(uint64_t intervalMs, std::string command);
+    // Returns 0 if the expression never matches
+    TaskId ScheduleCron(const CronSpec& spec, std::string_view specText, std::string command);
+    bool Cancel(TaskId id);
+    size_t CancelAll();
+
+    std::vector<TaskInfo> GetTasks() const;
+    size_t GetTaskCount() const;
+
+    // Runs every task that is due; returns how many ran
+    size_t RunDue();
+    // Milliseconds until RunDue() has something to do; UINT64_MAX if no tasks
+    uint64_t GetWaitMs() const;
+
+    // Runs due tasks on a background thread until Stop()
+    void Start();
+    void Stop();
+    // Blocks until no tasks are left, which for periodic tasks is never.
+    // Needs the background thread.
+    void WaitUntilIdle();
+
+private:
+    struct Task {
+        Kind kind = Kind::Once;
+        std::string schedule;
+        std::string command;
+        uint64_t intervalMs = 0;
+        CronSpec cron;
+        uint64_t dueMs = 0;
+        // Wall-clock minute the pending cron run belongs to
+        std::time_t cronTime = 0;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER;
+        uint64_t runs = 0;
+        uint64_t totalLatenessMs = 0;
+        uint64_t maxLatenessMs = 0;
+    };
+
+    TaskId AddTask(Task task);
+    // Moves a cron task to its next match after both the wall clock and its
+    // last run; false if there is none
+    bool ScheduleNextCron(Task& task, uint64_t nowMs) const;
+    uint64_t GetWaitMsLocked() const;
+    void ThreadMain();
+
+    Runner m_runner;
+    Clock m_clock;
+    WallClock m_wallClock;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    TimerWheel m_wheel;
+    std::unordered_map<TaskId, Task> m_tasks;
+    TaskId m_nextId = 1;
+    size_t m_running = 0;
+
+    std::thread m_thread;
+    bool m_stopping = false;
+};
+
+} // namespace NirUI
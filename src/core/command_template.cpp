@@ -0,0 +1,246 @@
+#include "command_template.h"
+#include "nircmd_manager.h"
+#include <algorithm>
+#include <charconv>
+
+namespace NirUI {
+
+namespace {
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+bool IsIdentifier(std::string_view name) {
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9')) return false;
+    for (char c : name) {
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (!valid) return false;
+    }
+    return true;
+}
+
+// Escapes a value for the inside of a quoted run with the CommandLineToArgvW rules
+void AppendEscaped(std::string& out, std::string_view value, bool beforeQuote) {
+    size_t backslashes = 0;
+    for (char c : value) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        out.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        backslashes = 0;
+        out += c;
+    }
+    out.append(beforeQuote ? backslashes * 2 : backslashes, '\\');
+}
+
+} // namespace
+
+void CommandTemplate::AddLiteral(std::string_view text) {
+    if (m_ops.empty() || m_ops.back().kind != OpKind::Literal) {
+        Op op;
+        op.offset = static_cast<uint32_t>(m_literals.size());
+        m_ops.push_back(op);
+    }
+    m_literals += text;
+    m_ops.back().length += static_cast<uint32_t>(text.size());
+}
+
+bool CommandTemplate::Compile(std::string_view text, std::string& error) {
+    m_literals.clear();
+    m_ops.clear();
+    m_slots.clear();
+    m_requiredFields = 0;
+
+    bool inQuotes = false;
+    size_t backslashes = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if ((c == '{' || c == '}') && pos + 1 < text.size() && text[pos + 1] == c) {
+            AddLiteral(text.substr(pos, 1));
+            pos += 2;
+            backslashes = 0;
+            continue;
+        }
+
+        if (c != '{') {
+            if (c == '\\') {
+                backslashes++;
+            } else {
+                if (c == '"' && backslashes % 2 == 0) inQuotes = !inQuotes;
+                backslashes = 0;
+            }
+            AddLiteral(text.substr(pos, 1));
+            pos++;
+            continue;
+        }
+
+        size_t close = text.find('}', pos + 1);
+        if (close == std::string_view::npos) {
+            error = "Unterminated placeholder at column " + std::to_string(pos + 1);
+            return false;
+        }
+
+        std::string_view name = text.substr(pos + 1, close - pos - 1);
+        Slot slot;
+        if (IsIdentifier(name)) {
+            slot.name = std::string(name);
+        } else {
+            auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), slot.column);
+            if (name.empty() || ec != std::errc() || end != name.data() + name.size()) {
+                error = "Invalid placeholder {" + std::string(name) + "}";
+                return false;
+            }
+            m_requiredFields = std::max(m_requiredFields, slot.column + 1);
+        }
+
+        auto existing = std::find_if(m_slots.begin(), m_slots.end(), [&](const Slot& other) {
+            return other.name == slot.name && (!slot.name.empty() || other.column == slot.column);
+        });
+        Op op;
+        op.slot = static_cast<uint32_t>(existing - m_slots.begin());
+        if (existing == m_slots.end()) m_slots.push_back(std::move(slot));
+
+        bool afterEnd = close + 1 == text.size();
+        if (inQuotes) {
+            op.kind = OpKind::QuotedEmbedded;
+            op.beforeQuote = !afterEnd && text[close + 1] == '"';
+        } else if ((pos == 0 || IsSpace(text[pos - 1])) && (afterEnd || IsSpace(text[close + 1]))) {
+            op.kind = OpKind::Argument;
+        } else {
+            op.kind = OpKind::Embedded;
+        }
+        m_ops.push_back(op);
+
+        pos = close + 1;
+        backslashes = 0;
+    }
+    return true;
+}
+
+bool CommandTemplate::Bind(const std::vector<std::string_view>& header, std::string& error) {
+    for (auto& slot : m_slots) {
+        if (slot.name.empty()) continue;
+        auto it = std::find(header.begin(), header.end(), slot.name);
+        if (it == header.end()) {
+            error = "No column named '" + slot.name + "' in the header";
+            return false;
+        }
+        slot.column = static_cast<size_t>(it - header.begin());
+        m_requiredFields = std::max(m_requiredFields, slot.column + 1);
+    }
+    return true;
+}
+
+bool CommandTemplate::HasNamedPlaceholders() const {
+    return std::any_of(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return !slot.name.empty(); });
+}
+
+void CommandTemplate::Expand(const std::string_view* fields, size_t count, std::string& out) const {
+    for (const auto& op : m_ops) {
+        if (op.kind == OpKind::Literal) {
+            out.append(m_literals, op.offset, op.length);
+            continue;
+        }
+
+        size_t column = m_slots[op.slot].column;
+        std::string_view value = column < count ? fields[column] : std::string_view();
+        switch (op.kind) {
+        case OpKind::Argument:
+            NirCmdManager::AppendEscapedArgument(out, value);
+            break;
+        case OpKind::Embedded:
+            if (!value.empty() && value.find_first_of(" \t\"") == std::string_view::npos) {
+                out += value;
+            } else {
+                out += '"';
+                AppendEscaped(out, value, true);
+                out += '"';
+            }
+            break;
+        default:
+            AppendEscaped(out, value, op.beforeQuote);
+            break;
+        }
+    }
+}
+
+CsvReader::CsvReader(std::string_view text) : m_text(text) {
+    if (m_text.substr(0, 3) == "\xEF\xBB\xBF") m_pos = 3;
+}
+
+bool CsvReader::Next(std::vector<std::string_view>& fields) {
+    fields.clear();
+    m_unescaped.clear();
+    m_unescapedFields.clear();
+
+    while (m_pos < m_text.size() && (m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+        if (m_text[m_pos] == '\n') m_line++;
+        m_pos++;
+    }
+    if (m_pos >= m_text.size()) return false;
+    m_rowLine = m_line;
+
+    while (true) {
+        size_t end;
+        if (m_text[m_pos] == '"') {
+            // Quoted field; "" is a literal quote and line breaks are kept
+            size_t start = m_pos + 1;
+            size_t close = start;
+            bool doubled = false;
+            while (true) {
+                close = m_text.find('"', close);
+                if (close == std::string_view::npos || close + 1 >= m_text.size() || m_text[close + 1] != '"') break;
+                doubled = true;
+                close += 2;
+            }
+            if (close == std::string_view::npos) close = m_text.size();
+            m_line += std::count(m_text.begin() + start, m_text.begin() + close, '\n');
+
+            std::string_view raw = m_text.substr(start, close - start);
+            if (doubled) {
+                UnescapedField field{ fields.size(), m_unescaped.size(), 0 };
+                for (size_t i = 0; i < raw.size(); ++i) {
+                    m_unescaped += raw[i];
+                    if (raw[i] == '"') i++;
+                }
+                field.length = m_unescaped.size() - field.offset;
+                m_unescapedFields.push_back(field);
+                fields.emplace_back();
+            } else {
+                fields.push_back(raw);
+            }
+
+            // Anything between the closing quote and the separator is dropped
+            end = m_text.find_first_of(",\n", std::min(close + 1, m_text.size()));
+        } else {
+            end = m_text.find_first_of(",\n", m_pos);
+            std::string_view raw = m_text.substr(m_pos, end == std::string_view::npos ? std::string_view::npos : end - m_pos);
+            if (!raw.empty() && raw.back() == '\r') raw.remove_suffix(1);
+            fields.push_back(raw);
+        }
+
+        if (end == std::string_view::npos) {
+            m_pos = m_text.size();
+            break;
+        }
+        m_pos = end + 1;
+        if (m_text[end] == '\n') {
+            m_line++;
+            break;
+        }
+        if (m_pos >= m_text.size()) {
+            fields.emplace_back();
+            break;
+        }
+    }
+
+    for (const auto& field : m_unescapedFields) {
+        fields[field.index] = std::string_view(m_unescaped).substr(field.offset, field.length);
+    }
+    return true;
+}
+
+} // namespace NirUI
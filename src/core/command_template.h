@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+// A command line with placeholders, such as "setappvolume {proc} {level}" or
+// "win close title {0}", compiled once into literal and slot operations.
+// {name} takes a column by header name and {N} the Nth column; "{{" and "}}"
+// are literal braces. A placeholder that is a whole word becomes one argument
+// escaped by NirCmdManager::AppendEscapedArgument, so quotes in row data can
+// never split it into extra arguments. One inside a word or a quoted string is
+// escaped the same way; every value parses back unchanged.
+class CommandTemplate {
+public:
+    bool Compile(std::string_view text, std::string& error);
+    // Resolves named placeholders against a header row
+    bool Bind(const std::vector<std::string_view>& header, std::string& error);
+
+    bool HasNamedPlaceholders() const;
+    // Columns a row needs; valid after Bind() when names are used
+    size_t GetRequiredFields() const { return m_requiredFields; }
+
+    // Appends the expansion for one row. Missing fields expand as empty values.
+    void Expand(const std::string_view* fields, size_t count, std::string& out) const;
+
+private:
+    enum class OpKind : uint8_t {
+        Literal,
+        Argument,       // a whole word
+        Embedded,       // part of an unquoted word
+        QuotedEmbedded  // inside a quoted string
+    };
+
+    struct Op {
+        OpKind kind = OpKind::Literal;
+        // Literal: range of m_literals. Otherwise the slot.
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        uint32_t slot = 0;
+        // QuotedEmbedded: the string closes right after the value, so trailing
+        // backslashes must be doubled
+        bool beforeQuote = false;
+    };
+
+    struct Slot {
+        std::string name;   // empty for positional placeholders
+        size_t column = 0;
+    };
+
+    void AddLiteral(std::string_view text);
+
+    std::string m_literals;
+    std::vector<Op> m_ops;
+    std::vector<Slot> m_slots;
+    size_t m_requiredFields = 0;
+};
+
+// Comma-separated rows with RFC 4180 quoting. Fields are views into the input
+// unless they contain doubled quotes, in which case they point into a buffer
+// that stays valid until the next call to Next().
+class CsvReader {
+public:
+    explicit CsvReader(std::string_view text);
+
+    // Reads the next non-empty row; returns false at the end of the input
+    bool Next(std::vector<std::string_view>& fields);
+    // 1-based line on which the last row returned by Next() started
+    size_t GetLineNumber() const { return m_rowLine; }
+
+private:
+    struct UnescapedField {
+        size_t index = 0;
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+    size_t m_line = 1;
+    size_t m_rowLine = 0;
+    std::string m_unescaped;
+    std::vector<UnescapedField> m_unescapedFields;
+};
+
+} // namespace NirUI
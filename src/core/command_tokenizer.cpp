@@ -0,0 +1,98 @@
+#include "command_tokenizer.h"
+
+namespace NirUI {
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+CommandTokens::CommandTokens(std::string_view line) {
+    size_t pos = 0;
+    while (true) {
+        while (pos < line.size() && IsSpace(line[pos])) pos++;
+        if (pos >= line.size()) break;
+
+        // Fast paths: a plain word, or one pair of quotes around text without
+        // quotes or a trailing backslash
+        if (line[pos] != '"') {
+            size_t end = pos;
+            while (end < line.size() && !IsSpace(line[end]) && line[end] != '"') end++;
+            if (end == line.size() || IsSpace(line[end])) {
+                Push(line.substr(pos, end - pos));
+                pos = end;
+                continue;
+            }
+        } else {
+            size_t close = line.find('"', pos + 1);
+            if (close != std::string_view::npos && (close == pos + 1 || line[close - 1] != '\\') &&
+                (close + 1 == line.size() || IsSpace(line[close + 1]))) {
+                Push(line.substr(pos + 1, close - pos - 1));
+                pos = close + 1;
+                continue;
+            }
+        }
+
+        pos = DecodeToken(line, pos);
+    }
+}
+
+std::string_view CommandTokens::operator[](size_t index) const {
+    if (index >= m_count) return std::string_view();
+    return index < INLINE_TOKENS ? m_inline[index] : m_overflow[index - INLINE_TOKENS];
+}
+
+void CommandTokens::Push(std::string_view token) {
+    if (m_count < INLINE_TOKENS) {
+        m_inline[m_count] = token;
+    } else {
+        m_overflow.push_back(token);
+    }
+    m_count++;
+}
+
+size_t CommandTokens::DecodeToken(std::string_view line, size_t pos) {
+    // Decoded text is never longer than the raw line, so reserving it once keeps
+    // earlier views valid
+    if (m_decoded.capacity() < line.size()) m_decoded.reserve(line.size());
+    size_t start = m_decoded.size();
+
+    bool inQuotes = false;
+    while (pos < line.size()) {
+        char c = line[pos];
+        if (c == '\\') {
+            size_t backslashes = 0;
+            while (pos < line.size() && line[pos] == '\\') {
+                backslashes++;
+                pos++;
+            }
+            if (pos < line.size() && line[pos] == '"') {
+                m_decoded.append(backslashes / 2, '\\');
+                if (backslashes % 2 == 1) {
+                    m_decoded += '"';
+                    pos++;
+                }
+            } else {
+                m_decoded.append(backslashes, '\\');
+            }
+            continue;
+        }
+        if (c == '"') {
+            if (inQuotes && pos + 1 < line.size() && line[pos + 1] == '"') {
+                m_decoded += '"';
+                pos += 2;
+            } else {
+                inQuotes = !inQuotes;
+                pos++;
+            }
+            continue;
+        }
+        if (IsSpace(c) && !inQuotes) break;
+        m_decoded += c;
+        pos++;
+    }
+
+    Push(std::string_view(m_decoded).substr(start));
+    return pos;
+}
+
+} // namespace NirUI
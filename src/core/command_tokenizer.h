@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+// Splits a command line into arguments with the CommandLineToArgvW rules:
+// whitespace separates arguments outside double quotes, 2n backslashes before a
+// quote become n and toggle quoting, 2n+1 become n and a literal quote, "" in a
+// quoted run is a literal quote, and other backslashes are literal.
+//
+// Tokens are views. Plain words and words wrapped in one pair of quotes point
+// into the line itself, so the common case does not allocate; only tokens that
+// need unescaping are decoded into an internal buffer. The line must outlive
+// the tokens, and the object cannot be copied or moved because views may point
+// into its own buffer.
+class CommandTokens {
+public:
+    static constexpr size_t INLINE_TOKENS = 16;
+
+    explicit CommandTokens(std::string_view line);
+
+    CommandTokens(const CommandTokens&) = delete;
+    CommandTokens& operator=(const CommandTokens&) = delete;
+
+    size_t GetCount() const { return m_count; }
+    bool IsEmpty() const { return m_count == 0; }
+    // Empty past the last token
+    std::string_view operator[](size_t index) const;
+
+private:
+    void Push(std::string_view token);
+    size_t DecodeToken(std::string_view line, size_t pos);
+
+    std::array<std::string_view, INLINE_TOKENS> m_inline;
+    std::vector<std::string_view> m_overflow;
+    std::string m_decoded;
+    size_t m_count = 0;
+};
+
+} // namespace NirUI
@@ -0,0 +1,185 @@
+#include "cost_model.h"
+#include "settings_store.h"
+#include "utils/duration.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace NirUI {
+
+void CostModel::Entry::Add(double ms) {
+    averageMs = samples == 0 ? ms : averageMs + AVERAGE_WEIGHT * (ms - averageMs);
+    samples++;
+
+    if (sketchTotal >= DECAY_SAMPLES) {
+        sketchTotal = 0;
+        for (auto& count : sketch) {
+            count /= 2;
+            sketchTotal += count;
+        }
+    }
+    size_t bucket = 0;
+    if (ms > MIN_MS) {
+        bucket = std::min(BUCKETS - 1, static_cast<size_t>(std::ceil(std::log(ms / MIN_MS) / std::log(GAMMA))));
+    }
+    sketch[bucket]++;
+    sketchTotal++;
+}
+
+double CostModel::Entry::GetQuantileMs(double q) const {
+    if (sketchTotal == 0) return averageMs;
+    uint32_t rank = static_cast<uint32_t>(std::ceil(q * sketchTotal));
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += sketch[i];
+        if (seen >= std::max(rank, 1u)) {
+            // Between the bucket bounds, within (GAMMA - 1) / (GAMMA + 1) of any value in it
+            return i == 0 ? MIN_MS : MIN_MS * std::pow(GAMMA, static_cast<double>(i)) * 2.0 / (1.0 + GAMMA);
+        }
+    }
+    return averageMs;
+}
+
+std::string CostModel::MakeKey(CostBackend backend, std::string_view name) {
+    std::string key = backend == CostBackend::NirCmd ? "n:" : "b:";
+    key += name;
+    return key;
+}
+
+double CostModel::GetDefaultMs(CostBackend backend) {
+    // Roughly a nircmd process start, and a NirUI command with no work to do
+    return backend == CostBackend::NirCmd ? 50.0 : 1.0;
+}
+
+void CostModel::Record(CostBackend backend, std::string_view name, double ms) {
+    if (name.empty() || !(ms >= 0)) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[MakeKey(backend, name)].Add(ms);
+    m_entries[MakeKey(backend, std::string_view())].Add(ms);
+}
+
+double CostModel::EstimateMs(CostBackend backend, std::string_view name) const {
+    std::string key = MakeKey(backend, name);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) it = m_entries.find(MakeKey(backend, std::string_view()));
+    return it != m_entries.end() ? it->second.averageMs : GetDefaultMs(backend);
+}
+
+bool CostModel::GetEstimate(CostBackend backend, std::string_view name, CostEstimate& estimate) const {
+    std::string key = MakeKey(backend, name);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return false;
+
+    const Entry& entry = it->second;
+    estimate.averageMs = entry.averageMs;
+    estimate.p50Ms = entry.GetQuantileMs(0.50);
+    estimate.p90Ms = entry.GetQuantileMs(0.90);
+    estimate.p99Ms = entry.GetQuantileMs(0.99);
+    estimate.samples = entry.samples;
+    return true;
+}
+
+size_t CostModel::GetCommandCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Less the two backend-wide entries
+    size_t count = 0;
+    for (const auto& [key, entry] : m_entries) {
+        if (key.size() > 2) count++;
+    }
+    return count;
+}
+
+void CostModel::Load(const SettingsStore& store) {
+    auto rows = store.GetRows(SECTION);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& row : rows) {
+        if (row.size() < 5 || (row[0] != "nircmd" && row[0] != "builtin")) continue;
+
+        CostBackend backend = row[0] == "nircmd" ? CostBackend::NirCmd : CostBackend::Builtin;
+        auto [it, inserted] = m_entries.try_emplace(MakeKey(backend, row[1]));
+        if (!inserted) continue;
+
+        Entry& entry = it->second;
+        entry.averageMs = std::strtod(row[2].c_str(), nullptr);
+        entry.samples = std::strtoull(row[3].c_str(), nullptr, 10);
+
+        // Sketch: "bucket:count" pairs separated by spaces
+        const char* pos = row[4].c_str();
+        while (*pos) {
+            char* end = nullptr;
+            unsigned long bucket = std::strtoul(pos, &end, 10);
+            if (*end != ':') break;
+            unsigned long count = std::strtoul(end + 1, &end, 10);
+            if (bucket < BUCKETS) {
+                entry.sketch[bucket] = static_cast<uint16_t>(std::min<unsigned long>(count, DECAY_SAMPLES));
+            }
+            pos = end;
+            while (*pos == ' ') pos++;
+        }
+        entry.sketchTotal = 0;
+        for (auto count : entry.sketch) entry.sketchTotal += count;
+    }
+}
+
+void CostModel::Save(SettingsStore& store) const {
+    std::vector<std::vector<std::string>> rows;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        rows.reserve(m_entries.size());
+        for (const auto& [key, entry] : m_entries) {
+            char average[32];
+            snprintf(average, sizeof(average), "%.17g", entry.averageMs);
+
+            std::string sketch;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                if (entry.sketch[i] == 0) continue;
+                if (!sketch.empty()) sketch += ' ';
+                sketch += std::to_string(i) + ":" + std::to_string(entry.sketch[i]);
+            }
+            rows.push_back({ key[0] == 'n' ? "nircmd" : "builtin", key.substr(2), average,
+                             std::to_string(entry.samples), std::move(sketch) });
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    store.SetRows(SECTION, SectionType::Table, std::move(rows));
+}
+
+std::string FormatEstimate(double ms) {
+    uint64_t rounded = ms < 1000 ? static_cast<uint64_t>(ms / 100 + 0.5) * 100
+                                 : static_cast<uint64_t>(ms / 1000 + 0.5) * 1000;
+    return FormatDuration(rounded);
+}
+
+void ProgressTracker::Add(double estimatedMs) {
+    m_total++;
+    m_totalMs += estimatedMs;
+}
+
+void ProgressTracker::Complete(double estimatedMs) {
+    m_done++;
+    m_doneMs += estimatedMs;
+}
+
+void ProgressTracker::Reset() {
+    *this = ProgressTracker();
+}
+
+double ProgressTracker::GetFraction() const {
+    if (m_totalMs > 0) return std::min(m_doneMs / m_totalMs, 1.0);
+    return m_total == 0 ? 1.0 : static_cast<double>(m_done) / m_total;
+}
+
+double ProgressTracker::GetRemainingMs(double elapsedMs, size_t parallelism) const {
+    double remainingMs = std::max(m_totalMs - m_doneMs, 0.0);
+    if (m_doneMs <= 0) return remainingMs / std::max<size_t>(parallelism, 1);
+    return remainingMs * elapsedMs / m_doneMs;
+}
+
+} // namespace NirUI
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace NirUI {
+
+class SettingsStore;
+
+// What ran a command: a nircmd process or NirUI itself (group, schedule and
+// freeze commands)
+enum class CostBackend : uint8_t {
+    NirCmd,
+    Builtin
+};
+
+struct CostEstimate {
+    double averageMs = 0;   // exponentially weighted, so recent runs count most
+    double p50Ms = 0;
+    double p90Ms = 0;
+    double p99Ms = 0;
+    uint64_t samples = 0;
+};
+
+// Running cost of each command, keyed by backend and the command name callers
+// pass in ("win close" for two-word commands, see
+// ParamValidators::GetCommandName). Every run updates an exponentially weighted average
+// and a log-bucketed quantile sketch whose counts halve every thousand or so
+// samples, so both follow a command that gets slower or faster. Commands never
+// seen fall back to the average of their backend. Safe to use from any thread.
+class CostModel {
+public:
+    static constexpr const char* SECTION = "command_costs";
+
+    void Record(CostBackend backend, std::string_view name, double ms);
+
+    double EstimateMs(CostBackend backend, std::string_view name) const;
+    // False if the command has never run
+    bool GetEstimate(CostBackend backend, std::string_view name, CostEstimate& estimate) const;
+    size_t GetCommandCount() const;
+
+    // Rows of { backend, command, average, samples, sketch }. Loading keeps
+    // whatever was recorded before it, so it can finish after the first runs.
+    void Load(const SettingsStore& store);
+    void Save(SettingsStore& store) const;
+
+private:
+    // Bucket i holds times up to MIN_MS * GAMMA^i, about 5% apart, from 50 us
+    // to an hour
+    static constexpr size_t BUCKETS = 192;
+    static constexpr double MIN_MS = 0.05;
+    static constexpr double GAMMA = 1.1;
+    static constexpr uint32_t DECAY_SAMPLES = 1024;
+    static constexpr double AVERAGE_WEIGHT = 0.2;
+
+    struct Entry {
+        double averageMs = 0;
+        uint64_t samples = 0;
+        uint32_t sketchTotal = 0;
+        std::array<uint16_t, BUCKETS> sketch{};
+
+        void Add(double ms);
+        double GetQuantileMs(double q) const;
+    };
+
+    // "n:" or "b:" followed by the command name; the name is empty for the
+    // backend-wide entry
+    static std::string MakeKey(CostBackend backend, std::string_view name);
+    static double GetDefaultMs(CostBackend backend);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+};
+
+// Estimate for display: tenths of a second below one second, whole seconds above
+std::string FormatEstimate(double ms);
+
+// Progress through a batch of commands, weighted by their estimated cost.
+// Not thread-safe; the thread collecting results owns it.
+class ProgressTracker {
+public:
+    void Add(double estimatedMs);
+    void Complete(double estimatedMs);
+    void Reset();
+
+    size_t GetTotal() const { return m_total; }
+    size_t GetDone() const { return m_done; }
+    bool IsActive() const { return m_done < m_total; }
+    double GetFraction() const;
+    // Time left. Before anything finishes this is the estimate spread over
+    // the workers; after that, the estimates are scaled by how long the
+    // finished part really took.
+    double GetRemainingMs(double elapsedMs, size_t parallelism) const;
+
+private:
+    size_t m_total = 0;
+    size_t m_done = 0;
+    double m_totalMs = 0;
+    double m_doneMs = 0;
+};
+
+} // namespace NirUI
@@ -0,0 +1,458 @@
+#include "history_store.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string_view>
+
+namespace NirUI {
+
+static const char DATA_MAGIC[8] = { 'N', 'I', 'R', 'H', 'I', 'S', 'T', 'D' };
+static const char INDEX_MAGIC[8] = { 'N', 'I', 'R', 'H', 'I', 'S', 'T', 'I' };
+static constexpr uint64_t HEADER_SIZE = sizeof(DATA_MAGIC) + sizeof(uint32_t);
+
+// Anything larger is treated as corruption rather than a record
+static constexpr uint32_t MAX_RECORD_SIZE = 16 * 1024 * 1024;
+
+// Search reads the archive this many records at a time
+static constexpr size_t SEARCH_BLOCK = 4096;
+
+#pragma pack(push, 1)
+struct IndexEntry {
+    int64_t unixTime;
+    uint64_t offset;
+};
+#pragma pack(pop)
+
+namespace {
+
+template <typename T>
+void AppendValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string& out, std::string_view value) {
+    AppendValue(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+std::string MakeHeader(const char (&magic)[8]) {
+    std::string header(magic, sizeof(magic));
+    AppendValue(header, HistoryStore::VERSION);
+    return header;
+}
+
+bool HasHeader(const std::filesystem::path& path, const char (&magic)[8]) {
+    std::ifstream file(path, std::ios::binary);
+    char header[HEADER_SIZE];
+    if (!file.read(header, sizeof(header))) return false;
+    return std::string_view(header, sizeof(header)) == MakeHeader(magic);
+}
+
+bool WriteHeader(const std::filesystem::path& path, const char (&magic)[8]) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    std::string header = MakeHeader(magic);
+    return static_cast<bool>(file.write(header.data(), static_cast<std::streamsize>(header.size())));
+}
+
+struct RecordView {
+    int64_t unixTime = 0;
+    double executionTime = 0.0;
+    bool success = false;
+    std::string_view command;
+    std::string_view timestamp;
+    std::string_view output;
+};
+
+class PayloadReader {
+public:
+    explicit PayloadReader(std::string_view data) : m_data(data) {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (m_data.size() - m_pos < sizeof(T)) return false;
+        memcpy(&value, m_data.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string_view& value) {
+        uint32_t length = 0;
+        if (!Read(length) || m_data.size() - m_pos < length) return false;
+        value = m_data.substr(m_pos, length);
+        m_pos += length;
+        return true;
+    }
+
+private:
+    std::string_view m_data;
+    size_t m_pos = 0;
+};
+
+bool DecodeRecord(std::string_view payload, RecordView& record) {
+    PayloadReader reader(payload);
+    uint8_t success = 0;
+    if (!reader.Read(record.unixTime) || !reader.Read(record.executionTime) || !reader.Read(success)) return false;
+    record.success = success != 0;
+    return reader.ReadString(record.command) && reader.ReadString(record.timestamp) && reader.ReadString(record.output);
+}
+
+HistoryEntry ToEntry(uint64_t index, const RecordView& record) {
+    HistoryEntry entry;
+    entry.command = std::string(record.command);
+    entry.index = index;
+    entry.outputSize = static_cast<uint32_t>(record.output.size());
+    entry.success = record.success;
+    entry.executionTime = record.executionTime;
+    entry.timestamp = std::string(record.timestamp);
+    entry.unixTime = record.unixTime;
+    return entry;
+}
+
+// Read-only access to the archive through its own file handles
+class ArchiveReader {
+public:
+    explicit ArchiveReader(const std::filesystem::path& directory)
+        : m_data(directory / "history.dat", std::ios::binary),
+          m_index(directory / "history.idx", std::ios::binary) {}
+
+    bool IsOpen() const { return m_data.is_open() && m_index.is_open(); }
+
+    bool ReadIndex(uint64_t first, size_t count, std::vector<IndexEntry>& entries) {
+        entries.resize(count);
+        m_index.clear();
+        m_index.seekg(static_cast<std::streamoff>(HEADER_SIZE + first * sizeof(IndexEntry)));
+        return static_cast<bool>(m_index.read(reinterpret_cast<char*>(entries.data()),
+                                              static_cast<std::streamsize>(count * sizeof(IndexEntry))));
+    }
+
+    // Reads records [first, first + count) with two reads of the data file and
+    // calls visitor(index, record) for each
+    template <typename Visitor>
+    bool ReadRecords(uint64_t first, size_t count, Visitor&& visitor) {
+        if (count == 0) return true;
+        if (!ReadIndex(first, count, m_entries)) return false;
+
+        uint32_t lastLength = 0;
+        m_data.clear();
+        m_data.seekg(static_cast<std::streamoff>(m_entries.back().offset));
+        if (!m_data.read(reinterpret_cast<char*>(&lastLength), sizeof(lastLength))) return false;
+
+        uint64_t start = m_entries.front().offset;
+        uint64_t end = m_entries.back().offset + sizeof(uint32_t) + lastLength;
+        if (end < start) return false;
+
+        m_buffer.resize(static_cast<size_t>(end - start));
+        m_data.seekg(static_cast<std::streamoff>(start));
+        if (!m_data.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()))) return false;
+
+        std::string_view span(m_buffer);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t pos = m_entries[i].offset - start;
+            uint32_t length = 0;
+            if (m_entries[i].offset < start || pos + sizeof(length) > span.size()) return false;
+            memcpy(&length, span.data() + pos, sizeof(length));
+            if (span.size() - pos - sizeof(length) < length) return false;
+
+            RecordView record;
+            if (!DecodeRecord(span.substr(static_cast<size_t>(pos + sizeof(length)), length), record)) return false;
+            visitor(first + i, record);
+        }
+        return true;
+    }
+
+    uint64_t LowerBound(uint64_t count, int64_t unixTime) {
+        uint64_t low = 0;
+        uint64_t high = count;
+        std::vector<IndexEntry> entry;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            if (!ReadIndex(mid, 1, entry)) return count;
+            if (entry[0].unixTime < unixTime) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+private:
+    std::ifstream m_data;
+    std::ifstream m_index;
+    std::vector<IndexEntry> m_entries;
+    std::string m_buffer;
+};
+
+bool ContainsNoCase(std::string_view haystack, std::string_view lowerNeedle) {
+    if (lowerNeedle.empty()) return true;
+    auto it = std::search(haystack.begin(), haystack.end(), lowerNeedle.begin(), lowerNeedle.end(),
+                          [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+    return it != haystack.end();
+}
+
+} // namespace
+
+HistoryStore::HistoryStore(size_t recentCapacity) : m_recent(recentCapacity) {}
+
+bool HistoryStore::Open(const std::filesystem::path& directory) {
+    m_dataOut.close();
+    m_indexOut.close();
+    m_open = false;
+    m_directory = directory;
+    m_recent.Clear();
+    m_outputs.Clear();
+    m_count = 0;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    auto dataPath = directory / "history.dat";
+    auto indexPath = directory / "history.idx";
+    if (!HasHeader(dataPath, DATA_MAGIC)) {
+        if (!WriteHeader(dataPath, DATA_MAGIC) || !WriteHeader(indexPath, INDEX_MAGIC)) return false;
+    } else if (!HasHeader(indexPath, INDEX_MAGIC)) {
+        // The index is derived data; Repair() rebuilds it from the records
+        if (!WriteHeader(indexPath, INDEX_MAGIC)) return false;
+    }
+
+    if (!Repair()) return false;
+
+    m_dataOut.open(dataPath, std::ios::binary | std::ios::app);
+    m_indexOut.open(indexPath, std::ios::binary | std::ios::app);
+    if (!m_dataOut || !m_indexOut) return false;
+    m_open = true;
+
+    std::vector<HistoryEntry> recent;
+    size_t recentCount = static_cast<size_t>(std::min<uint64_t>(m_count, m_recent.GetCapacity()));
+    if (Read(m_count - recentCount, recentCount, recent)) {
+        for (auto& entry : recent) m_recent.Push(std::move(entry));
+    }
+    return true;
+}
+
+bool HistoryStore::Repair() {
+    auto dataPath = m_directory / "history.dat";
+    auto indexPath = m_directory / "history.idx";
+
+    std::error_code ec;
+    uint64_t dataSize = std::filesystem::file_size(dataPath, ec);
+    if (ec) return false;
+    uint64_t indexSize = std::filesystem::file_size(indexPath, ec);
+    if (ec) return false;
+
+    uint64_t count = (indexSize - HEADER_SIZE) / sizeof(IndexEntry);
+    uint64_t end = HEADER_SIZE;
+    std::vector<IndexEntry> missing;
+    {
+        std::ifstream data(dataPath, std::ios::binary);
+        std::ifstream index(indexPath, std::ios::binary);
+
+        auto readLength = [&data, dataSize](uint64_t offset, uint32_t& length) {
+            if (offset < HEADER_SIZE || offset + sizeof(length) > dataSize) return false;
+            data.clear();
+            data.seekg(static_cast<std::streamoff>(offset));
+            return data.read(reinterpret_cast<char*>(&length), sizeof(length)) &&
+                   length <= MAX_RECORD_SIZE && offset + sizeof(length) + length <= dataSize;
+        };
+
+        // Drop index entries whose record did not make it to disk
+        while (count > 0) {
+            IndexEntry entry;
+            index.clear();
+            index.seekg(static_cast<std::streamoff>(HEADER_SIZE + (count - 1) * sizeof(IndexEntry)));
+            uint32_t length = 0;
+            if (index.read(reinterpret_cast<char*>(&entry), sizeof(entry)) && readLength(entry.offset, length)) {
+                end = entry.offset + sizeof(length) + length;
+                break;
+            }
+            --count;
+        }
+
+        // Index complete records written after the last indexed one
+        uint32_t length = 0;
+        while (readLength(end, length)) {
+            IndexEntry entry = { 0, end };
+            data.read(reinterpret_cast<char*>(&entry.unixTime), sizeof(entry.unixTime));
+            missing.push_back(entry);
+            end += sizeof(length) + length;
+        }
+    }
+
+    if (end != dataSize) std::filesystem::resize_file(dataPath, end, ec);
+    if (indexSize != HEADER_SIZE + count * sizeof(IndexEntry)) {
+        std::filesystem::resize_file(indexPath, HEADER_SIZE + count * sizeof(IndexEntry), ec);
+    }
+    if (!missing.empty()) {
+        std::ofstream index(indexPath, std::ios::binary | std::ios::app);
+        index.write(reinterpret_cast<const char*>(missing.data()),
+                    static_cast<std::streamsize>(missing.size() * sizeof(IndexEntry)));
+        if (!index) return false;
+    }
+
+    m_dataSize = end;
+    m_count = count + missing.size();
+    return true;
+}
+
+void HistoryStore::Add(HistoryEntry entry) {
+    if (entry.output.size() > MAX_ARCHIVED_OUTPUT) {
+        entry.output.resize(MAX_ARCHIVED_OUTPUT);
+    }
+    entry.index = m_count;
+    entry.outputSize = static_cast<uint32_t>(entry.output.size());
+
+    if (m_open) {
+        std::string record;
+        record.reserve(64 + entry.command.size() + entry.timestamp.size() + entry.output.size());
+        AppendValue(record, uint32_t(0));
+        AppendValue(record, entry.unixTime);
+        AppendValue(record, entry.executionTime);
+        AppendValue(record, static_cast<uint8_t>(entry.success ? 1 : 0));
+        AppendString(record, entry.command);
+        AppendString(record, entry.timestamp);
+        AppendString(record, entry.output);
+        uint32_t length = static_cast<uint32_t>(record.size() - sizeof(uint32_t));
+        memcpy(&record[0], &length, sizeof(length));
+
+        // Record first, then its index entry: Open() can rebuild a lost index
+        // entry but has to drop an index entry without a record
+        IndexEntry indexEntry = { entry.unixTime, m_dataSize };
+        m_dataOut.write(record.data(), static_cast<std::streamsize>(record.size()));
+        m_dataOut.flush();
+        m_indexOut.write(reinterpret_cast<const char*>(&indexEntry), sizeof(indexEntry));
+        m_indexOut.flush();
+        if (!m_dataOut || !m_indexOut) {
+            // Leave the archive as is; Open() trims whatever partial write got through
+            m_dataOut.clear();
+            m_indexOut.clear();
+            m_open = false;
+        } else {
+            m_dataSize += record.size();
+        }
+    }
+
+    m_count++;
+    m_outputs.Put(entry.index, entry.output);
+    entry.output.clear();
+    entry.output.shrink_to_fit();
+    m_recent.Push(std::move(entry));
+}
+
+void HistoryStore::Clear() {
+    m_recent.Clear();
+    m_outputs.Clear();
+    m_count = 0;
+    if (!m_open) return;
+
+    m_dataOut.close();
+    m_indexOut.close();
+    m_open = false;
+
+    auto dataPath = m_directory / "history.dat";
+    auto indexPath = m_directory / "history.idx";
+    if (!WriteHeader(dataPath, DATA_MAGIC) || !WriteHeader(indexPath, INDEX_MAGIC)) return;
+
+    m_dataSize = HEADER_SIZE;
+    m_dataOut.open(dataPath, std::ios::binary | std::ios::app);
+    m_indexOut.open(indexPath, std::ios::binary | std::ios::app);
+    m_open = m_dataOut && m_indexOut;
+}
+
+bool HistoryStore::Read(uint64_t first, size_t count, std::vector<HistoryEntry>& entries) const {
+    entries.clear();
+    if (first >= m_count) return count == 0;
+    count = static_cast<size_t>(std::min<uint64_t>(count, m_count - first));
+
+    uint64_t recentStart = m_count - m_recent.GetSize();
+    if (first >= recentStart) {
+        for (size_t i = 0; i < count; ++i) {
+            entries.push_back(m_recent[static_cast<size_t>(first - recentStart) + i]);
+        }
+        return true;
+    }
+    if (!m_open) return false;
+
+    entries.reserve(count);
+    ArchiveReader reader(m_directory);
+    return reader.ReadRecords(first, count, [&entries](uint64_t index, const RecordView& record) {
+        entries.push_back(ToEntry(index, record));
+    });
+}
+
+bool HistoryStore::Read(const std::vector<uint64_t>& indices, std::vector<HistoryEntry>& entries) const {
+    entries.clear();
+    entries.reserve(indices.size());
+
+    uint64_t recentStart = m_count - m_recent.GetSize();
+    ArchiveReader reader(m_directory);
+    for (uint64_t index : indices) {
+        if (index >= m_count) return false;
+        if (index >= recentStart) {
+            entries.push_back(m_recent[static_cast<size_t>(index - recentStart)]);
+            continue;
+        }
+
+        bool read = m_open && reader.ReadRecords(index, 1, [&entries](uint64_t index, const RecordView& record) {
+            entries.push_back(ToEntry(index, record));
+        });
+        if (!read) return false;
+    }
+    return true;
+}
+
+bool HistoryStore::ReadOutput(uint64_t index, std::string& output) const {
+    output.clear();
+    if (m_outputs.Get(index, output)) return true;
+    if (!m_open || index >= m_count) return false;
+
+    ArchiveReader reader(m_directory);
+    return reader.ReadRecords(index, 1, [&output](uint64_t, const RecordView& record) {
+        output.assign(record.output);
+    });
+}
+
+uint64_t HistoryStore::FindByTime(int64_t unixTime) const {
+    if (!m_open) {
+        uint64_t index = 0;
+        while (index < m_recent.GetSize() && m_recent[static_cast<size_t>(index)].unixTime < unixTime) ++index;
+        return index;
+    }
+
+    ArchiveReader reader(m_directory);
+    return reader.LowerBound(m_count, unixTime);
+}
+
+std::vector<uint64_t> HistoryStore::Search(const std::filesystem::path& directory, uint64_t count,
+                                           const HistoryQuery& query) {
+    std::vector<uint64_t> results;
+    ArchiveReader reader(directory);
+    if (!reader.IsOpen() || query.maxResults == 0) return results;
+
+    std::string needle = query.text;
+    std::transform(needle.begin(), needle.end(), needle.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // The time index narrows the scan; records are still checked in case the clock jumped
+    uint64_t begin = 0;
+    uint64_t end = count;
+    if (query.fromTime != std::numeric_limits<int64_t>::min()) begin = reader.LowerBound(count, query.fromTime);
+    if (query.toTime != std::numeric_limits<int64_t>::max()) end = reader.LowerBound(count, query.toTime + 1);
+
+    std::vector<uint64_t> blockMatches;
+    while (end > begin && results.size() < query.maxResults) {
+        uint64_t start = end - std::min<uint64_t>(end - begin, SEARCH_BLOCK);
+        blockMatches.clear();
+        bool read = reader.ReadRecords(start, static_cast<size_t>(end - start),
+                                       [&](uint64_t index, const RecordView& record) {
+            if (query.failuresOnly && record.success) return;
+            if (record.unixTime < query.fromTime || record.unixTime > query.toTime) return;
+            if (ContainsNoCase(record.command, needle)) blockMatches.push_back(index);
+        });
+        if (!read) break;
+
+        for (auto it = blockMatches.rbegin(); it != blockMatches.rend() && results.size() < query.maxResults; ++it) {
+            results.push_back(*it);
+        }
+        end = start;
+    }
+    return results;
+}
+
+} // namespace NirUI
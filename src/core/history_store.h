@@ -0,0 +1,96 @@
+#pragma once
+
+#include "output_block_store.h"
+#include "utils/ring_buffer.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace NirUI {
+
+struct HistoryEntry {
+    std::string command;
+    // Passed in to HistoryStore::Add(); entries read back leave it empty and
+    // the output is fetched on demand with ReadOutput()
+    std::string output;
+    bool success = false;
+    double executionTime = 0.0;
+    std::string timestamp;
+    int64_t unixTime = 0;
+    uint64_t index = 0;
+    uint32_t outputSize = 0;
+};
+
+struct HistoryQuery {
+    std::string text;       // case-insensitive substring of the command; empty matches everything
+    int64_t fromTime = std::numeric_limits<int64_t>::min();
+    int64_t toTime = std::numeric_limits<int64_t>::max();
+    bool failuresOnly = false;
+    size_t maxResults = 1000;
+};
+
+// Every executed command, kept in two append-only files in the data directory:
+// history.dat holds the records and history.idx holds one fixed-size
+// { unix time, offset } entry per record. The index makes paging O(page) and
+// time lookups a binary search, so nothing but the newest entries is ever kept
+// in memory. Those live in a ring buffer and serve the first page directly,
+// with the outputs of this session's entries compressed in an OutputBlockStore.
+//
+// Entries are addressed by their position in the archive, oldest first. The
+// time index assumes entries arrive in clock order; a clock adjustment only
+// makes time lookups around it imprecise.
+//
+// Records: u32 payload length, then { i64 unix time, f64 execution ms,
+// u8 success, and u32-length-prefixed command, timestamp and output }.
+class HistoryStore {
+public:
+    static constexpr size_t RECENT_CAPACITY = 100;
+    static constexpr size_t MAX_ARCHIVED_OUTPUT = 64 * 1024;
+    static constexpr uint32_t VERSION = 1;
+
+    explicit HistoryStore(size_t recentCapacity = RECENT_CAPACITY);
+
+    // Opens or creates the archive, repairing a torn tail left by a crash
+    bool Open(const std::filesystem::path& directory);
+    bool IsOpen() const { return m_open; }
+
+    // Entries added before Open() only live in the ring buffer
+    void Add(HistoryEntry entry);
+    void Clear();
+
+    uint64_t GetCount() const { return m_count; }
+    const RingBuffer<HistoryEntry>& GetRecent() const { return m_recent; }
+    const std::filesystem::path& GetDirectory() const { return m_directory; }
+
+    bool Read(uint64_t first, size_t count, std::vector<HistoryEntry>& entries) const;
+    bool Read(const std::vector<uint64_t>& indices, std::vector<HistoryEntry>& entries) const;
+    bool ReadOutput(uint64_t index, std::string& output) const;
+    const OutputBlockStore& GetOutputs() const { return m_outputs; }
+    void SetOutputBudget(size_t byteBudget) { m_outputs.SetBudget(byteBudget); }
+    // Index of the first entry at or after unixTime, or GetCount() if there is none
+    uint64_t FindByTime(int64_t unixTime) const;
+
+    // Scans entries [0, count) newest first and returns the matching indices.
+    // Uses its own file handles, so it may run on a worker thread while the
+    // owner keeps adding entries.
+    static std::vector<uint64_t> Search(const std::filesystem::path& directory, uint64_t count,
+                                        const HistoryQuery& query);
+    std::vector<uint64_t> Search(const HistoryQuery& query) const { return Search(m_directory, m_count, query); }
+
+private:
+    bool Repair();
+
+    std::filesystem::path m_directory;
+    std::ofstream m_dataOut;
+    std::ofstream m_indexOut;
+    uint64_t m_dataSize = 0;
+    uint64_t m_count = 0;
+    bool m_open = false;
+    RingBuffer<HistoryEntry> m_recent;
+    OutputBlockStore m_outputs;
+};
+
+} // namespace NirUI
@@ -0,0 +1,371 @@
+#include "meta_commands.h"
+#include "command_tokenizer.h"
+#include "param_validator.h"
+#include "utils/duration.h"
+#include "utils/latency_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+namespace NirUI {
+
+namespace {
+
+struct MetaCommandCall {
+    const CommandTokens& tokens;
+    const MetaCommandHandlers& handlers;
+    ExecutionResult& result;
+
+    // Arguments follow the two command words
+    size_t GetArgCount() const { return tokens.GetCount() - 2; }
+    std::string_view ArgView(size_t index) const { return tokens[index + 2]; }
+    std::string Arg(size_t index) const { return std::string(tokens[index + 2]); }
+
+    void Fail(std::string message) const {
+        result.success = false;
+        result.output = std::move(message);
+    }
+};
+
+struct MetaCommandSpec {
+    std::string_view verb;
+    std::string_view name;
+    size_t minArgs;
+    size_t maxArgs;
+    std::string_view usage;
+    void (*run)(const MetaCommandCall& call);
+};
+
+bool ParseBool(std::string_view value, bool& result) {
+    if (value == "1" || value == "true" || value == "yes" || value == "on") {
+        result = true;
+        return true;
+    }
+    if (value == "0" || value == "false" || value == "no" || value == "off") {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+// Accepts --recursive, -r, recursive=BOOL and a bare BOOL, the form the
+// command builder produces for the optional recursive parameter
+bool ParseRecursiveFlag(std::string_view token, bool& recursive) {
+    if (token == "--recursive" || token == "-r") {
+        recursive = true;
+        return true;
+    }
+    constexpr std::string_view prefix = "recursive=";
+    if (token.substr(0, prefix.size()) == prefix) {
+        return ParseBool(token.substr(prefix.size()), recursive);
+    }
+    return ParseBool(token, recursive);
+}
+
+bool ParseFreezeArgs(const MetaCommandCall& call, std::string& findType, std::string& findValue, bool& recursive) {
+    findType = call.Arg(0);
+    findValue = call.Arg(1);
+    recursive = false;
+    return call.GetArgCount() < 3 || ParseRecursiveFlag(call.ArgView(2), recursive);
+}
+
+void RunFreeze(const MetaCommandCall& call) {
+    if (!call.handlers.freeze) {
+        call.Fail("Freezing is not available here");
+        return;
+    }
+    std::string findType, findValue;
+    bool recursive = false;
+    if (!ParseFreezeArgs(call, findType, findValue, recursive)) {
+        call.Fail("Invalid recursive flag: " + call.Arg(2));
+        return;
+    }
+    call.result.output = call.handlers.freeze(findType, findValue, recursive);
+}
+
+void RunUnfreeze(const MetaCommandCall& call) {
+    if (!call.handlers.unfreeze) {
+        call.Fail("Unfreezing is not available here");
+        return;
+    }
+    std::string findType, findValue;
+    bool recursive = false;
+    if (!ParseFreezeArgs(call, findType, findValue, recursive)) {
+        call.Fail("Invalid recursive flag: " + call.Arg(2));
+        return;
+    }
+    call.result.output = call.handlers.unfreeze(findType, findValue, recursive);
+}
+
+void RunGroupList(const MetaCommandCall& call) {
+    std::string output = "App Groups:\n";
+    for (const auto& group : call.handlers.appGroups->GetGroups()) {
+        output += "  " + group.name + " (" + std::to_string(group.apps.size()) + " apps)\n";
+        for (const auto& app : group.apps) {
+            output += "    - " + app.name + " [" + app.targetType + ": " + app.targetValue + "]";
+            if (app.targetType == "folder" && app.recursive) output += " (recursive)";
+            output += "\n";
+        }
+    }
+    call.result.output = output;
+}
+
+void RunGroupCreate(const MetaCommandCall& call) {
+    std::string name = call.Arg(0);
+    if (call.handlers.appGroups->CreateGroup(name)) {
+        call.result.output = "Created group: " + name;
+    } else {
+        call.Fail("Group already exists: " + name);
+    }
+}
+
+void RunGroupDelete(const MetaCommandCall& call) {
+    std::string name = call.Arg(0);
+    if (call.handlers.appGroups->DeleteGroup(name)) {
+        call.result.output = "Deleted group: " + name;
+    } else {
+        call.Fail("Group not found: " + name);
+    }
+}
+
+void RunGroupAdd(const MetaCommandCall& call) {
+    std::string groupName = call.Arg(0);
+    std::string appName = call.Arg(1);
+
+    // Matches the parameter default in the command registry
+    bool recursive = true;
+    if (call.GetArgCount() > 4 && !ParseRecursiveFlag(call.ArgView(4), recursive)) {
+        call.Fail("Invalid recursive flag: " + call.Arg(4));
+        return;
+    }
+
+    if (call.handlers.appGroups->AddApp(groupName, appName, call.Arg(2), call.Arg(3), recursive)) {
+        call.result.output = "Added " + appName + " to " + groupName;
+    } else {
+        call.Fail("Group not found: " + groupName);
+    }
+}
+
+void RunGroupRemove(const MetaCommandCall& call) {
+    std::string groupName = call.Arg(0);
+    std::string appName = call.Arg(1);
+    if (call.handlers.appGroups->RemoveApp(groupName, appName)) {
+        call.result.output = "Removed " + appName + " from " + groupName;
+    } else {
+        call.Fail("Group or app not found");
+    }
+}
+
+void RunGroupRun(const MetaCommandCall& call) {
+    if (!call.handlers.runGroup) {
+        call.Fail("Running groups is not available here");
+        return;
+    }
+    call.result.output = call.handlers.runGroup(call.Arg(0), call.Arg(1));
+}
+
+CommandScheduler* RequireScheduler(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = call.handlers.getScheduler ? call.handlers.getScheduler() : nullptr;
+    if (!scheduler) call.Fail("Scheduling is not available here");
+    return scheduler;
+}
+
+// The command to schedule is either the remaining words or, quoted, one
+// argument holding the whole command line
+bool GetScheduledCommand(const MetaCommandCall& call, size_t first, std::string& command) {
+    if (call.GetArgCount() == first + 1) {
+        command = call.Arg(first);
+    } else {
+        for (size_t i = first; i < call.GetArgCount(); ++i) {
+            if (!command.empty()) command += ' ';
+            NirCmdManager::AppendQuotedArgument(command, call.ArgView(i));
+        }
+    }
+
+    std::string error;
+    if (!ParamValidators::Validate(command, error)) {
+        call.Fail(error);
+        return false;
+    }
+    return true;
+}
+
+void ReportScheduled(const MetaCommandCall& call, CommandScheduler::TaskId id, const std::string& command) {
+    call.result.output = "Scheduled #" + std::to_string(id) + ": " + command;
+}
+
+void RunScheduleIn(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = RequireScheduler(call);
+    if (!scheduler) return;
+    uint64_t delayMs = 0;
+    if (!ParseDuration(call.ArgView(0), delayMs)) {
+        call.Fail("Invalid duration: " + call.Arg(0) + " (e.g. 30s, 5m, 1h30m)");
+        return;
+    }
+    std::string command;
+    if (!GetScheduledCommand(call, 1, command)) return;
+    ReportScheduled(call, scheduler->ScheduleOnce(delayMs, command), command);
+}
+
+void RunScheduleEvery(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = RequireScheduler(call);
+    if (!scheduler) return;
+    uint64_t intervalMs = 0;
+    if (!ParseDuration(call.ArgView(0), intervalMs) || intervalMs == 0) {
+        call.Fail("Invalid interval: " + call.Arg(0) + " (e.g. 30s, 5m, 1h30m)");
+        return;
+    }
+    std::string command;
+    if (!GetScheduledCommand(call, 1, command)) return;
+    ReportScheduled(call, scheduler->ScheduleEvery(intervalMs, command), command);
+}
+
+void RunScheduleCron(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = RequireScheduler(call);
+    if (!scheduler) return;
+    CronSpec spec;
+    std::string error;
+    if (!spec.Parse(call.ArgView(0), error)) {
+        call.Fail(error);
+        return;
+    }
+    std::string command;
+    if (!GetScheduledCommand(call, 1, command)) return;
+    CommandScheduler::TaskId id = scheduler->ScheduleCron(spec, call.ArgView(0), command);
+    if (id == 0) {
+        call.Fail("Cron expression never matches: " + call.Arg(0));
+        return;
+    }
+    ReportScheduled(call, id, command);
+}
+
+void RunScheduleList(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = RequireScheduler(call);
+    if (!scheduler) return;
+    auto tasks = scheduler->GetTasks();
+    if (tasks.empty()) {
+        call.result.output = "No scheduled commands.";
+        return;
+    }
+    std::string output = "Scheduled commands:\n";
+    for (const auto& task : tasks) {
+        output += "  #" + std::to_string(task.id) + " " + task.schedule + ", next in " +
+                  FormatDuration(task.dueInMs) + ", " + std::to_string(task.runs) + " run(s)";
+        if (task.runs > 0) output += ", max " + std::to_string(task.maxLatenessMs) + " ms late";
+        output += ": " + task.command + "\n";
+    }
+    call.result.output = output;
+}
+
+void RunScheduleCancel(const MetaCommandCall& call) {
+    CommandScheduler* scheduler = RequireScheduler(call);
+    if (!scheduler) return;
+    std::string target = call.Arg(0);
+    if (target == "all") {
+        size_t count = scheduler->CancelAll();
+        call.result.output = "Cancelled " + std::to_string(count) + " scheduled command(s)";
+        return;
+    }
+    if (!target.empty() && target[0] == '#') target.erase(0, 1);
+    char* end = nullptr;
+    unsigned long id = std::strtoul(target.c_str(), &end, 10);
+    if (target.empty() || *end != '\0' || !scheduler->Cancel(static_cast<CommandScheduler::TaskId>(id))) {
+        call.Fail("No scheduled command #" + target);
+        return;
+    }
+    call.result.output = "Cancelled #" + target;
+}
+
+const MetaCommandSpec META_COMMANDS[] = {
+    { "win", "freeze", 2, 3, "win freeze TYPE VALUE [--recursive]", RunFreeze },
+    { "win", "unfreeze", 2, 3, "win unfreeze TYPE VALUE [--recursive]", RunUnfreeze },
+    { "group", "list", 0, 0, "group list", RunGroupList },
+    { "group", "create", 1, 1, "group create NAME", RunGroupCreate },
+    { "group", "delete", 1, 1, "group delete NAME", RunGroupDelete },
+    { "group", "add", 4, 5, "group add GROUP NAME TYPE VALUE [recursive]", RunGroupAdd },
+    { "group", "remove", 2, 2, "group remove GROUP NAME", RunGroupRemove },
+    { "group", "run", 2, 2, "group run GROUP ACTION", RunGroupRun },
+    { "schedule", "in", 2, SIZE_MAX, "schedule in DURATION COMMAND...", RunScheduleIn },
+    { "schedule", "every", 2, SIZE_MAX, "schedule every INTERVAL COMMAND...", RunScheduleEvery },
+    { "schedule", "cron", 2, SIZE_MAX, "schedule cron \"MIN HOUR DAY MONTH WEEKDAY\" COMMAND...", RunScheduleCron },
+    { "schedule", "list", 0, 0, "schedule list", RunScheduleList },
+    { "schedule", "cancel", 1, 1, "schedule cancel ID|all", RunScheduleCancel },
+};
+
+// "group" and "schedule" belong to NirUI entirely; "win" only for the commands in the table.
+// Returns false if the command goes to nircmd; spec stays null for an unknown
+// "group" subcommand.
+bool FindMetaCommand(std::string_view verb, std::string_view name, const MetaCommandSpec*& spec) {
+    spec = nullptr;
+    bool knownVerb = false;
+    for (const auto& entry : META_COMMANDS) {
+        if (entry.verb != verb) continue;
+        knownVerb = true;
+        if (entry.name == name) {
+            spec = &entry;
+            break;
+        }
+    }
+    return spec || (knownVerb && verb != "win");
+}
+
+} // namespace
+
+bool IsMetaCommand(std::string_view command) {
+    CommandTokens tokens(command);
+    const MetaCommandSpec* spec = nullptr;
+    return FindMetaCommand(tokens[0], tokens[1], spec);
+}
+
+double EstimateCommandMs(const CostModel& costs, std::string_view command) {
+    CommandTokens tokens(command);
+    const MetaCommandSpec* spec = nullptr;
+    if (FindMetaCommand(tokens[0], tokens[1], spec)) {
+        // Named as DispatchMetaCommand records them
+        std::string name = std::string(tokens[0]) + " " + std::string(tokens[1]);
+        return costs.EstimateMs(CostBackend::Builtin, name);
+    }
+    return costs.EstimateMs(CostBackend::NirCmd, ParamValidators::GetCommandName(command));
+}
+
+bool DispatchMetaCommand(std::string_view command, const MetaCommandHandlers& handlers, ExecutionResult& result) {
+    CommandTokens tokens(command);
+    std::string_view verb = tokens[0];
+    std::string_view name = tokens[1];
+
+    const MetaCommandSpec* spec = nullptr;
+    if (!FindMetaCommand(verb, name, spec)) return false;
+
+    result = ExecutionResult();
+    result.exitCode = 0;
+    result.success = true;
+    result.executionTimeMs = 0;
+
+    if (!spec) {
+        result.success = false;
+        result.output = "Unknown command: " + std::string(verb) + (name.empty() ? "" : " " + std::string(name)) +
+                        "\nAvailable:";
+        for (const auto& entry : META_COMMANDS) {
+            if (entry.verb == verb) result.output += "\n  " + std::string(entry.usage);
+        }
+    } else {
+        MetaCommandCall call{ tokens, handlers, result };
+        if (call.GetArgCount() < spec->minArgs || call.GetArgCount() > spec->maxArgs) {
+            call.Fail("Usage: " + std::string(spec->usage));
+        } else {
+            auto start = std::chrono::steady_clock::now();
+            spec->run(call);
+            result.executionTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::string specName = std::string(spec->verb) + " " + std::string(spec->name);
+            if (handlers.costs) handlers.costs->Record(CostBackend::Builtin, specName, result.executionTimeMs);
+
+            LatencyStats& stats = LatencyStats::Get();
+            stats.RecordMs(stats.Register("builtin", specName), LatencyPhase::Total, result.executionTimeMs);
+        }
+    }
+
+    if (!result.success) result.exitCode = 1;
+    return true;
+}
+
+} // namespace NirUI
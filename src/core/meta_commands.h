@@ -0,0 +1,47 @@
+#pragma once
+
+#include "app_groups.h"
+#include "command_scheduler.h"
+#include "cost_model.h"
+#include "nircmd_manager.h"
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace NirUI {
+
+// Front-end hooks for the commands NirUI handles itself instead of passing to
+// nircmd. The GUI freezes through its frozen-window list, the REPL through the
+// CLI session. Each hook returns text for the command's output.
+struct MetaCommandHandlers {
+    using FreezeHandler = std::function<std::string(const std::string& targetType, const std::string& targetValue,
+                                                    bool recursive)>;
+    using GroupHandler = std::function<std::string(const std::string& groupName, const std::string& action)>;
+    // Called only when a schedule command runs, so a front end can start its
+    // scheduler thread on first use
+    using SchedulerFactory = std::function<CommandScheduler*()>;
+
+    AppGroupsManager* appGroups = nullptr;
+    // Empty if the front end cannot run commands later
+    SchedulerFactory getScheduler;
+    // Null to skip recording how long meta-commands take
+    CostModel* costs = nullptr;
+    // Empty if the front end cannot freeze windows or run groups
+    FreezeHandler freeze;
+    FreezeHandler unfreeze;
+    GroupHandler runGroup;
+};
+
+// Handles "win freeze|unfreeze TYPE VALUE [recursive]" and every "group ..."
+// and "schedule ..." command, parsed with CommandTokens and looked up in a
+// table. The recursive flag may be --recursive, -r, recursive=BOOL or a bare
+// BOOL. Returns false, leaving result untouched, if the command should go to
+// nircmd instead.
+bool DispatchMetaCommand(std::string_view command, const MetaCommandHandlers& handlers, ExecutionResult& result);
+// True if DispatchMetaCommand would handle the command
+bool IsMetaCommand(std::string_view command);
+// Expected time of a command line: the cost model's estimate for its name,
+// under NirUI or nircmd depending on which one runs it
+double EstimateCommandMs(const CostModel& costs, std::string_view command);
+
+} // namespace NirUI
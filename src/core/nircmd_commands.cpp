@@ -68,6 +68,7 @@ void NirCmdCommands::InitializeCommands() {
     InitDialogCommands();
     InitMiscCommands();
     InitAppGroupCommands();
+    InitSchedulerCommands();
 }
 
 void NirCmdCommands::InitVolumeCommands() {
@@ -81,52 +82,52 @@ void NirCmdCommands::InitVolumeCommands() {
         "Set the system volume to a specific value (0-65535)",
         "nircmd setsysvolume 32768",
         {
-            Parameter("volume", "Volume level (0-65535)", ParamType::Integer, true),
+            Parameter("volume", "Volume level (0-65535)", ParamType::Integer, true).Range(0, 65535).Coalesced(),
             Parameter("component", "Sound component (master, waveout, synth, cd, microphone, phone, aux, line)", ParamType::Choice, false, "master",
                      {"master", "waveout", "synth", "cd", "microphone", "phone", "aux", "line"}),
-            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0")
+            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0").Range(0)
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Replace, "sysvolume"));
     
     cat.commands.push_back(Command(
         "changesysvolume",
         "Change the system volume by a relative amount",
         "nircmd changesysvolume 2000",
         {
-            Parameter("change", "Volume change (-65535 to 65535)", ParamType::Integer, true),
+            Parameter("change", "Volume change (-65535 to 65535)", ParamType::Integer, true).Range(-65535, 65535).Coalesced(),
             Parameter("component", "Sound component", ParamType::Choice, false, "master",
                      {"master", "waveout", "synth", "cd", "microphone", "phone", "aux", "line"}),
-            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0")
+            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0").Range(0)
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Sum, "sysvolume"));
     
     cat.commands.push_back(Command(
         "setsysvolume2",
         "Set the system volume using percentage (0-1000 = 0%-100%)",
         "nircmd setsysvolume2 500 master",
         {
-            Parameter("volume", "Volume level (0-1000)", ParamType::Integer, true),
+            Parameter("volume", "Volume level (0-1000)", ParamType::Integer, true).Range(0, 1000).Coalesced(),
             Parameter("component", "Sound component", ParamType::Choice, false, "master",
                      {"master", "waveout", "synth", "cd", "microphone", "phone", "aux", "line"}),
-            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0")
+            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0").Range(0)
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Replace, "sysvolume"));
     
     cat.commands.push_back(Command(
         "changesysvolume2",
         "Change the system volume by percentage",
         "nircmd changesysvolume2 50",
         {
-            Parameter("change", "Volume change percentage", ParamType::Integer, true),
+            Parameter("change", "Volume change percentage", ParamType::Integer, true).Coalesced(),
             Parameter("component", "Sound component", ParamType::Choice, false, "master",
                      {"master", "waveout", "synth", "cd", "microphone", "phone", "aux", "line"}),
-            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0")
+            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0").Range(0)
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Sum, "sysvolume"));
     
     cat.commands.push_back(Command(
         "mutesysvolume",
@@ -134,10 +135,10 @@ void NirCmdCommands::InitVolumeCommands() {
         "nircmd mutesysvolume 2",
         {
             Parameter("mute", "0=unmute, 1=mute, 2=toggle", ParamType::Choice, true, "2",
-                     {"0", "1", "2"}),
+                     {"0", "1", "2"}).Exhaustive(),
             Parameter("component", "Sound component", ParamType::Choice, false, "master",
                      {"master", "waveout", "synth", "cd", "microphone", "phone", "aux", "line", "default_record"}),
-            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0")
+            Parameter("device_index", "Sound device index", ParamType::Integer, false, "0").Range(0)
         },
         "Volume Control"
     ));
@@ -148,10 +149,10 @@ void NirCmdCommands::InitVolumeCommands() {
         "nircmd setappvolume firefox.exe 0.5",
         {
             Parameter("process", "Process name or 'focused'", ParamType::String, true),
-            Parameter("volume", "Volume level (0.0-1.0)", ParamType::String, true)
+            Parameter("volume", "Volume level (0.0-1.0)", ParamType::String, true).Coalesced()
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Replace, "appvolume"));
     
     cat.commands.push_back(Command(
         "changeappvolume",
@@ -159,10 +160,10 @@ void NirCmdCommands::InitVolumeCommands() {
         "nircmd changeappvolume chrome.exe 0.1",
         {
             Parameter("process", "Process name or 'focused'", ParamType::String, true),
-            Parameter("change", "Volume change (-1.0 to 1.0)", ParamType::String, true)
+            Parameter("change", "Volume change (-1.0 to 1.0)", ParamType::String, true).Coalesced()
         },
         "Volume Control"
-    ));
+    ).Coalesce(CoalesceMode::Sum, "appvolume"));
     
     cat.commands.push_back(Command(
         "muteappvolume",
@@ -171,7 +172,7 @@ void NirCmdCommands::InitVolumeCommands() {
         {
             Parameter("process", "Process name or 'focused'", ParamType::String, true),
             Parameter("mute", "0=unmute, 1=mute, 2=toggle", ParamType::Choice, true, "2",
-                     {"0", "1", "2"})
+                     {"0", "1", "2"}).Exhaustive()
         },
         "Volume Control"
     ));
@@ -183,7 +184,7 @@ void NirCmdCommands::InitVolumeCommands() {
         {
             Parameter("device_name", "Name of sound device", ParamType::String, true),
             Parameter("role", "0=console, 1=multimedia, 2=communications", ParamType::Choice, false, "1",
-                     {"0", "1", "2"})
+                     {"0", "1", "2"}).Exhaustive()
         },
         "Volume Control"
     ));
@@ -206,7 +207,7 @@ void NirCmdCommands::InitVolumeCommands() {
         {
             Parameter("subunit_name", "Name of subunit", ParamType::String, true),
             Parameter("mute", "0=unmute, 1=mute, 2=toggle", ParamType::Choice, true, "2",
-                     {"0", "1", "2"})
+                     {"0", "1", "2"}).Exhaustive()
         },
         "Volume Control"
     ));
@@ -234,7 +235,7 @@ void NirCmdCommands::InitMonitorCommands() {
         "nircmd monitor off",
         {
             Parameter("action", "on, off, low, async_off, async_on, async_low", ParamType::Choice, true, "off",
-                     {"on", "off", "low", "async_off", "async_on", "async_low"})
+                     {"on", "off", "low", "async_off", "async_on", "async_low"}).Exhaustive()
         },
         "Monitor Control"
     ));
@@ -252,7 +253,7 @@ void NirCmdCommands::InitMonitorCommands() {
         "Set screen saver timeout in seconds",
         "nircmd screensavertimeout 300",
         {
-            Parameter("seconds", "Timeout in seconds", ParamType::Integer, true)
+            Parameter("seconds", "Timeout in seconds", ParamType::Integer, true).Range(0)
         },
         "Monitor Control"
     ));
@@ -262,20 +263,20 @@ void NirCmdCommands::InitMonitorCommands() {
         "Set screen brightness (laptops)",
         "nircmd setbrightness 50",
         {
-            Parameter("brightness", "Brightness level (0-100)", ParamType::Integer, true)
+            Parameter("brightness", "Brightness level (0-100)", ParamType::Integer, true).Range(0, 100).Coalesced()
         },
         "Monitor Control"
-    ));
+    ).Coalesce(CoalesceMode::Replace, "brightness"));
     
     cat.commands.push_back(Command(
         "changebrightness",
         "Change screen brightness relatively",
         "nircmd changebrightness 10",
         {
-            Parameter("change", "Brightness change (-100 to 100)", ParamType::Integer, true)
+            Parameter("change", "Brightness change (-100 to 100)", ParamType::Integer, true).Range(-100, 100).Coalesced()
         },
         "Monitor Control"
-    ));
+    ).Coalesce(CoalesceMode::Sum, "brightness"));
     
     s_categories.push_back(cat);
 }
@@ -423,7 +424,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win close class \"Notepad\"",
         {
             Parameter("find_type", "class, title, ititle, process, handle, folder, active, alltop", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop", "alltopnodesktop", "foreground", "desktop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop", "alltopnodesktop", "foreground", "desktop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -435,7 +436,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win hide class \"IEFrame\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -447,7 +448,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win show class \"IEFrame\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -459,7 +460,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win min title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -471,7 +472,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win max title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -483,7 +484,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win normal title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -495,7 +496,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win activate title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -507,7 +508,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win focus title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -519,7 +520,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win center title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "alltop", "alltopnodesktop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "alltop", "alltopnodesktop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -531,7 +532,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win move title \"Calculator\" 100 100",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("x", "X position", ParamType::Integer, true),
             Parameter("y", "Y position", ParamType::Integer, true)
@@ -545,7 +546,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win setsize title \"Calculator\" 100 100 400 300",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("x", "X position", ParamType::Integer, true),
             Parameter("y", "Y position", ParamType::Integer, true),
@@ -561,9 +562,9 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win trans title \"Calculator\" 200",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
-            Parameter("transparency", "Transparency (0=invisible, 255=opaque)", ParamType::Integer, true)
+            Parameter("transparency", "Transparency (0=invisible, 255=opaque)", ParamType::Integer, true).Range(0, 255)
         },
         "Window Management"
     ));
@@ -574,10 +575,10 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win settopmost title \"Calculator\" 1",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("topmost", "1=topmost, 0=normal", ParamType::Choice, true, "1",
-                     {"0", "1"})
+                     {"0", "1"}).Exhaustive()
         },
         "Window Management"
     ));
@@ -588,7 +589,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win flash title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -600,7 +601,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win settext title \"Calculator\" \"New Title\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("new_text", "New window title", ParamType::String, true)
         },
@@ -613,7 +614,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win redraw title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active", "alltop"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active", "alltop"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -625,7 +626,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win +style title \"Calculator\" 0x00C00000",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("style", "Window style hex value", ParamType::String, true)
         },
@@ -638,7 +639,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win -style title \"Calculator\" 0x00C00000",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("style", "Window style hex value to remove", ParamType::String, true)
         },
@@ -651,7 +652,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win +exstyle title \"my computer\" 0x00400000",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("exstyle", "Extended style hex value", ParamType::String, true)
         },
@@ -664,7 +665,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win -exstyle title \"Calculator\" 0x00400000",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("exstyle", "Extended style hex value to remove", ParamType::String, true)
         },
@@ -677,7 +678,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win enable title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -689,7 +690,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win disable title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -701,7 +702,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win togglehide title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -713,7 +714,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win togglemin title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -725,7 +726,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win togglemax title \"Calculator\"",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true)
         },
         "Window Management"
@@ -737,7 +738,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win child class \"Shell_TrayWnd\" hide class \"button\"",
         {
             Parameter("parent_find_type", "How to find parent window", ParamType::Choice, true, "class",
-                     {"class", "title", "ititle", "process", "handle"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle"}),
             Parameter("parent_find_value", "Parent window identifier", ParamType::String, true),
             Parameter("action", "Action to perform on child", ParamType::String, true),
             Parameter("child_find_type", "How to find child window", ParamType::Choice, true, "class",
@@ -753,7 +754,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win sendmsg title \"Calculator\" 0x0010 0 0",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("msg", "Message ID (hex)", ParamType::String, true),
             Parameter("wparam", "WPARAM value", ParamType::String, true),
@@ -768,7 +769,7 @@ void NirCmdCommands::InitWindowCommands() {
         "nircmd win postmsg title \"Calculator\" 0x0010 0 0",
         {
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier value", ParamType::String, true),
             Parameter("msg", "Message ID (hex)", ParamType::String, true),
             Parameter("wparam", "WPARAM value", ParamType::String, true),
@@ -848,7 +849,7 @@ void NirCmdCommands::InitAppGroupCommands() {
             Parameter("group", "Name of the group", ParamType::String, true),
             Parameter("app_name", "Display name for the app", ParamType::String, true),
             Parameter("target_type", "How to identify the app", ParamType::Choice, true, "process",
-                     {"process", "class", "title", "ititle", "folder"}),
+                     {"process", "class", "title", "ititle", "folder"}).Exhaustive(),
             Parameter("target_value", "Identifier value or folder path", ParamType::String, true),
             Parameter("recursive", "Include subfolders (only for folder type)", ParamType::Boolean, false, "true")
         },
@@ -873,7 +874,7 @@ void NirCmdCommands::InitAppGroupCommands() {
         {
             Parameter("group", "Name of the group", ParamType::String, true),
             Parameter("action", "Action to perform on all apps", ParamType::Choice, true, "freeze",
-                     {"min", "max", "normal", "close", "hide", "show", "freeze", "unfreeze"})
+                     {"min", "max", "normal", "close", "hide", "show", "freeze", "unfreeze"}).Exhaustive()
         },
         "App Groups"
     ));
@@ -881,6 +882,66 @@ void NirCmdCommands::InitAppGroupCommands() {
     s_categories.push_back(cat);
 }
 
+void NirCmdCommands::InitSchedulerCommands() {
+    Category cat;
+    cat.name = "Scheduler";
+    cat.icon = "\xE2\x8F\xB0"; // Alarm clock
+    cat.description = "Run commands and group actions later or on a schedule";
+    
+    cat.commands.push_back(Command(
+        "schedule in",
+        "Run a command once after a delay",
+        "schedule in 25m mutesysvolume 1",
+        {
+            Parameter("delay", "Delay such as 30s, 5m or 1h30m", ParamType::String, true, "5m"),
+            Parameter("command", "Command to run", ParamType::String, true)
+        },
+        "Scheduler"
+    ));
+    
+    cat.commands.push_back(Command(
+        "schedule every",
+        "Run a command repeatedly at a fixed interval",
+        "schedule every 10m group run \"Chat\" min",
+        {
+            Parameter("interval", "Interval such as 30s, 5m or 1h30m", ParamType::String, true, "10m"),
+            Parameter("command", "Command to run", ParamType::String, true)
+        },
+        "Scheduler"
+    ));
+    
+    cat.commands.push_back(Command(
+        "schedule cron",
+        "Run a command on a cron schedule (minute hour day month weekday)",
+        "schedule cron \"0 9 * * 1-5\" setsysvolume 20000",
+        {
+            Parameter("spec", "Cron expression, quoted", ParamType::String, true, "0 9 * * 1-5"),
+            Parameter("command", "Command to run", ParamType::String, true)
+        },
+        "Scheduler"
+    ));
+    
+    cat.commands.push_back(Command(
+        "schedule list",
+        "List scheduled commands with their next run",
+        "schedule list",
+        {},
+        "Scheduler"
+    ));
+    
+    cat.commands.push_back(Command(
+        "schedule cancel",
+        "Cancel a scheduled command by number, or all of them",
+        "schedule cancel 3",
+        {
+            Parameter("id", "Number shown by schedule list, or all", ParamType::String, true)
+        },
+        "Scheduler"
+    ));
+    
+    s_categories.push_back(cat);
+}
+
 void NirCmdCommands::InitProcessCommands() {
     Category cat;
     cat.name = "Process Management";
@@ -934,7 +995,7 @@ void NirCmdCommands::InitProcessCommands() {
         {
             Parameter("process_name", "Name of the process", ParamType::String, true),
             Parameter("priority", "Priority level", ParamType::Choice, true, "normal",
-                     {"idle", "belownormal", "normal", "abovenormal", "high", "realtime"})
+                     {"idle", "belownormal", "normal", "abovenormal", "high", "realtime"}).Exhaustive()
         },
         "Process Management"
     ));
@@ -967,7 +1028,7 @@ void NirCmdCommands::InitProcessCommands() {
         "nircmd exec show notepad.exe",
         {
             Parameter("show_state", "show, hide, min, max", ParamType::Choice, true, "show",
-                     {"show", "hide", "min", "max"}),
+                     {"show", "hide", "min", "max"}).Exhaustive(),
             Parameter("program", "Program to execute", ParamType::FilePath, true),
             Parameter("parameters", "Command line parameters", ParamType::String, false)
         },
@@ -980,7 +1041,7 @@ void NirCmdCommands::InitProcessCommands() {
         "nircmd exec2 show \"C:\\Windows\" notepad.exe",
         {
             Parameter("show_state", "show, hide, min, max", ParamType::Choice, true, "show",
-                     {"show", "hide", "min", "max"}),
+                     {"show", "hide", "min", "max"}).Exhaustive(),
             Parameter("working_dir", "Working directory", ParamType::FolderPath, true),
             Parameter("program", "Program to execute", ParamType::FilePath, true),
             Parameter("parameters", "Command line parameters", ParamType::String, false)
@@ -1190,11 +1251,11 @@ void NirCmdCommands::InitDisplayCommands() {
         "Set display resolution and color depth",
         "nircmd setdisplay 1920 1080 32",
         {
-            Parameter("width", "Screen width in pixels", ParamType::Integer, true),
-            Parameter("height", "Screen height in pixels", ParamType::Integer, true),
+            Parameter("width", "Screen width in pixels", ParamType::Integer, true).Range(1),
+            Parameter("height", "Screen height in pixels", ParamType::Integer, true).Range(1),
             Parameter("color_bits", "Color depth (16, 24, 32)", ParamType::Choice, true, "32",
                      {"16", "24", "32"}),
-            Parameter("refresh_rate", "Refresh rate in Hz (optional)", ParamType::Integer, false),
+            Parameter("refresh_rate", "Refresh rate in Hz (optional)", ParamType::Integer, false).Range(1),
             Parameter("monitor", "Monitor index (optional)", ParamType::Integer, false)
         },
         "Display Settings"
@@ -1498,7 +1559,7 @@ void NirCmdCommands::InitNetworkCommands() {
         "nircmd multiremote copy c:\\computers.txt \"exec show notepad.exe\"",
         {
             Parameter("mode", "copy or copyuserpass", ParamType::Choice, true, "copy",
-                     {"copy", "copyuserpass"}),
+                     {"copy", "copyuserpass"}).Exhaustive(),
             Parameter("computer_file", "File with computer names", ParamType::FilePath, true),
             Parameter("command", "NirCmd command to execute", ParamType::String, true)
         },
@@ -1600,7 +1661,7 @@ void NirCmdCommands::InitServiceCommands() {
         "nircmd regsvr c:\\mydll.dll",
         {
             Parameter("action", "register or unregister", ParamType::Choice, true, "register",
-                     {"register", "unregister"}),
+                     {"register", "unregister"}).Exhaustive(),
             Parameter("dll_path", "Path to DLL file", ParamType::FilePath, true)
         },
         "Services"
@@ -1612,7 +1673,7 @@ void NirCmdCommands::InitServiceCommands() {
         "nircmd gac install c:\\MyAssembly.dll",
         {
             Parameter("action", "install or uninstall", ParamType::Choice, true, "install",
-                     {"install", "uninstall"}),
+                     {"install", "uninstall"}).Exhaustive(),
             Parameter("assembly_path", "Path to assembly file", ParamType::FilePath, true)
         },
         "Services"
@@ -1633,8 +1694,8 @@ void NirCmdCommands::InitSpeechCommands() {
         "nircmd speak text \"Hello World\"",
         {
             Parameter("text", "Text to speak", ParamType::String, true),
-            Parameter("rate", "Speaking rate (-10 to 10)", ParamType::Integer, false, "0"),
-            Parameter("volume", "Volume (0-100)", ParamType::Integer, false, "100")
+            Parameter("rate", "Speaking rate (-10 to 10)", ParamType::Integer, false, "0").Range(-10, 10),
+            Parameter("volume", "Volume (0-100)", ParamType::Integer, false, "100").Range(0, 100)
         },
         "Text-to-Speech"
     ));
@@ -1645,8 +1706,8 @@ void NirCmdCommands::InitSpeechCommands() {
         "nircmd speak file c:\\text.txt",
         {
             Parameter("filepath", "Path to text file", ParamType::FilePath, true),
-            Parameter("rate", "Speaking rate (-10 to 10)", ParamType::Integer, false, "0"),
-            Parameter("volume", "Volume (0-100)", ParamType::Integer, false, "100"),
+            Parameter("rate", "Speaking rate (-10 to 10)", ParamType::Integer, false, "0").Range(-10, 10),
+            Parameter("volume", "Volume (0-100)", ParamType::Integer, false, "100").Range(0, 100),
             Parameter("output_file", "Output .wav file (optional)", ParamType::FilePath, false),
             Parameter("audio_format", "Audio format if saving", ParamType::String, false)
         },
@@ -1701,7 +1762,7 @@ void NirCmdCommands::InitScreenshotCommands() {
         {
             Parameter("filepath", "Output file path", ParamType::FilePath, true),
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "active", "foreground"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "active", "foreground"}),
             Parameter("find_value", "Window identifier", ParamType::String, true)
         },
         "Screenshots"
@@ -1723,7 +1784,7 @@ void NirCmdCommands::InitInputCommands() {
         {
             Parameter("key", "Key to send (e.g., F1, enter, ctrl+c)", ParamType::KeyCombo, true),
             Parameter("action", "press, down, or up", ParamType::Choice, true, "press",
-                     {"press", "down", "up"})
+                     {"press", "down", "up"}).Exhaustive()
         },
         "Input Simulation"
     ));
@@ -1752,14 +1813,14 @@ void NirCmdCommands::InitInputCommands() {
     
     cat.commands.push_back(Command(
         "movecursor",
-        "Move mouse cursor to position",
-        "nircmd movecursor 500 300",
+        "Move mouse cursor relative to its current position",
+        "nircmd movecursor 50 -20",
         {
-            Parameter("x", "X coordinate", ParamType::Integer, true),
-            Parameter("y", "Y coordinate", ParamType::Integer, true)
+            Parameter("x", "Horizontal offset in pixels", ParamType::Integer, true).Coalesced(),
+            Parameter("y", "Vertical offset in pixels", ParamType::Integer, true).Coalesced()
         },
         "Input Simulation"
-    ));
+    ).Coalesce(CoalesceMode::Sum, "cursor"));
     
     cat.commands.push_back(Command(
         "setcursor",
@@ -1779,7 +1840,7 @@ void NirCmdCommands::InitInputCommands() {
             Parameter("x", "X coordinate within window", ParamType::Integer, true),
             Parameter("y", "Y coordinate within window", ParamType::Integer, true),
             Parameter("find_type", "How to find the window", ParamType::Choice, true, "title",
-                     {"class", "title", "ititle", "process", "handle", "folder", "active"}),
+                     {"class", "title", "ititle", "stitle", "etitle", "process", "handle", "folder", "active"}),
             Parameter("find_value", "Window identifier", ParamType::String, true)
         },
         "Input Simulation"
@@ -1859,7 +1920,7 @@ void NirCmdCommands::InitDialogCommands() {
             Parameter("message", "Balloon message", ParamType::String, true),
             Parameter("title", "Balloon title", ParamType::String, true),
             Parameter("icon", "Icon file path (or info, warning, error)", ParamType::String, true),
-            Parameter("timeout", "Display timeout in milliseconds", ParamType::Integer, true)
+            Parameter("timeout", "Display timeout in milliseconds", ParamType::Integer, true).Range(0)
         },
         "Dialogs & Messages"
     ));
@@ -1871,7 +1932,7 @@ void NirCmdCommands::InitDialogCommands() {
         {
             Parameter("window_title", "Window title (empty for any)", ParamType::String, false),
             Parameter("window_class", "Window class (empty for any)", ParamType::String, false),
-            Parameter("action", "click", ParamType::Choice, true, "click", {"click"}),
+            Parameter("action", "click", ParamType::Choice, true, "click", {"click"}).Exhaustive(),
             Parameter("button", "Button to click (yes, no, ok, cancel, abort, retry, ignore)", ParamType::Choice, true, "ok",
                      {"yes", "no", "ok", "cancel", "abort", "retry", "ignore"})
         },
@@ -1885,7 +1946,7 @@ void NirCmdCommands::InitDialogCommands() {
         {
             Parameter("window_title", "Window title (empty for any)", ParamType::String, false),
             Parameter("window_class", "Window class (empty for any)", ParamType::String, false),
-            Parameter("action", "click", ParamType::Choice, true, "click", {"click"}),
+            Parameter("action", "click", ParamType::Choice, true, "click", {"click"}).Exhaustive(),
             Parameter("button", "Button to click", ParamType::Choice, true, "ok",
                      {"yes", "no", "ok", "cancel", "abort", "retry", "ignore"})
         },
@@ -2018,7 +2079,7 @@ void NirCmdCommands::InitMiscCommands() {
         "nircmd setconsolemode 1",
         {
             Parameter("mode", "0=windowed, 1=fullscreen", ParamType::Choice, true, "0",
-                     {"0", "1"})
+                     {"0", "1"}).Exhaustive()
         },
         "Miscellaneous"
     ));
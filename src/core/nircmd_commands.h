@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 #include <map>
@@ -11,6 +13,15 @@ enum class ParamType {
     None, String, Integer, FilePath, FolderPath, Choice, Boolean, KeyCombo, Color, Rectangle
 };
 
+// How queued runs of a command may merge before they reach nircmd. Commands
+// that share a coalescing target and the same non-coalesced arguments act on
+// the same thing (e.g. the master volume of device 0).
+enum class CoalesceMode : uint8_t {
+    None,
+    Sum,        // coalesced parameters are deltas that add up
+    Replace     // an absolute setter that overrides everything queued before it
+};
+
 struct Parameter {
     std::string name;
     std::string description;
@@ -23,6 +34,33 @@ struct Parameter {
               bool req = true, const std::string& def = "", 
               const std::vector<std::string>& ch = {})
         : name(n), description(desc), type(t), required(req), defaultValue(def), choices(ch) {}
+
+    // Accepted range for Integer parameters
+    int64_t minValue = std::numeric_limits<int64_t>::min();
+    int64_t maxValue = std::numeric_limits<int64_t>::max();
+
+    Parameter& Range(int64_t min, int64_t max = std::numeric_limits<int64_t>::max()) {
+        minValue = min;
+        maxValue = max;
+        return *this;
+    }
+
+    // Summed or replaced when queued runs merge; other parameters identify the target
+    bool coalesced = false;
+
+    Parameter& Coalesced() {
+        coalesced = true;
+        return *this;
+    }
+
+    // The choices are every value the command accepts, so anything else is
+    // rejected before it runs. Other choice lists only feed the command builder.
+    bool exhaustive = false;
+
+    Parameter& Exhaustive() {
+        exhaustive = true;
+        return *this;
+    }
 };
 
 struct Command {
@@ -36,6 +74,15 @@ struct Command {
     Command(const std::string& n, const std::string& desc, const std::string& ex,
             const std::vector<Parameter>& params, const std::string& cat)
         : name(n), description(desc), example(ex), parameters(params), category(cat) {}
+
+    CoalesceMode coalesce = CoalesceMode::None;
+    std::string coalesceTarget;
+
+    Command& Coalesce(CoalesceMode mode, const std::string& target) {
+        coalesce = mode;
+        coalesceTarget = target;
+        return *this;
+    }
 };
 
 struct Category {
@@ -75,6 +122,7 @@ private:
     static void InitDialogCommands();
     static void InitMiscCommands();
     static void InitAppGroupCommands();
+    static void InitSchedulerCommands();
 };
 
 } // namespace NirUI
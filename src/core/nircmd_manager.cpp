@@ -1,5 +1,9 @@
 #include "nircmd_manager.h"
+#include "cost_model.h"
+#include "param_validator.h"
 #include "utils/http_downloader.h"
+#include "utils/latency_stats.h"
+#include "utils/trace_recorder.h"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -12,7 +16,7 @@
 
 namespace NirUI {
 
-NirCmdManager::NirCmdManager() {
+NirCmdManager::NirCmdManager(bool discoverNow) {
     wchar_t* appDataPathW = nullptr;
     if (SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &appDataPathW))) {
         m_appDataPath = std::filesystem::path(appDataPathW) / "NirUI";
@@ -22,12 +26,18 @@ NirCmdManager::NirCmdManager() {
     }
     
     std::filesystem::create_directories(m_appDataPath);
-    FindNirCmd();
+    if (discoverNow) {
+        FindNirCmd();
+    }
 }
 
 NirCmdManager::~NirCmdManager() {
 }
 
+void NirCmdManager::Discover() {
+    FindNirCmd();
+}
+
 void NirCmdManager::FindNirCmd() {
     std::vector<std::filesystem::path> searchPaths = {
         std::filesystem::current_path() / (IsSystem64Bit() ? "nircmd.exe" : "nircmd.exe"),
@@ -37,21 +47,31 @@ void NirCmdManager::FindNirCmd() {
         std::filesystem::path("C:\\Windows\\System32\\nircmd.exe"),
     };
     
+    std::filesystem::path found;
     for (const auto& path : searchPaths) {
         if (std::filesystem::exists(path)) {
-            m_nircmdPath = path;
-            return;
+            found = path;
+            break;
         }
     }
     
-    m_nircmdPath.clear();
+    std::lock_guard<std::mutex> lock(m_pathMutex);
+    m_nircmdPath = found;
+    m_discovered = true;
+}
+
+bool NirCmdManager::IsDiscovered() const {
+    std::lock_guard<std::mutex> lock(m_pathMutex);
+    return m_discovered;
 }
 
 bool NirCmdManager::IsAvailable() const {
+    std::lock_guard<std::mutex> lock(m_pathMutex);
     return !m_nircmdPath.empty() && std::filesystem::exists(m_nircmdPath);
 }
 
 std::string NirCmdManager::GetNirCmdPath() const {
+    std::lock_guard<std::mutex> lock(m_pathMutex);
     return m_nircmdPath.string();
 }
 
@@ -133,6 +153,56 @@ bool NirCmdManager::ExtractNirCmd(const std::filesystem::path& zipPath) {
     return exitCode == 0;
 }
 
+// Starts a hidden child that inherits only its own pipe ends. With plain
+// inheritance, a child started on another thread at the same moment would also
+// inherit these handles and keep the pipes open until it exits, so parallel
+// Execute() calls would wait on each other.
+static bool CreateChildProcess(std::vector<char>& cmdBuffer, STARTUPINFOA& si, PROCESS_INFORMATION& pi) {
+    HANDLE handles[2] = { si.hStdOutput, si.hStdError };
+    DWORD handleCount = si.hStdOutput == si.hStdError ? 1 : 2;
+
+    SIZE_T size = 0;
+    InitializeProcThreadAttributeList(nullptr, 1, 0, &size);
+    std::vector<char> attributes(size);
+    auto* attributeList = reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attributes.data());
+    if (!InitializeProcThreadAttributeList(attributeList, 1, 0, &size)) return false;
+
+    STARTUPINFOEXA siEx = {};
+    siEx.StartupInfo = si;
+    siEx.StartupInfo.cb = sizeof(siEx);
+    siEx.lpAttributeList = attributeList;
+
+    BOOL created = UpdateProcThreadAttribute(attributeList, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                                             handles, handleCount * sizeof(HANDLE), nullptr, nullptr) &&
+                   CreateProcessA(nullptr, cmdBuffer.data(), nullptr, nullptr, TRUE,
+                                  CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr,
+                                  &siEx.StartupInfo, &pi);
+    DWORD err = created ? ERROR_SUCCESS : ::GetLastError();
+    DeleteProcThreadAttributeList(attributeList);
+    SetLastError(err);
+    return created != FALSE;
+}
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Records one completed run in the cost model and the latency phases, from
+// before the process was created until it was seen to exit
+static void RecordRun(CostModel* costs, const std::string& command, Clock::time_point start, Clock::time_point spawned,
+                      Clock::time_point drained, Clock::time_point exited, Clock::time_point end) {
+    auto us = [](Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    };
+    std::string name = ParamValidators::GetCommandName(command);
+    if (costs) costs->Record(CostBackend::NirCmd, name, std::chrono::duration<double, std::milli>(end - start).count());
+
+    LatencyStats& stats = LatencyStats::Get();
+    LatencyStats::SeriesId series = stats.Register("nircmd", name);
+    stats.Record(series, LatencyPhase::Spawn, us(start, spawned));
+    stats.Record(series, LatencyPhase::Drain, us(spawned, drained));
+    stats.Record(series, LatencyPhase::Run, us(spawned, exited));
+    stats.Record(series, LatencyPhase::Total, us(start, end));
+}
+
 ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForCompletion) {
     ExecutionResult result;
     result.success = false;
@@ -144,9 +214,11 @@ ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForC
         return result;
     }
     
+    TraceZone zone("NirCmdManager::Execute", command);
     auto startTime = std::chrono::high_resolution_clock::now();
+    TraceZone spawnZone("spawn");
     
-    std::string fullCommand = "\"" + m_nircmdPath.string() + "\" " + command;
+    std::string fullCommand = "\"" + GetNirCmdPath() + "\" " + command;
     
     SECURITY_ATTRIBUTES sa;
     sa.nLength = sizeof(sa);
@@ -173,8 +245,7 @@ ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForC
     std::vector<char> cmdBuffer(fullCommand.begin(), fullCommand.end());
     cmdBuffer.push_back('\0');
     
-    if (!CreateProcessA(nullptr, cmdBuffer.data(), nullptr, nullptr, TRUE,
-                       CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi)) {
+    if (!CreateChildProcess(cmdBuffer, si, pi)) {
         DWORD err = ::GetLastError();
         result.error = "Failed to create process. Error code: " + std::to_string(err);
         CloseHandle(hStdOutRead);
@@ -186,10 +257,15 @@ ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForC
     
     CloseHandle(hStdOutWrite);
     CloseHandle(hStdErrWrite);
+    auto spawnedTime = Clock::now();
+    spawnZone.End();
+    auto drainedTime = spawnedTime;
+    auto exitedTime = spawnedTime;
     
     if (waitForCompletion) {
         char buffer[4096];
         DWORD bytesRead;
+        TraceZone drainZone("drain");
         
         while (ReadFile(hStdOutRead, buffer, sizeof(buffer) - 1, &bytesRead, nullptr) && bytesRead > 0) {
             buffer[bytesRead] = '\0';
@@ -200,8 +276,13 @@ ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForC
             buffer[bytesRead] = '\0';
             result.error += buffer;
         }
+        drainedTime = Clock::now();
+        drainZone.End();
         
+        TraceZone waitZone("wait");
         WaitForSingleObject(pi.hProcess, INFINITE);
+        exitedTime = Clock::now();
+        waitZone.End();
         
         DWORD exitCode;
         GetExitCodeProcess(pi.hProcess, &exitCode);
@@ -214,6 +295,9 @@ ExecutionResult NirCmdManager::Execute(const std::string& command, bool waitForC
     
     auto endTime = std::chrono::high_resolution_clock::now();
     result.executionTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    if (waitForCompletion) {
+        RecordRun(m_costModel, command, startTime, spawnedTime, drainedTime, exitedTime, endTime);
+    }
     
     CloseHandle(hStdOutRead);
     CloseHandle(hStdErrRead);
@@ -235,9 +319,11 @@ ExecutionResult NirCmdManager::ExecuteWithCallback(const std::string& command, E
         return result;
     }
     
+    TraceZone zone("NirCmdManager::ExecuteWithCallback", command);
     auto startTime = std::chrono::high_resolution_clock::now();
+    TraceZone spawnZone("spawn");
     
-    std::string fullCommand = "\"" + m_nircmdPath.string() + "\" " + command;
+    std::string fullCommand = "\"" + GetNirCmdPath() + "\" " + command;
     
     SECURITY_ATTRIBUTES sa;
     sa.nLength = sizeof(sa);
@@ -259,8 +345,7 @@ ExecutionResult NirCmdManager::ExecuteWithCallback(const std::string& command, E
     std::vector<char> cmdBuffer(fullCommand.begin(), fullCommand.end());
     cmdBuffer.push_back('\0');
     
-    if (!CreateProcessA(nullptr, cmdBuffer.data(), nullptr, nullptr, TRUE,
-                       CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi)) {
+    if (!CreateChildProcess(cmdBuffer, si, pi)) {
         result.error = "Failed to create process";
         if (callback) callback(result.error);
         CloseHandle(hStdOutRead);
@@ -269,17 +354,25 @@ ExecutionResult NirCmdManager::ExecuteWithCallback(const std::string& command, E
     }
     
     CloseHandle(hStdOutWrite);
+    auto spawnedTime = Clock::now();
+    spawnZone.End();
     
     char buffer[1024];
     DWORD bytesRead;
+    TraceZone drainZone("drain");
     
     while (ReadFile(hStdOutRead, buffer, sizeof(buffer) - 1, &bytesRead, nullptr) && bytesRead > 0) {
         buffer[bytesRead] = '\0';
         result.output += buffer;
         if (callback) callback(std::string(buffer, bytesRead));
     }
+    auto drainedTime = Clock::now();
+    drainZone.End();
     
+    TraceZone waitZone("wait");
     WaitForSingleObject(pi.hProcess, INFINITE);
+    auto exitedTime = Clock::now();
+    waitZone.End();
     
     DWORD exitCode;
     GetExitCodeProcess(pi.hProcess, &exitCode);
@@ -288,6 +381,7 @@ ExecutionResult NirCmdManager::ExecuteWithCallback(const std::string& command, E
     
     auto endTime = std::chrono::high_resolution_clock::now();
     result.executionTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    RecordRun(m_costModel, command, startTime, spawnedTime, drainedTime, exitedTime, endTime);
     
     CloseHandle(hStdOutRead);
     CloseHandle(pi.hProcess);
@@ -296,24 +390,4 @@ ExecutionResult NirCmdManager::ExecuteWithCallback(const std::string& command, E
     return result;
 }
 
-std::string NirCmdManager::BuildCommandLine(const std::string& commandName, const std::vector<std::string>& params) {
-    std::ostringstream oss;
-    oss << commandName;
-    
-    for (const auto& param : params) {
-        oss << " ";
-        if (param.find(' ') != std::string::npos && param[0] != '"') {
-            oss << "\"" << param << "\"";
-        } else {
-            oss << param;
-        }
-    }
-    
-    return oss.str();
-}
-
-std::string NirCmdManager::GetNirCmdVersion() const {
-    return "2.87";
-}
-
 } // namespace NirUI
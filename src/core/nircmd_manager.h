@@ -1,12 +1,16 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <filesystem>
+#include <mutex>
 
 namespace NirUI {
 
+class CostModel;
+
 struct ExecutionResult {
     int exitCode;
     std::string output;
@@ -19,22 +23,36 @@ using ExecutionCallback = std::function<void(const std::string& output)>;
 
 class NirCmdManager {
 public:
-    NirCmdManager();
+    explicit NirCmdManager(bool discoverNow = true);
     ~NirCmdManager();
     
+    // Probes the search paths for nircmd.exe. Safe to call from a worker thread.
+    void Discover();
+    bool IsDiscovered() const;
     bool IsAvailable() const;
     std::string GetNirCmdPath() const;
     bool DownloadNirCmd(std::function<void(int progress, const std::string& status)> progressCallback = nullptr);
     ExecutionResult Execute(const std::string& command, bool waitForCompletion = true);
     ExecutionResult ExecuteWithCallback(const std::string& command, ExecutionCallback callback);
     static std::string BuildCommandLine(const std::string& commandName, const std::vector<std::string>& params);
+    // Appends one argument using the CommandLineToArgvW quoting rules. Values that are
+    // already wrapped in double quotes are passed through untouched.
+    static void AppendQuotedArgument(std::string& out, std::string_view arg);
+    // Same rules without the pass-through, for untrusted values: the result
+    // always parses back to exactly arg
+    static void AppendEscapedArgument(std::string& out, std::string_view arg);
     std::filesystem::path GetAppDataPath() const;
     std::string GetNirCmdVersion() const;
     bool IsSystem64Bit() const;
+    // Every completed run is recorded in the model. Set before commands run.
+    void SetCostModel(CostModel* model) { m_costModel = model; }
     
 private:
     std::filesystem::path m_nircmdPath;
     std::filesystem::path m_appDataPath;
+    mutable std::mutex m_pathMutex;
+    bool m_discovered = false;
+    CostModel* m_costModel = nullptr;
     
     void FindNirCmd();
     bool ExtractNirCmd(const std::filesystem::path& zipPath);
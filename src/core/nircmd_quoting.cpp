@@ -0,0 +1,54 @@
+#include "nircmd_manager.h"
+
+// Command line building shared with the CLI, scripts and tests; nothing here
+// needs Windows
+
+namespace NirUI {
+
+std::string NirCmdManager::BuildCommandLine(const std::string& commandName, const std::vector<std::string>& params) {
+    std::string cmdLine = commandName;
+    for (const auto& param : params) {
+        cmdLine += ' ';
+        AppendQuotedArgument(cmdLine, param);
+    }
+    return cmdLine;
+}
+
+void NirCmdManager::AppendQuotedArgument(std::string& out, std::string_view arg) {
+    if (arg.size() >= 2 && arg.front() == '"' && arg.back() == '"') {
+        out += arg;
+        return;
+    }
+    AppendEscapedArgument(out, arg);
+}
+
+void NirCmdManager::AppendEscapedArgument(std::string& out, std::string_view arg) {
+    if (!arg.empty() && arg.find_first_of(" \t\"") == std::string_view::npos) {
+        out += arg;
+        return;
+    }
+
+    out += '"';
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        if (c == '"') {
+            out.append(backslashes * 2 + 1, '\\');
+        } else {
+            out.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        out += c;
+    }
+    out.append(backslashes * 2, '\\');
+    out += '"';
+}
+
+std::string NirCmdManager::GetNirCmdVersion() const {
+    return "2.87";
+}
+
+} // namespace NirUI
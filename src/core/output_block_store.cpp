@@ -0,0 +1,72 @@
+#include "output_block_store.h"
+#include "utils/lz_codec.h"
+#include <algorithm>
+
+namespace NirUI {
+
+OutputBlockStore::OutputBlockStore(size_t byteBudget) : m_budget(byteBudget) {}
+
+size_t OutputBlockStore::StoredSize(const Block& block) {
+    return sizeof(Block) + block.data.size();
+}
+
+void OutputBlockStore::Put(uint64_t id, std::string_view output) {
+    if (output.empty() || output.size() > UINT32_MAX) return;
+
+    Block block;
+    block.id = id;
+    block.rawSize = static_cast<uint32_t>(output.size());
+    if (output.size() >= MIN_COMPRESS_SIZE) {
+        std::string compressed = CompressBlock(output);
+        if (compressed.size() < output.size()) {
+            block.data = std::move(compressed);
+            block.compressed = true;
+        }
+    }
+    if (!block.compressed) block.data.assign(output);
+    block.data.shrink_to_fit();
+
+    m_storedBytes += StoredSize(block);
+    m_rawBytes += sizeof(Block) + output.size();
+    m_blocks.push_back(std::move(block));
+    Evict();
+}
+
+bool OutputBlockStore::Get(uint64_t id, std::string& output) const {
+    const Block* block = Find(id);
+    if (!block) return false;
+
+    if (!block->compressed) {
+        output = block->data;
+        return true;
+    }
+    return DecompressBlock(block->data, block->rawSize, output);
+}
+
+void OutputBlockStore::Clear() {
+    m_blocks.clear();
+    m_storedBytes = 0;
+    m_rawBytes = 0;
+}
+
+void OutputBlockStore::SetBudget(size_t byteBudget) {
+    m_budget = byteBudget;
+    Evict();
+}
+
+const OutputBlockStore::Block* OutputBlockStore::Find(uint64_t id) const {
+    auto it = std::lower_bound(m_blocks.begin(), m_blocks.end(), id,
+                               [](const Block& block, uint64_t value) { return block.id < value; });
+    return it != m_blocks.end() && it->id == id ? &*it : nullptr;
+}
+
+void OutputBlockStore::Evict() {
+    while (m_storedBytes > m_budget && !m_blocks.empty()) {
+        const Block& oldest = m_blocks.front();
+        m_storedBytes -= StoredSize(oldest);
+        m_rawBytes -= sizeof(Block) + oldest.rawSize;
+        m_blocks.pop_front();
+    }
+}
+
+} // namespace NirUI
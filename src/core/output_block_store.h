@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+
+namespace NirUI {
+
+// In-memory store of command outputs, each compressed on insert and
+// decompressed only when asked for. Outputs are keyed by increasing ids (the
+// history index), and the oldest are evicted once the byte budget is exceeded.
+// Short or incompressible outputs are kept as they are.
+class OutputBlockStore {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 1024 * 1024;
+    static constexpr size_t MIN_COMPRESS_SIZE = 32;
+
+    explicit OutputBlockStore(size_t byteBudget = DEFAULT_BUDGET);
+
+    // Ids must increase from one call to the next; empty outputs are not stored
+    void Put(uint64_t id, std::string_view output);
+    bool Get(uint64_t id, std::string& output) const;
+    bool Contains(uint64_t id) const { return Find(id) != nullptr; }
+    void Clear();
+
+    void SetBudget(size_t byteBudget);
+    size_t GetBudget() const { return m_budget; }
+    size_t GetCount() const { return m_blocks.size(); }
+    // Memory held for the outputs, including per-block bookkeeping
+    size_t GetStoredBytes() const { return m_storedBytes; }
+    // What the same outputs would take uncompressed
+    size_t GetRawBytes() const { return m_rawBytes; }
+
+private:
+    struct Block {
+        uint64_t id = 0;
+        uint32_t rawSize = 0;
+        bool compressed = false;
+        std::string data;
+    };
+
+    static size_t StoredSize(const Block& block);
+    const Block* Find(uint64_t id) const;
+    void Evict();
+
+    std::deque<Block> m_blocks;
+    size_t m_budget;
+    size_t m_storedBytes = 0;
+    size_t m_rawBytes = 0;
+};
+
+} // namespace NirUI
@@ -0,0 +1,351 @@
+#include "param_validator.h"
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+namespace NirUI {
+
+namespace {
+
+constexpr std::string_view KEY_MODIFIERS[] = { "ctrl", "alt", "shift", "win", "lwin", "rwin" };
+
+char ToLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool EqualsNoCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (ToLower(a[i]) != ToLower(b[i])) return false;
+    }
+    return true;
+}
+
+bool EndsWith(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+bool IsValuelessFinder(std::string_view findType) {
+    constexpr std::string_view finders[] = { "active", "foreground", "desktop", "alltop", "alltopnodesktop" };
+    for (auto finder : finders) {
+        if (EqualsNoCase(findType, finder)) return true;
+    }
+    return false;
+}
+
+uint32_t HashChoice(std::string_view value, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : value) {
+        hash ^= static_cast<unsigned char>(ToLower(c));
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+// Decimal with an optional sign, or 0x hex
+bool ParseInteger(std::string_view text, int64_t& value) {
+    if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+    int base = 10;
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+        base = 16;
+    }
+    if (text.empty()) return false;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    return ec == std::errc() && end == text.data() + text.size();
+}
+
+bool ParseIntegerInRange(std::string_view text, int64_t min, int64_t max) {
+    int64_t value = 0;
+    return ParseInteger(text, value) && value >= min && value <= max;
+}
+
+bool IsBoolWord(std::string_view value) {
+    constexpr std::string_view words[] = { "0", "1", "true", "false", "yes", "no", "on", "off" };
+    for (auto word : words) {
+        if (EqualsNoCase(value, word)) return true;
+    }
+    return false;
+}
+
+// A bool word, or the flag forms NirUI and nircmd accept: NAME, --NAME, -N and NAME=BOOL
+bool IsBoolArgument(std::string_view value, std::string_view name) {
+    if (IsBoolWord(value) || EqualsNoCase(value, name)) return true;
+    if (value.size() == 2 && value[0] == '-' && !name.empty() && ToLower(value[1]) == ToLower(name[0])) return true;
+    if (value.size() > 2 && value.substr(0, 2) == "--") return EqualsNoCase(value.substr(2), name);
+    size_t equals = value.find('=');
+    return equals != std::string_view::npos && EqualsNoCase(value.substr(0, equals), name) &&
+           IsBoolWord(value.substr(equals + 1));
+}
+
+bool IsKeyName(std::string_view key) {
+    if (key.size() == 1) return key[0] > ' ' && key[0] < 127;
+    if ((key[0] == 'f' || key[0] == 'F') && key.size() <= 3) {
+        return ParseIntegerInRange(key.substr(1), 1, 24);
+    }
+    if (key.size() > 2 && key[0] == '0' && (key[1] == 'x' || key[1] == 'X')) {
+        return ParseIntegerInRange(key, 1, 0xFF);
+    }
+    for (char c : key) {
+        bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (!word) return false;
+    }
+    return key.size() <= 24;
+}
+
+// Modifiers joined by '+', optionally ending in one key: "ctrl+shift+esc", "f5", "0x41"
+bool IsKeyCombo(std::string_view combo) {
+    if (combo.empty()) return false;
+    while (true) {
+        size_t plus = combo.find('+', 1);
+        std::string_view part = combo.substr(0, plus);
+        if (part.empty()) return false;
+        if (plus == std::string_view::npos) return IsKeyName(part);
+
+        bool modifier = false;
+        for (auto name : KEY_MODIFIERS) {
+            if (EqualsNoCase(part, name)) modifier = true;
+        }
+        if (!modifier) return false;
+        combo.remove_prefix(plus + 1);
+        if (combo.empty()) return false;
+    }
+}
+
+// Splits "a,b,c" into exactly count integers within [min, max]
+bool ParseIntegerList(std::string_view text, size_t count, int64_t* values, int64_t min, int64_t max) {
+    for (size_t i = 0; i < count; ++i) {
+        size_t comma = text.find(',');
+        if ((comma == std::string_view::npos) != (i + 1 == count)) return false;
+        if (!ParseInteger(text.substr(0, comma), values[i]) || values[i] < min || values[i] > max) return false;
+        if (comma != std::string_view::npos) text.remove_prefix(comma + 1);
+    }
+    return true;
+}
+
+// #RRGGBB, RRGGBB or R,G,B
+bool IsColor(std::string_view value) {
+    std::string_view hex = (!value.empty() && value[0] == '#') ? value.substr(1) : value;
+    if (hex.size() == 6 && hex.find_first_not_of("0123456789abcdefABCDEF") == std::string_view::npos) return true;
+    int64_t rgb[3];
+    return ParseIntegerList(value, 3, rgb, 0, 255);
+}
+
+// X,Y,WIDTH,HEIGHT
+bool IsRectangle(std::string_view value) {
+    int64_t rect[4];
+    return ParseIntegerList(value, 4, rect, INT32_MIN, INT32_MAX) && rect[2] >= 0 && rect[3] >= 0;
+}
+
+} // namespace
+
+CommandValidator::CommandValidator(const Command& command) : m_command(command) {
+    // Far above any real choice list; a table this large means the hash is broken
+    constexpr uint32_t MAX_CHOICE_TABLE = 1u << 16;
+
+    const auto& params = command.parameters;
+    m_slots.reserve(params.size());
+    for (size_t index = 0; index < params.size(); ++index) {
+        const Parameter& param = params[index];
+        if (param.required) m_requiredCount++;
+
+        Slot slot;
+        slot.param = &param;
+        slot.findsWindow = param.type == ParamType::Choice && EndsWith(param.name, "find_type") &&
+                           index + 1 < params.size() && EndsWith(params[index + 1].name, "find_value");
+
+        // Choices equal apart from case would share a bucket under every seed
+        std::vector<std::string_view> choices;
+        if (param.type == ParamType::Choice && param.exhaustive) {
+            for (const auto& choice : param.choices) {
+                bool duplicate = false;
+                for (auto existing : choices) {
+                    if (EqualsNoCase(existing, choice)) duplicate = true;
+                }
+                if (!duplicate) choices.push_back(choice);
+            }
+        }
+
+        if (!choices.empty()) {
+            // Smallest power-of-two table with a collision-free seed
+            uint32_t size = 1;
+            while (size < choices.size()) size <<= 1;
+            bool placed = false;
+            while (!placed && size <= MAX_CHOICE_TABLE) {
+                for (uint32_t seed = 0; seed < 256 && !placed; ++seed) {
+                    slot.choiceTable.assign(size, std::string_view());
+                    placed = true;
+                    for (auto choice : choices) {
+                        std::string_view& bucket = slot.choiceTable[HashChoice(choice, seed) & (size - 1)];
+                        if (!bucket.empty()) {
+                            placed = false;
+                            break;
+                        }
+                        bucket = choice;
+                    }
+                    if (placed) slot.choiceSeed = seed;
+                }
+                if (!placed) size <<= 1;
+            }
+            assert(placed);
+            if (placed) {
+                slot.choiceMask = size - 1;
+                for (auto choice : choices) {
+                    slot.maxChoiceLength = std::max(slot.maxChoiceLength, choice.size());
+                }
+            } else {
+                slot.choiceTable.clear();
+            }
+        }
+        m_slots.push_back(std::move(slot));
+    }
+}
+
+bool CommandValidator::CheckValue(const Slot& slot, std::string_view value) const {
+    const Parameter& param = *slot.param;
+    switch (param.type) {
+    case ParamType::Integer:
+        return ParseIntegerInRange(value, param.minValue, param.maxValue);
+    case ParamType::Choice: {
+        if (slot.choiceTable.empty()) return true;
+        if (value.size() > slot.maxChoiceLength) return false;
+        std::string_view bucket = slot.choiceTable[HashChoice(value, slot.choiceSeed) & slot.choiceMask];
+        return !bucket.empty() && EqualsNoCase(bucket, value);
+    }
+    case ParamType::Boolean:
+        return IsBoolArgument(value, param.name);
+    case ParamType::KeyCombo:
+        return IsKeyCombo(value);
+    case ParamType::Color:
+        return IsColor(value);
+    case ParamType::Rectangle:
+        return IsRectangle(value);
+    default:
+        return true;
+    }
+}
+
+std::string CommandValidator::Describe(const Slot& slot) const {
+    const Parameter& param = *slot.param;
+    switch (param.type) {
+    case ParamType::Integer: {
+        std::string text = "must be an integer";
+        bool hasMin = param.minValue != std::numeric_limits<int64_t>::min();
+        bool hasMax = param.maxValue != std::numeric_limits<int64_t>::max();
+        if (hasMin && hasMax) {
+            text += " from " + std::to_string(param.minValue) + " to " + std::to_string(param.maxValue);
+        } else if (hasMin) {
+            text += " of at least " + std::to_string(param.minValue);
+        }
+        return text;
+    }
+    case ParamType::Choice: {
+        std::string text = "must be one of:";
+        for (const auto& choice : param.choices) text += " " + choice;
+        return text;
+    }
+    case ParamType::Boolean:
+        return "must be 0/1, true/false or " + param.name;
+    case ParamType::KeyCombo:
+        return "must be a key combination such as ctrl+shift+esc";
+    case ParamType::Color:
+        return "must be a color (#RRGGBB or R,G,B)";
+    case ParamType::Rectangle:
+        return "must be a rectangle (X,Y,WIDTH,HEIGHT)";
+    default:
+        return "is invalid";
+    }
+}
+
+bool CommandValidator::Validate(const CommandTokens& tokens, size_t first, std::string& error) const {
+    size_t argCount = tokens.GetCount() > first ? tokens.GetCount() - first : 0;
+
+    // Match arguments to parameters first: a valueless finder drops the
+    // find_value parameter, and a wrong count is reported before a wrong value
+    size_t requiredCount = m_requiredCount;
+    const Slot* invalidSlot = nullptr;
+    std::string_view invalidValue;
+    size_t arg = 0;
+    for (size_t i = 0; i < m_slots.size() && arg < argCount; ++i) {
+        const Slot& slot = m_slots[i];
+        std::string_view value = tokens[first + arg++];
+        if (!invalidSlot && !CheckValue(slot, value)) {
+            invalidSlot = &slot;
+            invalidValue = value;
+        }
+        if (slot.findsWindow && IsValuelessFinder(value)) {
+            if (m_slots[++i].param->required) requiredCount--;
+        }
+    }
+
+    if (argCount < requiredCount) {
+        error = m_command.name + " expects at least " + std::to_string(requiredCount) + " argument(s), got " +
+                std::to_string(argCount);
+        return false;
+    }
+    if (invalidSlot) {
+        error = m_command.name + ": " + invalidSlot->param->name + " " + Describe(*invalidSlot) + ", got '" +
+                std::string(invalidValue) + "'";
+        return false;
+    }
+    return true;
+}
+
+const CommandValidator* ParamValidators::Find(std::string_view commandName) {
+    static const auto validators = []() {
+        std::unordered_map<std::string_view, CommandValidator> map;
+        for (const auto& category : NirCmdCommands::GetCategories()) {
+            for (const auto& cmd : category.commands) {
+                map.try_emplace(cmd.name, cmd);
+            }
+        }
+        return map;
+    }();
+
+    auto it = validators.find(commandName);
+    return it != validators.end() ? &it->second : nullptr;
+}
+
+std::string ParamValidators::GetCommandName(std::string_view commandLine) {
+    CommandTokens tokens(commandLine);
+    if (tokens.IsEmpty()) return std::string();
+
+    std::string name(tokens[0]);
+    if (!tokens[1].empty()) {
+        std::string twoWords = name + " " + std::string(tokens[1]);
+        if (Find(twoWords)) return twoWords;
+    }
+    return name;
+}
+
+bool ParamValidators::Validate(const CommandTokens& tokens, std::string& error, bool* known) {
+    const CommandValidator* validator = nullptr;
+    size_t first = 2;
+
+    // Two-word commands such as "win close" take precedence over one-word ones
+    std::array<char, 64> name;
+    std::string_view verb = tokens[0];
+    std::string_view sub = tokens[1];
+    if (!sub.empty() && verb.size() + 1 + sub.size() <= name.size()) {
+        std::memcpy(name.data(), verb.data(), verb.size());
+        name[verb.size()] = ' ';
+        std::memcpy(name.data() + verb.size() + 1, sub.data(), sub.size());
+        validator = Find(std::string_view(name.data(), verb.size() + 1 + sub.size()));
+    }
+    if (!validator) {
+        validator = Find(verb);
+        first = 1;
+    }
+
+    if (known) *known = validator != nullptr;
+    return !validator || validator->Validate(tokens, first, error);
+}
+
+bool ParamValidators::Validate(std::string_view commandLine, std::string& error) {
+    CommandTokens tokens(commandLine);
+    return tokens.IsEmpty() || Validate(tokens, error);
+}
+
+} // namespace NirUI
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "command_tokenizer.h"
+#include "nircmd_commands.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+// Argument checks for one registry command, compiled from its parameter
+// metadata: integer ranges, exhaustive choice sets as perfect-hash tables, and
+// the key combination, color and rectangle grammars. Checking allocates only to
+// build an error message.
+//
+// Window finders are a *find_type choice followed by its *find_value. Finders
+// that name no window (active, foreground, desktop, alltop, alltopnodesktop)
+// take no value, so the arguments after them move up one parameter.
+class CommandValidator {
+public:
+    explicit CommandValidator(const Command& command);
+
+    // Checks tokens[first...] against the parameters. Arguments past the last
+    // parameter are passed through unchecked.
+    bool Validate(const CommandTokens& tokens, size_t first, std::string& error) const;
+
+    const Command& GetCommand() const { return m_command; }
+
+private:
+    struct Slot {
+        const Parameter* param = nullptr;
+        // The next slot is this finder's value
+        bool findsWindow = false;
+        // Choice parameters: one choice (or nothing) per hash bucket
+        std::vector<std::string_view> choiceTable;
+        uint32_t choiceSeed = 0;
+        uint32_t choiceMask = 0;
+        size_t maxChoiceLength = 0;
+    };
+
+    bool CheckValue(const Slot& slot, std::string_view value) const;
+    std::string Describe(const Slot& slot) const;
+
+    const Command& m_command;
+    std::vector<Slot> m_slots;
+    size_t m_requiredCount = 0;
+};
+
+// Validators for the whole registry, compiled on first use. Every front end
+// checks a command line here before anything is spawned.
+class ParamValidators {
+public:
+    static const CommandValidator* Find(std::string_view commandName);
+    // Registry name of the command on the line: two words ("win close") when
+    // the registry has them, else the first word
+    static std::string GetCommandName(std::string_view commandLine);
+
+    // Finds the command in tokens (two-word names first) and checks its
+    // arguments. Commands outside the registry pass; known reports whether the
+    // command was found.
+    static bool Validate(const CommandTokens& tokens, std::string& error, bool* known = nullptr);
+    static bool Validate(std::string_view commandLine, std::string& error);
+};
+
+} // namespace NirUI
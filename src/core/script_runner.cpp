@@ -0,0 +1,183 @@
+#include "script_runner.h"
+#include "command_tokenizer.h"
+#include "cost_model.h"
+#include "meta_commands.h"
+#include "param_validator.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+
+namespace NirUI {
+
+namespace {
+
+struct CompletedCommand {
+    ExecutionResult result;
+    double latencyMs = 0;
+};
+
+std::string_view Trim(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string_view::npos) return std::string_view();
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+bool ScriptRunner::Load(const std::filesystem::path& path, std::string& error) {
+    m_text.clear();
+    if (!m_file.Open(path)) {
+        m_lines.clear();
+        error = "Cannot open script: " + path.string();
+        return false;
+    }
+    Parse(m_file.GetView(), {});
+    return true;
+}
+
+void ScriptRunner::LoadText(std::string text, std::vector<uint32_t> sourceLines) {
+    m_file.Close();
+    m_text = std::move(text);
+    Parse(m_text, sourceLines);
+}
+
+void ScriptRunner::Parse(std::string_view text, const std::vector<uint32_t>& sourceLines) {
+    m_lines.clear();
+    if (text.substr(0, 3) == "\xEF\xBB\xBF") text.remove_prefix(3);
+
+    uint32_t lineNumber = 0;
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view raw = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        lineNumber++;
+
+        std::string_view command = Trim(raw);
+        if (command.empty() || command[0] == '#') continue;
+
+        ScriptLine line;
+        line.lineNumber = lineNumber <= sourceLines.size() ? sourceLines[lineNumber - 1] : lineNumber;
+        if (command[0] == '!') {
+            line.barrier = true;
+            command = Trim(command.substr(1));
+        }
+        line.command = command;
+        if (!line.barrier) line.barrier = IsMetaCommand(command);
+        m_lines.push_back(line);
+    }
+}
+
+std::vector<std::string> ScriptRunner::Validate() const {
+    std::vector<std::string> problems;
+    std::string error;
+    for (const auto& line : m_lines) {
+        // NirUI's own commands are not in the registry; they report usage
+        // errors when they run
+        CommandTokens tokens(line.command);
+        if (tokens.IsEmpty() || IsMetaCommand(line.command)) continue;
+
+        // Unlike the interactive front ends, scripts reject commands the
+        // registry does not know, which catches typos before any line runs
+        bool known = false;
+        std::string prefix = "line " + std::to_string(line.lineNumber) + ": ";
+        if (!ParamValidators::Validate(tokens, error, &known)) {
+            problems.push_back(prefix + error);
+        } else if (!known) {
+            problems.push_back(prefix + "unknown command '" + std::string(tokens[0]) + "'");
+        }
+    }
+    return problems;
+}
+
+ScriptSummary ScriptRunner::Run(size_t jobs, const Executor& execute, const BarrierExecutor& executeBarrier,
+                                const ResultCallback& onResult, const CostModel* costs) const {
+    ScriptSummary summary;
+    summary.latenciesMs.reserve(m_lines.size());
+    auto start = std::chrono::steady_clock::now();
+
+    jobs = std::max<size_t>(jobs, 1);
+    ThreadPool pool(jobs);
+
+    // Lines between barriers go out in batches of a few times the job count.
+    // Within a batch the slowest commands are submitted first, so a slow one
+    // does not start last and leave the other workers idle. The next batch
+    // is submitted before the previous one is collected, keeping workers busy,
+    // and results are reported in line order.
+    const size_t window = jobs * 4;
+    using Batch = std::vector<std::pair<const ScriptLine*, std::future<CompletedCommand>>>;
+    std::deque<Batch> inFlight;
+    std::vector<const ScriptLine*> pending;
+    std::vector<std::pair<double, size_t>> order;
+
+    auto report = [&](const ScriptLine& line, const CompletedCommand& completed) {
+        summary.commands++;
+        if (!completed.result.success) summary.failed++;
+        summary.latenciesMs.push_back(completed.latencyMs);
+        onResult(line, completed.result);
+    };
+    auto finishOldest = [&]() {
+        for (auto& [line, result] : inFlight.front()) {
+            report(*line, result.get());
+        }
+        inFlight.pop_front();
+    };
+    auto submitPending = [&]() {
+        if (pending.empty()) return;
+
+        order.clear();
+        for (size_t i = 0; i < pending.size(); ++i) {
+            order.emplace_back(costs ? EstimateCommandMs(*costs, pending[i]->command) : 0.0, i);
+        }
+        std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        Batch batch(pending.size());
+        for (const auto& [cost, index] : order) {
+            batch[index].first = pending[index];
+            batch[index].second = pool.Submit([&execute, command = std::string(pending[index]->command)]() {
+                CompletedCommand completed;
+                auto commandStart = std::chrono::steady_clock::now();
+                completed.result = execute(command);
+                completed.latencyMs = ElapsedMs(commandStart);
+                return completed;
+            });
+        }
+        pending.clear();
+        if (!inFlight.empty()) finishOldest();
+        inFlight.push_back(std::move(batch));
+    };
+
+    for (const auto& line : m_lines) {
+        if (line.barrier) {
+            submitPending();
+            while (!inFlight.empty()) finishOldest();
+            if (line.command.empty()) continue;
+
+            CompletedCommand completed;
+            auto commandStart = std::chrono::steady_clock::now();
+            std::string command(line.command);
+            if (!executeBarrier(command, completed.result)) {
+                completed.result = execute(command);
+            }
+            completed.latencyMs = ElapsedMs(commandStart);
+            report(line, completed);
+            continue;
+        }
+
+        pending.push_back(&line);
+        if (pending.size() >= window) submitPending();
+    }
+    submitPending();
+    while (!inFlight.empty()) finishOldest();
+
+    summary.wallTimeMs = ElapsedMs(start);
+    return summary;
+}
+
+} // namespace NirUI
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "nircmd_manager.h"
+#include "utils/mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+class CostModel;
+
+struct ScriptLine {
+    uint32_t lineNumber = 0;
+    // Command text with the barrier marker and surrounding whitespace removed;
+    // empty for a bare "!" barrier
+    std::string_view command;
+    // Runs after every earlier line has finished and before any later line starts
+    bool barrier = false;
+};
+
+struct ScriptSummary {
+    size_t commands = 0;
+    size_t failed = 0;
+    double wallTimeMs = 0;
+    // Per-command latency in line order
+    std::vector<double> latenciesMs;
+};
+
+// Batch runner for command files. The file is memory-mapped and split into
+// lines that point into the mapping; blank lines and lines starting with '#'
+// are skipped. Lines run in parallel up to the job limit, except barriers: a
+// line starting with '!' (or a bare "!") waits for everything before it and
+// runs alone. Meta-commands are always barriers because they change app groups
+// and window state that later lines may depend on.
+class ScriptRunner {
+public:
+    // Runs a command on a worker thread
+    using Executor = std::function<ExecutionResult(const std::string& command)>;
+    // Runs a barrier command on the calling thread; returns false if it is not
+    // a meta-command and should go to the executor instead
+    using BarrierExecutor = std::function<bool(const std::string& command, ExecutionResult& result)>;
+    // Called on the calling thread, in line order, as results come in
+    using ResultCallback = std::function<void(const ScriptLine& line, const ExecutionResult& result)>;
+
+    bool Load(const std::filesystem::path& path, std::string& error);
+    // Takes the script from memory instead, e.g. commands expanded from a
+    // template. sourceLines, if given, holds the line number to report for each
+    // line of text.
+    void LoadText(std::string text, std::vector<uint32_t> sourceLines = {});
+    // Checks every command against the registry before anything runs. Returns
+    // one message per problem, prefixed with the line number.
+    std::vector<std::string> Validate() const;
+    // With a cost model, the slowest lines of each batch are started first
+    ScriptSummary Run(size_t jobs, const Executor& execute, const BarrierExecutor& executeBarrier,
+                      const ResultCallback& onResult, const CostModel* costs = nullptr) const;
+
+    const std::vector<ScriptLine>& GetLines() const { return m_lines; }
+
+private:
+    void Parse(std::string_view text, const std::vector<uint32_t>& sourceLines);
+
+    MappedFile m_file;
+    std::string m_text;
+    std::vector<ScriptLine> m_lines;
+};
+
+} // namespace NirUI
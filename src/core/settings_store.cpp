@@ -0,0 +1,334 @@
+#include "settings_store.h"
+#include "utils/atomic_file.h"
+#include "utils/mapped_file.h"
+#include <cstring>
+
+namespace NirUI {
+
+static const char STORE_MAGIC[8] = { 'N', 'I', 'R', 'S', 'T', 'O', 'R', 'E' };
+
+// Saves keep being postponed while changes arrive, but never by more than this
+// many debounce periods.
+static constexpr int MAX_DEBOUNCE_PERIODS = 4;
+
+namespace {
+
+template <typename T>
+void AppendValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendString(std::string& out, const std::string& value) {
+    AppendValue(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename T>
+    bool Read(T& value) {
+        if (m_size - m_pos < sizeof(T)) return false;
+        memcpy(&value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string& value) {
+        uint32_t length = 0;
+        if (!Read(length) || m_size - m_pos < length) return false;
+        value.assign(reinterpret_cast<const char*>(m_data + m_pos), length);
+        m_pos += length;
+        return true;
+    }
+
+    bool ReadBytes(const unsigned char*& bytes, size_t length) {
+        if (m_size - m_pos < length) return false;
+        bytes = m_data + m_pos;
+        m_pos += length;
+        return true;
+    }
+
+    size_t GetPosition() const { return m_pos; }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+SettingsStore::SettingsStore(std::filesystem::path path) : m_path(std::move(path)) {
+}
+
+SettingsStore::~SettingsStore() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_saverCondition.notify_all();
+    if (m_saverThread.joinable()) {
+        m_saverThread.join();
+    }
+    Commit();
+}
+
+bool SettingsStore::Exists() const {
+    std::error_code ec;
+    return std::filesystem::exists(m_path, ec);
+}
+
+bool SettingsStore::Load() {
+    MappedFile file;
+    if (!file.Open(m_path)) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sections.clear();
+    m_needsWrite = false;
+    if (!Parse(file.GetData(), file.GetSize())) {
+        m_sections.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SettingsStore::Parse(const unsigned char* data, size_t size) {
+    if (!data || size < sizeof(STORE_MAGIC) || memcmp(data, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0) {
+        return false;
+    }
+
+    Reader reader(data + sizeof(STORE_MAGIC), size - sizeof(STORE_MAGIC));
+    uint32_t version = 0;
+    uint32_t sectionCount = 0;
+    if (!reader.Read(version) || version != VERSION || !reader.Read(sectionCount)) return false;
+
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        size_t start = reader.GetPosition();
+        std::string name;
+        uint8_t type = 0;
+        uint64_t payloadSize = 0;
+        const unsigned char* payload = nullptr;
+        if (!reader.ReadString(name) || !reader.Read(type) || !reader.Read(payloadSize) ||
+            !reader.ReadBytes(payload, static_cast<size_t>(payloadSize))) {
+            return false;
+        }
+
+        Reader rows(payload, static_cast<size_t>(payloadSize));
+        uint32_t rowCount = 0;
+        if (!rows.Read(rowCount)) return false;
+
+        Section section;
+        section.type = static_cast<SectionType>(type);
+        section.rows.reserve(std::min<size_t>(rowCount, static_cast<size_t>(payloadSize) / sizeof(uint32_t)));
+        for (uint32_t r = 0; r < rowCount; ++r) {
+            uint32_t fieldCount = 0;
+            if (!rows.Read(fieldCount)) return false;
+
+            Row row;
+            row.reserve(std::min<size_t>(fieldCount, 64));
+            for (uint32_t f = 0; f < fieldCount; ++f) {
+                std::string field;
+                if (!rows.ReadString(field)) return false;
+                row.push_back(std::move(field));
+            }
+            section.rows.push_back(std::move(row));
+        }
+
+        // The file bytes stay valid until the section changes, so keep them as the encoding
+        const unsigned char* sectionStart = data + sizeof(STORE_MAGIC) + start;
+        section.encoded.assign(reinterpret_cast<const char*>(sectionStart), reader.GetPosition() - start);
+        section.dirty = false;
+        m_sections[name] = std::move(section);
+    }
+    return true;
+}
+
+std::string SettingsStore::EncodeSection(const std::string& name, const Section& section) {
+    std::string payload;
+    AppendValue(payload, static_cast<uint32_t>(section.rows.size()));
+    for (const auto& row : section.rows) {
+        AppendValue(payload, static_cast<uint32_t>(row.size()));
+        for (const auto& field : row) {
+            AppendString(payload, field);
+        }
+    }
+
+    std::string encoded;
+    encoded.reserve(name.size() + payload.size() + 32);
+    AppendString(encoded, name);
+    AppendValue(encoded, static_cast<uint8_t>(section.type));
+    AppendValue(encoded, static_cast<uint64_t>(payload.size()));
+    encoded.append(payload);
+    return encoded;
+}
+
+bool SettingsStore::HasSection(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sections.count(name) > 0;
+}
+
+std::vector<SettingsStore::Row> SettingsStore::GetRows(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sections.find(name);
+    if (it == m_sections.end()) return {};
+    return it->second.rows;
+}
+
+std::map<std::string, std::string> SettingsStore::GetKeyValues(const std::string& name) const {
+    std::map<std::string, std::string> values;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sections.find(name);
+    if (it == m_sections.end()) return values;
+
+    for (const auto& row : it->second.rows) {
+        if (row.size() >= 2) values[row[0]] = row[1];
+    }
+    return values;
+}
+
+std::vector<std::string> SettingsStore::GetList(const std::string& name) const {
+    std::vector<std::string> values;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sections.find(name);
+    if (it == m_sections.end()) return values;
+
+    values.reserve(it->second.rows.size());
+    for (const auto& row : it->second.rows) {
+        if (!row.empty()) values.push_back(row[0]);
+    }
+    return values;
+}
+
+void SettingsStore::SetRows(const std::string& name, SectionType type, std::vector<Row> rows) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Section& section = m_sections[name];
+    if (!section.dirty && section.type == type && section.rows == rows) return;
+
+    section.type = type;
+    section.rows = std::move(rows);
+    section.dirty = true;
+    m_needsWrite = true;
+}
+
+void SettingsStore::SetKeyValues(const std::string& name, const std::map<std::string, std::string>& values) {
+    std::vector<Row> rows;
+    rows.reserve(values.size());
+    for (const auto& [key, value] : values) {
+        rows.push_back({ key, value });
+    }
+    SetRows(name, SectionType::KeyValue, std::move(rows));
+}
+
+void SettingsStore::SetList(const std::string& name, const std::vector<std::string>& values) {
+    std::vector<Row> rows;
+    rows.reserve(values.size());
+    for (const auto& value : values) {
+        rows.push_back({ value });
+    }
+    SetRows(name, SectionType::List, std::move(rows));
+}
+
+void SettingsStore::RemoveSection(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_sections.erase(name) > 0) {
+        m_needsWrite = true;
+    }
+}
+
+bool SettingsStore::IsDirty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_needsWrite;
+}
+
+bool SettingsStore::Commit() {
+    std::lock_guard<std::mutex> commitLock(m_commitMutex);
+
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_needsWrite) return true;
+
+        size_t total = sizeof(STORE_MAGIC) + sizeof(uint32_t) * 2;
+        for (auto& [name, section] : m_sections) {
+            if (section.dirty) {
+                section.encoded = EncodeSection(name, section);
+                section.dirty = false;
+            }
+            total += section.encoded.size();
+        }
+
+        data.reserve(total);
+        data.append(STORE_MAGIC, sizeof(STORE_MAGIC));
+        AppendValue(data, VERSION);
+        AppendValue(data, static_cast<uint32_t>(m_sections.size()));
+        for (const auto& entry : m_sections) {
+            data.append(entry.second.encoded);
+        }
+        m_needsWrite = false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_path.parent_path(), ec);
+    if (!WriteFileAtomically(m_path, data)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_needsWrite = true;
+        return false;
+    }
+    return true;
+}
+
+void SettingsStore::ScheduleSave() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (!m_savePending) {
+            m_savePending = true;
+            m_firstPendingSave = now;
+        }
+        m_saveDeadline = std::min(now + m_debounce, m_firstPendingSave + m_debounce * MAX_DEBOUNCE_PERIODS);
+
+        if (!m_saverThread.joinable()) {
+            m_saverThread = std::thread([this]() { SaverLoop(); });
+        }
+    }
+    m_saverCondition.notify_all();
+}
+
+void SettingsStore::SetDebounce(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_debounce = delay;
+}
+
+void SettingsStore::Flush() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_savePending = false;
+    }
+    Commit();
+}
+
+void SettingsStore::SaverLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_saverCondition.wait(lock, [this]() { return m_stopping || m_savePending; });
+        if (m_stopping) return;
+
+        while (!m_stopping && m_savePending && std::chrono::steady_clock::now() < m_saveDeadline) {
+            m_saverCondition.wait_until(lock, m_saveDeadline);
+        }
+        // The destructor commits whatever is still pending
+        if (m_stopping) return;
+        if (!m_savePending) continue;
+
+        m_savePending = false;
+        lock.unlock();
+        Commit();
+        lock.lock();
+    }
+}
+
+} // namespace NirUI
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NirUI {
+
+enum class SectionType : uint8_t {
+    KeyValue = 1,   // rows of { key, value }
+    List = 2,       // rows of { value }
+    Table = 3       // rows of any number of fields
+};
+
+// Single-file persistent store made of named, typed sections. Every commit
+// writes a complete new file and renames it over the old one, but only sections
+// changed since the last commit are re-encoded; the rest reuse their cached
+// bytes. ScheduleSave() batches changes and commits them from a background
+// thread after a short quiet period.
+//
+// Layout: "NIRSTORE", u32 version, u32 section count, then per section
+// { u32 name length, name, u8 type, u64 payload length, payload } where the
+// payload is u32 row count followed by rows of { u32 field count, fields of
+// { u32 length, bytes } }.
+class SettingsStore {
+public:
+    using Row = std::vector<std::string>;
+
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int DEFAULT_DEBOUNCE_MS = 500;
+
+    explicit SettingsStore(std::filesystem::path path);
+    ~SettingsStore();
+
+    SettingsStore(const SettingsStore&) = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    // Returns false if the file is missing or unreadable; the store is then empty
+    bool Load();
+    bool Exists() const;
+    const std::filesystem::path& GetPath() const { return m_path; }
+
+    bool HasSection(const std::string& name) const;
+    std::vector<Row> GetRows(const std::string& name) const;
+    std::map<std::string, std::string> GetKeyValues(const std::string& name) const;
+    std::vector<std::string> GetList(const std::string& name) const;
+
+    void SetRows(const std::string& name, SectionType type, std::vector<Row> rows);
+    void SetKeyValues(const std::string& name, const std::map<std::string, std::string>& values);
+    void SetList(const std::string& name, const std::vector<std::string>& values);
+    void RemoveSection(const std::string& name);
+
+    bool IsDirty() const;
+    bool Commit();
+    void ScheduleSave();
+    void SetDebounce(std::chrono::milliseconds delay);
+    // Commits anything pending on the calling thread and waits for an in-flight save
+    void Flush();
+
+private:
+    struct Section {
+        SectionType type = SectionType::Table;
+        std::vector<Row> rows;
+        std::string encoded;
+        bool dirty = true;
+    };
+
+    static std::string EncodeSection(const std::string& name, const Section& section);
+    bool Parse(const unsigned char* data, size_t size);
+    void SaverLoop();
+
+    std::filesystem::path m_path;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Section> m_sections;
+    bool m_needsWrite = false;
+
+    std::mutex m_commitMutex;
+
+    std::condition_variable m_saverCondition;
+    std::thread m_saverThread;
+    std::chrono::milliseconds m_debounce{ DEFAULT_DEBOUNCE_MS };
+    std::chrono::steady_clock::time_point m_saveDeadline;
+    std::chrono::steady_clock::time_point m_firstPendingSave;
+    bool m_savePending = false;
+    bool m_stopping = false;
+};
+
+} // namespace NirUI
@@ -0,0 +1,376 @@
+#include "suggestion_engine.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace NirUI {
+
+static constexpr double NO_SCORE = -std::numeric_limits<double>::infinity();
+static const double DECAY_PER_SECOND = std::log(2.0) / (SuggestionEngine::HALF_LIFE_DAYS * 86400.0);
+
+// Below this many prefix matches, sorting them beats walking the ranked set
+static constexpr uint32_t SORT_MATCHES_LIMIT = 256;
+
+static double LogAddExp(double a, double b) {
+    if (a == NO_SCORE) return b;
+    if (b == NO_SCORE) return a;
+    double high = std::max(a, b);
+    return high + std::log1p(std::exp(-std::fabs(a - b)));
+}
+
+static std::string ToLower(std::string_view text) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+static bool StartsWithNoCase(std::string_view text, std::string_view lowerPrefix) {
+    if (text.size() < lowerPrefix.size()) return false;
+    for (size_t i = 0; i < lowerPrefix.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(lowerPrefix[i])) return false;
+    }
+    return true;
+}
+
+PrefixTrie::PrefixTrie() {
+    m_nodes.emplace_back();
+}
+
+void PrefixTrie::Clear() {
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_nodes.emplace_back();
+}
+
+uint32_t PrefixTrie::NewNode() {
+    if (!m_freeNodes.empty()) {
+        uint32_t node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        return node;
+    }
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void PrefixTrie::FreeNode(uint32_t node) {
+    for (uint32_t child : m_nodes[node].children) FreeNode(child);
+    m_nodes[node] = Node();
+    m_freeNodes.push_back(node);
+}
+
+uint32_t PrefixTrie::FindChild(uint32_t node, char first) const {
+    const auto& children = m_nodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), first, [this](uint32_t child, char value) {
+        return m_nodes[child].label[0] < value;
+    });
+    return it != children.end() && m_nodes[*it].label[0] == first ? *it : NONE;
+}
+
+void PrefixTrie::AddChild(uint32_t node, uint32_t child) {
+    auto& children = m_nodes[node].children;
+    char first = m_nodes[child].label[0];
+    auto it = std::lower_bound(children.begin(), children.end(), first, [this](uint32_t existing, char value) {
+        return m_nodes[existing].label[0] < value;
+    });
+    children.insert(it, child);
+}
+
+void PrefixTrie::RemoveChild(uint32_t node, uint32_t child) {
+    auto& children = m_nodes[node].children;
+    children.erase(std::find(children.begin(), children.end(), child));
+}
+
+bool PrefixTrie::Insert(std::string_view key, uint32_t id) {
+    std::vector<uint32_t> path;
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (true) {
+        path.push_back(node);
+        if (pos == key.size()) break;
+
+        uint32_t child = FindChild(node, key[pos]);
+        if (child == NONE) {
+            uint32_t leaf = NewNode();
+            m_nodes[leaf].label = std::string(key.substr(pos));
+            AddChild(node, leaf);
+            node = leaf;
+            path.push_back(node);
+            break;
+        }
+
+        const std::string& label = m_nodes[child].label;
+        size_t common = 0;
+        while (common < label.size() && pos + common < key.size() && label[common] == key[pos + common]) ++common;
+
+        if (common < label.size()) {
+            // Split the edge so the shared part gets its own node
+            uint32_t middle = NewNode();
+            m_nodes[middle].label = m_nodes[child].label.substr(0, common);
+            m_nodes[middle].count = m_nodes[child].count;
+            m_nodes[child].label.erase(0, common);
+            RemoveChild(node, child);
+            m_nodes[middle].children.push_back(child);
+            AddChild(node, middle);
+            child = middle;
+        }
+        node = child;
+        pos += common;
+    }
+
+    bool added = m_nodes[node].id == NONE;
+    m_nodes[node].id = id;
+    if (added) {
+        for (uint32_t visited : path) m_nodes[visited].count++;
+    }
+    return added;
+}
+
+bool PrefixTrie::Erase(std::string_view key) {
+    std::vector<uint32_t> path = { 0 };
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < key.size()) {
+        uint32_t child = FindChild(node, key[pos]);
+        if (child == NONE || key.substr(pos, m_nodes[child].label.size()) != m_nodes[child].label) return false;
+        pos += m_nodes[child].label.size();
+        node = child;
+        path.push_back(node);
+    }
+    if (m_nodes[node].id == NONE) return false;
+
+    m_nodes[node].id = NONE;
+    for (uint32_t visited : path) m_nodes[visited].count--;
+
+    // Drop the highest node that no longer holds anything
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (m_nodes[path[i]].count == 0) {
+            RemoveChild(path[i - 1], path[i]);
+            FreeNode(path[i]);
+            break;
+        }
+    }
+    return true;
+}
+
+uint32_t PrefixTrie::FindPrefix(std::string_view prefix) const {
+    uint32_t node = 0;
+    size_t pos = 0;
+    while (pos < prefix.size()) {
+        uint32_t child = FindChild(node, prefix[pos]);
+        if (child == NONE) return NONE;
+
+        const std::string& label = m_nodes[child].label;
+        std::string_view rest = prefix.substr(pos);
+        if (rest.size() <= label.size()) {
+            return label.compare(0, rest.size(), rest) == 0 ? child : NONE;
+        }
+        if (rest.compare(0, label.size(), label) != 0) return NONE;
+        pos += label.size();
+        node = child;
+    }
+    return node;
+}
+
+double SuggestionEngine::UsageAt(int64_t unixTime, double weight) {
+    return std::log(weight) + DECAY_PER_SECOND * static_cast<double>(unixTime);
+}
+
+std::string SuggestionEngine::TrieKey(const std::string& value) {
+    // Lowercase for matching, then the original so values differing only in case stay apart
+    std::string key = ToLower(value);
+    key += '\0';
+    key += value;
+    return key;
+}
+
+SuggestionEngine::Entry& SuggestionEngine::Acquire(KeyIndex& index, const std::string& value, uint32_t& id) {
+    auto it = index.byValue.find(value);
+    if (it != index.byValue.end()) {
+        id = it->second;
+        return index.entries[id];
+    }
+
+    if (!index.freeEntries.empty()) {
+        id = index.freeEntries.back();
+        index.freeEntries.pop_back();
+    } else {
+        id = static_cast<uint32_t>(index.entries.size());
+        index.entries.emplace_back();
+    }
+
+    Entry& entry = index.entries[id];
+    entry = Entry{ value, NO_SCORE, NO_SCORE, NO_SCORE, NO_SCORE };
+    index.byValue.emplace(value, id);
+    index.trie.Insert(TrieKey(value), id);
+    return entry;
+}
+
+void SuggestionEngine::Update(KeyIndex& index, uint32_t id) {
+    Entry& entry = index.entries[id];
+    index.ranked.erase({ entry.score, id });
+    entry.score = LogAddExp(LogAddExp(entry.usage, entry.history), entry.live);
+    if (entry.score == NO_SCORE) {
+        Release(index, id);
+        return;
+    }
+    index.ranked.insert({ entry.score, id });
+}
+
+void SuggestionEngine::Release(KeyIndex& index, uint32_t id) {
+    Entry& entry = index.entries[id];
+    index.ranked.erase({ entry.score, id });
+    index.trie.Erase(TrieKey(entry.value));
+    index.byValue.erase(entry.value);
+    entry = Entry{ std::string(), NO_SCORE, NO_SCORE, NO_SCORE, NO_SCORE };
+    index.freeEntries.push_back(id);
+}
+
+void SuggestionEngine::Trim(KeyIndex& index) {
+    auto it = index.ranked.begin();
+    while (index.byValue.size() > MAX_VALUES_PER_KEY && it != index.ranked.end()) {
+        uint32_t id = it->second;
+        ++it;
+        if (!(index.entries[id].sources & static_cast<uint8_t>(SuggestionSource::Live))) {
+            Release(index, id);
+        }
+    }
+}
+
+void SuggestionEngine::Record(const std::string& key, const std::string& value, int64_t unixTime,
+                              SuggestionSource source) {
+    if (value.empty()) return;
+
+    KeyIndex& index = m_keys[key];
+    uint32_t id;
+    Entry& entry = Acquire(index, value, id);
+    if (source == SuggestionSource::History) {
+        entry.history = LogAddExp(entry.history, UsageAt(unixTime, HISTORY_WEIGHT));
+    } else {
+        entry.usage = LogAddExp(entry.usage, UsageAt(unixTime));
+        entry.useCount++;
+    }
+    entry.lastUsed = std::max(entry.lastUsed, unixTime);
+    entry.sources |= static_cast<uint8_t>(source);
+    Update(index, id);
+    Trim(index);
+}
+
+void SuggestionEngine::Restore(const StoredSuggestion& stored) {
+    if (stored.value.empty() || !std::isfinite(stored.usage)) return;
+
+    KeyIndex& index = m_keys[stored.key];
+    uint32_t id;
+    Entry& entry = Acquire(index, stored.value, id);
+    entry.usage = LogAddExp(entry.usage, stored.usage);
+    entry.useCount += stored.useCount;
+    entry.lastUsed = std::max(entry.lastUsed, stored.lastUsed);
+    entry.sources |= static_cast<uint8_t>(SuggestionSource::Recent);
+    Update(index, id);
+    Trim(index);
+}
+
+bool SuggestionEngine::Remove(const std::string& key, const std::string& value) {
+    auto keyIt = m_keys.find(key);
+    if (keyIt == m_keys.end()) return false;
+
+    KeyIndex& index = keyIt->second;
+    auto it = index.byValue.find(value);
+    if (it == index.byValue.end()) return false;
+
+    uint32_t id = it->second;
+    auto live = std::find(index.liveEntries.begin(), index.liveEntries.end(), id);
+    if (live != index.liveEntries.end()) index.liveEntries.erase(live);
+    Release(index, id);
+    return true;
+}
+
+void SuggestionEngine::SetLiveValues(const std::string& key, const std::vector<std::string>& values, int64_t unixTime) {
+    KeyIndex& index = m_keys[key];
+    std::unordered_set<std::string> current(values.begin(), values.end());
+
+    for (uint32_t id : index.liveEntries) {
+        Entry& entry = index.entries[id];
+        if (current.count(entry.value)) continue;
+        entry.live = NO_SCORE;
+        entry.sources &= ~static_cast<uint8_t>(SuggestionSource::Live);
+        Update(index, id);
+    }
+    index.liveEntries.clear();
+
+    double live = UsageAt(unixTime, LIVE_WEIGHT);
+    for (const auto& value : current) {
+        if (value.empty()) continue;
+        uint32_t id;
+        Entry& entry = Acquire(index, value, id);
+        entry.live = live;
+        entry.sources |= static_cast<uint8_t>(SuggestionSource::Live);
+        Update(index, id);
+        index.liveEntries.push_back(id);
+    }
+    Trim(index);
+}
+
+std::vector<Suggestion> SuggestionEngine::Lookup(const std::string& key, std::string_view prefix, size_t maxResults,
+                                                 int64_t unixTime) const {
+    std::vector<Suggestion> results;
+    auto keyIt = m_keys.find(key);
+    if (keyIt == m_keys.end() || maxResults == 0) return results;
+
+    const KeyIndex& index = keyIt->second;
+    std::string lowerPrefix = ToLower(prefix);
+    uint32_t node = index.trie.FindPrefix(lowerPrefix);
+    uint32_t matches = index.trie.CountUnder(node);
+    if (matches == 0) return results;
+
+    double now = DECAY_PER_SECOND * static_cast<double>(unixTime);
+    auto add = [&](uint32_t id) {
+        const Entry& entry = index.entries[id];
+        results.push_back({ entry.value, std::exp(entry.score - now), entry.sources });
+    };
+
+    if (matches <= SORT_MATCHES_LIMIT) {
+        std::vector<uint32_t> ids;
+        ids.reserve(matches);
+        index.trie.ForEachUnder(node, [&ids](uint32_t id) { ids.push_back(id); });
+
+        size_t count = std::min(maxResults, ids.size());
+        std::partial_sort(ids.begin(), ids.begin() + count, ids.end(), [&index](uint32_t a, uint32_t b) {
+            return index.entries[a].score > index.entries[b].score;
+        });
+        for (size_t i = 0; i < count; ++i) add(ids[i]);
+        return results;
+    }
+
+    // Many values match, so the best of them turn up early in rank order
+    for (auto it = index.ranked.rbegin(); it != index.ranked.rend() && results.size() < maxResults; ++it) {
+        if (StartsWithNoCase(index.entries[it->second].value, lowerPrefix)) add(it->second);
+    }
+    return results;
+}
+
+bool SuggestionEngine::HasValues(const std::string& key) const {
+    return GetValueCount(key) > 0;
+}
+
+size_t SuggestionEngine::GetValueCount(const std::string& key) const {
+    auto it = m_keys.find(key);
+    return it == m_keys.end() ? 0 : it->second.byValue.size();
+}
+
+std::vector<StoredSuggestion> SuggestionEngine::Export() const {
+    std::vector<StoredSuggestion> stored;
+    for (const auto& [key, index] : m_keys) {
+        for (auto it = index.ranked.rbegin(); it != index.ranked.rend(); ++it) {
+            const Entry& entry = index.entries[it->second];
+            if (entry.sources & static_cast<uint8_t>(SuggestionSource::Recent)) {
+                stored.push_back({ key, entry.value, entry.usage, entry.lastUsed, entry.useCount });
+            }
+        }
+    }
+    return stored;
+}
+
+} // namespace NirUI
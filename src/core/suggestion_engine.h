@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace NirUI {
+
+enum class SuggestionSource : uint8_t {
+    Recent = 1,     // entered by the user
+    History = 2,    // taken from an executed command in the history
+    Live = 4        // currently open window or running process
+};
+
+struct Suggestion {
+    std::string value;
+    double score = 0.0;     // decayed use count at the time of the lookup
+    uint8_t sources = 0;    // SuggestionSource bits
+};
+
+struct StoredSuggestion {
+    std::string key;
+    std::string value;
+    double usage = 0.0;
+    int64_t lastUsed = 0;
+    uint32_t useCount = 0;
+};
+
+// Compressed (radix) trie mapping strings to ids. Nodes live in one vector and
+// track how many ids their subtree holds, so a prefix lookup can tell how many
+// values match before visiting them.
+class PrefixTrie {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    PrefixTrie();
+
+    // Returns false if the string was already present (its id is replaced)
+    bool Insert(std::string_view key, uint32_t id);
+    bool Erase(std::string_view key);
+    void Clear();
+
+    // Node whose subtree holds every string starting with prefix, or NONE
+    uint32_t FindPrefix(std::string_view prefix) const;
+    uint32_t CountUnder(uint32_t node) const { return node == NONE ? 0 : m_nodes[node].count; }
+
+    template <typename Visitor>
+    void ForEachUnder(uint32_t node, Visitor&& visitor) const {
+        if (node == NONE) return;
+        std::vector<uint32_t> stack = { node };
+        while (!stack.empty()) {
+            const Node& current = m_nodes[stack.back()];
+            stack.pop_back();
+            if (current.id != NONE) visitor(current.id);
+            stack.insert(stack.end(), current.children.begin(), current.children.end());
+        }
+    }
+
+private:
+    struct Node {
+        std::string label;
+        std::vector<uint32_t> children;     // sorted by the first byte of their labels
+        uint32_t id = NONE;
+        uint32_t count = 0;
+    };
+
+    uint32_t FindChild(uint32_t node, char first) const;
+    void AddChild(uint32_t node, uint32_t child);
+    void RemoveChild(uint32_t node, uint32_t child);
+    uint32_t NewNode();
+    void FreeNode(uint32_t node);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+};
+
+// Ranks parameter values per key (e.g. "window_process") by frecency: every
+// use adds a weight that halves each HALF_LIFE_DAYS. Scores are kept as
+// log(weight) + decay * time, which never changes as time passes, so ranking
+// is a std::set ordered once per update (O(log n)), and prefix lookups go
+// through a case-insensitive PrefixTrie.
+//
+// Values come from three sources with separate scores: user entries
+// (persisted), executed history (rebuilt at startup) and the live
+// window/process list (replaced on every refresh).
+class SuggestionEngine {
+public:
+    static constexpr double HALF_LIFE_DAYS = 7.0;
+    static constexpr size_t MAX_VALUES_PER_KEY = 4096;
+    static constexpr double HISTORY_WEIGHT = 0.5;
+    static constexpr double LIVE_WEIGHT = 0.25;
+
+    void Record(const std::string& key, const std::string& value, int64_t unixTime,
+                SuggestionSource source = SuggestionSource::Recent);
+    void Restore(const StoredSuggestion& stored);
+    bool Remove(const std::string& key, const std::string& value);
+    void SetLiveValues(const std::string& key, const std::vector<std::string>& values, int64_t unixTime);
+    void Clear() { m_keys.clear(); }
+
+    // Best-ranked values starting with prefix (case-insensitive), best first
+    std::vector<Suggestion> Lookup(const std::string& key, std::string_view prefix, size_t maxResults,
+                                   int64_t unixTime) const;
+    bool HasValues(const std::string& key) const;
+    size_t GetValueCount(const std::string& key) const;
+
+    // Values entered by the user, for persistence
+    std::vector<StoredSuggestion> Export() const;
+
+    static double UsageAt(int64_t unixTime, double weight = 1.0);
+
+private:
+    struct Entry {
+        std::string value;
+        double usage;
+        double history;
+        double live;
+        double score;
+        int64_t lastUsed = 0;
+        uint32_t useCount = 0;
+        uint8_t sources = 0;
+    };
+
+    struct KeyIndex {
+        std::vector<Entry> entries;
+        std::vector<uint32_t> freeEntries;
+        std::unordered_map<std::string, uint32_t> byValue;
+        std::set<std::pair<double, uint32_t>> ranked;   // ascending; best is last
+        std::vector<uint32_t> liveEntries;
+        PrefixTrie trie;
+    };
+
+    static std::string TrieKey(const std::string& value);
+    Entry& Acquire(KeyIndex& index, const std::string& value, uint32_t& id);
+    void Update(KeyIndex& index, uint32_t id);
+    void Release(KeyIndex& index, uint32_t id);
+    void Trim(KeyIndex& index);
+
+    std::unordered_map<std::string, KeyIndex> m_keys;
+};
+
+} // namespace NirUI
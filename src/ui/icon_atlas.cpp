@@ -0,0 +1,230 @@
+#define NANOSVG_IMPLEMENTATION
+#define NANOSVGRAST_IMPLEMENTATION
+#include "nanosvg.h"
+#include "nanosvgrast.h"
+#include "icon_atlas.h"
+#include "icon_cache.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace NirUI {
+
+static int NextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+bool IconAtlas::RasterizeSvg(const char* svgData, int size, int iconSize, RasterizedIcon& icon) {
+    if (!svgData || size <= 0 || iconSize <= 0) return false;
+
+    // nsvgParse modifies the string, so we need a mutable copy
+    std::vector<char> svgCopy(svgData, svgData + size);
+    svgCopy.push_back('\0');
+
+    NSVGimage* image = nsvgParse(svgCopy.data(), "px", 96.0f);
+    if (!image) return false;
+
+    if (image->width <= 0 || image->height <= 0) {
+        nsvgDelete(image);
+        return false;
+    }
+
+    NSVGrasterizer* rast = nsvgCreateRasterizer();
+    if (!rast) {
+        nsvgDelete(image);
+        return false;
+    }
+
+    icon.width = iconSize;
+    icon.height = iconSize;
+    icon.pixels.assign(static_cast<size_t>(iconSize) * iconSize * 4, 0);
+
+    float maxDim = image->width > image->height ? image->width : image->height;
+    float scale = (float)iconSize / maxDim;
+    nsvgRasterize(rast, image, 0, 0, scale, icon.pixels.data(), iconSize, iconSize, iconSize * 4);
+
+    for (int i = 0; i < iconSize * iconSize; ++i) {
+        if (icon.pixels[i * 4 + 3] > 0) {
+            icon.pixels[i * 4 + 0] = 200;
+            icon.pixels[i * 4 + 1] = 200;
+            icon.pixels[i * 4 + 2] = 200;
+        }
+    }
+
+    nsvgDeleteRasterizer(rast);
+    nsvgDelete(image);
+    return true;
+}
+
+bool IconAtlas::Build(const std::vector<SvgSource>& sources, int baseSize, const std::vector<float>& scales,
+                      const std::filesystem::path& cachePath) {
+    struct Job {
+        const char* svg;
+        int length;
+        uint64_t key;
+        RasterizedIcon icon;
+    };
+
+    std::vector<Job> jobs;
+    jobs.reserve(sources.size() * scales.size());
+    for (const auto& source : sources) {
+        int length = static_cast<int>(strlen(source.second));
+        int lastSize = 0;
+        for (float scale : scales) {
+            int iconSize = static_cast<int>(std::lround(baseSize * scale));
+            if (iconSize == lastSize) continue;
+            lastSize = iconSize;
+
+            Job job;
+            job.svg = source.second;
+            job.length = length;
+            job.key = IconCache::MakeKey(std::string_view(source.second, length), iconSize, scale);
+            job.icon.name = source.first;
+            job.icon.width = iconSize;
+            job.icon.height = iconSize;
+            jobs.push_back(std::move(job));
+        }
+    }
+
+    std::vector<size_t> misses;
+    {
+        IconCache cache;
+        bool haveCache = !cachePath.empty() && cache.Load(cachePath);
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (!haveCache || !cache.Lookup(jobs[i].key, jobs[i].icon)) {
+                misses.push_back(i);
+            }
+        }
+    }
+
+    ThreadPool::Shared().ParallelFor(misses.size(), [&jobs, &misses](size_t i) {
+        Job& job = jobs[misses[i]];
+        if (!RasterizeSvg(job.svg, job.length, job.icon.width, job.icon)) {
+            job.icon.pixels.clear();
+        }
+    });
+
+    if (!cachePath.empty() && !misses.empty()) {
+        std::vector<std::pair<uint64_t, const RasterizedIcon*>> entries;
+        entries.reserve(jobs.size());
+        for (const auto& job : jobs) {
+            if (!job.icon.pixels.empty()) entries.emplace_back(job.key, &job.icon);
+        }
+        IconCache::Write(cachePath, entries);
+    }
+
+    std::vector<RasterizedIcon> icons;
+    icons.reserve(jobs.size());
+    for (auto& job : jobs) {
+        if (!job.icon.pixels.empty()) icons.push_back(std::move(job.icon));
+    }
+    return Pack(std::move(icons));
+}
+
+bool IconAtlas::Pack(std::vector<RasterizedIcon> icons, int padding) {
+    Clear();
+    if (icons.empty()) return false;
+
+    // Shelf packing: tallest first, left to right, new shelf when the row is full
+    std::vector<size_t> order(icons.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&icons](size_t a, size_t b) {
+        if (icons[a].height != icons[b].height) return icons[a].height > icons[b].height;
+        return icons[a].width > icons[b].width;
+    });
+
+    size_t area = 0;
+    int widest = 0;
+    for (const auto& icon : icons) {
+        area += static_cast<size_t>(icon.width + padding) * (icon.height + padding);
+        widest = std::max(widest, icon.width + padding * 2);
+    }
+    int width = NextPowerOfTwo(std::max(widest, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area))))));
+
+    std::vector<AtlasRegion> placed(icons.size());
+    int x = padding;
+    int y = padding;
+    int shelfHeight = 0;
+    for (size_t index : order) {
+        const auto& icon = icons[index];
+        if (x + icon.width + padding > width) {
+            x = padding;
+            y += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+        placed[index].x = x;
+        placed[index].y = y;
+        placed[index].width = icon.width;
+        placed[index].height = icon.height;
+        x += icon.width + padding;
+        shelfHeight = std::max(shelfHeight, icon.height);
+    }
+
+    m_width = width;
+    m_height = NextPowerOfTwo(y + shelfHeight + padding);
+    m_pixels.assign(static_cast<size_t>(m_width) * m_height * 4, 0);
+
+    for (size_t i = 0; i < icons.size(); ++i) {
+        const auto& icon = icons[i];
+        AtlasRegion& region = placed[i];
+
+        size_t rowBytes = static_cast<size_t>(icon.width) * 4;
+        for (int row = 0; row < icon.height && !icon.pixels.empty(); ++row) {
+            memcpy(&m_pixels[(static_cast<size_t>(region.y + row) * m_width + region.x) * 4],
+                   &icon.pixels[row * rowBytes], rowBytes);
+        }
+
+        region.u0 = static_cast<float>(region.x) / m_width;
+        region.v0 = static_cast<float>(region.y) / m_height;
+        region.u1 = static_cast<float>(region.x + region.width) / m_width;
+        region.v1 = static_cast<float>(region.y + region.height) / m_height;
+
+        m_regions[icon.name].push_back({ icon.width, region });
+    }
+
+    for (auto& entry : m_regions) {
+        auto& variants = entry.second;
+        std::sort(variants.begin(), variants.end(), [](const Variant& a, const Variant& b) {
+            return a.size < b.size;
+        });
+    }
+    return true;
+}
+
+void IconAtlas::Clear() {
+    m_width = 0;
+    m_height = 0;
+    m_pixels.clear();
+    m_regions.clear();
+}
+
+const AtlasRegion* IconAtlas::Find(const std::string& name, float pixelSize) const {
+    auto it = m_regions.find(name);
+    if (it == m_regions.end() || it->second.empty()) return nullptr;
+
+    for (const auto& variant : it->second) {
+        if (static_cast<float>(variant.size) >= pixelSize) {
+            return &variant.region;
+        }
+    }
+    return &it->second.back().region;
+}
+
+size_t IconAtlas::GetRegionCount() const {
+    size_t count = 0;
+    for (const auto& entry : m_regions) {
+        count += entry.second.size();
+    }
+    return count;
+}
+
+void IconAtlas::ReleasePixels() {
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+}
+
+} // namespace NirUI
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace NirUI {
+
+struct RasterizedIcon {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+struct AtlasRegion {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 0.0f;
+    float v1 = 0.0f;
+};
+
+// Packs rasterized SVG icons into a single RGBA image so every icon can be drawn
+// from one texture. Each icon is stored at several pixel sizes; lookups return
+// the smallest variant that is at least as large as the requested size.
+// Renderer independent: the caller uploads GetPixels() however it likes.
+class IconAtlas {
+public:
+    using SvgSource = std::pair<std::string, const char*>;
+
+    static bool RasterizeSvg(const char* svgData, int size, int iconSize, RasterizedIcon& icon);
+
+    // Rasterizes every source at baseSize * scale for each scale on the shared thread
+    // pool and packs the result. When cachePath is set, icons found in the cache are
+    // not rasterized again and the cache is rewritten if anything was missing.
+    bool Build(const std::vector<SvgSource>& sources, int baseSize, const std::vector<float>& scales,
+               const std::filesystem::path& cachePath = {});
+    bool Pack(std::vector<RasterizedIcon> icons, int padding = 1);
+    void Clear();
+
+    const AtlasRegion* Find(const std::string& name, float pixelSize) const;
+    bool Contains(const std::string& name) const { return m_regions.count(name) > 0; }
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    bool IsEmpty() const { return m_regions.empty(); }
+    size_t GetIconCount() const { return m_regions.size(); }
+    size_t GetRegionCount() const;
+    const std::vector<unsigned char>& GetPixels() const { return m_pixels; }
+
+    // Drops the CPU copy of the image once it has been uploaded; lookups keep working
+    void ReleasePixels();
+
+private:
+    struct Variant {
+        int size;
+        AtlasRegion region;
+    };
+
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<unsigned char> m_pixels;
+    std::unordered_map<std::string, std::vector<Variant>> m_regions;
+};
+
+} // namespace NirUI
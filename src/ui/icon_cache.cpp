@@ -0,0 +1,126 @@
+#include "icon_cache.h"
+#include "utils/atomic_file.h"
+#include <cstring>
+#include <string>
+
+namespace NirUI {
+
+static const char CACHE_MAGIC[8] = { 'N', 'I', 'R', 'I', 'C', 'O', 'N', 'S' };
+
+#pragma pack(push, 1)
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+};
+
+struct CacheEntry {
+    uint64_t key;
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;
+};
+#pragma pack(pop)
+
+static uint64_t Fnv1a(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t IconCache::MakeKey(std::string_view svg, int iconSize, float scale) {
+    uint64_t hash = 14695981039346656037ULL;
+    hash = Fnv1a(hash, &VERSION, sizeof(VERSION));
+    hash = Fnv1a(hash, svg.data(), svg.size());
+    hash = Fnv1a(hash, &iconSize, sizeof(iconSize));
+    hash = Fnv1a(hash, &scale, sizeof(scale));
+    return hash;
+}
+
+bool IconCache::Load(const std::filesystem::path& path) {
+    Close();
+    if (!m_file.Open(path)) return false;
+
+    const unsigned char* data = m_file.GetData();
+    size_t size = m_file.GetSize();
+    if (size < sizeof(CacheHeader)) {
+        Close();
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION ||
+        header.count > (size - sizeof(CacheHeader)) / sizeof(CacheEntry)) {
+        Close();
+        return false;
+    }
+
+    m_entries.reserve(header.count);
+    const unsigned char* cursor = data + sizeof(CacheHeader);
+    for (uint32_t i = 0; i < header.count; ++i, cursor += sizeof(CacheEntry)) {
+        CacheEntry entry;
+        memcpy(&entry, cursor, sizeof(entry));
+
+        uint64_t bytes = static_cast<uint64_t>(entry.width) * entry.height * 4;
+        if (entry.offset > size || bytes > size - entry.offset) continue;
+        m_entries[entry.key] = { entry.width, entry.height, entry.offset };
+    }
+    return true;
+}
+
+void IconCache::Close() {
+    m_entries.clear();
+    m_file.Close();
+}
+
+bool IconCache::Lookup(uint64_t key, RasterizedIcon& icon) const {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return false;
+
+    const Entry& entry = it->second;
+    const unsigned char* pixels = m_file.GetData() + entry.offset;
+    icon.width = static_cast<int>(entry.width);
+    icon.height = static_cast<int>(entry.height);
+    icon.pixels.assign(pixels, pixels + static_cast<size_t>(entry.width) * entry.height * 4);
+    return true;
+}
+
+bool IconCache::Write(const std::filesystem::path& path,
+                      const std::vector<std::pair<uint64_t, const RasterizedIcon*>>& icons) {
+    size_t total = sizeof(CacheHeader) + sizeof(CacheEntry) * icons.size();
+    for (const auto& entry : icons) {
+        total += entry.second->pixels.size();
+    }
+
+    std::string data;
+    data.reserve(total);
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.count = static_cast<uint32_t>(icons.size());
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t offset = sizeof(CacheHeader) + sizeof(CacheEntry) * icons.size();
+    for (const auto& [key, icon] : icons) {
+        CacheEntry entry;
+        entry.key = key;
+        entry.width = static_cast<uint32_t>(icon->width);
+        entry.height = static_cast<uint32_t>(icon->height);
+        entry.offset = offset;
+        data.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        offset += icon->pixels.size();
+    }
+
+    for (const auto& [key, icon] : icons) {
+        data.append(reinterpret_cast<const char*>(icon->pixels.data()), icon->pixels.size());
+    }
+
+    return WriteFileAtomically(path, data);
+}
+
+} // namespace NirUI
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "icon_atlas.h"
+#include "utils/mapped_file.h"
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace NirUI {
+
+// On-disk cache of rasterized icons. Entries are keyed by a hash of the SVG
+// source, pixel size and scale, so edited icons simply miss. The file is mapped
+// once and pixels are copied out on lookup.
+//
+// Layout: header { "NIRICONS", u32 version, u32 count }, count entries of
+// { u64 key, u32 width, u32 height, u64 offset }, then RGBA pixel data.
+class IconCache {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    static uint64_t MakeKey(std::string_view svg, int iconSize, float scale);
+
+    bool Load(const std::filesystem::path& path);
+    void Close();
+    bool Lookup(uint64_t key, RasterizedIcon& icon) const;
+    size_t GetEntryCount() const { return m_entries.size(); }
+
+    static bool Write(const std::filesystem::path& path,
+                      const std::vector<std::pair<uint64_t, const RasterizedIcon*>>& icons);
+
+private:
+    struct Entry {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;
+    };
+
+    MappedFile m_file;
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+} // namespace NirUI
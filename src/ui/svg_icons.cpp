@@ -1,9 +1,7 @@
-#define NANOSVG_IMPLEMENTATION
-#define NANOSVGRAST_IMPLEMENTATION
-#include "nanosvg.h"
-#include "nanosvgrast.h"
 #include "svg_icons.h"
-#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <utility>
 
 namespace NirUI {
 
@@ -181,62 +179,19 @@ void SvgIconManager::Initialize(ID3D11Device* device) {
 }
 
 void SvgIconManager::Cleanup() {
-    for (auto& pair : m_icons) {
-        if (pair.second) {
-            pair.second->Release();
-        }
+    if (m_atlasTexture) {
+        m_atlasTexture->Release();
+        m_atlasTexture = nullptr;
     }
-    m_icons.clear();
+    m_atlas.Clear();
 }
 
-ID3D11ShaderResourceView* SvgIconManager::LoadSvgFromMemory(const char* svgData, int size) {
-    if (!m_device || !svgData || size <= 0) return nullptr;
-    
-    // nsvgParse modifies the string, so we need a mutable copy
-    char* svgCopy = new char[size + 1];
-    memcpy(svgCopy, svgData, size);
-    svgCopy[size] = '\0';
-    
-    NSVGimage* image = nsvgParse(svgCopy, "px", 96.0f);
-    delete[] svgCopy;
-    
-    if (!image) return nullptr;
-    
-    if (image->width <= 0 || image->height <= 0) {
-        nsvgDelete(image);
-        return nullptr;
-    }
-    
-    int iconSize = 16;
-    NSVGrasterizer* rast = nsvgCreateRasterizer();
-    if (!rast) {
-        nsvgDelete(image);
-        return nullptr;
-    }
-    
-    unsigned char* pixels = new unsigned char[iconSize * iconSize * 4];
-    memset(pixels, 0, iconSize * iconSize * 4);
-    
-    float maxDim = image->width > image->height ? image->width : image->height;
-    float scale = (float)iconSize / maxDim;
-    nsvgRasterize(rast, image, 0, 0, scale, pixels, iconSize, iconSize, iconSize * 4);
-    
-    for (int i = 0; i < iconSize * iconSize; ++i) {
-        unsigned char r = pixels[i * 4 + 0];
-        unsigned char g = pixels[i * 4 + 1];
-        unsigned char b = pixels[i * 4 + 2];
-        unsigned char a = pixels[i * 4 + 3];
-        
-        if (a > 0) {
-            pixels[i * 4 + 0] = 200;
-            pixels[i * 4 + 1] = 200;
-            pixels[i * 4 + 2] = 200;
-        }
-    }
+ID3D11ShaderResourceView* SvgIconManager::CreateTexture(int width, int height, const unsigned char* pixels) {
+    if (!m_device || !pixels || width <= 0 || height <= 0) return nullptr;
     
     D3D11_TEXTURE2D_DESC desc = {};
-    desc.Width = iconSize;
-    desc.Height = iconSize;
+    desc.Width = width;
+    desc.Height = height;
     desc.MipLevels = 1;
     desc.ArraySize = 1;
     desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
@@ -246,15 +201,10 @@ ID3D11ShaderResourceView* SvgIconManager::LoadSvgFromMemory(const char* svgData,
     
     D3D11_SUBRESOURCE_DATA initData = {};
     initData.pSysMem = pixels;
-    initData.SysMemPitch = iconSize * 4;
+    initData.SysMemPitch = width * 4;
     
     ID3D11Texture2D* texture = nullptr;
     HRESULT hr = m_device->CreateTexture2D(&desc, &initData, &texture);
-    
-    delete[] pixels;
-    nsvgDeleteRasterizer(rast);
-    nsvgDelete(image);
-    
     if (FAILED(hr)) return nullptr;
     
     ID3D11ShaderResourceView* srv = nullptr;
@@ -271,81 +221,106 @@ ID3D11ShaderResourceView* SvgIconManager::LoadSvgFromMemory(const char* svgData,
     return srv;
 }
 
-void SvgIconManager::LoadBuiltinIcons() {
-    const std::pair<std::string, const char*> icons[] = {
-        {"volume", SvgData::VOLUME},
-        {"monitor", SvgData::MONITOR},
-        {"settings", SvgData::SETTINGS},
-        {"window", SvgData::WINDOW},
-        {"folder", SvgData::FOLDER},
-        {"clipboard", SvgData::CLIPBOARD},
-        {"keyboard", SvgData::KEYBOARD},
-        {"process", SvgData::PROCESS},
-        {"power", SvgData::POWER},
-        {"network", SvgData::NETWORK},
-        {"mouse", SvgData::MOUSE},
-        {"dialog", SvgData::DIALOG},
-        {"shortcut", SvgData::SHORTCUT},
-        {"system", SvgData::SYSTEM},
-        {"registry", SvgData::REGISTRY},
-        {"display", SvgData::DISPLAY},
-        {"audio", SvgData::AUDIO},
-        {"time", SvgData::TIME},
-        {"star", SvgData::STAR},
-        {"star_filled", SvgData::STAR_FILLED},
-        {"freeze", SvgData::FREEZE},
-        {"play", SvgData::PLAY},
-        {"search", SvgData::SEARCH},
-        {"close", SvgData::CLOSE},
-        {"minimize", SvgData::MINIMIZE},
-        {"maximize", SvgData::MAXIMIZE},
-        {"app_group", SvgData::APP_GROUP},
-    };
-    
-    for (const auto& icon : icons) {
-        auto srv = LoadSvgFromMemory(icon.second, static_cast<int>(strlen(icon.second)));
-        if (srv) {
-            m_icons[icon.first] = srv;
-        }
+namespace {
+
+struct BuiltinIcon {
+    std::string_view name;
+    const char* const* svg;
+};
+
+// Sorted by name so lookups can binary search; checked at compile time below
+constexpr BuiltinIcon BUILTIN_ICONS[] = {
+    {"app_group", &SvgData::APP_GROUP},
+    {"audio", &SvgData::AUDIO},
+    {"clipboard", &SvgData::CLIPBOARD},
+    {"close", &SvgData::CLOSE},
+    {"dialog", &SvgData::DIALOG},
+    {"display", &SvgData::DISPLAY},
+    {"folder", &SvgData::FOLDER},
+    {"freeze", &SvgData::FREEZE},
+    {"keyboard", &SvgData::KEYBOARD},
+    {"maximize", &SvgData::MAXIMIZE},
+    {"minimize", &SvgData::MINIMIZE},
+    {"monitor", &SvgData::MONITOR},
+    {"mouse", &SvgData::MOUSE},
+    {"network", &SvgData::NETWORK},
+    {"play", &SvgData::PLAY},
+    {"power", &SvgData::POWER},
+    {"process", &SvgData::PROCESS},
+    {"registry", &SvgData::REGISTRY},
+    {"search", &SvgData::SEARCH},
+    {"settings", &SvgData::SETTINGS},
+    {"shortcut", &SvgData::SHORTCUT},
+    {"star", &SvgData::STAR},
+    {"star_filled", &SvgData::STAR_FILLED},
+    {"system", &SvgData::SYSTEM},
+    {"time", &SvgData::TIME},
+    {"volume", &SvgData::VOLUME},
+    {"window", &SvgData::WINDOW},
+};
+
+constexpr bool IsSortedByName() {
+    for (size_t i = 1; i < std::size(BUILTIN_ICONS); ++i) {
+        if (!(BUILTIN_ICONS[i - 1].name < BUILTIN_ICONS[i].name)) return false;
     }
+    return true;
 }
 
-ID3D11ShaderResourceView* SvgIconManager::GetIcon(const std::string& name) {
-    auto it = m_icons.find(name);
-    if (it != m_icons.end()) {
-        return it->second;
+static_assert(IsSortedByName(), "BUILTIN_ICONS must be sorted by name");
+
+} // namespace
+
+IconAtlas SvgIconManager::BuildBuiltinAtlas(int baseSize, const std::filesystem::path& cachePath) {
+    std::vector<IconAtlas::SvgSource> icons;
+    icons.reserve(std::size(BUILTIN_ICONS));
+    for (const auto& icon : BUILTIN_ICONS) {
+        icons.emplace_back(std::string(icon.name), *icon.svg);
     }
-    return nullptr;
+    
+    IconAtlas atlas;
+    atlas.Build(icons, baseSize, { 1.0f, 1.5f, 2.0f }, cachePath);
+    return atlas;
+}
+
+void SvgIconManager::Upload(ID3D11Device* device, IconAtlas atlas) {
+    m_device = device;
+    
+    auto srv = CreateTexture(atlas.GetWidth(), atlas.GetHeight(), atlas.GetPixels().data());
+    if (!srv) return;
+    
+    if (m_atlasTexture) {
+        m_atlasTexture->Release();
+    }
+    m_atlasTexture = srv;
+    m_atlas = std::move(atlas);
+    m_atlas.ReleasePixels();
 }
 
-const char* SvgIconManager::GetSvgData(const std::string& name) {
-    if (name == "volume") return SvgData::VOLUME;
-    if (name == "monitor") return SvgData::MONITOR;
-    if (name == "settings") return SvgData::SETTINGS;
-    if (name == "window") return SvgData::WINDOW;
-    if (name == "folder") return SvgData::FOLDER;
-    if (name == "clipboard") return SvgData::CLIPBOARD;
-    if (name == "keyboard") return SvgData::KEYBOARD;
-    if (name == "process") return SvgData::PROCESS;
-    if (name == "power") return SvgData::POWER;
-    if (name == "network") return SvgData::NETWORK;
-    if (name == "mouse") return SvgData::MOUSE;
-    if (name == "dialog") return SvgData::DIALOG;
-    if (name == "shortcut") return SvgData::SHORTCUT;
-    if (name == "system") return SvgData::SYSTEM;
-    if (name == "registry") return SvgData::REGISTRY;
-    if (name == "display") return SvgData::DISPLAY;
-    if (name == "audio") return SvgData::AUDIO;
-    if (name == "time") return SvgData::TIME;
-    if (name == "star") return SvgData::STAR;
-    if (name == "star_filled") return SvgData::STAR_FILLED;
-    if (name == "freeze") return SvgData::FREEZE;
-    if (name == "play") return SvgData::PLAY;
-    if (name == "search") return SvgData::SEARCH;
-    if (name == "close") return SvgData::CLOSE;
-    if (name == "minimize") return SvgData::MINIMIZE;
-    if (name == "maximize") return SvgData::MAXIMIZE;
-    if (name == "app_group") return SvgData::APP_GROUP;
+void SvgIconManager::LoadBuiltinIcons() {
+    Upload(m_device, BuildBuiltinAtlas());
+}
+
+IconView SvgIconManager::GetIcon(const std::string& name, float pixelSize) const {
+    IconView view;
+    if (!m_atlasTexture) return view;
+    
+    const AtlasRegion* region = m_atlas.Find(name, pixelSize);
+    if (!region) return view;
+    
+    view.texture = m_atlasTexture;
+    view.u0 = region->u0;
+    view.v0 = region->v0;
+    view.u1 = region->u1;
+    view.v1 = region->v1;
+    return view;
+}
+
+const char* SvgIconManager::GetSvgData(std::string_view name) {
+    auto it = std::lower_bound(std::begin(BUILTIN_ICONS), std::end(BUILTIN_ICONS), name,
+                               [](const BuiltinIcon& icon, std::string_view key) { return icon.name < key; });
+    if (it != std::end(BUILTIN_ICONS) && it->name == name) {
+        return *it->svg;
+    }
     return nullptr;
 }
 
@@ -1,29 +1,53 @@
 #pragma once
 
+#include "icon_atlas.h"
+#include <filesystem>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 #include <d3d11.h>
 
 namespace NirUI {
 
+struct IconView {
+    ID3D11ShaderResourceView* texture = nullptr;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+    
+    explicit operator bool() const { return texture != nullptr; }
+};
+
 class SvgIconManager {
 public:
+    static constexpr int BASE_ICON_SIZE = 16;
+    
     SvgIconManager();
     ~SvgIconManager();
     
     void Initialize(ID3D11Device* device);
     void Cleanup();
     
-    ID3D11ShaderResourceView* GetIcon(const std::string& name);
+    // pixelSize is the on-screen size after DPI scaling; picks the closest variant
+    IconView GetIcon(const std::string& name, float pixelSize = BASE_ICON_SIZE) const;
     void LoadBuiltinIcons();
     
-    static const char* GetSvgData(const std::string& name);
+    // CPU-only rasterization and packing (1x, 1.5x and 2x), safe to run on a worker
+    // thread. Upload() must be called on the thread that owns the device context.
+    static IconAtlas BuildBuiltinAtlas(int baseSize = BASE_ICON_SIZE, const std::filesystem::path& cachePath = {});
+    void Upload(ID3D11Device* device, IconAtlas atlas);
+    bool IsReady() const { return m_atlasTexture != nullptr; }
+    const IconAtlas& GetAtlas() const { return m_atlas; }
+    
+    static const char* GetSvgData(std::string_view name);
     
 private:
-    ID3D11ShaderResourceView* LoadSvgFromMemory(const char* svgData, int size);
+    ID3D11ShaderResourceView* CreateTexture(int width, int height, const unsigned char* pixels);
     
     ID3D11Device* m_device = nullptr;
-    std::unordered_map<std::string, ID3D11ShaderResourceView*> m_icons;
+    ID3D11ShaderResourceView* m_atlasTexture = nullptr;
+    IconAtlas m_atlas;
 };
 
 namespace SvgData {
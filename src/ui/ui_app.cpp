@@ -1,4 +1,10 @@
 #include "ui_app.h"
+#include "utils/duration.h"
+#include "utils/startup_profiler.h"
+#include "utils/trace_recorder.h"
+#include "core/command_tokenizer.h"
+#include "core/meta_commands.h"
+#include "core/param_validator.h"
 
 #include "imgui.h"
 #include "imgui_internal.h"
@@ -27,6 +33,80 @@ namespace NirUI {
 
 static UIApp* g_appInstance = nullptr;
 
+static int InputTextResizeCallback(ImGuiInputTextCallbackData* data) {
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+        auto* str = static_cast<std::string*>(data->UserData);
+        str->resize(data->BufTextLen);
+        data->Buf = str->data();
+    }
+    return 0;
+}
+
+static bool InputTextString(const char* label, std::string& value, ImGuiInputTextFlags flags = 0) {
+    flags |= ImGuiInputTextFlags_CallbackResize;
+    return ImGui::InputText(label, value.data(), value.capacity() + 1, flags, InputTextResizeCallback, &value);
+}
+
+// Suggestion key for a parameter: window find values are keyed by their find
+// type, paths by parameter name. Empty if the parameter gets no suggestions.
+static std::string GetSuggestionKey(const Command& cmd, const std::vector<std::string>& values, size_t slot) {
+    if (slot >= values.size() || values[slot].empty()) return std::string();
+    const Parameter& param = cmd.parameters[slot];
+    
+    size_t valuePos = param.name.find("_value");
+    if (valuePos != std::string::npos) {
+        std::string typeParam = param.name;
+        typeParam.replace(valuePos, 6, "_type");
+        std::string findType;
+        for (size_t i = 0; i < cmd.parameters.size() && i < values.size(); ++i) {
+            if (cmd.parameters[i].name == typeParam) findType = values[i];
+        }
+        return "window_" + (findType.empty() ? std::string("title") : findType);
+    }
+    if (param.type == ParamType::FilePath || param.type == ParamType::FolderPath) {
+        return "path_" + param.name;
+    }
+    return std::string();
+}
+
+static void RecordCommandArguments(SuggestionEngine& suggestions, const std::string& command, int64_t unixTime,
+                                   SuggestionSource source) {
+    CommandTokens words(command);
+    if (words.IsEmpty()) return;
+    
+    // Two-word commands such as "win close" take precedence over one-word ones
+    std::string name(words[0]);
+    const Command* cmd = words.GetCount() > 1 ? NirCmdCommands::FindCommand(name + " " + std::string(words[1])) : nullptr;
+    size_t first = 2;
+    if (!cmd) {
+        cmd = NirCmdCommands::FindCommand(name);
+        first = 1;
+    }
+    if (!cmd) return;
+    
+    std::vector<std::string> values;
+    for (size_t i = first; i < words.GetCount(); ++i) {
+        values.emplace_back(words[i]);
+    }
+    for (size_t slot = 0; slot < cmd->parameters.size() && slot < values.size(); ++slot) {
+        std::string key = GetSuggestionKey(*cmd, values, slot);
+        if (!key.empty()) suggestions.Record(key, values[slot], unixTime, source);
+    }
+}
+
+// Values without usage data count as one use each, a minute apart, newest first
+static void RestoreOrderedValue(SuggestionEngine& suggestions, const std::string& key, const std::string& value,
+                                int64_t position) {
+    int64_t now = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    StoredSuggestion stored;
+    stored.key = key;
+    stored.value = value;
+    stored.lastUsed = now - position * 60;
+    stored.usage = SuggestionEngine::UsageAt(stored.lastUsed);
+    stored.useCount = 1;
+    suggestions.Restore(stored);
+}
+
 static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     if (ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam))
         return true;
@@ -80,23 +160,22 @@ static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
     return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
-UIApp::UIApp() {
+UIApp::UIApp()
+    : m_scheduler([this](const std::string& command) { ExecuteCommand(command, WorkClass::Scheduled); }) {
     g_appInstance = this;
-    m_nircmdManager = std::make_unique<NirCmdManager>();
-    LoadRecentValues();
-    LoadHistory();
-    LoadSettings();
-    m_appGroupsManager.SetDataPath(m_nircmdManager->GetAppDataPath());
-    m_appGroupsManager.Load();
+    StartupProfiler::Get().Mark("ui_init");
+    m_nircmdManager = std::make_unique<NirCmdManager>(false);
+    StartBackgroundLoads();
 }
 
 UIApp::~UIApp() {
+    m_dataWatcher.Stop();
+    FinishStartupTasks();
     RemoveTrayIcon();
     SaveRecentValues();
     SaveFavorites();
-    SaveHistory();
     SaveSettings();
-    m_appGroupsManager.Save();
+    if (m_settingsStore) m_settingsStore->Flush();
     m_svgIcons.Cleanup();
     CleanupD3D();
     g_appInstance = nullptr;
@@ -277,9 +356,201 @@ void UIApp::ApplyLightTheme() {
     style.ItemSpacing = ImVec2(8, 6);
 }
 
+template <typename T>
+static bool IsTaskReady(const std::future<T>& task) {
+    return task.valid() && task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void UIApp::StartBackgroundLoads() {
+    std::filesystem::path dataPath = m_nircmdManager->GetAppDataPath();
+    m_settingsStore = std::make_unique<SettingsStore>(dataPath / "nirui.store");
+    m_costStore = std::make_unique<SettingsStore>(dataPath / "command_costs.store");
+    m_nircmdManager->SetCostModel(&m_costModel);
+    
+    m_persistenceTask = std::async(std::launch::async, [this, dataPath]() {
+        TraceZone zone("LoadPersistedState");
+        PersistedState state;
+        TraceZone settingsZone("LoadSettings");
+        if (m_settingsStore->Load()) {
+            LoadStoredState(state);
+        } else {
+            // First run with the store: the text files are migrated by the first save
+            LoadLegacySettings(state);
+            LoadLegacyRecentValues(state.suggestions);
+            LoadLegacyHistory(state.importedHistory);
+            LoadLegacyFavorites(state.favorites);
+        }
+        settingsZone.End();
+        
+        TraceZone historyZone("LoadHistory");
+        if (state.history.Open(dataPath) && state.history.GetCount() == 0) {
+            for (auto& entry : state.importedHistory) {
+                state.history.Add(std::move(entry));
+            }
+        }
+        state.importedHistory.clear();
+        
+        // Arguments of recent commands seed the suggestions; they are rebuilt every start
+        std::vector<HistoryEntry> recentHistory;
+        uint64_t historyCount = state.history.GetCount();
+        uint64_t historyFirst = historyCount - std::min<uint64_t>(historyCount, HISTORY_SUGGESTION_ENTRIES);
+        if (state.history.Read(historyFirst, static_cast<size_t>(historyCount - historyFirst), recentHistory)) {
+            for (const auto& entry : recentHistory) {
+                RecordCommandArguments(state.suggestions, entry.command, entry.unixTime, SuggestionSource::History);
+            }
+        }
+        historyZone.End();
+        
+        // Commands that ran before this finished keep their fresher numbers
+        TraceZone costsZone("LoadCosts");
+        if (m_costStore->Load()) {
+            m_costModel.Load(*m_costStore);
+        }
+        costsZone.End();
+        
+        TraceZone groupsZone("LoadAppGroups");
+        state.appGroups.SetDataPath(dataPath);
+        state.appGroups.Load();
+        groupsZone.End();
+        StartupProfiler::Get().Mark("persistence_loaded");
+        return state;
+    });
+    
+    m_iconTask = std::async(std::launch::async, [dataPath]() {
+        TraceZone zone("BuildIconAtlas");
+        IconAtlas atlas = SvgIconManager::BuildBuiltinAtlas(SvgIconManager::BASE_ICON_SIZE, dataPath / "icon_cache.bin");
+        StartupProfiler::Get().Mark("icons_rasterized");
+        return atlas;
+    });
+    
+    m_discoveryTask = std::async(std::launch::async, [this]() {
+        TraceZone zone("NirCmdManager::Discover");
+        m_nircmdManager->Discover();
+        StartupProfiler::Get().Mark("nircmd_discovered");
+    });
+}
+
+void UIApp::PollStartupTasks() {
+    if (m_startupComplete) return;
+    
+    if (IsTaskReady(m_persistenceTask)) {
+        ApplyPersistedState(m_persistenceTask.get());
+    }
+    
+    if (IsTaskReady(m_iconTask)) {
+        m_svgIcons.Upload(m_pd3dDevice, m_iconTask.get());
+        StartupProfiler::Get().Mark("icons_ready");
+    }
+    
+    if (IsTaskReady(m_discoveryTask)) {
+        m_discoveryTask.get();
+        if (!m_nircmdManager->IsAvailable()) {
+            m_showDownloadDialog = true;
+        }
+    }
+    
+    if (!m_persistenceTask.valid() && !m_iconTask.valid() && !m_discoveryTask.valid()) {
+        m_startupComplete = true;
+        StartupProfiler::Get().Mark("interactive");
+        StartupProfiler::Get().WriteReportFromEnvironment();
+    }
+}
+
+void UIApp::FinishStartupTasks() {
+    if (m_persistenceTask.valid()) {
+        ApplyPersistedState(m_persistenceTask.get());
+    }
+    if (m_iconTask.valid()) {
+        m_iconTask.get();
+    }
+    if (m_discoveryTask.valid()) {
+        m_discoveryTask.get();
+    }
+}
+
+void UIApp::ApplyPersistedState(PersistedState&& state) {
+    m_minimizeToTray = state.minimizeToTray;
+    m_unfreezeOnExit = state.unfreezeOnExit;
+    m_outputBufferKb = state.outputBufferKb;
+    m_output.SetMaxBytes(static_cast<size_t>(m_outputBufferKb) * 1024);
+    
+    if (m_darkTheme != state.darkTheme) {
+        m_darkTheme = state.darkTheme;
+        if (ImGui::GetCurrentContext()) {
+            if (m_darkTheme) ApplyDarkTheme();
+            else ApplyLightTheme();
+        }
+        UpdateTitleBarColor();
+    }
+    
+    // Anything recorded before the load finished is merged on top of the persisted data
+    for (const auto& stored : m_suggestions.Export()) {
+        state.suggestions.Restore(stored);
+    }
+    m_suggestions = std::move(state.suggestions);
+    
+    const auto& earlyHistory = m_history.GetRecent();
+    for (size_t i = 0; i < earlyHistory.GetSize(); ++i) {
+        HistoryEntry entry = earlyHistory[i];
+        m_history.ReadOutput(entry.index, entry.output);
+        state.history.Add(std::move(entry));
+    }
+    m_history = std::move(state.history);
+    m_historyPageDirty = true;
+    
+    m_favoriteProcesses.insert(state.favorites.begin(), state.favorites.end());
+    for (auto& win : m_windowList) {
+        win.isFavorite = m_favoriteProcesses.count(win.processName) > 0;
+    }
+    
+    for (const auto& group : m_appGroupsManager.GetGroups()) {
+        if (state.appGroups.CreateGroup(group.name)) {
+            for (const auto& app : group.apps) {
+                state.appGroups.AddApp(group.name, app.name, app.targetType, app.targetValue, app.recursive);
+            }
+        }
+    }
+    m_appGroupsManager = std::move(state.appGroups);
+    m_editingAppGroup = AppGroupHandle();
+    
+    // Writes back anything merged above; unchanged sections are skipped by the store
+    m_persistenceLoaded = true;
+    SaveRecentValues();
+    SaveFavorites();
+    SaveSettings();
+    // History moved to its own archive; drop the copy the store used to keep
+    m_settingsStore->RemoveSection("history");
+    
+    StartDataWatcher();
+}
+
+void UIApp::StartDataWatcher() {
+    std::filesystem::path dataPath = m_nircmdManager->GetAppDataPath();
+    std::error_code ec;
+    std::filesystem::create_directories(dataPath, ec);
+    
+    // Runs on the watcher thread; the main loop picks the flag up on its next frame
+    m_dataWatcher.Start(dataPath, [this](const std::string& fileName) {
+        if (fileName.empty() || fileName == "app_groups.txt") {
+            m_appGroupsChangedOnDisk.store(true, std::memory_order_release);
+        }
+    });
+}
+
+void UIApp::PollExternalChanges() {
+    if (!m_appGroupsChangedOnDisk.exchange(false, std::memory_order_acquire)) return;
+    
+    // Our own appends and saves also land here; Refresh() sees nothing new for them
+    if (m_appGroupsManager.Refresh()) {
+        m_output.AppendLine("App groups reloaded from disk.");
+    }
+}
+
 int UIApp::Run() {
     if (!InitWindow()) return 1;
+    StartupProfiler::Get().Mark("window_created");
     if (!InitD3D()) return 1;
+    StartupProfiler::Get().Mark("d3d_ready");
 
     ShowWindow((HWND)m_hwnd, SW_SHOWDEFAULT);
     UpdateWindow((HWND)m_hwnd);
@@ -297,14 +568,9 @@ int UIApp::Run() {
 
     ImGui_ImplWin32_Init(m_hwnd);
     ImGui_ImplDX11_Init(m_pd3dDevice, m_pd3dDeviceContext);
-    
-    m_svgIcons.Initialize(m_pd3dDevice);
-    LoadFavorites();
-
-    if (!m_nircmdManager->IsAvailable()) {
-        m_showDownloadDialog = true;
-    }
+    StartupProfiler::Get().Mark("imgui_ready");
 
+    bool firstFrame = true;
     MSG msg = {};
     while (m_running && msg.message != WM_QUIT) {
         if (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
@@ -312,6 +578,11 @@ int UIApp::Run() {
             DispatchMessage(&msg);
             continue;
         }
+        
+        PollStartupTasks();
+        PollExternalChanges();
+        m_scheduler.RunDue();
+        PollCommandResults();
 
         RECT rect;
         GetClientRect((HWND)m_hwnd, &rect);
@@ -334,6 +605,11 @@ int UIApp::Run() {
         }
 
         Render();
+        
+        if (firstFrame) {
+            firstFrame = false;
+            StartupProfiler::Get().Mark("first_frame");
+        }
     }
 
     ImGui_ImplDX11_Shutdown();
@@ -347,6 +623,7 @@ int UIApp::Run() {
 }
 
 void UIApp::Render() {
+    TraceZone zone("UIApp::Render");
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
@@ -404,16 +681,25 @@ void UIApp::Render() {
     if (m_showAppGroups) DrawAppGroupsPanel();
     if (m_showAppGroupEditor) DrawAppGroupEditor();
     if (m_showWindowManager) DrawWindowManagerPanel();
+    if (m_showScheduler) DrawSchedulerPanel();
+    if (m_showLatency) DrawLatencyPanel();
 
     DrawStatusBar();
 
     ImGui::End();
 
     ImGui::Render();
+    
+    ImDrawData* drawData = ImGui::GetDrawData();
+    m_lastDrawCalls = 0;
+    for (int i = 0; i < drawData->CmdListsCount; ++i) {
+        m_lastDrawCalls += drawData->CmdLists[i]->CmdBuffer.Size;
+    }
+    
     const float clear_color[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
     m_pd3dDeviceContext->OMSetRenderTargets(1, &m_mainRenderTargetView, nullptr);
     m_pd3dDeviceContext->ClearRenderTargetView(m_mainRenderTargetView, clear_color);
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    ImGui_ImplDX11_RenderDrawData(drawData);
 
     m_pSwapChain->Present(1, 0);
 }
@@ -445,6 +731,12 @@ void UIApp::DrawMenuBar() {
             if (ImGui::MenuItem("Window Manager", "Ctrl+W", m_showWindowManager)) {
                 m_showWindowManager = !m_showWindowManager;
             }
+            if (ImGui::MenuItem("Scheduled Commands", nullptr, m_showScheduler)) {
+                m_showScheduler = !m_showScheduler;
+            }
+            if (ImGui::MenuItem("Command Latency", nullptr, m_showLatency)) {
+                m_showLatency = !m_showLatency;
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Dark Theme", nullptr, m_darkTheme)) {
                 m_darkTheme = true;
@@ -493,13 +785,16 @@ std::string UIApp::GetCategoryIconName(const std::string& categoryName) {
     if (categoryName == "Input Simulation") return "keyboard";
     if (categoryName == "Dialogs & Messages") return "dialog";
     if (categoryName == "Miscellaneous") return "settings";
+    if (categoryName == "Scheduler") return "time";
     return "settings";
 }
 
 void UIApp::DrawIcon(const std::string& iconName, float size) {
-    auto icon = m_svgIcons.GetIcon(iconName);
+    // All icons share one atlas texture, so consecutive icons batch into one draw call
+    auto icon = m_svgIcons.GetIcon(iconName, size * ImGui::GetWindowDpiScale());
     if (icon) {
-        ImGui::Image(reinterpret_cast<ImTextureID>(icon), ImVec2(size, size));
+        ImGui::Image(reinterpret_cast<ImTextureID>(icon.texture), ImVec2(size, size),
+                     ImVec2(icon.u0, icon.v0), ImVec2(icon.u1, icon.v1));
     } else {
         ImGui::Dummy(ImVec2(size, size));
     }
@@ -520,6 +815,12 @@ void UIApp::DrawSidebar() {
         
         const auto& categories = NirCmdCommands::GetCategories();
         
+        // Every row alternates between the icon atlas and the font texture, which
+        // costs two draw calls a row. Drawing the icons into their own channel
+        // lets each channel merge into a single call.
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->ChannelsSplit(2);
+        
         for (size_t i = 0; i < categories.size(); ++i) {
             const auto& cat = categories[i];
             
@@ -528,7 +829,9 @@ void UIApp::DrawSidebar() {
                 flags |= ImGuiTreeNodeFlags_Selected;
             }
             
+            drawList->ChannelsSetCurrent(1);
             DrawIcon(GetCategoryIconName(cat.name), 14.0f);
+            drawList->ChannelsSetCurrent(0);
             ImGui::SameLine();
             bool open = ImGui::TreeNodeEx(("##cat" + std::to_string(i)).c_str(), flags);
             ImGui::SameLine();
@@ -560,7 +863,7 @@ void UIApp::DrawSidebar() {
                     if (ImGui::Selectable(("  " + cmd.name).c_str(), selected)) {
                         m_selectedCategory = static_cast<int>(i);
                         m_selectedCommand = static_cast<int>(j);
-                        m_parameterValues.clear();
+                        BindCommandForm(cmd);
                         m_customCommandBuffer[0] = '\0';
                     }
                     
@@ -573,6 +876,7 @@ void UIApp::DrawSidebar() {
                 ImGui::TreePop();
             }
         }
+        drawList->ChannelsMerge();
     }
     ImGui::End();
 }
@@ -604,41 +908,64 @@ void UIApp::DrawWindowTargetSelector(const std::string& paramName, std::string&
         targetValue = buffer;
     }
     
-    std::string recentKey = "window_target_" + targetType;
+    std::string recentKey = "window_" + (targetType.empty() ? std::string("title") : targetType);
     DrawRecentValuesPopup(recentKey, targetValue);
 }
 
-void UIApp::DrawRecentValuesPopup(const std::string& paramKey, std::string& currentValue) {
-    auto it = m_recentValues.find(paramKey);
-    if (it == m_recentValues.end() || it->second.empty()) return;
+bool UIApp::DrawRecentValuesPopup(const std::string& paramKey, std::string& currentValue) {
+    bool isWindowKey = paramKey.compare(0, 7, "window_") == 0;
+    if (!isWindowKey && !m_suggestions.HasValues(paramKey)) return false;
     
+    bool selected = false;
     ImGui::SameLine();
     std::string popupId = "recent_" + paramKey;
     
     if (ImGui::Button(("...##" + paramKey).c_str())) {
+        if (isWindowKey) RefreshWindowList();
         ImGui::OpenPopup(popupId.c_str());
     }
     
     if (ImGui::IsItemHovered()) {
         ImGui::BeginTooltip();
-        ImGui::Text("Recent values");
+        ImGui::Text("Suggestions");
         ImGui::EndTooltip();
     }
     
     if (ImGui::BeginPopup(popupId.c_str())) {
-        ImGui::Text("Recent Values:");
+        // Values starting with what is typed, or everything if nothing matches
+        int64_t now = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        auto suggestions = m_suggestions.Lookup(paramKey, currentValue, MAX_SUGGESTIONS_SHOWN, now);
+        if (suggestions.empty()) {
+            suggestions = m_suggestions.Lookup(paramKey, "", MAX_SUGGESTIONS_SHOWN, now);
+        }
+        
+        ImGui::Text("Suggestions:");
         ImGui::Separator();
+        if (suggestions.empty()) {
+            ImGui::TextDisabled("No values yet");
+        }
         
         std::vector<std::string> toRemove;
         
-        for (const auto& val : it->second) {
+        for (const auto& suggestion : suggestions) {
+            const std::string& val = suggestion.value;
             ImGui::PushID(val.c_str());
             
             if (ImGui::Selectable(val.c_str(), false, 0, ImVec2(200, 0))) {
                 currentValue = val;
+                selected = true;
                 ImGui::CloseCurrentPopup();
             }
             
+            ImGui::SameLine();
+            if (suggestion.sources & static_cast<uint8_t>(SuggestionSource::Live)) {
+                ImGui::TextDisabled("open");
+            } else if (!(suggestion.sources & static_cast<uint8_t>(SuggestionSource::Recent))) {
+                ImGui::TextDisabled("history");
+            } else {
+                ImGui::TextDisabled("%.1f", suggestion.score);
+            }
+            
             ImGui::SameLine();
             ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
             if (ImGui::SmallButton("X")) {
@@ -655,6 +982,50 @@ void UIApp::DrawRecentValuesPopup(const std::string& paramKey, std::string& curr
         
         ImGui::EndPopup();
     }
+    
+    return selected;
+}
+
+void UIApp::BindCommandForm(const Command& cmd) {
+    // Slots are reused across commands so switching does not reallocate the value strings
+    m_form.command = &cmd;
+    m_form.values.resize(cmd.parameters.size());
+    for (size_t slot = 0; slot < cmd.parameters.size(); ++slot) {
+        m_form.values[slot].assign(cmd.parameters[slot].defaultValue);
+    }
+    m_form.dirty = true;
+}
+
+int UIApp::FindFormSlot(const std::string& paramName) const {
+    if (!m_form.command) return -1;
+    const auto& params = m_form.command->parameters;
+    for (size_t slot = 0; slot < params.size(); ++slot) {
+        if (params[slot].name == paramName) return static_cast<int>(slot);
+    }
+    return -1;
+}
+
+bool UIApp::IsFormParamHidden(size_t slot) const {
+    if (m_form.command->parameters[slot].name != "recursive") return false;
+    
+    int typeSlot = FindFormSlot("find_type");
+    if (typeSlot < 0 || m_form.values[typeSlot].empty()) typeSlot = FindFormSlot("target_type");
+    return typeSlot < 0 || m_form.values[typeSlot] != "folder";
+}
+
+void UIApp::RebuildCommandPreview() {
+    std::string& preview = m_form.preview;
+    preview.clear();
+    m_form.dirty = false;
+    if (!m_form.command) return;
+    
+    preview += m_form.command->name;
+    for (size_t slot = 0; slot < m_form.values.size(); ++slot) {
+        const auto& value = m_form.values[slot];
+        if (value.empty() || IsFormParamHidden(slot)) continue;
+        preview += ' ';
+        NirCmdManager::AppendQuotedArgument(preview, value);
+    }
 }
 
 void UIApp::DrawMainPanel() {
@@ -667,6 +1038,10 @@ void UIApp::DrawMainPanel() {
             if (m_selectedCommand >= 0 && m_selectedCommand < static_cast<int>(cat.commands.size())) {
                 const auto& cmd = cat.commands[m_selectedCommand];
                 
+                if (m_form.command != &cmd) {
+                    BindCommandForm(cmd);
+                }
+                
                 DrawIcon(GetCategoryIconName(cat.name), 18.0f);
                 ImGui::SameLine();
                 ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", cmd.name.c_str());
@@ -680,22 +1055,22 @@ void UIApp::DrawMainPanel() {
                     ImGui::Text("Parameters:");
                     ImGui::Spacing();
                     
-                    for (const auto& param : cmd.parameters) {
-                        ImGui::PushID(param.name.c_str());
+                    for (size_t slot = 0; slot < cmd.parameters.size(); ++slot) {
+                        const auto& param = cmd.parameters[slot];
+                        ImGui::PushID(static_cast<int>(slot));
                         
-                        auto& value = m_parameterValues[param.name];
+                        auto& value = m_form.values[slot];
+                        bool changed = false;
                         if (value.empty() && !param.defaultValue.empty()) {
                             value = param.defaultValue;
+                            changed = true;
                         }
                         
                         // Skip recursive parameter unless folder type is selected
-                        if (param.name == "recursive") {
-                            std::string typeVal = m_parameterValues["find_type"];
-                            if (typeVal.empty()) typeVal = m_parameterValues["target_type"];
-                            if (typeVal != "folder") {
-                                ImGui::PopID();
-                                continue;
-                            }
+                        if (IsFormParamHidden(slot)) {
+                            if (changed) m_form.dirty = true;
+                            ImGui::PopID();
+                            continue;
                         }
                         
                         ImGui::Text("%s%s:", param.name.c_str(), param.required ? "*" : "");
@@ -707,7 +1082,6 @@ void UIApp::DrawMainPanel() {
                             ImGui::EndTooltip();
                         }
                         
-                        bool isWindowFindType = (param.name == "find_type" || param.name == "parent_find_type" || param.name == "child_find_type");
                         bool isWindowFindValue = (param.name == "find_value" || param.name == "parent_find_value" || param.name == "child_find_value");
                         bool isGroupParam = (param.name == "group" && (cmd.name.substr(0, 6) == "group "));
                         
@@ -721,6 +1095,7 @@ void UIApp::DrawMainPanel() {
                                 for (const auto& group : groups) {
                                     if (ImGui::Selectable(group.name.c_str(), value == group.name)) {
                                         value = group.name;
+                                        changed = true;
                                     }
                                 }
                                 ImGui::EndCombo();
@@ -731,6 +1106,7 @@ void UIApp::DrawMainPanel() {
                                 for (const auto& choice : param.choices) {
                                     if (ImGui::Selectable(choice.c_str(), value == choice)) {
                                         value = choice;
+                                        changed = true;
                                     }
                                 }
                                 ImGui::EndCombo();
@@ -740,32 +1116,26 @@ void UIApp::DrawMainPanel() {
                             bool boolValue = (value == "1" || value == "true");
                             if (ImGui::Checkbox("##bool", &boolValue)) {
                                 value = boolValue ? "1" : "0";
+                                changed = true;
                             }
                         }
                         else if (param.type == ParamType::Integer) {
                             int intValue = value.empty() ? 0 : std::atoi(value.c_str());
                             if (ImGui::InputInt("##int", &intValue)) {
                                 value = std::to_string(intValue);
+                                changed = true;
                             }
                         }
                         else if (param.type == ParamType::FilePath || param.type == ParamType::FolderPath) {
-                            char buffer[512] = {};
-                            strncpy_s(buffer, value.c_str(), sizeof(buffer) - 1);
-                            if (ImGui::InputText("##path", buffer, sizeof(buffer))) {
-                                value = buffer;
-                            }
+                            changed |= InputTextString("##path", value);
                             ImGui::SameLine();
                             if (ImGui::Button("...")) {}
                             
                             std::string recentKey = "path_" + param.name;
-                            DrawRecentValuesPopup(recentKey, value);
+                            changed |= DrawRecentValuesPopup(recentKey, value);
                         }
                         else {
-                            char buffer[512] = {};
-                            strncpy_s(buffer, value.c_str(), sizeof(buffer) - 1);
-                            if (ImGui::InputText("##text", buffer, sizeof(buffer))) {
-                                value = buffer;
-                            }
+                            changed |= InputTextString("##text", value);
                             
                             if (isWindowFindValue) {
                                 std::string findTypeParam = param.name;
@@ -773,11 +1143,12 @@ void UIApp::DrawMainPanel() {
                                 if (pos != std::string::npos) {
                                     findTypeParam.replace(pos, 6, "_type");
                                 }
-                                std::string findType = m_parameterValues[findTypeParam];
+                                int findTypeSlot = FindFormSlot(findTypeParam);
+                                std::string findType = findTypeSlot >= 0 ? m_form.values[findTypeSlot] : "";
                                 if (findType.empty()) findType = "title";
                                 
                                 std::string recentKey = "window_" + findType;
-                                DrawRecentValuesPopup(recentKey, value);
+                                changed |= DrawRecentValuesPopup(recentKey, value);
                                 
                                 ImGui::SameLine();
                                 std::string pickerId = "##picker_" + param.name;
@@ -827,6 +1198,7 @@ void UIApp::DrawMainPanel() {
                                             } else {
                                                 value = win.title;
                                             }
+                                            changed = true;
                                             windowPickerSearch[0] = '\0';
                                             ImGui::CloseCurrentPopup();
                                         }
@@ -840,6 +1212,8 @@ void UIApp::DrawMainPanel() {
                             }
                         }
                         
+                        if (changed) m_form.dirty = true;
+                        
                         ImGui::PopID();
                         ImGui::Spacing();
                     }
@@ -849,30 +1223,15 @@ void UIApp::DrawMainPanel() {
                 ImGui::Separator();
                 ImGui::Spacing();
                 
-                std::string cmdLine = cmd.name;
-                for (const auto& param : cmd.parameters) {
-                    // Skip recursive if not folder type
-                    if (param.name == "recursive") {
-                        std::string typeVal = m_parameterValues["find_type"];
-                        if (typeVal.empty()) typeVal = m_parameterValues["target_type"];
-                        if (typeVal != "folder") continue;
-                    }
-                    
-                    auto it = m_parameterValues.find(param.name);
-                    if (it != m_parameterValues.end() && !it->second.empty()) {
-                        cmdLine += " ";
-                        if (it->second.find(' ') != std::string::npos) {
-                            cmdLine += "\"" + it->second + "\"";
-                        } else {
-                            cmdLine += it->second;
-                        }
-                    }
+                if (m_form.dirty) {
+                    RebuildCommandPreview();
                 }
+                const std::string& cmdLine = m_form.preview;
                 
                 ImGui::Text("Command Preview:");
                 ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.05f, 0.05f, 0.05f, 1.0f));
                 ImGui::SetNextItemWidth(-1);
-                ImGui::InputText("##preview", &cmdLine[0], cmdLine.size() + 1, ImGuiInputTextFlags_ReadOnly);
+                ImGui::InputText("##preview", m_form.preview.data(), m_form.preview.size() + 1, ImGuiInputTextFlags_ReadOnly);
                 ImGui::PopStyleColor();
                 
                 ImGui::Spacing();
@@ -883,24 +1242,9 @@ void UIApp::DrawMainPanel() {
                 if (ImGui::Button("Execute", ImVec2(120, 35))) {
                     strncpy_s(m_customCommandBuffer, cmdLine.c_str(), sizeof(m_customCommandBuffer) - 1);
                     
-                    for (const auto& param : cmd.parameters) {
-                        auto it = m_parameterValues.find(param.name);
-                        if (it != m_parameterValues.end() && !it->second.empty()) {
-                            bool isWindowFindValue = (param.name == "find_value" || param.name.find("_value") != std::string::npos);
-                            if (isWindowFindValue) {
-                                std::string findTypeParam = param.name;
-                                size_t pos = findTypeParam.find("_value");
-                                if (pos != std::string::npos) {
-                                    findTypeParam.replace(pos, 6, "_type");
-                                }
-                                std::string findType = m_parameterValues[findTypeParam];
-                                if (findType.empty()) findType = "title";
-                                AddRecentValue("window_" + findType, it->second);
-                            }
-                            else if (param.type == ParamType::FilePath || param.type == ParamType::FolderPath) {
-                                AddRecentValue("path_" + param.name, it->second);
-                            }
-                        }
+                    for (size_t slot = 0; slot < cmd.parameters.size(); ++slot) {
+                        std::string key = GetSuggestionKey(cmd, m_form.values, slot);
+                        if (!key.empty()) AddRecentValue(key, m_form.values[slot]);
                     }
                     
                     ExecuteCurrentCommand();
@@ -949,31 +1293,93 @@ void UIApp::DrawMainPanel() {
 void UIApp::DrawOutputPanel() {
     if (ImGui::Begin("Output", nullptr, ImGuiWindowFlags_NoCollapse)) {
         if (ImGui::Button("Clear")) {
-            m_lastOutput.clear();
-            m_lastError.clear();
+            m_output.Clear();
+            m_outputMatches.clear();
+            m_outputMatchCursor = -1;
         }
         ImGui::SameLine();
         if (ImGui::Button("Copy")) {
-            CopyToClipboard(m_lastOutput + m_lastError);
+            CopyToClipboard(m_output.GetText());
+        }
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto-scroll", &m_outputAutoScroll);
+        
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(200);
+        bool searchChanged = ImGui::InputTextWithHint("##outputsearch", "Find in output...", m_outputSearch, sizeof(m_outputSearch));
+        
+        uint64_t version = m_output.GetVersion();
+        if (searchChanged || (m_outputSearch[0] != '\0' && version != m_outputSearchVersion)) {
+            m_outputMatches = m_output.Search(m_outputSearch);
+            m_outputSearchVersion = version;
+            if (searchChanged || m_outputMatchCursor >= static_cast<int>(m_outputMatches.size())) {
+                m_outputMatchCursor = m_outputMatches.empty() ? -1 : 0;
+            }
+        }
+        if (m_outputSearch[0] == '\0') {
+            m_outputMatches.clear();
+            m_outputMatchCursor = -1;
+        }
+        
+        int scrollToLine = -1;
+        if (m_outputSearch[0] != '\0') {
+            ImGui::SameLine();
+            if (ImGui::SmallButton("<") && !m_outputMatches.empty()) {
+                int count = static_cast<int>(m_outputMatches.size());
+                m_outputMatchCursor = (m_outputMatchCursor + count - 1) % count;
+                scrollToLine = static_cast<int>(m_outputMatches[m_outputMatchCursor]);
+            }
+            ImGui::SameLine();
+            if (ImGui::SmallButton(">") && !m_outputMatches.empty()) {
+                int count = static_cast<int>(m_outputMatches.size());
+                m_outputMatchCursor = (m_outputMatchCursor + 1) % count;
+                scrollToLine = static_cast<int>(m_outputMatches[m_outputMatchCursor]);
+            }
+            ImGui::SameLine();
+            ImGui::TextDisabled("%d/%d", m_outputMatchCursor + 1, static_cast<int>(m_outputMatches.size()));
+            if (searchChanged && m_outputMatchCursor >= 0) {
+                scrollToLine = static_cast<int>(m_outputMatches[m_outputMatchCursor]);
+            }
         }
         
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Spacing();
         
-        ImGui::BeginChild("OutputScroll", ImVec2(0, 0), true);
-        
-        if (!m_lastOutput.empty()) {
-            ImGui::TextWrapped("%s", m_lastOutput.c_str());
-        }
-        
-        if (!m_lastError.empty()) {
-            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", m_lastError.c_str());
-        }
+        ImGui::BeginChild("OutputScroll", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
         
-        if (m_lastOutput.empty() && m_lastError.empty()) {
+        size_t lineCount = m_output.GetLineCount();
+        if (lineCount == 0) {
             ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Command output will appear here...");
+        } else {
+            bool wasAtBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+            size_t currentMatch = m_outputMatchCursor >= 0 ? m_outputMatches[m_outputMatchCursor] : static_cast<size_t>(-1);
+            
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(lineCount));
+            while (clipper.Step()) {
+                m_output.VisitLines(clipper.DisplayStart, clipper.DisplayEnd,
+                    [&](size_t index, std::string_view text, OutputLineKind kind) {
+                        ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_Text);
+                        if (index == currentMatch) color = ImVec4(1.0f, 0.85f, 0.2f, 1.0f);
+                        else if (kind == OutputLineKind::Error) color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+                        else if (kind == OutputLineKind::Command) color = ImVec4(0.4f, 0.7f, 1.0f, 1.0f);
+                        else if (std::binary_search(m_outputMatches.begin(), m_outputMatches.end(), index)) color = ImVec4(0.9f, 0.75f, 0.4f, 1.0f);
+                        
+                        ImGui::PushStyleColor(ImGuiCol_Text, color);
+                        ImGui::TextUnformatted(text.data(), text.data() + text.size());
+                        ImGui::PopStyleColor();
+                    });
+            }
+            clipper.End();
+            
+            if (scrollToLine >= 0) {
+                ImGui::SetScrollY(scrollToLine * ImGui::GetTextLineHeightWithSpacing() - ImGui::GetWindowHeight() * 0.5f);
+            } else if (version != m_outputSeenVersion && m_outputAutoScroll && wasAtBottom) {
+                ImGui::SetScrollHereY(1.0f);
+            }
         }
+        m_outputSeenVersion = version;
         
         ImGui::EndChild();
     }
@@ -985,17 +1391,82 @@ void UIApp::DrawHistoryPanel() {
     
     if (ImGui::Begin("Command History", &m_showHistory)) {
         if (ImGui::Button("Clear History")) {
-            m_history.clear();
+            m_history.Clear();
+            m_historyResults.clear();
+            m_historyFiltered = false;
+            m_historyPage = 0;
+            m_historyPageDirty = true;
         }
         
+        ImGui::SetNextItemWidth(200);
+        bool search = ImGui::InputTextWithHint("##HistorySearch", "Search commands...", m_historySearch,
+                                               sizeof(m_historySearch), ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::SameLine();
+        search |= ImGui::Checkbox("Failures only", &m_historyFailuresOnly);
+        ImGui::SameLine();
+        search |= ImGui::Button("Search");
+        if (m_historyFiltered) {
+            ImGui::SameLine();
+            if (ImGui::Button("Show All")) {
+                m_historySearch[0] = '\0';
+                m_historyFailuresOnly = false;
+                search = true;
+            }
+        }
+        if (search) StartHistorySearch();
+        
+        if (IsTaskReady(m_historySearchTask)) {
+            m_historyResults = m_historySearchTask.get();
+            m_historyFiltered = true;
+            m_historyPage = 0;
+            m_historyPageDirty = true;
+        }
+        
+        uint64_t total = m_historyFiltered ? m_historyResults.size() : m_history.GetCount();
+        uint64_t pageCount = std::max<uint64_t>(1, (total + HISTORY_PAGE_SIZE - 1) / HISTORY_PAGE_SIZE);
+        if (m_historyPage >= pageCount) {
+            m_historyPage = pageCount - 1;
+            m_historyPageDirty = true;
+        }
+        
+        if (m_historyPage == 0) ImGui::BeginDisabled();
+        if (ImGui::Button("< Newer")) {
+            m_historyPage--;
+            m_historyPageDirty = true;
+        }
+        if (m_historyPage == 0) ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::Text("Page %llu of %llu (%llu %s)", static_cast<unsigned long long>(m_historyPage + 1),
+                    static_cast<unsigned long long>(pageCount), static_cast<unsigned long long>(total),
+                    m_historyFiltered ? "matches" : "entries");
+        ImGui::SameLine();
+        bool lastPage = m_historyPage + 1 >= pageCount;
+        if (lastPage) ImGui::BeginDisabled();
+        if (ImGui::Button("Older >")) {
+            m_historyPage++;
+            m_historyPageDirty = true;
+        }
+        if (lastPage) ImGui::EndDisabled();
+        if (m_historySearchTask.valid()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("Searching...");
+        }
+        
+        const auto& outputs = m_history.GetOutputs();
+        ImGui::TextDisabled("Recent outputs: %.1f KB in memory (%.1f KB uncompressed)",
+                            outputs.GetStoredBytes() / 1024.0, outputs.GetRawBytes() / 1024.0);
+        
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Spacing();
         
-        for (int i = static_cast<int>(m_history.size()) - 1; i >= 0; --i) {
-            const auto& entry = m_history[i];
+        RefreshHistoryPage();
+        
+        ImGui::BeginChild("##HistoryEntries");
+        for (size_t i = 0; i < m_historyPageEntries.size(); ++i) {
+            const auto& entry = m_historyPageEntries[i];
             
-            ImGui::PushID(i);
+            ImGui::PushID(static_cast<int>(i));
             
             ImVec4 color = entry.success ? ImVec4(0.3f, 0.8f, 0.3f, 1.0f) : ImVec4(0.8f, 0.3f, 0.3f, 1.0f);
             ImGui::TextColored(color, entry.success ? "[OK]" : "[ERR]");
@@ -1004,6 +1475,17 @@ void UIApp::DrawHistoryPanel() {
             ImGui::Text("  %s", entry.command.c_str());
             ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "  (%.1f ms)", entry.executionTime);
             
+            // Outputs stay compressed (or on disk) until their node is opened
+            if (entry.outputSize > 0 && ImGui::TreeNode("Output")) {
+                auto it = m_historyOutputs.find(entry.index);
+                if (it == m_historyOutputs.end()) {
+                    it = m_historyOutputs.emplace(entry.index, std::string()).first;
+                    m_history.ReadOutput(entry.index, it->second);
+                }
+                ImGui::TextUnformatted(it->second.c_str(), it->second.c_str() + it->second.size());
+                ImGui::TreePop();
+            }
+            
             if (ImGui::Button("Run")) {
                 strncpy_s(m_customCommandBuffer, entry.command.c_str(), sizeof(m_customCommandBuffer) - 1);
                 ExecuteCurrentCommand();
@@ -1016,10 +1498,58 @@ void UIApp::DrawHistoryPanel() {
             ImGui::Separator();
             ImGui::PopID();
         }
+        ImGui::EndChild();
     }
     ImGui::End();
 }
 
+void UIApp::StartHistorySearch() {
+    HistoryQuery query;
+    query.text = m_historySearch;
+    query.failuresOnly = m_historyFailuresOnly;
+    query.maxResults = 10000;
+    
+    if ((query.text.empty() && !query.failuresOnly) || !m_history.IsOpen()) {
+        m_historyResults.clear();
+        m_historyFiltered = false;
+        m_historyPage = 0;
+        m_historyPageDirty = true;
+        return;
+    }
+    
+    // Scans the archive on a worker so millions of entries don't stall the frame
+    m_historySearchTask = std::async(std::launch::async,
+        [directory = m_history.GetDirectory(), count = m_history.GetCount(), query]() {
+            return HistoryStore::Search(directory, count, query);
+        });
+}
+
+void UIApp::RefreshHistoryPage() {
+    uint64_t count = m_history.GetCount();
+    if (!m_historyPageDirty && count == m_historyPageCount) return;
+    m_historyPageDirty = false;
+    m_historyPageCount = count;
+    m_historyPageIndices.clear();
+    m_historyOutputs.clear();
+    
+    // Pages run newest first
+    uint64_t skip = m_historyPage * HISTORY_PAGE_SIZE;
+    if (m_historyFiltered) {
+        for (uint64_t i = skip; i < m_historyResults.size() && i < skip + HISTORY_PAGE_SIZE; ++i) {
+            m_historyPageIndices.push_back(m_historyResults[static_cast<size_t>(i)]);
+        }
+        if (!m_history.Read(m_historyPageIndices, m_historyPageEntries)) m_historyPageEntries.clear();
+        return;
+    }
+    
+    uint64_t end = count - std::min(count, skip);
+    uint64_t start = end - std::min<uint64_t>(end, HISTORY_PAGE_SIZE);
+    if (!m_history.Read(start, static_cast<size_t>(end - start), m_historyPageEntries)) {
+        m_historyPageEntries.clear();
+    }
+    std::reverse(m_historyPageEntries.begin(), m_historyPageEntries.end());
+}
+
 void UIApp::DrawSettingsPanel() {
     if (ImGui::Begin("Settings", &m_showSettings)) {
         ImGui::Text("Theme:");
@@ -1058,6 +1588,20 @@ void UIApp::DrawSettingsPanel() {
         ImGui::Separator();
         ImGui::Spacing();
         
+        ImGui::Text("Output:");
+        ImGui::SetNextItemWidth(200);
+        ImGui::SliderInt("Buffer size (KB)", &m_outputBufferKb, 256, 65536, "%d", ImGuiSliderFlags_Logarithmic);
+        if (ImGui::IsItemDeactivatedAfterEdit()) {
+            m_output.SetMaxBytes(static_cast<size_t>(m_outputBufferKb) * 1024);
+            SaveSettings();
+        }
+        ImGui::TextDisabled("%d lines, %d KB in use", static_cast<int>(m_output.GetLineCount()),
+                            static_cast<int>(m_output.GetByteCount() / 1024));
+        
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+        
         ImGui::Text("NirCmd Location:");
         ImGui::Text("  %s", m_nircmdManager->GetNirCmdPath().c_str());
         
@@ -1099,6 +1643,13 @@ void UIApp::DrawAboutPanel() {
         ImGui::Spacing();
         
         ImGui::TextWrapped("NirCmd is freeware. NirUI is a third-party wrapper and is not affiliated with NirSoft.");
+        
+        double firstFrameMs = StartupProfiler::Get().GetPhaseMs("first_frame");
+        double interactiveMs = StartupProfiler::Get().GetPhaseMs("interactive");
+        if (firstFrameMs >= 0.0) {
+            ImGui::Spacing();
+            ImGui::TextDisabled("Startup: first frame %.0f ms, interactive %.0f ms", firstFrameMs, interactiveMs);
+        }
     }
     ImGui::End();
 }
@@ -1175,201 +1726,153 @@ void UIApp::DrawStatusBar() {
         ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "NirCmd Not Found");
     }
     
+    if (!m_pendingCommands.empty()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("| %d running", static_cast<int>(m_pendingCommands.size()));
+        if (ImGui::IsItemHovered()) {
+            ImGui::BeginTooltip();
+            for (size_t i = 0; i < WORK_CLASS_COUNT; ++i) {
+                auto workClass = static_cast<WorkClass>(i);
+                auto stats = m_executor.GetStats(workClass);
+                ImGui::Text("%-12s %zu running, %zu queued, wait p99 %.1f ms", GetWorkClassName(workClass),
+                            stats.running, stats.queued, stats.p99WaitMs);
+            }
+            ImGui::EndTooltip();
+        }
+    }
+    
+    if (m_groupProgress.IsActive()) {
+        double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_groupProgressStart).count();
+        double remainingMs = m_groupProgress.GetRemainingMs(elapsedMs, m_executor.GetThreadCount() - 1);
+        ImGui::SameLine();
+        ImGui::TextDisabled("| group steps %zu/%zu, about %s left", m_groupProgress.GetDone(), m_groupProgress.GetTotal(),
+                            FormatEstimate(remainingMs).c_str());
+    }
+    
+    ImGui::SameLine(viewport->WorkSize.x - 320);
+    ImGui::TextDisabled("Draw calls: %d", m_lastDrawCalls);
+    
     ImGui::SameLine(viewport->WorkSize.x - 200);
-    ImGui::Text("Commands: %d", static_cast<int>(m_history.size()));
+    ImGui::Text("Commands: %llu", static_cast<unsigned long long>(m_history.GetCount()));
     
     ImGui::End();
     ImGui::PopStyleColor();
     ImGui::PopStyleVar();
 }
 
-static std::string ExtractQuotedOrWord(const std::string& str, size_t& pos) {
-    while (pos < str.length() && str[pos] == ' ') pos++;
-    if (pos >= str.length()) return "";
-    
-    if (str[pos] == '"') {
-        size_t end = str.find('"', pos + 1);
-        if (end != std::string::npos) {
-            std::string result = str.substr(pos + 1, end - pos - 1);
-            pos = end + 1;
-            return result;
-        }
-    }
-    size_t end = str.find(' ', pos);
-    if (end == std::string::npos) end = str.length();
-    std::string result = str.substr(pos, end - pos);
-    pos = end;
-    return result;
+void UIApp::ExecuteCurrentCommand() {
+    ExecuteCommand(m_customCommandBuffer);
 }
 
-void UIApp::ExecuteCurrentCommand() {
-    std::string command = m_customCommandBuffer;
+void UIApp::ExecuteCommand(const std::string& command, WorkClass workClass) {
     if (command.empty()) return;
     
-    if (command.substr(0, 11) == "win freeze " && command.length() > 11) {
-        std::string rest = command.substr(11);
-        size_t spacePos = rest.find(' ');
-        if (spacePos != std::string::npos) {
-            std::string findType = rest.substr(0, spacePos);
-            std::string findValue = rest.substr(spacePos + 1);
-            bool recursive = false;
-            size_t recPos = findValue.find(" recursive=");
-            if (recPos != std::string::npos) {
-                std::string recVal = findValue.substr(recPos + 11);
-                recursive = (recVal == "true" || recVal == "1");
-                findValue = findValue.substr(0, recPos);
-            }
-            if (!findValue.empty() && findValue.front() == '"' && findValue.back() == '"') {
-                findValue = findValue.substr(1, findValue.length() - 2);
-            }
-            FreezeWindow(findType, findValue, findType == "process" ? findValue : "", "", "", recursive);
-            
-            ExecutionResult result;
-            result.success = true;
-            result.output = "Frozen: " + findValue;
-            result.executionTimeMs = 0;
-            AddToHistory(command, result);
-            return;
-        }
-    }
-    else if (command.substr(0, 13) == "win unfreeze " && command.length() > 13) {
-        std::string rest = command.substr(13);
-        size_t spacePos = rest.find(' ');
-        if (spacePos != std::string::npos) {
-            std::string findType = rest.substr(0, spacePos);
-            std::string findValue = rest.substr(spacePos + 1);
-            bool recursive = false;
-            size_t recPos = findValue.find(" recursive=");
-            if (recPos != std::string::npos) {
-                std::string recVal = findValue.substr(recPos + 11);
-                recursive = (recVal == "true" || recVal == "1");
-                findValue = findValue.substr(0, recPos);
-            }
-            if (!findValue.empty() && findValue.front() == '"' && findValue.back() == '"') {
-                findValue = findValue.substr(1, findValue.length() - 2);
-            }
-            auto it = std::find_if(m_frozenWindows.begin(), m_frozenWindows.end(),
-                [&](const FrozenWindow& fw) { return fw.targetValue == findValue; });
-            if (it != m_frozenWindows.end()) {
-                UnfreezeWindow(*it);
-                m_frozenWindows.erase(it);
-            } else {
-                FrozenWindow tempFw;
-                tempFw.targetType = findType;
-                tempFw.targetValue = findValue;
-                tempFw.processName = (findType == "process") ? findValue : "";
-                UnfreezeWindow(tempFw);
-            }
-            
-            ExecutionResult result;
-            result.success = true;
-            result.output = "Unfrozen: " + findValue;
-            result.executionTimeMs = 0;
-            AddToHistory(command, result);
-            return;
-        }
-    }
-    else if (command.substr(0, 6) == "group ") {
-        ExecutionResult result;
-        result.success = true;
-        result.executionTimeMs = 0;
-        
-        std::string rest = command.substr(6);
-        size_t pos = 0;
-        std::string subCmd = ExtractQuotedOrWord(rest, pos);
-        
-        if (subCmd == "list") {
-            std::string output = "App Groups:\n";
-            for (const auto& group : m_appGroupsManager.GetGroups()) {
-                output += "  " + group.name + " (" + std::to_string(group.apps.size()) + " apps)\n";
-                for (const auto& app : group.apps) {
-                    output += "    - " + app.name + " [" + app.targetType + ": " + app.targetValue + "]";
-                    if (app.targetType == "folder" && app.recursive) output += " (recursive)";
-                    output += "\n";
-                }
-            }
-            result.output = output;
-        }
-        else if (subCmd == "create") {
-            std::string name = ExtractQuotedOrWord(rest, pos);
-            if (!name.empty()) {
-                if (m_appGroupsManager.CreateGroup(name)) {
-                    m_appGroupsManager.Save();
-                    result.output = "Created group: " + name;
-                } else {
-                    result.output = "Group already exists: " + name;
-                    result.success = false;
-                }
-            }
-        }
-        else if (subCmd == "delete") {
-            std::string name = ExtractQuotedOrWord(rest, pos);
-            if (!name.empty()) {
-                if (m_appGroupsManager.DeleteGroup(name)) {
-                    m_appGroupsManager.Save();
-                    result.output = "Deleted group: " + name;
-                } else {
-                    result.output = "Group not found: " + name;
-                    result.success = false;
-                }
-            }
+    m_output.AppendLine("> " + command, OutputLineKind::Command);
+    
+    std::string validationError;
+    if (!ParamValidators::Validate(command, validationError)) {
+        m_output.AppendLine(validationError, OutputLineKind::Error);
+        return;
+    }
+    
+    MetaCommandHandlers handlers;
+    handlers.appGroups = &m_appGroupsManager;
+    handlers.getScheduler = [this]() { return &m_scheduler; };
+    handlers.costs = &m_costModel;
+    handlers.freeze = [this](const std::string& findType, const std::string& findValue, bool recursive) {
+        FreezeWindow(findType, findValue, findType == "process" ? findValue : "", "", "", recursive);
+        return "Frozen: " + findValue;
+    };
+    handlers.unfreeze = [this](const std::string& findType, const std::string& findValue, bool) {
+        auto it = std::find_if(m_frozenWindows.begin(), m_frozenWindows.end(),
+            [&](const FrozenWindow& fw) { return fw.targetValue == findValue; });
+        if (it != m_frozenWindows.end()) {
+            UnfreezeWindow(*it);
+            m_frozenWindows.erase(it);
+        } else {
+            FrozenWindow tempFw;
+            tempFw.targetType = findType;
+            tempFw.targetValue = findValue;
+            tempFw.processName = (findType == "process") ? findValue : "";
+            UnfreezeWindow(tempFw);
+        }
+        return "Unfrozen: " + findValue;
+    };
+    handlers.runGroup = [this](const std::string& groupName, const std::string& action) {
+        ExecuteOnAppGroup(groupName, action);
+        return "Executed " + action + " on group: " + groupName;
+    };
+    
+    ExecutionResult metaResult;
+    if (DispatchMetaCommand(command, handlers, metaResult)) {
+        m_output.AppendLine(metaResult.output, metaResult.success ? OutputLineKind::Normal : OutputLineKind::Error);
+        AddToHistory(command, metaResult);
+        return;
+    }
+    
+    // Repeated steps for one target merge while an earlier one still runs
+    if (m_coalescer.Push(command)) {
+        StartCoalescedCommands();
+        return;
+    }
+    
+    SubmitCommand(command, workClass, std::string());
+}
+
+void UIApp::SubmitCommand(const std::string& command, WorkClass workClass, const std::string& coalesceTarget) {
+    // Runs off the UI thread; PollCommandResults() reports the result
+    PendingCommand pending;
+    pending.command = command;
+    pending.coalesceTarget = coalesceTarget;
+    pending.result = m_executor.Submit(workClass, [this, command]() {
+        return m_nircmdManager->ExecuteWithCallback(command, [this](const std::string& chunk) {
+            m_output.Append(chunk);
+        });
+    });
+    m_pendingCommands.push_back(std::move(pending));
+}
+
+void UIApp::StartCoalescedCommands() {
+    std::string command;
+    std::string target;
+    while (m_coalescer.TakeNext(command, target)) {
+        SubmitCommand(command, WorkClass::Interactive, target);
+    }
+}
+
+void UIApp::PollCommandResults() {
+    bool completed = false;
+    for (auto it = m_pendingCommands.begin(); it != m_pendingCommands.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
         }
-        else if (subCmd == "add") {
-            std::string groupName = ExtractQuotedOrWord(rest, pos);
-            std::string appName = ExtractQuotedOrWord(rest, pos);
-            std::string targetType = ExtractQuotedOrWord(rest, pos);
-            std::string targetValue = ExtractQuotedOrWord(rest, pos);
-            std::string recursiveStr = ExtractQuotedOrWord(rest, pos);
-            bool recursive = (recursiveStr.empty() || recursiveStr == "true" || recursiveStr == "1");
-            
-            if (!groupName.empty() && !appName.empty() && !targetType.empty() && !targetValue.empty()) {
-                if (m_appGroupsManager.AddApp(groupName, appName, targetType, targetValue, recursive)) {
-                    m_appGroupsManager.Save();
-                    result.output = "Added " + appName + " to " + groupName;
-                } else {
-                    result.output = "Group not found: " + groupName;
-                    result.success = false;
-                }
+        
+        ExecutionResult result = it->result.get();
+        if (!it->quiet) {
+            if (result.success && result.output.empty()) {
+                m_output.AppendLine("Command executed successfully.");
+            } else if (!result.success) {
+                m_output.AppendLine("Command failed (exit code " + std::to_string(result.exitCode) + "): " + it->command,
+                                    OutputLineKind::Error);
             }
         }
-        else if (subCmd == "remove") {
-            std::string groupName = ExtractQuotedOrWord(rest, pos);
-            std::string appName = ExtractQuotedOrWord(rest, pos);
-            if (!groupName.empty() && !appName.empty()) {
-                if (m_appGroupsManager.RemoveApp(groupName, appName)) {
-                    m_appGroupsManager.Save();
-                    result.output = "Removed " + appName + " from " + groupName;
-                } else {
-                    result.output = "Group or app not found";
-                    result.success = false;
-                }
-            }
+        AddToHistory(it->command, result);
+        if (!it->coalesceTarget.empty()) {
+            m_coalescer.Finish(it->coalesceTarget);
         }
-        else if (subCmd == "run") {
-            std::string groupName = ExtractQuotedOrWord(rest, pos);
-            std::string action = ExtractQuotedOrWord(rest, pos);
-            if (!groupName.empty() && !action.empty()) {
-                ExecuteOnAppGroup(groupName, action);
-                result.output = "Executed " + action + " on group: " + groupName;
-            }
+        if (it->quiet) {
+            m_groupProgress.Complete(it->estimatedMs);
         }
-        
-        m_lastOutput = result.output;
-        m_lastError = result.success ? "" : result.output;
-        AddToHistory(command, result);
-        return;
+        it = m_pendingCommands.erase(it);
+        completed = true;
     }
+    StartCoalescedCommands();
     
-    auto result = m_nircmdManager->Execute(command);
-    
-    m_lastOutput = result.output;
-    m_lastError = result.error;
-    
-    if (result.success && m_lastOutput.empty()) {
-        m_lastOutput = "Command executed successfully.";
+    if (completed && m_persistenceLoaded) {
+        m_costModel.Save(*m_costStore);
+        m_costStore->ScheduleSave();
     }
-    
-    AddToHistory(command, result);
 }
 
 void UIApp::AddToHistory(const std::string& cmd, const ExecutionResult& result) {
@@ -1379,63 +1882,52 @@ void UIApp::AddToHistory(const std::string& cmd, const ExecutionResult& result)
     entry.success = result.success;
     entry.executionTime = result.executionTimeMs;
     entry.timestamp = GetCurrentTimestamp();
+    entry.unixTime = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
     
-    m_history.push_back(entry);
-    
-    if (m_history.size() > 100) {
-        m_history.erase(m_history.begin());
-    }
+    RecordCommandArguments(m_suggestions, cmd, entry.unixTime, SuggestionSource::History);
+    m_history.Add(std::move(entry));
+    m_historyPageDirty = true;
 }
 
 void UIApp::AddRecentValue(const std::string& paramKey, const std::string& value) {
     if (value.empty()) return;
     
-    auto& recent = m_recentValues[paramKey];
-    
-    auto it = std::find(recent.begin(), recent.end(), value);
-    if (it != recent.end()) {
-        recent.erase(it);
-    }
-    
-    recent.insert(recent.begin(), value);
-    
-    if (recent.size() > MAX_RECENT_VALUES) {
-        recent.resize(MAX_RECENT_VALUES);
-    }
+    int64_t now = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    m_suggestions.Record(paramKey, value, now);
+    SaveRecentValues();
 }
 
 void UIApp::RemoveRecentValue(const std::string& paramKey, const std::string& value) {
-    auto it = m_recentValues.find(paramKey);
-    if (it != m_recentValues.end()) {
-        auto& vec = it->second;
-        vec.erase(std::remove(vec.begin(), vec.end(), value), vec.end());
+    if (m_suggestions.Remove(paramKey, value)) {
+        SaveRecentValues();
     }
 }
 
 void UIApp::SaveRecentValues() {
-    std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "recent_values.txt";
-    std::ofstream file(savePath);
-    if (!file) return;
+    if (!m_persistenceLoaded) return;
     
-    for (const auto& [key, values] : m_recentValues) {
-        for (const auto& val : values) {
-            file << key << "|" << val << "\n";
-        }
+    std::vector<SettingsStore::Row> rows;
+    for (const auto& stored : m_suggestions.Export()) {
+        char usage[32];
+        snprintf(usage, sizeof(usage), "%.17g", stored.usage);
+        rows.push_back({ stored.key, stored.value, usage, std::to_string(stored.lastUsed), std::to_string(stored.useCount) });
     }
+    m_settingsStore->SetRows("recent_values", SectionType::Table, std::move(rows));
+    m_settingsStore->ScheduleSave();
 }
 
-void UIApp::LoadRecentValues() {
+void UIApp::LoadLegacyRecentValues(SuggestionEngine& suggestions) const {
     std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "recent_values.txt";
     std::ifstream file(savePath);
     if (!file) return;
     
+    std::map<std::string, int64_t> positions;
     std::string line;
     while (std::getline(file, line)) {
         size_t pos = line.find('|');
         if (pos != std::string::npos) {
             std::string key = line.substr(0, pos);
-            std::string value = line.substr(pos + 1);
-            m_recentValues[key].push_back(value);
+            RestoreOrderedValue(suggestions, key, line.substr(pos + 1), positions[key]++);
         }
     }
 }
@@ -1454,7 +1946,7 @@ void UIApp::DrawAppGroupsPanel() {
         ImGui::Spacing();
         
         if (ImGui::Button("New Group", ImVec2(120, 0))) {
-            m_editingAppGroup = -1;
+            m_editingAppGroup = AppGroupHandle();
             m_newGroupName[0] = '\0';
             m_showAppGroupEditor = true;
         }
@@ -1487,7 +1979,7 @@ void UIApp::DrawAppGroupsPanel() {
             }
             ImGui::SameLine();
             if (ImGui::SmallButton("Edit")) {
-                m_editingAppGroup = static_cast<int>(i);
+                m_editingAppGroup = m_appGroupsManager.GetHandle(i);
                 strncpy_s(m_newGroupName, group.name.c_str(), sizeof(m_newGroupName) - 1);
                 m_showAppGroupEditor = true;
             }
@@ -1557,7 +2049,7 @@ void UIApp::DrawAppGroupsPanel() {
 void UIApp::DrawAppGroupEditor() {
     ImGui::SetNextWindowSize(ImVec2(450, 400), ImGuiCond_FirstUseEver);
     
-    std::string title = (m_editingAppGroup >= 0) ? "Edit App Group" : "New App Group";
+    std::string title = m_editingAppGroup.IsValid() ? "Edit App Group" : "New App Group";
     
     if (ImGui::Begin(title.c_str(), &m_showAppGroupEditor, ImGuiWindowFlags_NoCollapse)) {
         ImGui::Text("Group Name:");
@@ -1568,11 +2060,7 @@ void UIApp::DrawAppGroupEditor() {
         ImGui::Separator();
         ImGui::Spacing();
         
-        auto& groups = m_appGroupsManager.GetGroups();
-        AppGroup* editGroup = nullptr;
-        if (m_editingAppGroup >= 0 && m_editingAppGroup < static_cast<int>(groups.size())) {
-            editGroup = &groups[m_editingAppGroup];
-        }
+        AppGroup* editGroup = m_appGroupsManager.Get(m_editingAppGroup);
         
         ImGui::Text("Applications in Group:");
         
@@ -1594,7 +2082,7 @@ void UIApp::DrawAppGroupEditor() {
                 ImGui::SameLine(ImGui::GetWindowWidth() - 40);
                 ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
                 if (ImGui::SmallButton("X")) {
-                    editGroup->apps.erase(editGroup->apps.begin() + i);
+                    m_appGroupsManager.RemoveAppAt(editGroup->name, i);
                     ImGui::PopStyleColor();
                     ImGui::PopID();
                     break;
@@ -1745,10 +2233,11 @@ void UIApp::DrawAppGroupEditor() {
         if (ImGui::Button(editGroup ? "Save Changes" : "Create Group", ImVec2(120, 30))) {
             if (strlen(m_newGroupName) > 0) {
                 if (editGroup) {
-                    editGroup->name = m_newGroupName;
+                    m_appGroupsManager.RenameGroup(editGroup->name, m_newGroupName);
                 } else {
-                    m_appGroupsManager.CreateGroup(m_newGroupName);
-                    m_editingAppGroup = static_cast<int>(groups.size()) - 1;
+                    if (m_appGroupsManager.CreateGroup(m_newGroupName)) {
+                        m_editingAppGroup = m_appGroupsManager.FindGroupHandle(m_newGroupName);
+                    }
                 }
             }
         }
@@ -1769,6 +2258,147 @@ void UIApp::DrawAppGroupEditor() {
     ImGui::End();
 }
 
+void UIApp::DrawSchedulerPanel() {
+    ImGui::SetNextWindowSize(ImVec2(560, 420), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Scheduled Commands", &m_showScheduler)) {
+        DrawIcon("time", 18.0f);
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "Scheduled Commands");
+        ImGui::TextWrapped("Run a command or group action after a delay, at an interval, or on a cron schedule "
+                           "(minute hour day month weekday). Schedules last until NirUI exits.");
+        
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+        
+        static const char* const KINDS[] = { "In", "Every", "Cron" };
+        static const char* const VERBS[] = { "in", "every", "cron" };
+        ImGui::SetNextItemWidth(90);
+        ImGui::Combo("##kind", &m_scheduleKind, KINDS, IM_ARRAYSIZE(KINDS));
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(130);
+        ImGui::InputTextWithHint("##timing", m_scheduleKind == 2 ? "0 9 * * 1-5" : "5m", m_scheduleTiming,
+                                 sizeof(m_scheduleTiming));
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(-100);
+        ImGui::InputTextWithHint("##command", "Command", m_scheduleCommand, sizeof(m_scheduleCommand));
+        ImGui::SameLine();
+        if (ImGui::Button("Schedule", ImVec2(90, 0)) && m_scheduleCommand[0] != '\0') {
+            std::string line = std::string("schedule ") + VERBS[m_scheduleKind] + " ";
+            NirCmdManager::AppendQuotedArgument(line, m_scheduleTiming);
+            line += " ";
+            line += m_scheduleCommand;
+            ExecuteCommand(line);
+        }
+        
+        ImGui::Spacing();
+        
+        auto tasks = m_scheduler.GetTasks();
+        if (tasks.empty()) {
+            ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "Nothing scheduled.");
+        } else {
+            if (ImGui::Button("Cancel All")) {
+                m_scheduler.CancelAll();
+            }
+            ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+            if (ImGui::BeginTable("##scheduled", 5, flags)) {
+                ImGui::TableSetupColumn("Schedule", ImGuiTableColumnFlags_WidthFixed, 130.0f);
+                ImGui::TableSetupColumn("Next", ImGuiTableColumnFlags_WidthFixed, 80.0f);
+                ImGui::TableSetupColumn("Runs", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+                ImGui::TableSetupColumn("Command");
+                ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableHeadersRow();
+                
+                for (const auto& task : tasks) {
+                    ImGui::PushID(static_cast<int>(task.id));
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(task.schedule.c_str());
+                    ImGui::TableNextColumn();
+                    // Rounded up to whole seconds so the label does not flicker
+                    ImGui::Text("%s", FormatDuration((task.dueInMs + 999) / 1000 * 1000).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(task.runs));
+                    if (task.runs > 0 && ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Started %.1f ms late on average, %llu ms at most", task.averageLatenessMs,
+                                          static_cast<unsigned long long>(task.maxLatenessMs));
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(task.command.c_str());
+                    ImGui::TableNextColumn();
+                    if (ImGui::SmallButton("Cancel")) {
+                        m_scheduler.Cancel(task.id);
+                    }
+                    ImGui::PopID();
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    ImGui::End();
+}
+
+void UIApp::DrawLatencyPanel() {
+    ImGui::SetNextWindowSize(ImVec2(640, 420), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("Command Latency", &m_showLatency)) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - m_latencyRefreshTime >= std::chrono::milliseconds(500)) {
+            m_latencySummaries = LatencyStats::Get().GetSummaries();
+            m_latencyRefreshTime = now;
+        }
+        
+        DrawIcon("time", 18.0f);
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "Command Latency");
+        ImGui::TextWrapped("Percentiles of every command run since NirUI started. For nircmd, spawn is starting "
+                           "the process, drain is reading its output and run is until it exits.");
+        
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+        
+        if (m_latencySummaries.empty()) {
+            ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.5f, 1.0f), "No commands have run yet.");
+        } else {
+            ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable |
+                                    ImGuiTableFlags_ScrollY;
+            if (ImGui::BeginTable("##latency", 9, flags)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Backend", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("Command");
+                ImGui::TableSetupColumn("Phase", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+                ImGui::TableSetupColumn("Count", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+                ImGui::TableSetupColumn("Mean", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("p50", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("p90", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("p99", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                ImGui::TableHeadersRow();
+                
+                for (const auto& summary : m_latencySummaries) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(summary.backend.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(summary.command.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(GetLatencyPhaseName(summary.phase));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%llu", static_cast<unsigned long long>(summary.count));
+                    for (double ms : { summary.meanMs, summary.p50Ms, summary.p90Ms, summary.p99Ms, summary.maxMs }) {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.1f ms", ms);
+                    }
+                }
+                ImGui::EndTable();
+            }
+        }
+    }
+    ImGui::End();
+}
+
 void UIApp::DrawWindowManagerPanel() {
     ImGui::SetNextWindowSize(ImVec2(600, 550), ImGuiCond_FirstUseEver);
     
@@ -2097,6 +2727,7 @@ static bool PathStartsWith(const std::string& path, const std::string& prefix, b
 }
 
 void UIApp::FreezeWindow(const std::string& targetType, const std::string& targetValue, const std::string& processName, const std::string& className, const std::string& windowTitle, bool recursive) {
+    TraceZone zone("UIApp::FreezeWindow", targetValue);
     RefreshWindowList();
     
     std::vector<WindowInfo> matchingWindows;
@@ -2188,13 +2819,13 @@ void UIApp::FreezeWindow(const std::string& targetType, const std::string& targe
     }
     
     int windowCount = matchingWindows.empty() ? 1 : static_cast<int>(matchingWindows.size());
-    m_lastOutput = "Frozen: " + targetValue + " (" + std::to_string(windowCount) + " window" + 
-                   (windowCount > 1 ? "s" : "") + ", " + std::to_string(suspendedCount) + " process" +
-                   (suspendedCount > 1 ? "es" : "") + ")";
-    m_lastError.clear();
+    m_output.AppendLine("Frozen: " + targetValue + " (" + std::to_string(windowCount) + " window" + 
+                        (windowCount > 1 ? "s" : "") + ", " + std::to_string(suspendedCount) + " process" +
+                        (suspendedCount > 1 ? "es" : "") + ")");
 }
 
 void UIApp::UnfreezeWindow(const FrozenWindow& fw) {
+    TraceZone zone("UIApp::UnfreezeWindow", fw.targetValue);
     if (fw.processId != 0) {
         std::string resumeCmd = "resumeprocess /" + std::to_string(fw.processId);
         m_nircmdManager->Execute(resumeCmd);
@@ -2229,8 +2860,7 @@ void UIApp::UnfreezeWindow(const FrozenWindow& fw) {
         m_nircmdManager->Execute(normalCmd);
     }
     
-    m_lastOutput = "Unfrozen: " + fw.targetValue;
-    m_lastError.clear();
+    m_output.AppendLine("Unfrozen: " + fw.targetValue);
 }
 
 struct EnumWindowsData {
@@ -2257,6 +2887,7 @@ static BOOL CALLBACK EnumWindowsCallback(HWND hwnd, LPARAM lParam) {
     
     std::string procName;
     std::string procPath;
+    TraceZone openZone("OpenProcess");
     HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
     if (hProcess) {
         char processPath[MAX_PATH] = {};
@@ -2271,6 +2902,7 @@ static BOOL CALLBACK EnumWindowsCallback(HWND hwnd, LPARAM lParam) {
         }
         CloseHandle(hProcess);
     }
+    openZone.End();
     
     if (strlen(title) == 0 && procName.empty()) return TRUE;
     if (procName == "NirUI.exe") return TRUE;
@@ -2290,7 +2922,25 @@ static BOOL CALLBACK EnumWindowsCallback(HWND hwnd, LPARAM lParam) {
     return TRUE;
 }
 
+void UIApp::RefreshLiveSuggestions() {
+    std::vector<std::string> titles;
+    std::vector<std::string> processes;
+    std::vector<std::string> classes;
+    for (const auto& win : m_windowList) {
+        titles.push_back(win.title);
+        processes.push_back(win.processName);
+        classes.push_back(win.className);
+    }
+    
+    int64_t now = static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    m_suggestions.SetLiveValues("window_title", titles, now);
+    m_suggestions.SetLiveValues("window_ititle", titles, now);
+    m_suggestions.SetLiveValues("window_process", processes, now);
+    m_suggestions.SetLiveValues("window_class", classes, now);
+}
+
 void UIApp::RefreshWindowList() {
+    TraceZone zone("UIApp::RefreshWindowList");
     m_windowList.clear();
     
     EnumWindowsData data;
@@ -2301,6 +2951,8 @@ void UIApp::RefreshWindowList() {
     for (auto& win : m_windowList) {
         win.isFavorite = m_favoriteProcesses.count(win.processName) > 0;
     }
+    
+    RefreshLiveSuggestions();
 }
 
 void UIApp::ToggleFavorite(const std::string& processName) {
@@ -2313,54 +2965,35 @@ void UIApp::ToggleFavorite(const std::string& processName) {
     for (auto& win : m_windowList) {
         win.isFavorite = m_favoriteProcesses.count(win.processName) > 0;
     }
+    
+    SaveFavorites();
 }
 
 void UIApp::SaveFavorites() {
-    std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "favorites.txt";
-    std::ofstream file(savePath);
-    if (!file) return;
+    if (!m_persistenceLoaded) return;
     
-    for (const auto& fav : m_favoriteProcesses) {
-        file << fav << "\n";
-    }
+    m_settingsStore->SetList("favorites", std::vector<std::string>(m_favoriteProcesses.begin(), m_favoriteProcesses.end()));
+    m_settingsStore->ScheduleSave();
 }
 
-void UIApp::LoadFavorites() {
+void UIApp::LoadLegacyFavorites(std::set<std::string>& favorites) const {
     std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "favorites.txt";
     std::ifstream file(savePath);
     if (!file) return;
     
-    m_favoriteProcesses.clear();
     std::string line;
     while (std::getline(file, line)) {
         if (!line.empty()) {
-            m_favoriteProcesses.insert(line);
+            favorites.insert(line);
         }
     }
 }
 
-void UIApp::SaveHistory() {
-    std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "history.txt";
-    std::ofstream file(savePath);
-    if (!file) return;
-    
-    int count = 0;
-    for (const auto& entry : m_history) {
-        if (count >= 100) break;
-        file << (entry.success ? "1" : "0") << "|"
-             << entry.executionTime << "|"
-             << entry.timestamp << "|"
-             << entry.command << "\n";
-        count++;
-    }
-}
-
-void UIApp::LoadHistory() {
+void UIApp::LoadLegacyHistory(std::vector<HistoryEntry>& history) const {
     std::filesystem::path savePath = m_nircmdManager->GetAppDataPath() / "history.txt";
     std::ifstream file(savePath);
     if (!file) return;
     
-    m_history.clear();
     std::string line;
     while (std::getline(file, line)) {
         if (line.empty()) continue;
@@ -2380,16 +3013,20 @@ void UIApp::LoadHistory() {
         entry.command = line.substr(pos3 + 1);
         entry.output = "";
         
-        m_history.push_back(entry);
+        history.push_back(entry);
     }
 }
 
 void UIApp::ExecuteOnAppGroup(const std::string& groupName, const std::string& action) {
-    AppGroup* group = m_appGroupsManager.FindGroup(groupName);
+    TraceZone zone("UIApp::ExecuteOnAppGroup", groupName);
+    // Iterate a snapshot so the group editor can keep changing the live groups
+    auto snapshot = m_appGroupsManager.GetSnapshot();
+    const AppGroup* group = snapshot->Find(groupName);
     if (!group) return;
     
     bool isFreeze = (action == "freeze");
     bool isUnfreeze = (action == "unfreeze");
+    std::vector<PendingCommand> steps;
     
     for (const auto& app : group->apps) {
         if (isFreeze) {
@@ -2413,14 +3050,31 @@ void UIApp::ExecuteOnAppGroup(const std::string& groupName, const std::string& a
             }
         }
         else {
-            std::string cmd = "win " + action + " " + app.targetType + " \"" + app.targetValue + "\"";
-            auto result = m_nircmdManager->Execute(cmd);
-            AddToHistory(cmd, result);
+            PendingCommand pending;
+            pending.command = "win " + action + " " + app.targetType + " \"" + app.targetValue + "\"";
+            pending.quiet = true;
+            pending.estimatedMs = EstimateCommandMs(m_costModel, pending.command);
+            steps.push_back(std::move(pending));
         }
     }
     
-    m_lastOutput = "Executed '" + action + "' on " + std::to_string(group->apps.size()) + " apps in group '" + groupName + "'";
-    m_lastError.clear();
+    // Slowest first, so the last step to start is a quick one
+    std::stable_sort(steps.begin(), steps.end(), [](const PendingCommand& a, const PendingCommand& b) {
+        return a.estimatedMs > b.estimatedMs;
+    });
+    if (!m_groupProgress.IsActive()) {
+        m_groupProgress.Reset();
+        m_groupProgressStart = std::chrono::steady_clock::now();
+    }
+    for (auto& pending : steps) {
+        m_groupProgress.Add(pending.estimatedMs);
+        pending.result = m_executor.Submit(WorkClass::Group, [this, cmd = pending.command]() {
+            return m_nircmdManager->Execute(cmd);
+        });
+        m_pendingCommands.push_back(std::move(pending));
+    }
+    
+    m_output.AppendLine("Executed '" + action + "' on " + std::to_string(group->apps.size()) + " apps in group '" + groupName + "'");
 }
 
 void UIApp::CopyToClipboard(const std::string& text) {
@@ -2449,16 +3103,61 @@ std::string UIApp::GetCurrentTimestamp() {
 }
 
 void UIApp::SaveSettings() {
-    auto path = m_nircmdManager->GetAppDataPath() / "settings.txt";
-    std::ofstream file(path);
-    if (file.is_open()) {
-        file << "minimize_to_tray=" << (m_minimizeToTray ? "1" : "0") << "\n";
-        file << "unfreeze_on_exit=" << (m_unfreezeOnExit ? "1" : "0") << "\n";
-        file << "dark_theme=" << (m_darkTheme ? "1" : "0") << "\n";
+    if (!m_persistenceLoaded) return;
+    
+    std::map<std::string, std::string> values;
+    values["minimize_to_tray"] = m_minimizeToTray ? "1" : "0";
+    values["unfreeze_on_exit"] = m_unfreezeOnExit ? "1" : "0";
+    values["dark_theme"] = m_darkTheme ? "1" : "0";
+    values["output_buffer_kb"] = std::to_string(m_outputBufferKb);
+    m_settingsStore->SetKeyValues("settings", values);
+    m_settingsStore->ScheduleSave();
+}
+
+static void ApplySettingValue(PersistedState& state, const std::string& key, const std::string& value) {
+    if (key == "minimize_to_tray") state.minimizeToTray = (value == "1");
+    else if (key == "unfreeze_on_exit") state.unfreezeOnExit = (value == "1");
+    else if (key == "dark_theme") state.darkTheme = (value == "1");
+    else if (key == "output_buffer_kb") state.outputBufferKb = std::max(256, std::atoi(value.c_str()));
+}
+
+void UIApp::LoadStoredState(PersistedState& state) const {
+    for (const auto& [key, value] : m_settingsStore->GetKeyValues("settings")) {
+        ApplySettingValue(state, key, value);
+    }
+    
+    std::map<std::string, int64_t> positions;
+    for (const auto& row : m_settingsStore->GetRows("recent_values")) {
+        if (row.size() >= 5) {
+            StoredSuggestion stored;
+            stored.key = row[0];
+            stored.value = row[1];
+            stored.usage = std::strtod(row[2].c_str(), nullptr);
+            stored.lastUsed = std::strtoll(row[3].c_str(), nullptr, 10);
+            stored.useCount = static_cast<uint32_t>(std::strtoul(row[4].c_str(), nullptr, 10));
+            state.suggestions.Restore(stored);
+        } else if (row.size() >= 2) {
+            // Rows from before ranking: newest first, no usage data
+            RestoreOrderedValue(state.suggestions, row[0], row[1], positions[row[0]]++);
+        }
     }
+    
+    for (const auto& row : m_settingsStore->GetRows("history")) {
+        if (row.size() < 4) continue;
+        
+        HistoryEntry entry;
+        entry.success = (row[0] == "1");
+        entry.executionTime = std::atof(row[1].c_str());
+        entry.timestamp = row[2];
+        entry.command = row[3];
+        state.importedHistory.push_back(entry);
+    }
+    
+    auto favorites = m_settingsStore->GetList("favorites");
+    state.favorites.insert(favorites.begin(), favorites.end());
 }
 
-void UIApp::LoadSettings() {
+void UIApp::LoadLegacySettings(PersistedState& state) const {
     auto path = m_nircmdManager->GetAppDataPath() / "settings.txt";
     std::ifstream file(path);
     if (file.is_open()) {
@@ -2466,11 +3165,7 @@ void UIApp::LoadSettings() {
         while (std::getline(file, line)) {
             size_t eq = line.find('=');
             if (eq != std::string::npos) {
-                std::string key = line.substr(0, eq);
-                std::string value = line.substr(eq + 1);
-                if (key == "minimize_to_tray") m_minimizeToTray = (value == "1");
-                else if (key == "unfreeze_on_exit") m_unfreezeOnExit = (value == "1");
-                else if (key == "dark_theme") m_darkTheme = (value == "1");
+                ApplySettingValue(state, line.substr(0, eq), line.substr(eq + 1));
             }
         }
     }
@@ -3,12 +3,25 @@
 #include "core/nircmd_commands.h"
 #include "core/nircmd_manager.h"
 #include "core/app_groups.h"
+#include "core/command_coalescer.h"
+#include "core/command_scheduler.h"
+#include "core/cost_model.h"
 #include "svg_icons.h"
+#include "core/settings_store.h"
+#include "core/history_store.h"
+#include "core/suggestion_engine.h"
+#include "utils/output_buffer.h"
+#include "utils/dir_watcher.h"
+#include "utils/latency_stats.h"
+#include "utils/priority_executor.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <set>
 #include <memory>
+#include <future>
+#include <atomic>
+#include <chrono>
 
 struct ID3D11Device;
 struct ID3D11DeviceContext;
@@ -19,14 +32,6 @@ struct ImFont;
 
 namespace NirUI {
 
-struct HistoryEntry {
-    std::string command;
-    std::string output;
-    bool success;
-    double executionTime;
-    std::string timestamp;
-};
-
 struct FrozenWindow {
     std::string targetType;
     std::string targetValue;
@@ -44,6 +49,38 @@ struct FrozenWindow {
     int savedHeight = 0;
 };
 
+struct CommandFormState {
+    const Command* command = nullptr;
+    std::vector<std::string> values;
+    std::string preview;
+    bool dirty = true;
+};
+
+// A nircmd command running on the executor; its result is reported on the UI thread
+struct PendingCommand {
+    std::string command;
+    std::future<ExecutionResult> result;
+    // Group steps only go to history
+    bool quiet = false;
+    // Set for commands taken from the coalescer, which waits for them to finish
+    std::string coalesceTarget;
+    // Group steps count towards the group progress shown in the status bar
+    double estimatedMs = 0;
+};
+
+struct PersistedState {
+    SuggestionEngine suggestions;
+    HistoryStore history;
+    // Entries from the settings store or history.txt, imported into an empty archive
+    std::vector<HistoryEntry> importedHistory;
+    std::set<std::string> favorites;
+    AppGroupsManager appGroups;
+    bool minimizeToTray = true;
+    bool unfreezeOnExit = true;
+    bool darkTheme = true;
+    int outputBufferKb = static_cast<int>(OutputBuffer::DEFAULT_MAX_BYTES / 1024);
+};
+
 struct WindowInfo {
     std::string title;
     std::string processName;
@@ -74,6 +111,12 @@ private:
     void CleanupD3D();
     void Render();
     void SetupFonts();
+    void StartBackgroundLoads();
+    void PollStartupTasks();
+    void FinishStartupTasks();
+    void ApplyPersistedState(PersistedState&& state);
+    void StartDataWatcher();
+    void PollExternalChanges();
     
     void DrawMenuBar();
     void DrawSidebar();
@@ -87,20 +130,32 @@ private:
     void DrawAppGroupsPanel();
     void DrawAppGroupEditor();
     void DrawWindowManagerPanel();
+    void DrawSchedulerPanel();
+    void DrawLatencyPanel();
     void DrawWindowTargetSelector(const std::string& paramName, std::string& targetType, std::string& targetValue);
-    void DrawRecentValuesPopup(const std::string& paramKey, std::string& currentValue);
+    bool DrawRecentValuesPopup(const std::string& paramKey, std::string& currentValue);
+    void BindCommandForm(const Command& cmd);
+    void RebuildCommandPreview();
+    int FindFormSlot(const std::string& paramName) const;
+    bool IsFormParamHidden(size_t slot) const;
     void RefreshWindowList();
     void FreezeWindow(const std::string& targetType, const std::string& targetValue, const std::string& processName, const std::string& className = "", const std::string& windowTitle = "", bool recursive = false);
     void UnfreezeWindow(const FrozenWindow& fw);
     void ToggleFavorite(const std::string& processName);
     void SaveFavorites();
-    void LoadFavorites();
-    void SaveHistory();
-    void LoadHistory();
+    void LoadLegacyFavorites(std::set<std::string>& favorites) const;
+    void StartHistorySearch();
+    void RefreshHistoryPage();
+    void LoadLegacyHistory(std::vector<HistoryEntry>& history) const;
     void DrawIcon(const std::string& iconName, float size = 16.0f);
     std::string GetCategoryIconName(const std::string& categoryName);
     
     void ExecuteCurrentCommand();
+    void ExecuteCommand(const std::string& command, WorkClass workClass = WorkClass::Interactive);
+    void PollCommandResults();
+    void SubmitCommand(const std::string& command, WorkClass workClass, const std::string& coalesceTarget);
+    // Submits queued volume, brightness and cursor steps whose target is idle
+    void StartCoalescedCommands();
     void ExecuteOnAppGroup(const std::string& groupName, const std::string& action);
     void AddToHistory(const std::string& cmd, const ExecutionResult& result);
     void AddRecentValue(const std::string& paramKey, const std::string& value);
@@ -111,11 +166,13 @@ private:
     void ApplyLightTheme();
     void UpdateTitleBarColor();
     void SaveRecentValues();
-    void LoadRecentValues();
+    void LoadLegacyRecentValues(SuggestionEngine& suggestions) const;
+    void RefreshLiveSuggestions();
     void SaveAppGroups();
     void LoadAppGroups();
     void SaveSettings();
-    void LoadSettings();
+    void LoadLegacySettings(PersistedState& state) const;
+    void LoadStoredState(PersistedState& state) const;
     void CreateTrayIcon();
     void RemoveTrayIcon();
     void UnfreezeAllWindows();
@@ -130,20 +187,52 @@ private:
     ImFont* m_defaultFont = nullptr;
     ImFont* m_iconFont = nullptr;
     
+    // Before the manager and executor, which record into it
+    CostModel m_costModel;
     std::unique_ptr<NirCmdManager> m_nircmdManager;
     
+    std::unique_ptr<SettingsStore> m_settingsStore;
+    // Shared with the CLI, so kept out of the main store
+    std::unique_ptr<SettingsStore> m_costStore;
+    std::future<PersistedState> m_persistenceTask;
+    std::future<IconAtlas> m_iconTask;
+    std::future<void> m_discoveryTask;
+    bool m_persistenceLoaded = false;
+    bool m_startupComplete = false;
+    
+    DirectoryWatcher m_dataWatcher;
+    std::atomic<bool> m_appGroupsChangedOnDisk{ false };
+    
     int m_selectedCategory = 0;
     int m_selectedCommand = -1;
     char m_searchBuffer[256] = {};
     std::vector<const Command*> m_filteredCommands;
     
-    std::map<std::string, std::string> m_parameterValues;
-    std::map<std::string, std::vector<std::string>> m_recentValues;
+    CommandFormState m_form;
+    SuggestionEngine m_suggestions;
     char m_customCommandBuffer[1024] = {};
-    std::string m_lastOutput;
-    std::string m_lastError;
+    OutputBuffer m_output;
+    char m_outputSearch[128] = {};
+    std::vector<size_t> m_outputMatches;
+    int m_outputMatchCursor = -1;
+    uint64_t m_outputSeenVersion = 0;
+    uint64_t m_outputSearchVersion = 0;
+    bool m_outputAutoScroll = true;
+    int m_outputBufferKb = static_cast<int>(OutputBuffer::DEFAULT_MAX_BYTES / 1024);
     
-    std::vector<HistoryEntry> m_history;
+    HistoryStore m_history;
+    static constexpr size_t HISTORY_PAGE_SIZE = 50;
+    uint64_t m_historyPage = 0;
+    uint64_t m_historyPageCount = 0;
+    bool m_historyPageDirty = true;
+    std::vector<HistoryEntry> m_historyPageEntries;
+    std::vector<uint64_t> m_historyPageIndices;
+    std::map<uint64_t, std::string> m_historyOutputs;
+    char m_historySearch[256] = {};
+    bool m_historyFailuresOnly = false;
+    bool m_historyFiltered = false;
+    std::vector<uint64_t> m_historyResults;
+    std::future<std::vector<uint64_t>> m_historySearchTask;
     
     bool m_showSettings = false;
     bool m_showAbout = false;
@@ -152,18 +241,34 @@ private:
     bool m_showAppGroups = false;
     bool m_showAppGroupEditor = false;
     bool m_showWindowManager = false;
+    bool m_showScheduler = false;
+    bool m_showLatency = false;
+    // Merged from every thread's shard, so refreshed twice a second rather than each frame
+    std::vector<LatencySummary> m_latencySummaries;
+    std::chrono::steady_clock::time_point m_latencyRefreshTime;
     bool m_downloadInProgress = false;
     int m_downloadProgress = 0;
     std::string m_downloadStatus;
     
     AppGroupsManager m_appGroupsManager;
-    int m_selectedAppGroup = -1;
-    int m_editingAppGroup = -1;
+    AppGroupHandle m_editingAppGroup;
     char m_newGroupName[64] = {};
     char m_newAppName[64] = {};
     char m_newAppValue[256] = {};
     int m_newAppTargetType = 0;
     
+    // Runs due commands from the frame loop, on the UI thread
+    CommandScheduler m_scheduler;
+    CommandCoalescer m_coalescer;
+    // Declared after everything its tasks use, so it is destroyed first
+    PriorityExecutor m_executor{ 4 };
+    std::vector<PendingCommand> m_pendingCommands;
+    ProgressTracker m_groupProgress;
+    std::chrono::steady_clock::time_point m_groupProgressStart;
+    int m_scheduleKind = 0;
+    char m_scheduleTiming[64] = "5m";
+    char m_scheduleCommand[512] = {};
+    
     std::vector<FrozenWindow> m_frozenWindows;
     char m_quickWindowTarget[256] = {};
     
@@ -173,6 +278,7 @@ private:
     char m_windowSearchBuffer[256] = {};
     bool m_windowListNeedsRefresh = false;
     bool m_dockLayoutInitialized = false;
+    int m_lastDrawCalls = 0;
     
     bool m_darkTheme = true;
     bool m_running = true;
@@ -185,7 +291,8 @@ private:
     bool m_isMinimizedToTray = false;
     bool m_trayIconCreated = false;
     
-    static constexpr int MAX_RECENT_VALUES = 10;
+    static constexpr size_t MAX_SUGGESTIONS_SHOWN = 20;
+    static constexpr size_t HISTORY_SUGGESTION_ENTRIES = 1000;
     static constexpr unsigned int TRAY_UID = 1;
 };
 
@@ -0,0 +1,95 @@
+#include "atomic_file.h"
+#include <algorithm>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NirUI {
+
+namespace {
+
+// Writes and syncs the temporary file, so the rename can never publish a name
+// whose contents are still only in the page cache
+bool WriteAndSync(const std::filesystem::path& path, std::string_view data) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < data.size()) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - written, 1u << 30));
+        DWORD done = 0;
+        ok = WriteFile(file, data.data() + written, chunk, &done, nullptr) != 0;
+        written += done;
+    }
+    ok = ok && FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < data.size()) {
+        ssize_t done = write(fd, data.data() + written, data.size() - written);
+        if (done < 0) {
+            ok = errno == EINTR;
+            continue;
+        }
+        written += static_cast<size_t>(done);
+    }
+    ok = ok && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    return ok;
+#endif
+}
+
+#ifndef _WIN32
+// The rename itself is only durable once the directory entry is synced
+void SyncParentDirectory(const std::filesystem::path& path) {
+    std::filesystem::path parent = path.parent_path();
+    if (parent.empty()) parent = ".";
+    int fd = open(parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+#endif
+
+} // namespace
+
+bool WriteFileAtomically(const std::filesystem::path& path, std::string_view data) {
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    if (!WriteAndSync(tempPath, data)) {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+#ifdef _WIN32
+    bool renamed = MoveFileExW(tempPath.wstring().c_str(), path.wstring().c_str(),
+                               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    std::error_code renameError;
+    std::filesystem::rename(tempPath, path, renameError);
+    bool renamed = !renameError;
+    if (renamed) SyncParentDirectory(path);
+#endif
+
+    if (!renamed) {
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+    }
+    return renamed;
+}
+
+} // namespace NirUI
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace NirUI {
+
+// Writes data to a sibling temporary file and renames it over path, so readers
+// and crashes only ever see the old or the new contents. The data is synced to
+// disk before the rename, and on POSIX the directory entry after it.
+bool WriteFileAtomically(const std::filesystem::path& path, std::string_view data);
+
+} // namespace NirUI
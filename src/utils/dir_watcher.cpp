@@ -0,0 +1,164 @@
+#include "dir_watcher.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace NirUI {
+
+DirectoryWatcher::~DirectoryWatcher() {
+    Stop();
+}
+
+#ifdef _WIN32
+
+static std::string WideToUtf8(const wchar_t* wide, int length) {
+    int size = WideCharToMultiByte(CP_UTF8, 0, wide, length, nullptr, 0, nullptr, nullptr);
+    std::string result(size, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wide, length, &result[0], size, nullptr, nullptr);
+    return result;
+}
+
+bool DirectoryWatcher::Start(const std::filesystem::path& directory, Callback callback) {
+    Stop();
+
+    HANDLE handle = CreateFileW(directory.wstring().c_str(), FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    HANDLE stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!stopEvent) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    m_directoryHandle = handle;
+    m_stopEvent = stopEvent;
+    m_callback = std::move(callback);
+    m_thread = std::thread([this]() { Run(); });
+    return true;
+}
+
+void DirectoryWatcher::Stop() {
+    if (m_thread.joinable()) {
+        SetEvent(static_cast<HANDLE>(m_stopEvent));
+        m_thread.join();
+    }
+    if (m_directoryHandle) CloseHandle(static_cast<HANDLE>(m_directoryHandle));
+    if (m_stopEvent) CloseHandle(static_cast<HANDLE>(m_stopEvent));
+    m_directoryHandle = nullptr;
+    m_stopEvent = nullptr;
+}
+
+void DirectoryWatcher::Run() {
+    HANDLE directory = static_cast<HANDLE>(m_directoryHandle);
+    HANDLE stopEvent = static_cast<HANDLE>(m_stopEvent);
+
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!overlapped.hEvent) return;
+
+    alignas(DWORD) char buffer[16 * 1024];
+    const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+    while (true) {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(directory, buffer, sizeof(buffer), FALSE, filter, nullptr, &overlapped, nullptr)) {
+            break;
+        }
+
+        HANDLE handles[2] = { overlapped.hEvent, stopEvent };
+        DWORD wait = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        if (wait != WAIT_OBJECT_0) {
+            CancelIo(directory);
+            DWORD ignored = 0;
+            GetOverlappedResult(directory, &overlapped, &ignored, TRUE);
+            break;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE)) break;
+
+        // A zero-byte result means the buffer overflowed; report an unknown change
+        if (bytes == 0) {
+            m_callback(std::string());
+            continue;
+        }
+
+        size_t offset = 0;
+        while (true) {
+            auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer + offset);
+            m_callback(WideToUtf8(info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR))));
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+}
+
+#else
+
+bool DirectoryWatcher::Start(const std::filesystem::path& directory, Callback callback) {
+    Stop();
+
+    int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (fd < 0) return false;
+
+    const uint32_t mask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+    if (inotify_add_watch(fd, directory.c_str(), mask) < 0 || pipe(m_stopPipe) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_inotifyFd = fd;
+    m_callback = std::move(callback);
+    m_thread = std::thread([this]() { Run(); });
+    return true;
+}
+
+void DirectoryWatcher::Stop() {
+    if (m_thread.joinable()) {
+        char byte = 0;
+        ssize_t written = write(m_stopPipe[1], &byte, 1);
+        (void)written;
+        m_thread.join();
+    }
+    for (int& fd : { std::ref(m_inotifyFd), std::ref(m_stopPipe[0]), std::ref(m_stopPipe[1]) }) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+}
+
+void DirectoryWatcher::Run() {
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    while (true) {
+        pollfd fds[2] = { { m_inotifyFd, POLLIN, 0 }, { m_stopPipe[0], POLLIN, 0 } };
+        if (poll(fds, 2, -1) < 0) continue;
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) continue;
+
+        for (ssize_t offset = 0; offset < length;) {
+            auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+            if (event->mask & IN_Q_OVERFLOW) {
+                m_callback(std::string());
+            } else if (event->len > 0) {
+                m_callback(std::string(event->name));
+            }
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+
+#endif
+
+} // namespace NirUI
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace NirUI {
+
+// Watches one directory (not recursive) for created, modified, renamed and
+// deleted files using ReadDirectoryChangesW on Windows and inotify elsewhere.
+// The callback runs on the watcher thread with the affected file name; several
+// notifications may arrive for a single write.
+class DirectoryWatcher {
+public:
+    using Callback = std::function<void(const std::string& fileName)>;
+
+    DirectoryWatcher() = default;
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    bool Start(const std::filesystem::path& directory, Callback callback);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+private:
+    void Run();
+
+    Callback m_callback;
+    std::thread m_thread;
+#ifdef _WIN32
+    void* m_directoryHandle = nullptr;
+    void* m_stopEvent = nullptr;
+#else
+    int m_inotifyFd = -1;
+    int m_stopPipe[2] = { -1, -1 };
+#endif
+};
+
+} // namespace NirUI
@@ -0,0 +1,53 @@
+#include "duration.h"
+#include <charconv>
+#include <utility>
+
+namespace NirUI {
+
+bool ParseDuration(std::string_view text, uint64_t& milliseconds) {
+    milliseconds = 0;
+    if (text.empty()) return false;
+
+    uint64_t bare = 0;
+    auto [bareEnd, bareEc] = std::from_chars(text.data(), text.data() + text.size(), bare);
+    if (bareEc == std::errc() && bareEnd == text.data() + text.size()) {
+        milliseconds = bare * 1000;
+        return true;
+    }
+
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    while (pos < end) {
+        uint64_t value = 0;
+        auto [unitStart, ec] = std::from_chars(pos, end, value);
+        if (ec != std::errc()) return false;
+
+        const char* unitEnd = unitStart;
+        while (unitEnd < end && *unitEnd >= 'a' && *unitEnd <= 'z') unitEnd++;
+        std::string_view unit(unitStart, unitEnd - unitStart);
+        if (unit == "ms") milliseconds += value;
+        else if (unit == "s") milliseconds += value * 1000;
+        else if (unit == "m") milliseconds += value * 60 * 1000;
+        else if (unit == "h") milliseconds += value * 3600 * 1000;
+        else if (unit == "d") milliseconds += value * 24 * 3600 * 1000;
+        else return false;
+        pos = unitEnd;
+    }
+    return true;
+}
+
+std::string FormatDuration(uint64_t milliseconds) {
+    if (milliseconds == 0) return "0s";
+    static const std::pair<uint64_t, const char*> UNITS[] = {
+        { 24 * 3600 * 1000, "d" }, { 3600 * 1000, "h" }, { 60 * 1000, "m" }, { 1000, "s" }, { 1, "ms" }
+    };
+    std::string text;
+    for (const auto& [size, name] : UNITS) {
+        if (milliseconds < size) continue;
+        text += std::to_string(milliseconds / size) + name;
+        milliseconds %= size;
+    }
+    return text;
+}
+
+} // namespace NirUI
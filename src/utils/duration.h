@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace NirUI {
+
+// Parses "500ms", "90s", "5m", "1h30m", "2d" or a bare number of seconds
+bool ParseDuration(std::string_view text, uint64_t& milliseconds);
+// Largest units first, zero parts left out: "1h30m", "2s500ms", "0s"
+std::string FormatDuration(uint64_t milliseconds);
+
+} // namespace NirUI
@@ -0,0 +1,353 @@
+#include "ipc_channel.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace NirUI {
+
+#ifdef _WIN32
+using NativeHandle = HANDLE;
+
+static bool ReadExact(NativeHandle handle, char* data, size_t size) {
+    while (size > 0) {
+        DWORD chunk = static_cast<DWORD>(size < 0x10000000 ? size : 0x10000000);
+        DWORD read = 0;
+        if (!ReadFile(handle, data, chunk, &read, nullptr) || read == 0) return false;
+        data += read;
+        size -= read;
+    }
+    return true;
+}
+
+static bool WriteAll(NativeHandle handle, const char* data, size_t size) {
+    while (size > 0) {
+        DWORD chunk = static_cast<DWORD>(size < 0x10000000 ? size : 0x10000000);
+        DWORD written = 0;
+        if (!WriteFile(handle, data, chunk, &written, nullptr) || written == 0) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+#else
+using NativeHandle = int;
+
+static bool ReadExact(NativeHandle fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t read = recv(fd, data, size, 0);
+        if (read < 0 && errno == EINTR) continue;
+        if (read <= 0) return false;
+        data += read;
+        size -= static_cast<size_t>(read);
+    }
+    return true;
+}
+
+static bool WriteAll(NativeHandle fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+
+static bool ReadFrame(NativeHandle handle, std::string& message) {
+    uint32_t length = 0;
+    if (!ReadExact(handle, reinterpret_cast<char*>(&length), sizeof(length))) return false;
+    if (length > IpcServer::MAX_MESSAGE_SIZE) return false;
+    message.resize(length);
+    return length == 0 || ReadExact(handle, &message[0], length);
+}
+
+static bool WriteFrame(NativeHandle handle, std::string_view message) {
+    if (message.size() > IpcServer::MAX_MESSAGE_SIZE) return false;
+    // One write for small messages so the peer sees header and body together
+    std::string frame;
+    frame.reserve(sizeof(uint32_t) + message.size());
+    uint32_t length = static_cast<uint32_t>(message.size());
+    frame.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    frame.append(message.data(), message.size());
+    return WriteAll(handle, frame.data(), frame.size());
+}
+
+IpcServer::~IpcServer() {
+    Close();
+}
+
+#ifdef _WIN32
+
+// SID of the user a process runs as, copied out of its token
+static bool GetProcessUserSid(HANDLE process, std::vector<unsigned char>& sid) {
+    HANDLE token = nullptr;
+    if (!OpenProcessToken(process, TOKEN_QUERY, &token)) return false;
+
+    DWORD size = 0;
+    GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+    std::vector<unsigned char> buffer(size);
+    bool ok = size > 0 && GetTokenInformation(token, TokenUser, buffer.data(), size, &size);
+    CloseHandle(token);
+    if (!ok) return false;
+
+    PSID user = reinterpret_cast<TOKEN_USER*>(buffer.data())->User.Sid;
+    if (!IsValidSid(user)) return false;
+    sid.assign(static_cast<unsigned char*>(user), static_cast<unsigned char*>(user) + GetLengthSid(user));
+    return true;
+}
+
+// The pipe name is predictable, so another user could create it before our
+// server does; only a server running as the current user gets the request
+static bool IsServerCurrentUser(HANDLE pipe) {
+    ULONG processId = 0;
+    if (!GetNamedPipeServerProcessId(pipe, &processId)) return false;
+
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!process) return false;
+
+    std::vector<unsigned char> serverSid;
+    std::vector<unsigned char> ownSid;
+    bool same = GetProcessUserSid(process, serverSid) && GetProcessUserSid(GetCurrentProcess(), ownSid) &&
+                EqualSid(serverSid.data(), ownSid.data());
+    CloseHandle(process);
+    return same;
+}
+
+std::string GetIpcEndpoint(const std::string& name) {
+    char user[256] = {};
+    DWORD userSize = sizeof(user);
+    if (!GetUserNameA(user, &userSize)) user[0] = '\0';
+
+    DWORD session = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &session);
+    return "\\\\.\\pipe\\" + name + "-" + user + "-" + std::to_string(session);
+}
+
+bool IpcServer::Listen(const std::string& name) {
+    Close();
+
+    // An explicit DACL with one entry for the current user; the default one
+    // also grants access to SYSTEM, administrators and everyone for reading
+    std::vector<unsigned char> sid;
+    if (!GetProcessUserSid(GetCurrentProcess(), sid)) return false;
+
+    DWORD aclSize = sizeof(ACL) + sizeof(ACCESS_ALLOWED_ACE) - sizeof(DWORD) + GetLengthSid(sid.data());
+    std::vector<unsigned char> aclBuffer(aclSize);
+    PACL acl = reinterpret_cast<PACL>(aclBuffer.data());
+    SECURITY_DESCRIPTOR descriptor;
+    if (!InitializeAcl(acl, aclSize, ACL_REVISION) ||
+        !AddAccessAllowedAce(acl, ACL_REVISION, GENERIC_READ | GENERIC_WRITE, sid.data()) ||
+        !InitializeSecurityDescriptor(&descriptor, SECURITY_DESCRIPTOR_REVISION) ||
+        !SetSecurityDescriptorDacl(&descriptor, TRUE, acl, FALSE)) {
+        return false;
+    }
+    SECURITY_ATTRIBUTES attributes = { sizeof(attributes), &descriptor, FALSE };
+
+    // A single instance that is reused for every client keeps the name alive
+    // between connections, so clients see a busy pipe rather than none at all
+    HANDLE pipe = CreateNamedPipeA(GetIpcEndpoint(name).c_str(),
+                                   PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                   PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                   1, 64 * 1024, 64 * 1024, 0, &attributes);
+    if (pipe == INVALID_HANDLE_VALUE) return false;
+
+    m_pipe = pipe;
+    return true;
+}
+
+void IpcServer::Serve(const Handler& handler) {
+    HANDLE pipe = static_cast<HANDLE>(m_pipe);
+    if (!pipe) return;
+
+    bool stop = false;
+    while (!stop) {
+        if (!ConnectNamedPipe(pipe, nullptr) && GetLastError() != ERROR_PIPE_CONNECTED) {
+            DisconnectNamedPipe(pipe);
+            continue;
+        }
+
+        std::string request;
+        if (ReadFrame(pipe, request)) {
+            std::string response = handler(request, stop);
+            if (WriteFrame(pipe, response)) FlushFileBuffers(pipe);
+        }
+        DisconnectNamedPipe(pipe);
+    }
+}
+
+void IpcServer::Close() {
+    if (m_pipe) CloseHandle(static_cast<HANDLE>(m_pipe));
+    m_pipe = nullptr;
+}
+
+bool IpcServer::IsListening() const {
+    return m_pipe != nullptr;
+}
+
+bool IpcRequest(const std::string& name, std::string_view request, std::string& response, int connectTimeoutMs) {
+    std::string path = GetIpcEndpoint(name);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connectTimeoutMs);
+
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    while (true) {
+        // Identification only: the server may check who we are but not act as us
+        pipe = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                           SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE) break;
+        if (GetLastError() != ERROR_PIPE_BUSY) return false;
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || !WaitNamedPipeA(path.c_str(), static_cast<DWORD>(remaining))) return false;
+    }
+
+    bool ok = IsServerCurrentUser(pipe) && WriteFrame(pipe, request) && ReadFrame(pipe, response);
+    CloseHandle(pipe);
+    return ok;
+}
+
+#else
+
+std::string GetIpcEndpoint(const std::string& name) {
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && *runtimeDir) {
+        return std::string(runtimeDir) + "/" + name + ".sock";
+    }
+    return "/tmp/" + name + "-" + std::to_string(getuid()) + ".sock";
+}
+
+static bool MakeAddress(const std::string& path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+static int ConnectSocket(const sockaddr_un& address) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int result;
+    do {
+        result = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    } while (result != 0 && errno == EINTR);
+    if (result != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Without XDG_RUNTIME_DIR the socket lives in the shared /tmp, where another
+// user could bind the name first; only a server running as us gets the request
+static bool IsServerCurrentUser(int fd) {
+#ifdef SO_PEERCRED
+    ucred credentials = {};
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) return false;
+    return credentials.uid == getuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (getpeereid(fd, &uid, &gid) != 0) return false;
+    return uid == getuid();
+#endif
+}
+
+bool IpcServer::Listen(const std::string& name) {
+    Close();
+
+    std::string path = GetIpcEndpoint(name);
+    sockaddr_un address;
+    if (!MakeAddress(path, address)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    // Only the owner may connect
+    mode_t oldMask = umask(077);
+    int result = bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    if (result != 0 && errno == EADDRINUSE) {
+        // A socket file without a live server behind it is left over from a crash
+        int probe = ConnectSocket(address);
+        if (probe >= 0) {
+            close(probe);
+        } else {
+            unlink(path.c_str());
+            result = bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        }
+    }
+    umask(oldMask);
+
+    if (result != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return false;
+    }
+
+    m_socket = fd;
+    m_socketPath = path;
+    return true;
+}
+
+void IpcServer::Serve(const Handler& handler) {
+    if (m_socket < 0) return;
+
+    bool stop = false;
+    while (!stop) {
+        int client = accept4(m_socket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        std::string request;
+        if (ReadFrame(client, request)) {
+            std::string response = handler(request, stop);
+            WriteFrame(client, response);
+        }
+        close(client);
+    }
+}
+
+void IpcServer::Close() {
+    if (m_socket >= 0) {
+        close(m_socket);
+        unlink(m_socketPath.c_str());
+    }
+    m_socket = -1;
+    m_socketPath.clear();
+}
+
+bool IpcServer::IsListening() const {
+    return m_socket >= 0;
+}
+
+bool IpcRequest(const std::string& name, std::string_view request, std::string& response, int connectTimeoutMs) {
+    (void)connectTimeoutMs; // a full backlog blocks in connect() instead
+    sockaddr_un address;
+    if (!MakeAddress(GetIpcEndpoint(name), address)) return false;
+
+    int fd = ConnectSocket(address);
+    if (fd < 0) return false;
+
+    bool ok = IsServerCurrentUser(fd) && WriteFrame(fd, request) && ReadFrame(fd, response);
+    close(fd);
+    return ok;
+}
+
+#endif
+
+} // namespace NirUI
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace NirUI {
+
+// Local request/response channel between processes of the same user: a named
+// pipe on Windows, a Unix domain socket elsewhere. Every connection carries one
+// request and one response, each framed as { u32 length, bytes }. Only the
+// current user can connect: the pipe's DACL has a single entry for the user's
+// SID and the socket is created with mode 0600. The client also checks that the
+// server runs as the same user before sending: by the server process's SID on
+// Windows, by the socket's peer credentials elsewhere.
+class IpcServer {
+public:
+    // Returns the response for one request; set stop to leave Serve() once it is sent
+    using Handler = std::function<std::string(const std::string& request, bool& stop)>;
+
+    static constexpr uint32_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    IpcServer() = default;
+    ~IpcServer();
+
+    IpcServer(const IpcServer&) = delete;
+    IpcServer& operator=(const IpcServer&) = delete;
+
+    // Fails if another live server already owns the name
+    bool Listen(const std::string& name);
+    // Handles connections one at a time on the calling thread
+    void Serve(const Handler& handler);
+    void Close();
+    bool IsListening() const;
+
+private:
+#ifdef _WIN32
+    void* m_pipe = nullptr;
+#else
+    int m_socket = -1;
+    std::string m_socketPath;
+#endif
+};
+
+// Sends one request and waits for the response. Returns false right away when no
+// server is listening; a busy server is waited for up to connectTimeoutMs.
+bool IpcRequest(const std::string& name, std::string_view request, std::string& response,
+                int connectTimeoutMs = 1000);
+
+// Pipe or socket path the name maps to for the current user
+std::string GetIpcEndpoint(const std::string& name);
+
+} // namespace NirUI
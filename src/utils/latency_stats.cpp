@@ -0,0 +1,240 @@
+#include "latency_stats.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <tuple>
+
+namespace NirUI {
+
+// Gives each thread a shard on its first sample and hands it back when the
+// thread exits
+struct LatencyShardHandle {
+    LatencyStats::Shard* shard = nullptr;
+
+    ~LatencyShardHandle() {
+        if (shard) LatencyStats::Get().ReleaseShard(shard);
+    }
+};
+
+namespace {
+
+thread_local LatencyShardHandle t_shard;
+
+} // namespace
+
+const char* GetLatencyPhaseName(LatencyPhase phase) {
+    switch (phase) {
+    case LatencyPhase::Spawn: return "spawn";
+    case LatencyPhase::Run: return "run";
+    case LatencyPhase::Drain: return "drain";
+    default: return "total";
+    }
+}
+
+size_t LatencyHistogram::GetBucket(uint64_t us) {
+    us = std::min(us, MAX_US);
+    if (us < SUB_COUNT) return static_cast<size_t>(us);
+    size_t shift = std::bit_width(us) - SUB_BITS - 1;
+    return shift * SUB_COUNT + static_cast<size_t>(us >> shift);
+}
+
+uint64_t LatencyHistogram::GetBucketLow(size_t bucket) {
+    if (bucket < SUB_COUNT) return bucket;
+    size_t shift = bucket / SUB_COUNT - 1;
+    return static_cast<uint64_t>(bucket - shift * SUB_COUNT) << shift;
+}
+
+uint64_t LatencyHistogram::GetBucketHigh(size_t bucket) {
+    if (bucket < SUB_COUNT) return bucket;
+    size_t shift = bucket / SUB_COUNT - 1;
+    return (static_cast<uint64_t>(bucket - shift * SUB_COUNT + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Add(uint64_t us) {
+    m_counts[GetBucket(us)]++;
+    m_count++;
+    m_sumUs += us;
+    m_maxUs = std::max(m_maxUs, us);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sumUs += other.m_sumUs;
+    m_maxUs = std::max(m_maxUs, other.m_maxUs);
+}
+
+uint64_t LatencyHistogram::GetQuantileUs(double q) const {
+    if (m_count == 0) return 0;
+    uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(q * m_count)), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank) return std::min((GetBucketLow(i) + GetBucketHigh(i)) / 2, m_maxUs);
+    }
+    return m_maxUs;
+}
+
+LatencyStats::Shard::~Shard() {
+    for (auto& histogram : histograms) {
+        delete histogram.load(std::memory_order_relaxed);
+    }
+}
+
+LatencyStats& LatencyStats::Get() {
+    static LatencyStats instance;
+    return instance;
+}
+
+LatencyStats::SeriesId LatencyStats::Register(std::string_view backend, std::string_view command) {
+    std::string key;
+    key.reserve(backend.size() + command.size() + 1);
+    key += backend;
+    key += '\x1f';
+    key += command;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(m_seriesMutex);
+        auto it = m_seriesIds.find(key);
+        if (it != m_seriesIds.end()) return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_seriesMutex);
+    auto it = m_seriesIds.find(key);
+    if (it != m_seriesIds.end()) return it->second;
+    if (m_series.size() >= MAX_SERIES) return INVALID_SERIES;
+
+    SeriesId id = static_cast<SeriesId>(m_series.size());
+    m_series.push_back({ std::string(backend), std::string(command) });
+    m_seriesIds.emplace(std::move(key), id);
+    return id;
+}
+
+void LatencyStats::Record(SeriesId series, LatencyPhase phase, uint64_t us) {
+    if (series >= MAX_SERIES) return;
+    size_t index = series * LATENCY_PHASE_COUNT + static_cast<size_t>(phase);
+
+    Shard* shard = t_shard.shard;
+    if (!shard) shard = t_shard.shard = AcquireShard();
+
+    ShardHistogram* histogram = shard->histograms[index].load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new ShardHistogram();
+        shard->histograms[index].store(histogram, std::memory_order_release);
+    }
+
+    // Only this thread writes the shard, so a load and a store do what an
+    // atomic increment would without the locked instruction
+    auto& count = histogram->counts[LatencyHistogram::GetBucket(us)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    histogram->sumUs.store(histogram->sumUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    if (us > histogram->maxUs.load(std::memory_order_relaxed)) {
+        histogram->maxUs.store(us, std::memory_order_relaxed);
+    }
+}
+
+void LatencyStats::RecordMs(SeriesId series, LatencyPhase phase, double ms) {
+    if (!(ms >= 0)) return;
+    Record(series, phase, static_cast<uint64_t>(std::min(ms * 1000.0 + 0.5, static_cast<double>(LatencyHistogram::MAX_US))));
+}
+
+LatencyStats::Shard* LatencyStats::AcquireShard() {
+    std::lock_guard<std::mutex> lock(m_shardMutex);
+    if (!m_freeShards.empty()) {
+        Shard* shard = m_freeShards.back();
+        m_freeShards.pop_back();
+        return shard;
+    }
+    m_shards.push_back(std::make_unique<Shard>());
+    return m_shards.back().get();
+}
+
+void LatencyStats::ReleaseShard(Shard* shard) {
+    // Its counts stay; the next thread to take it adds to them
+    std::lock_guard<std::mutex> lock(m_shardMutex);
+    m_freeShards.push_back(shard);
+}
+
+void LatencyStats::MergeInto(size_t index, LatencyHistogram& histogram) const {
+    // Caller holds m_shardMutex
+    for (const auto& shard : m_shards) {
+        const ShardHistogram* source = shard->histograms[index].load(std::memory_order_acquire);
+        if (!source) continue;
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+            uint32_t count = source->counts[i].load(std::memory_order_relaxed);
+            if (count != 0) histogram.AddBucket(i, count);
+        }
+        histogram.m_sumUs += source->sumUs.load(std::memory_order_relaxed);
+        histogram.m_maxUs = std::max(histogram.m_maxUs, source->maxUs.load(std::memory_order_relaxed));
+    }
+}
+
+bool LatencyStats::GetHistogram(SeriesId series, LatencyPhase phase, LatencyHistogram& histogram) const {
+    if (series >= MAX_SERIES) return false;
+    histogram = LatencyHistogram();
+    std::lock_guard<std::mutex> lock(m_shardMutex);
+    MergeInto(series * LATENCY_PHASE_COUNT + static_cast<size_t>(phase), histogram);
+    return histogram.GetCount() > 0;
+}
+
+std::vector<LatencySummary> LatencyStats::GetSummaries() const {
+    std::vector<Series> series;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_seriesMutex);
+        series = m_series;
+    }
+
+    std::vector<LatencySummary> summaries;
+    auto histogram = std::make_unique<LatencyHistogram>();
+    std::lock_guard<std::mutex> lock(m_shardMutex);
+    for (size_t id = 0; id < series.size(); ++id) {
+        for (size_t phase = 0; phase < LATENCY_PHASE_COUNT; ++phase) {
+            *histogram = LatencyHistogram();
+            MergeInto(id * LATENCY_PHASE_COUNT + phase, *histogram);
+            if (histogram->GetCount() == 0) continue;
+
+            LatencySummary summary;
+            summary.backend = series[id].backend;
+            summary.command = series[id].command;
+            summary.phase = static_cast<LatencyPhase>(phase);
+            summary.count = histogram->GetCount();
+            summary.meanMs = histogram->GetSumUs() / 1000.0 / summary.count;
+            summary.p50Ms = histogram->GetQuantileUs(0.50) / 1000.0;
+            summary.p90Ms = histogram->GetQuantileUs(0.90) / 1000.0;
+            summary.p99Ms = histogram->GetQuantileUs(0.99) / 1000.0;
+            summary.maxMs = histogram->GetMaxUs() / 1000.0;
+            summaries.push_back(std::move(summary));
+        }
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](const LatencySummary& a, const LatencySummary& b) {
+        return std::tie(a.backend, a.command, a.phase) < std::tie(b.backend, b.command, b.phase);
+    });
+    return summaries;
+}
+
+std::string FormatLatencyTable(const std::vector<LatencySummary>& summaries) {
+    size_t width = 7;
+    for (const auto& summary : summaries) {
+        width = std::max(width, summary.command.size());
+    }
+
+    std::string table;
+    char line[256];
+    snprintf(line, sizeof(line), "%-8s %-*s %-6s %8s %10s %10s %10s %10s %10s\n",
+             "Backend", static_cast<int>(width), "Command", "Phase", "Count", "Mean ms", "p50 ms", "p90 ms", "p99 ms", "Max ms");
+    table += line;
+    for (const auto& summary : summaries) {
+        snprintf(line, sizeof(line), "%-8s %-*s %-6s %8llu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                 summary.backend.c_str(), static_cast<int>(width), summary.command.c_str(),
+                 GetLatencyPhaseName(summary.phase), static_cast<unsigned long long>(summary.count),
+                 summary.meanMs, summary.p50Ms, summary.p90Ms, summary.p99Ms, summary.maxMs);
+        table += line;
+    }
+    return table;
+}
+
+} // namespace NirUI
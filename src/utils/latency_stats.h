@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace NirUI {
+
+// Where the time of one command went. Spawn is starting the process, Drain is
+// reading its output until the pipes close and Run is from the process starting
+// until it has exited. Total is the whole call, and the only phase builtin
+// commands have.
+enum class LatencyPhase : uint8_t {
+    Total,
+    Spawn,
+    Run,
+    Drain
+};
+
+constexpr size_t LATENCY_PHASE_COUNT = 4;
+
+const char* GetLatencyPhaseName(LatencyPhase phase);
+
+// Log-linear histogram of microsecond values in the style of HdrHistogram: each
+// power of two is split into 16 buckets, so a bucket is at most 1/16 as wide as
+// the values in it, from 1 us to about 70 minutes.
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BITS = 4;
+    static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+    static constexpr uint64_t MAX_US = 0xffffffffull;
+    static constexpr size_t BUCKETS = (32 - SUB_BITS + 1) * SUB_COUNT;
+
+    static size_t GetBucket(uint64_t us);
+    // Smallest and largest value that land in the bucket
+    static uint64_t GetBucketLow(size_t bucket);
+    static uint64_t GetBucketHigh(size_t bucket);
+
+    void Add(uint64_t us);
+    void AddBucket(size_t bucket, uint64_t count) { m_counts[bucket] += count; m_count += count; }
+    void Merge(const LatencyHistogram& other);
+
+    uint64_t GetCount() const { return m_count; }
+    uint64_t GetSumUs() const { return m_sumUs; }
+    uint64_t GetMaxUs() const { return m_maxUs; }
+    // Middle of the bucket holding the value at quantile q, at most the maximum
+    uint64_t GetQuantileUs(double q) const;
+
+private:
+    friend class LatencyStats;
+
+    std::array<uint64_t, BUCKETS> m_counts{};
+    uint64_t m_count = 0;
+    uint64_t m_sumUs = 0;
+    uint64_t m_maxUs = 0;
+};
+
+struct LatencySummary {
+    std::string backend;
+    std::string command;
+    LatencyPhase phase = LatencyPhase::Total;
+    uint64_t count = 0;
+    double meanMs = 0;
+    double p50Ms = 0;
+    double p90Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+};
+
+// Process-wide latency histograms, one per backend, command and phase. Every
+// thread records into its own shard with plain relaxed stores, so recording
+// takes no lock and shares no cache lines; readers merge the shards. A shard
+// whose thread exits is handed to the next new thread, so pools that come and
+// go do not grow the memory used.
+class LatencyStats {
+public:
+    using SeriesId = uint32_t;
+    static constexpr SeriesId INVALID_SERIES = UINT32_MAX;
+    static constexpr size_t MAX_SERIES = 1024;
+
+    static LatencyStats& Get();
+
+    // Id of a backend and command pair, made on first use. INVALID_SERIES once
+    // MAX_SERIES pairs exist; recording into it does nothing.
+    SeriesId Register(std::string_view backend, std::string_view command);
+    void Record(SeriesId series, LatencyPhase phase, uint64_t us);
+    void RecordMs(SeriesId series, LatencyPhase phase, double ms);
+
+    // Series with samples, sorted by backend, command and phase
+    std::vector<LatencySummary> GetSummaries() const;
+    bool GetHistogram(SeriesId series, LatencyPhase phase, LatencyHistogram& histogram) const;
+
+private:
+    static constexpr size_t MAX_HISTOGRAMS = MAX_SERIES * LATENCY_PHASE_COUNT;
+
+    // Written only by the thread that owns the shard
+    struct ShardHistogram {
+        std::array<std::atomic<uint32_t>, LatencyHistogram::BUCKETS> counts{};
+        std::atomic<uint64_t> sumUs{ 0 };
+        std::atomic<uint64_t> maxUs{ 0 };
+    };
+
+    struct Shard {
+        // Allocated on the first sample of each series and phase
+        std::array<std::atomic<ShardHistogram*>, MAX_HISTOGRAMS> histograms{};
+
+        ~Shard();
+    };
+
+    struct Series {
+        std::string backend;
+        std::string command;
+    };
+
+    friend struct LatencyShardHandle;
+
+    LatencyStats() = default;
+    Shard* AcquireShard();
+    void ReleaseShard(Shard* shard);
+    void MergeInto(size_t index, LatencyHistogram& histogram) const;
+
+    mutable std::shared_mutex m_seriesMutex;
+    std::unordered_map<std::string, SeriesId> m_seriesIds;
+    std::vector<Series> m_series;
+
+    mutable std::mutex m_shardMutex;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::vector<Shard*> m_freeShards;
+};
+
+// Fixed-width table of the summaries, one line per series and phase
+std::string FormatLatencyTable(const std::vector<LatencySummary>& summaries);
+
+} // namespace NirUI
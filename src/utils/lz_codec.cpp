@@ -0,0 +1,120 @@
+#include "lz_codec.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace NirUI {
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+static constexpr int HASH_BITS = 12;
+static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+static uint32_t Read32(const char* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static void AppendLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+static void AppendSequence(std::string& out, std::string_view literals, size_t offset, size_t matchLength) {
+    size_t literalCode = literals.size() < 15 ? literals.size() : 15;
+    size_t matchCode = 0;
+    if (matchLength > 0) {
+        matchCode = matchLength - MIN_MATCH < 15 ? matchLength - MIN_MATCH : 15;
+    }
+    out += static_cast<char>(literalCode << 4 | matchCode);
+    if (literalCode == 15) AppendLength(out, literals.size() - 15);
+    out.append(literals);
+
+    if (matchLength == 0) return;
+    out += static_cast<char>(offset & 0xFF);
+    out += static_cast<char>(offset >> 8);
+    if (matchCode == 15) AppendLength(out, matchLength - MIN_MATCH - 15);
+}
+
+std::string CompressBlock(std::string_view input) {
+    std::string out;
+    if (input.empty()) return out;
+    out.reserve(input.size() + input.size() / 255 + 16);
+
+    // Greedy matching; the table remembers the last position of each hashed 4-byte sequence
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, NO_POSITION);
+    const char* data = input.data();
+    size_t size = input.size();
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= size) {
+        uint32_t sequence = Read32(data + pos);
+        uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        uint32_t candidate = table[hash];
+        table[hash] = static_cast<uint32_t>(pos);
+
+        if (candidate == NO_POSITION || pos - candidate > MAX_OFFSET || Read32(data + candidate) != sequence) {
+            ++pos;
+            continue;
+        }
+
+        size_t length = MIN_MATCH;
+        while (pos + length < size && data[candidate + length] == data[pos + length]) ++length;
+
+        AppendSequence(out, input.substr(anchor, pos - anchor), pos - candidate, length);
+        pos += length;
+        anchor = pos;
+    }
+
+    AppendSequence(out, input.substr(anchor), 0, 0);
+    return out;
+}
+
+static bool ReadLength(std::string_view input, size_t& pos, size_t limit, size_t& length) {
+    while (true) {
+        if (pos >= input.size()) return false;
+        unsigned char byte = static_cast<unsigned char>(input[pos++]);
+        length += byte;
+        if (length > limit) return false;
+        if (byte != 255) return true;
+    }
+}
+
+bool DecompressBlock(std::string_view input, size_t decodedSize, std::string& output) {
+    output.clear();
+    output.reserve(decodedSize);
+
+    size_t pos = 0;
+    while (pos < input.size()) {
+        unsigned char token = static_cast<unsigned char>(input[pos++]);
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(input, pos, decodedSize, literals)) return false;
+        if (input.size() - pos < literals || decodedSize - output.size() < literals) return false;
+        output.append(input.data() + pos, literals);
+        pos += literals;
+        if (pos == input.size()) break;
+
+        if (input.size() - pos < 2) return false;
+        size_t offset = static_cast<unsigned char>(input[pos]) | static_cast<size_t>(static_cast<unsigned char>(input[pos + 1])) << 8;
+        pos += 2;
+
+        size_t length = token & 0x0F;
+        if (length == 15 && !ReadLength(input, pos, decodedSize, length)) return false;
+        length += MIN_MATCH;
+        if (offset == 0 || offset > output.size() || decodedSize - output.size() < length) return false;
+
+        // Byte by byte, since the match may overlap the bytes it produces
+        size_t from = output.size() - offset;
+        for (size_t i = 0; i < length; ++i) {
+            output += output[from + i];
+        }
+    }
+    return output.size() == decodedSize;
+}
+
+} // namespace NirUI
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace NirUI {
+
+// LZ4-style block codec. A block is a run of sequences, each a token byte
+// (literal count in the high nibble, match length - 4 in the low nibble, 15
+// meaning more length bytes follow), the literals, then a little-endian u16
+// match offset. The last sequence stops after its literals. Blocks carry no
+// header, so callers store the decoded size next to them.
+std::string CompressBlock(std::string_view input);
+
+// Fails on malformed input or if the result would not be exactly decodedSize bytes
+bool DecompressBlock(std::string_view input, size_t decodedSize, std::string& output);
+
+} // namespace NirUI
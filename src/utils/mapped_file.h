@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace NirUI {
+
+// Read-only memory mapping of a whole file. Empty files map successfully with a
+// null data pointer and zero size.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path) { Open(path); }
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+    const unsigned char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+    // Identifies the file on its volume; changes when the file is replaced by a rename
+    uint64_t GetFileId() const { return m_fileId; }
+    std::string_view GetView() const {
+        return std::string_view(reinterpret_cast<const char*>(m_data), m_size);
+    }
+
+private:
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    uint64_t m_fileId = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+} // namespace NirUI
@@ -0,0 +1,247 @@
+#include "output_buffer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <functional>
+
+namespace NirUI {
+
+OutputBuffer::OutputBuffer(size_t maxBytes)
+    : m_maxBytes(std::max(maxBytes, CHUNK_SIZE)) {
+}
+
+void OutputBuffer::Append(std::string_view text, OutputLineKind kind) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    AppendLocked(text, kind);
+    Evict();
+    m_version++;
+}
+
+void OutputBuffer::AppendLine(std::string_view text, OutputLineKind kind) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lineOpen = false;
+    AppendLocked(text, kind);
+    if (text.empty()) AppendSegment({}, kind);
+    m_lineOpen = false;
+    Evict();
+    m_version++;
+}
+
+void OutputBuffer::AppendLocked(std::string_view text, OutputLineKind kind) {
+    size_t start = 0;
+    while (true) {
+        size_t newline = text.find('\n', start);
+        std::string_view segment = text.substr(start, newline == std::string_view::npos ? std::string_view::npos : newline - start);
+        if (!segment.empty() && segment.back() == '\r') {
+            segment.remove_suffix(1);
+        }
+
+        if (newline == std::string_view::npos) {
+            if (!segment.empty()) AppendSegment(segment, kind);
+            break;
+        }
+
+        AppendSegment(segment, kind);
+        m_lineOpen = false;
+        start = newline + 1;
+    }
+}
+
+void OutputBuffer::AppendSegment(std::string_view text, OutputLineKind kind) {
+    // Longer lines are wrapped, so no chunk ever outgrows the byte budget
+    size_t maxLine = GetMaxLineBytes();
+    do {
+        if (m_lineOpen && m_lines.back().length >= maxLine) {
+            m_lineOpen = false;
+        }
+        size_t room = maxLine - (m_lineOpen ? m_lines.back().length : 0);
+        std::string_view piece = text.substr(0, room);
+        text.remove_prefix(piece.size());
+
+        if (m_lineOpen) {
+            char* dst = Reserve(piece.size(), true);
+            if (!piece.empty()) memcpy(dst, piece.data(), piece.size());
+            m_lines.back().length += static_cast<uint32_t>(piece.size());
+            continue;
+        }
+
+        char* dst = Reserve(piece.size(), false);
+        if (!piece.empty()) memcpy(dst, piece.data(), piece.size());
+
+        const Chunk& chunk = m_chunks.back();
+        LineRef line;
+        line.chunk = chunk.sequence;
+        line.offset = static_cast<uint32_t>(chunk.used - piece.size());
+        line.length = static_cast<uint32_t>(piece.size());
+        line.kind = kind;
+        m_lines.push_back(line);
+        m_lineOpen = true;
+    } while (!text.empty());
+}
+
+size_t OutputBuffer::GetMaxLineBytes() const {
+    return m_maxBytes / 2;
+}
+
+char* OutputBuffer::Reserve(size_t bytes, bool extendOpenLine) {
+    if (!m_chunks.empty()) {
+        Chunk& last = m_chunks.back();
+        if (last.capacity - last.used >= bytes) {
+            char* dst = last.data.get() + last.used;
+            last.used += bytes;
+            return dst;
+        }
+    }
+
+    // The open line is always the last thing written, so it can be moved into the
+    // new chunk to keep every line contiguous.
+    std::string_view carried;
+    if (extendOpenLine && !m_lines.empty()) {
+        carried = LineText(m_lines.back());
+    }
+
+    size_t needed = carried.size() + bytes;
+    Chunk chunk;
+    if (needed <= CHUNK_SIZE && !m_spareChunks.empty()) {
+        chunk = std::move(m_spareChunks.back());
+        m_spareChunks.pop_back();
+    } else {
+        // A growing line doubles its chunk, so a long line streamed in small
+        // pieces is copied a logarithmic number of times
+        size_t capacity = carried.empty() ? needed : needed * 2;
+        capacity = std::min(capacity, std::max(GetMaxLineBytes(), CHUNK_SIZE));
+        chunk.capacity = std::max({capacity, needed, CHUNK_SIZE});
+        chunk.data = std::make_unique<char[]>(chunk.capacity);
+    }
+    m_bytes += chunk.capacity;
+    chunk.used = 0;
+
+    if (!carried.empty()) {
+        memcpy(chunk.data.get(), carried.data(), carried.size());
+        chunk.used = carried.size();
+    }
+
+    if (extendOpenLine && !m_lines.empty()) {
+        LineRef& line = m_lines.back();
+        if (line.offset == 0) {
+            // The line filled its chunk alone; replace that chunk in place
+            // rather than leaving a stale copy behind
+            chunk.sequence = line.chunk;
+            Chunk old = std::move(m_chunks.back());
+            m_chunks.back() = std::move(chunk);
+            RecycleChunk(std::move(old));
+        } else {
+            chunk.sequence = m_nextChunkSequence++;
+            line.chunk = chunk.sequence;
+            line.offset = 0;
+            m_chunks.push_back(std::move(chunk));
+        }
+    } else {
+        chunk.sequence = m_nextChunkSequence++;
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    Chunk& last = m_chunks.back();
+    char* dst = last.data.get() + last.used;
+    last.used += bytes;
+    return dst;
+}
+
+void OutputBuffer::Evict() {
+    while (m_bytes > m_maxBytes && m_chunks.size() > 1) {
+        Chunk chunk = std::move(m_chunks.front());
+        m_chunks.pop_front();
+
+        while (!m_lines.empty() && m_lines.front().chunk == chunk.sequence) {
+            m_lines.pop_front();
+        }
+
+        RecycleChunk(std::move(chunk));
+    }
+}
+
+void OutputBuffer::RecycleChunk(Chunk&& chunk) {
+    m_bytes -= chunk.capacity;
+    if (chunk.capacity == CHUNK_SIZE && m_spareChunks.empty()) {
+        m_spareChunks.push_back(std::move(chunk));
+    }
+}
+
+void OutputBuffer::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& chunk : m_chunks) {
+        RecycleChunk(std::move(chunk));
+    }
+    m_chunks.clear();
+    m_lines.clear();
+    m_lineOpen = false;
+    m_version++;
+}
+
+std::string_view OutputBuffer::LineText(const LineRef& line) const {
+    const Chunk& chunk = m_chunks[static_cast<size_t>(line.chunk - m_chunks.front().sequence)];
+    return std::string_view(chunk.data.get() + line.offset, line.length);
+}
+
+void OutputBuffer::SetMaxBytes(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxBytes = std::max(maxBytes, CHUNK_SIZE);
+    Evict();
+    m_version++;
+}
+
+size_t OutputBuffer::GetMaxBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxBytes;
+}
+
+size_t OutputBuffer::GetLineCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lines.size();
+}
+
+size_t OutputBuffer::GetByteCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+uint64_t OutputBuffer::GetVersion() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_version;
+}
+
+std::string OutputBuffer::GetText() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string text;
+    for (const auto& line : m_lines) {
+        text += LineText(line);
+        text += '\n';
+    }
+    return text;
+}
+
+std::vector<size_t> OutputBuffer::Search(std::string_view needle, bool matchCase, size_t maxResults) const {
+    std::vector<size_t> results;
+    if (needle.empty()) return results;
+
+    auto fold = [matchCase](char c) {
+        return matchCase ? c : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    };
+    auto hash = [fold](char c) { return std::hash<char>()(fold(c)); };
+    auto equal = [fold](char a, char b) { return fold(a) == fold(b); };
+    std::boyer_moore_horspool_searcher searcher(needle.begin(), needle.end(), hash, equal);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_lines.size() && results.size() < maxResults; ++i) {
+        std::string_view text = LineText(m_lines[i]);
+        if (text.size() < needle.size()) continue;
+        if (std::search(text.begin(), text.end(), searcher) != text.end()) {
+            results.push_back(i);
+        }
+    }
+    return results;
+}
+
+} // namespace NirUI
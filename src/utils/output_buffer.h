@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+enum class OutputLineKind : uint8_t {
+    Normal, Error, Command
+};
+
+// Console text storage. Lines are packed into fixed-size chunks that are recycled
+// once the byte budget is exceeded, and a line-offset index allows rendering and
+// searching only the lines that are needed. Lines longer than half the budget are
+// wrapped so the budget always holds. Appends may come from worker threads.
+class OutputBuffer {
+public:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_MAX_BYTES = 4 * 1024 * 1024;
+
+    explicit OutputBuffer(size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    void Append(std::string_view text, OutputLineKind kind = OutputLineKind::Normal);
+    void AppendLine(std::string_view text, OutputLineKind kind = OutputLineKind::Normal);
+    void Clear();
+
+    void SetMaxBytes(size_t maxBytes);
+    size_t GetMaxBytes() const;
+    size_t GetLineCount() const;
+    size_t GetByteCount() const;
+    uint64_t GetVersion() const;
+
+    // Calls visitor(index, text, kind) for lines in [first, last) while holding the lock
+    template <typename Visitor>
+    void VisitLines(size_t first, size_t last, Visitor&& visitor) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        last = last < m_lines.size() ? last : m_lines.size();
+        for (size_t i = first; i < last; ++i) {
+            visitor(i, LineText(m_lines[i]), m_lines[i].kind);
+        }
+    }
+
+    std::string GetText() const;
+    std::vector<size_t> Search(std::string_view needle, bool matchCase = false, size_t maxResults = 1000) const;
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t capacity = 0;
+        size_t used = 0;
+        uint64_t sequence = 0;
+    };
+
+    struct LineRef {
+        uint64_t chunk;
+        uint32_t offset;
+        uint32_t length;
+        OutputLineKind kind;
+    };
+
+    void AppendLocked(std::string_view text, OutputLineKind kind);
+    void AppendSegment(std::string_view text, OutputLineKind kind);
+    void RecycleChunk(Chunk&& chunk);
+    size_t GetMaxLineBytes() const;
+    char* Reserve(size_t bytes, bool extendOpenLine);
+    void Evict();
+    std::string_view LineText(const LineRef& line) const;
+
+    mutable std::mutex m_mutex;
+    std::deque<Chunk> m_chunks;
+    std::vector<Chunk> m_spareChunks;
+    std::deque<LineRef> m_lines;
+    uint64_t m_nextChunkSequence = 0;
+    size_t m_maxBytes;
+    size_t m_bytes = 0;
+    uint64_t m_version = 0;
+    bool m_lineOpen = false;
+};
+
+} // namespace NirUI
@@ -0,0 +1,208 @@
+#include "priority_executor.h"
+#include <algorithm>
+#include <bit>
+
+namespace NirUI {
+
+namespace {
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+const char* GetWorkClassName(WorkClass workClass) {
+    switch (workClass) {
+    case WorkClass::Interactive: return "interactive";
+    case WorkClass::Group: return "group";
+    case WorkClass::Scheduled: return "scheduled";
+    default: return "bulk";
+    }
+}
+
+PriorityExecutor::PriorityExecutor(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_backgroundLimit = std::max<size_t>(threadCount - 1, 1);
+    m_classes[static_cast<size_t>(WorkClass::Interactive)].limit = threadCount;
+    m_classes[static_cast<size_t>(WorkClass::Group)].limit = m_backgroundLimit;
+    m_classes[static_cast<size_t>(WorkClass::Scheduled)].limit = m_backgroundLimit;
+    m_classes[static_cast<size_t>(WorkClass::Bulk)].limit = std::max<size_t>(threadCount / 2, 1);
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+PriorityExecutor::~PriorityExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void PriorityExecutor::SetLimit(WorkClass workClass, size_t maxRunning) {
+    m_classes[static_cast<size_t>(workClass)].limit = std::max<size_t>(maxRunning, 1);
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_epoch++;
+    }
+    m_wake.notify_all();
+}
+
+void PriorityExecutor::SetAgingStep(std::chrono::milliseconds step) {
+    m_agingStepUs = std::chrono::duration_cast<std::chrono::microseconds>(step).count();
+}
+
+void PriorityExecutor::Enqueue(WorkClass workClass, std::function<void()> run) {
+    ClassQueue& queue = m_classes[static_cast<size_t>(workClass)];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({ std::move(run), NowUs() });
+        if (queue.tasks.size() == 1) queue.oldestUs = queue.tasks.front().enqueuedUs;
+        queue.queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_epoch++;
+    }
+    m_wake.notify_one();
+}
+
+bool PriorityExecutor::Reserve(size_t index) {
+    ClassQueue& queue = m_classes[index];
+    if (queue.running.fetch_add(1) >= queue.limit) {
+        queue.running--;
+        return false;
+    }
+    if (index != static_cast<size_t>(WorkClass::Interactive) && m_backgroundRunning.fetch_add(1) >= m_backgroundLimit) {
+        m_backgroundRunning--;
+        queue.running--;
+        return false;
+    }
+    return true;
+}
+
+void PriorityExecutor::Release(size_t index) {
+    if (index != static_cast<size_t>(WorkClass::Interactive)) m_backgroundRunning--;
+    m_classes[index].running--;
+}
+
+bool PriorityExecutor::RunNext() {
+    int64_t now = NowUs();
+    int64_t agingStep = m_agingStepUs;
+
+    // Lower scores go first. Each aging step waited counts as one class.
+    size_t order[WORK_CLASS_COUNT];
+    int64_t scores[WORK_CLASS_COUNT];
+    size_t candidates = 0;
+    for (size_t i = 0; i < WORK_CLASS_COUNT; ++i) {
+        const ClassQueue& queue = m_classes[i];
+        if (queue.queued == 0 || queue.running >= queue.limit) continue;
+        int64_t score = static_cast<int64_t>(i);
+        if (agingStep > 0) score = score * agingStep - (now - queue.oldestUs);
+        size_t pos = candidates++;
+        while (pos > 0 && scores[pos - 1] > score) {
+            order[pos] = order[pos - 1];
+            scores[pos] = scores[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+        scores[pos] = score;
+    }
+
+    for (size_t c = 0; c < candidates; ++c) {
+        size_t index = order[c];
+        if (!Reserve(index)) continue;
+
+        ClassQueue& queue = m_classes[index];
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                Release(index);
+                continue;
+            }
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            queue.queued--;
+            queue.oldestUs = queue.tasks.empty() ? 0 : queue.tasks.front().enqueuedUs;
+        }
+
+        RecordWait(queue, NowUs() - task.enqueuedUs);
+        task.run();
+        Release(index);
+        return true;
+    }
+    return false;
+}
+
+void PriorityExecutor::RecordWait(ClassQueue& queue, int64_t waitUs) {
+    uint64_t wait = static_cast<uint64_t>(std::max<int64_t>(waitUs, 0));
+    size_t bucket = std::min<size_t>(std::bit_width(wait), WAIT_BUCKETS - 1);
+    queue.waitBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    queue.started.fetch_add(1, std::memory_order_relaxed);
+    queue.totalWaitUs.fetch_add(wait, std::memory_order_relaxed);
+
+    uint64_t max = queue.maxWaitUs.load(std::memory_order_relaxed);
+    while (wait > max && !queue.maxWaitUs.compare_exchange_weak(max, wait, std::memory_order_relaxed)) {
+    }
+}
+
+PriorityExecutor::ClassStats PriorityExecutor::GetStats(WorkClass workClass) const {
+    const ClassQueue& queue = m_classes[static_cast<size_t>(workClass)];
+    ClassStats stats;
+    stats.queued = queue.queued;
+    stats.running = queue.running;
+    stats.started = queue.started.load(std::memory_order_relaxed);
+    stats.maxWaitMs = queue.maxWaitUs.load(std::memory_order_relaxed) / 1000.0;
+    if (stats.started == 0) return stats;
+    stats.averageWaitMs = queue.totalWaitUs.load(std::memory_order_relaxed) / 1000.0 / stats.started;
+
+    uint64_t counts[WAIT_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < WAIT_BUCKETS; ++i) {
+        counts[i] = queue.waitBuckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    auto percentile = [&](double p) {
+        uint64_t rank = static_cast<uint64_t>(p * total + 0.5);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < WAIT_BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank && seen > 0) return std::min(static_cast<double>(1ull << i) / 1000.0, stats.maxWaitMs);
+        }
+        return stats.maxWaitMs;
+    };
+    stats.p50WaitMs = percentile(0.50);
+    stats.p99WaitMs = percentile(0.99);
+    return stats;
+}
+
+void PriorityExecutor::WorkerLoop() {
+    while (true) {
+        uint64_t epoch;
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            if (m_stopping) return;
+            epoch = m_epoch;
+        }
+        if (RunNext()) continue;
+
+        // Nothing could start; sleep until new work arrives or limits change.
+        // A finishing worker looks for more work itself, so completions need
+        // no wakeup.
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [&]() { return m_stopping || m_epoch != epoch; });
+    }
+}
+
+} // namespace NirUI
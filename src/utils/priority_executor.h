@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace NirUI {
+
+// Where a piece of work comes from, most urgent first
+enum class WorkClass : uint8_t {
+    Interactive,    // a click or tray action the user is waiting on
+    Group,          // one step of an app group action
+    Scheduled,      // a timer firing
+    Bulk            // scripts and other batch work
+};
+
+constexpr size_t WORK_CLASS_COUNT = 4;
+const char* GetWorkClassName(WorkClass workClass);
+
+// Worker pool that runs the most urgent queued work first. Each class has its
+// own queue and lock and a limit on how many of its tasks run at once, and one
+// worker is held back from the background classes so an interactive command
+// never waits for a long group action or script to finish. A queued task gains
+// one class of priority per aging step it has waited, so bulk work still moves
+// under a steady stream of clicks. Tasks that are still queued when the
+// executor is destroyed are dropped.
+class PriorityExecutor {
+public:
+    struct ClassStats {
+        size_t queued = 0;
+        size_t running = 0;
+        uint64_t started = 0;
+        // Time from Submit() until a worker picked the task up. Percentiles
+        // are upper bounds of power-of-two buckets.
+        double averageWaitMs = 0;
+        double p50WaitMs = 0;
+        double p99WaitMs = 0;
+        double maxWaitMs = 0;
+    };
+
+    // Limits default to every worker for interactive work, all but one for
+    // group and scheduled work, and half for bulk work
+    explicit PriorityExecutor(size_t threadCount = 0);
+    ~PriorityExecutor();
+
+    PriorityExecutor(const PriorityExecutor&) = delete;
+    PriorityExecutor& operator=(const PriorityExecutor&) = delete;
+
+    template <typename Func>
+    auto Submit(WorkClass workClass, Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> future = task->get_future();
+        Enqueue(workClass, [task]() { (*task)(); });
+        return future;
+    }
+
+    void SetLimit(WorkClass workClass, size_t maxRunning);
+    // Zero turns aging off
+    void SetAgingStep(std::chrono::milliseconds step);
+
+    ClassStats GetStats(WorkClass workClass) const;
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+private:
+    static constexpr size_t WAIT_BUCKETS = 40;
+
+    struct Task {
+        std::function<void()> run;
+        int64_t enqueuedUs = 0;
+    };
+
+    struct ClassQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        // Mirrors of the queue state so workers can pick a class without locking
+        std::atomic<size_t> queued{ 0 };
+        std::atomic<int64_t> oldestUs{ 0 };
+        std::atomic<size_t> running{ 0 };
+        std::atomic<size_t> limit{ 0 };
+
+        std::atomic<uint64_t> started{ 0 };
+        std::atomic<uint64_t> totalWaitUs{ 0 };
+        std::atomic<uint64_t> maxWaitUs{ 0 };
+        // Bucket i counts waits below 2^i microseconds
+        std::array<std::atomic<uint64_t>, WAIT_BUCKETS> waitBuckets{};
+    };
+
+    void Enqueue(WorkClass workClass, std::function<void()> run);
+    // Runs one task; false if nothing could start
+    bool RunNext();
+    bool Reserve(size_t index);
+    void Release(size_t index);
+    void RecordWait(ClassQueue& queue, int64_t waitUs);
+    void WorkerLoop();
+
+    std::array<ClassQueue, WORK_CLASS_COUNT> m_classes;
+    std::atomic<size_t> m_backgroundRunning{ 0 };
+    size_t m_backgroundLimit = 1;
+    std::atomic<int64_t> m_agingStepUs{ 250000 };
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    uint64_t m_epoch = 0;
+    bool m_stopping = false;
+};
+
+} // namespace NirUI
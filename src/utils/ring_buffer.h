@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace NirUI {
+
+// Fixed-capacity FIFO. Pushing onto a full buffer overwrites the oldest item, so
+// inserts are O(1) and never reallocate. Index 0 is the oldest item.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) : m_items(capacity) {}
+
+    size_t GetCapacity() const { return m_items.size(); }
+    size_t GetSize() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+
+    void Push(T item) {
+        if (m_items.empty()) return;
+        m_items[(m_start + m_size) % m_items.size()] = std::move(item);
+        if (m_size < m_items.size()) {
+            ++m_size;
+        } else {
+            m_start = (m_start + 1) % m_items.size();
+        }
+    }
+
+    void Clear() {
+        for (auto& item : m_items) item = T();
+        m_start = 0;
+        m_size = 0;
+    }
+
+    T& operator[](size_t index) { return m_items[(m_start + index) % m_items.size()]; }
+    const T& operator[](size_t index) const { return m_items[(m_start + index) % m_items.size()]; }
+
+private:
+    std::vector<T> m_items;
+    size_t m_start = 0;
+    size_t m_size = 0;
+};
+
+} // namespace NirUI
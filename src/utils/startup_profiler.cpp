@@ -0,0 +1,59 @@
+#include "startup_profiler.h"
+#include <cstdlib>
+#include <fstream>
+
+namespace NirUI {
+
+// Constructed during static initialization so the baseline is as close to process
+// start as we can get without platform calls.
+static StartupProfiler& s_startupProfiler = StartupProfiler::Get();
+
+StartupProfiler& StartupProfiler::Get() {
+    static StartupProfiler instance;
+    return instance;
+}
+
+StartupProfiler::StartupProfiler() : m_start(std::chrono::steady_clock::now()) {
+}
+
+void StartupProfiler::Mark(const std::string& phase) {
+    double elapsed = GetElapsedMs();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.emplace_back(phase, elapsed);
+}
+
+double StartupProfiler::GetElapsedMs() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+double StartupProfiler::GetPhaseMs(const std::string& phase) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, ms] : m_phases) {
+        if (name == phase) return ms;
+    }
+    return -1.0;
+}
+
+std::vector<std::pair<std::string, double>> StartupProfiler::GetPhases() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_phases;
+}
+
+bool StartupProfiler::WriteReport(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    
+    for (const auto& [name, ms] : GetPhases()) {
+        file << name << "," << ms << "\n";
+    }
+    return true;
+}
+
+void StartupProfiler::WriteReportFromEnvironment() const {
+    const char* path = std::getenv("NIRUI_STARTUP_REPORT");
+    if (path && path[0] != '\0') {
+        WriteReport(path);
+    }
+}
+
+} // namespace NirUI
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace NirUI {
+
+// Records named startup phases relative to process start. When NIRUI_STARTUP_REPORT
+// names a file, WriteReportFromEnvironment() writes "phase,milliseconds" lines to it
+// so CI can track time-to-first-frame and time-to-interactive.
+class StartupProfiler {
+public:
+    static StartupProfiler& Get();
+    
+    void Mark(const std::string& phase);
+    double GetElapsedMs() const;
+    double GetPhaseMs(const std::string& phase) const;
+    std::vector<std::pair<std::string, double>> GetPhases() const;
+    
+    bool WriteReport(const std::filesystem::path& path) const;
+    void WriteReportFromEnvironment() const;
+    
+private:
+    StartupProfiler();
+    
+    std::chrono::steady_clock::time_point m_start;
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<std::string, double>> m_phases;
+};
+
+} // namespace NirUI
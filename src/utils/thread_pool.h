@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace NirUI {
+
+// Fixed-size worker pool. Tasks run in submission order; Submit() returns a future
+// for the task's result. Shared() is sized to the hardware concurrency.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& Shared();
+
+    template <typename Func>
+    auto Submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> future = task->get_future();
+        Enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    // Runs func(i) for i in [0, count) across the pool and waits for all of them
+    template <typename Func>
+    void ParallelFor(size_t count, Func&& func) {
+        std::vector<std::future<void>> pending;
+        pending.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            pending.push_back(Submit([&func, i]() { func(i); }));
+        }
+        for (auto& future : pending) {
+            future.get();
+        }
+    }
+
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+private:
+    void Enqueue(std::function<void()> task);
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+} // namespace NirUI
@@ -0,0 +1,164 @@
+#include "timer_wheel.h"
+#include <algorithm>
+#include <bit>
+
+namespace NirUI {
+
+TimerWheel::TimerWheel(uint64_t currentTick) : m_current(currentTick) {
+    m_heads.fill(NONE);
+    m_tails.fill(NONE);
+}
+
+TimerWheel::TimerId TimerWheel::Add(uint64_t tick, uint64_t payload) {
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.tick = tick;
+    node.payload = payload;
+    Place(index);
+    m_count++;
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    if (index >= m_nodes.size()) return false;
+    Node& node = m_nodes[index];
+    if (node.bucket == NONE || node.generation != static_cast<uint32_t>(id >> 32)) return false;
+
+    Unlink(index);
+    Release(index);
+    return true;
+}
+
+void TimerWheel::Place(uint32_t index) {
+    // Overdue timers go in the current level-0 slot, which the next Advance()
+    // drains before moving on
+    uint64_t tick = std::max(m_nodes[index].tick, m_current);
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        unsigned shift = SLOT_BITS * (level + 1);
+        if ((tick >> shift) == (m_current >> shift)) {
+            uint32_t slot = static_cast<uint32_t>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+            Link(index, level * SLOTS + slot);
+            return;
+        }
+    }
+    Link(index, OVERFLOW_BUCKET);
+}
+
+void TimerWheel::Link(uint32_t index, uint32_t bucket) {
+    Node& node = m_nodes[index];
+    node.bucket = bucket;
+    node.next = NONE;
+    node.prev = m_tails[bucket];
+    if (node.prev != NONE) {
+        m_nodes[node.prev].next = index;
+    } else {
+        m_heads[bucket] = index;
+    }
+    m_tails[bucket] = index;
+    if (bucket != OVERFLOW_BUCKET) m_occupied[bucket / SLOTS] |= 1ull << (bucket % SLOTS);
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+    Node& node = m_nodes[index];
+    uint32_t bucket = node.bucket;
+    if (node.prev != NONE) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_heads[bucket] = node.next;
+    }
+    if (node.next != NONE) {
+        m_nodes[node.next].prev = node.prev;
+    } else {
+        m_tails[bucket] = node.prev;
+    }
+    if (m_heads[bucket] == NONE && bucket != OVERFLOW_BUCKET) {
+        m_occupied[bucket / SLOTS] &= ~(1ull << (bucket % SLOTS));
+    }
+    node.prev = node.next = NONE;
+    node.bucket = NONE;
+}
+
+void TimerWheel::Release(uint32_t index) {
+    Node& node = m_nodes[index];
+    node.bucket = NONE;
+    // Bumping the generation invalidates ids handed out for the old timer
+    if (++node.generation == 0) node.generation = 1;
+    m_free.push_back(index);
+    m_count--;
+}
+
+void TimerWheel::Redistribute(uint32_t bucket) {
+    uint32_t index = m_heads[bucket];
+    m_heads[bucket] = NONE;
+    m_tails[bucket] = NONE;
+    if (bucket != OVERFLOW_BUCKET) m_occupied[bucket / SLOTS] &= ~(1ull << (bucket % SLOTS));
+
+    while (index != NONE) {
+        uint32_t next = m_nodes[index].next;
+        Place(index);
+        index = next;
+    }
+}
+
+uint64_t TimerWheel::GetNextTick() const {
+    uint64_t next = NEVER;
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        unsigned shift = SLOT_BITS * level;
+        unsigned digit = static_cast<unsigned>((m_current >> shift) & (SLOTS - 1));
+        // Level 0 includes the current slot, which only holds overdue timers
+        uint64_t above = level == 0 ? (1ull << digit) - 1 : (2ull << digit) - 1;
+        uint64_t pending = m_occupied[level] & ~above;
+        if (pending == 0) continue;
+
+        unsigned blockShift = shift + SLOT_BITS;
+        uint64_t tick = ((m_current >> blockShift) << blockShift) |
+                        (static_cast<uint64_t>(std::countr_zero(pending)) << shift);
+        next = std::min(next, tick);
+    }
+    if (m_heads[OVERFLOW_BUCKET] != NONE) {
+        unsigned shift = SLOT_BITS * LEVELS;
+        next = std::min(next, ((m_current >> shift) + 1) << shift);
+    }
+    return next;
+}
+
+void TimerWheel::Advance(uint64_t tick, std::vector<Expired>& expired) {
+    while (true) {
+        // Everything in the current level-0 slot is due
+        uint32_t bucket = static_cast<uint32_t>(m_current & (SLOTS - 1));
+        while (m_heads[bucket] != NONE) {
+            uint32_t index = m_heads[bucket];
+            Node& node = m_nodes[index];
+            expired.push_back({ (static_cast<uint64_t>(node.generation) << 32) | index, node.payload, node.tick });
+            Unlink(index);
+            Release(index);
+        }
+
+        uint64_t next = GetNextTick();
+        if (next == NEVER || next > tick) break;
+        m_current = next;
+
+        // Entering a slot on an upper level moves its timers down, highest
+        // level first so they can cascade all the way to level 0 in one step
+        unsigned topShift = SLOT_BITS * LEVELS;
+        if ((m_current & ((1ull << topShift) - 1)) == 0) Redistribute(OVERFLOW_BUCKET);
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            unsigned shift = SLOT_BITS * level;
+            if ((m_current & ((1ull << shift) - 1)) != 0) continue;
+            uint32_t slot = static_cast<uint32_t>((m_current >> shift) & (SLOTS - 1));
+            if (m_heads[level * SLOTS + slot] != NONE) Redistribute(level * SLOTS + slot);
+        }
+    }
+    m_current = std::max(m_current, tick);
+}
+
+} // namespace NirUI
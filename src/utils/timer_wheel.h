@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NirUI {
+
+// Hierarchical timer wheel over integer ticks. Each level has 64 slots; a timer
+// sits on the lowest level whose block also contains the current tick, and
+// moves down a level when the current tick enters its slot. Timers further out
+// than the top level wait in an overflow list. Add and Cancel are O(1), and
+// Advance skips empty stretches using per-level occupancy bitmaps, so a long
+// idle gap costs nothing.
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    static constexpr TimerId INVALID_TIMER = 0;
+    static constexpr uint64_t NEVER = UINT64_MAX;
+
+    struct Expired {
+        TimerId id = INVALID_TIMER;
+        uint64_t payload = 0;
+        uint64_t tick = 0;
+    };
+
+    explicit TimerWheel(uint64_t currentTick = 0);
+
+    // Ticks at or before the current tick fire on the next Advance()
+    TimerId Add(uint64_t tick, uint64_t payload);
+    bool Cancel(TimerId id);
+
+    // Moves to tick, appending every timer that expires on the way in tick order
+    void Advance(uint64_t tick, std::vector<Expired>& expired);
+    // Next tick at which Advance() has work to do: an expiry, or an earlier
+    // point where a level must be redistributed. NEVER if no timers are left.
+    uint64_t GetNextTick() const;
+
+    uint64_t GetCurrentTick() const { return m_current; }
+    size_t GetCount() const { return m_count; }
+
+private:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS;
+    static constexpr unsigned LEVELS = 5;
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint32_t OVERFLOW_BUCKET = LEVELS * SLOTS;
+
+    struct Node {
+        uint64_t tick = 0;
+        uint64_t payload = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t bucket = NONE;     // NONE while the node is free
+        uint32_t generation = 1;
+    };
+
+    void Place(uint32_t index);
+    void Link(uint32_t index, uint32_t bucket);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    // Re-places every timer in a bucket against the current tick
+    void Redistribute(uint32_t bucket);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_free;
+    std::array<uint32_t, OVERFLOW_BUCKET + 1> m_heads;
+    std::array<uint32_t, OVERFLOW_BUCKET + 1> m_tails;
+    std::array<uint64_t, LEVELS> m_occupied = {};
+    uint64_t m_current = 0;
+    size_t m_count = 0;
+};
+
+} // namespace NirUI
@@ -0,0 +1,201 @@
+#include "trace_recorder.h"
+#include "atomic_file.h"
+#include <cstdio>
+
+namespace NirUI {
+
+namespace {
+
+void AppendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+// Chrome trace times are microseconds; keep nanosecond precision as decimals
+void AppendMicroseconds(std::string& out, int64_t ns) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+TraceRecorder::ThreadBuffer::~ThreadBuffer() {
+    Chunk* chunk = first.next.load(std::memory_order_relaxed);
+    while (chunk) {
+        Chunk* next = chunk->next.load(std::memory_order_relaxed);
+        delete chunk;
+        chunk = next;
+    }
+}
+
+TraceRecorder& TraceRecorder::Get() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder() : m_origin(std::chrono::steady_clock::now()) {
+}
+
+void TraceRecorder::Start() {
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::Stop() {
+    s_enabled.store(false, std::memory_order_relaxed);
+}
+
+int64_t TraceRecorder::GetNowNs() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count();
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetThreadBuffer() {
+    if (s_threadBuffer) return s_threadBuffer;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers.push_back(std::make_unique<ThreadBuffer>());
+    ThreadBuffer* buffer = m_buffers.back().get();
+    buffer->threadId = static_cast<uint32_t>(m_buffers.size());
+    s_threadBuffer = buffer;
+    return buffer;
+}
+
+void TraceRecorder::SetThreadName(std::string_view name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    buffer->name = name;
+}
+
+void TraceRecorder::AddZone(const char* name, std::string_view detail, int64_t startNs, int64_t endNs) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer->total >= MAX_THREAD_EVENTS) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Chunk* chunk = buffer->last;
+    size_t count = chunk->count.load(std::memory_order_relaxed);
+    if (count == CHUNK_EVENTS) {
+        Chunk* next = new Chunk();
+        chunk->next.store(next, std::memory_order_release);
+        buffer->last = chunk = next;
+        count = 0;
+    }
+
+    Event& event = chunk->events[count];
+    event.name = name;
+    event.detail = detail;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    // Readers only look at events below the count
+    chunk->count.store(count + 1, std::memory_order_release);
+    buffer->total++;
+}
+
+size_t TraceRecorder::GetEventCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& buffer : m_buffers) {
+        for (const Chunk* chunk = &buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            count += chunk->count.load(std::memory_order_acquire);
+        }
+    }
+    return count;
+}
+
+uint64_t TraceRecorder::GetDroppedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : m_buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::filesystem::path& path) const {
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first) json += ",\n";
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& buffer : m_buffers) {
+        std::string tid = std::to_string(buffer->threadId);
+        if (!buffer->name.empty()) {
+            beginEvent();
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+            AppendJsonString(json, buffer->name);
+            json += "}}";
+        }
+
+        for (const Chunk* chunk = &buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; ++i) {
+                const Event& event = chunk->events[i];
+                beginEvent();
+                json += "{\"name\":";
+                AppendJsonString(json, event.name);
+                json += ",\"cat\":\"nirui\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+                AppendMicroseconds(json, event.startNs);
+                json += ",\"dur\":";
+                AppendMicroseconds(json, event.durationNs);
+                if (!event.detail.empty()) {
+                    json += ",\"args\":{\"detail\":";
+                    AppendJsonString(json, event.detail);
+                    json += "}";
+                }
+                json += "}";
+            }
+        }
+    }
+    json += "\n]}\n";
+    return WriteFileAtomically(path, json);
+}
+
+void TraceZone::Begin(const char* name, std::string_view detail) {
+    m_name = name;
+    m_detail = detail;
+    m_startNs = TraceRecorder::Get().GetNowNs();
+}
+
+void TraceZone::Finish() {
+    TraceRecorder& recorder = TraceRecorder::Get();
+    recorder.AddZone(m_name, m_detail, m_startNs, recorder.GetNowNs());
+    m_name = nullptr;
+}
+
+TraceFile::TraceFile(std::filesystem::path path) : m_path(std::move(path)) {
+    if (m_path.empty()) return;
+    TraceRecorder::Get().SetThreadName("main");
+    TraceRecorder::Get().Start();
+}
+
+TraceFile::~TraceFile() {
+    if (m_path.empty()) return;
+    TraceRecorder& recorder = TraceRecorder::Get();
+    recorder.Stop();
+    if (!recorder.WriteChromeTrace(m_path)) {
+        fprintf(stderr, "Failed to write trace to %s\n", m_path.string().c_str());
+    }
+}
+
+} // namespace NirUI
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NirUI {
+
+// Timeline of scoped zones, written as Chrome trace event JSON for
+// chrome://tracing or ui.perfetto.dev. Nothing is recorded until Start(); until
+// then a TraceZone costs one relaxed load. Each thread appends to its own
+// chunked buffer and publishes every event with a release store of the chunk's
+// count, so recording takes no lock and the trace can be written while other
+// threads are still recording.
+class TraceRecorder {
+public:
+    static TraceRecorder& Get();
+
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    void Start();
+    void Stop();
+
+    // Names the calling thread in the trace
+    void SetThreadName(std::string_view name);
+    // Called by TraceZone. Name must outlive the recorder; detail is copied.
+    void AddZone(const char* name, std::string_view detail, int64_t startNs, int64_t endNs);
+    int64_t GetNowNs() const;
+
+    size_t GetEventCount() const;
+    // Events dropped because a thread reached MAX_THREAD_EVENTS
+    uint64_t GetDroppedCount() const;
+    bool WriteChromeTrace(const std::filesystem::path& path) const;
+
+private:
+    static constexpr size_t CHUNK_EVENTS = 1024;
+    static constexpr size_t MAX_THREAD_EVENTS = size_t(1) << 20;
+
+    struct Event {
+        const char* name = nullptr;
+        std::string detail;
+        int64_t startNs = 0;
+        int64_t durationNs = 0;
+    };
+
+    struct Chunk {
+        std::array<Event, CHUNK_EVENTS> events;
+        std::atomic<size_t> count{ 0 };
+        std::atomic<Chunk*> next{ nullptr };
+    };
+
+    // Appended to only by its thread; kept after the thread exits
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::string name;           // guarded by m_mutex
+        Chunk first;
+        Chunk* last = &first;
+        size_t total = 0;
+        std::atomic<uint64_t> dropped{ 0 };
+
+        ~ThreadBuffer();
+    };
+
+    TraceRecorder();
+    ThreadBuffer* GetThreadBuffer();
+
+    static inline std::atomic<bool> s_enabled{ false };
+    static inline thread_local ThreadBuffer* s_threadBuffer = nullptr;
+
+    std::chrono::steady_clock::time_point m_origin;
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
+
+// Records the time from construction to End() or destruction as one zone. The
+// detail, such as the command line, shows as an argument of the event.
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) {
+        if (TraceRecorder::IsEnabled()) Begin(name, std::string_view());
+    }
+    TraceZone(const char* name, std::string_view detail) {
+        if (TraceRecorder::IsEnabled()) Begin(name, detail);
+    }
+    ~TraceZone() { End(); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+    void End() {
+        if (m_name) Finish();
+    }
+
+private:
+    void Begin(const char* name, std::string_view detail);
+    void Finish();
+
+    const char* m_name = nullptr;
+    std::string m_detail;
+    int64_t m_startNs = 0;
+};
+
+// Backs the --trace flag: records from construction and writes the trace to
+// path when destroyed. Does nothing for an empty path.
+class TraceFile {
+public:
+    explicit TraceFile(std::filesystem::path path);
+    ~TraceFile();
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+private:
+    std::filesystem::path m_path;
+};
+
+} // namespace NirUI
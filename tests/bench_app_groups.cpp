@@ -0,0 +1,104 @@
+#include "test_support.h"
+#include "core/app_groups.h"
+#include <fstream>
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr size_t GROUP_COUNT = 10000;
+constexpr size_t APPS_PER_GROUP = 50;
+
+std::string GetGroupName(size_t i) {
+    return "group " + std::to_string(i);
+}
+
+std::string GetAppName(size_t i) {
+    return "app " + std::to_string(i);
+}
+
+// Writes 10k groups of 50 apps, then deletes every other group and removes the
+// first app of the rest, as a long-lived journal would before compaction
+void WriteJournal(const std::filesystem::path& directory) {
+    std::ofstream file(directory / "app_groups.txt", std::ios::binary);
+    file << AppGroupsManager::JOURNAL_HEADER << '\n';
+    for (size_t i = 0; i < GROUP_COUNT; ++i) {
+        std::string group = GetGroupName(i);
+        file << "C\t" << group << '\n';
+        for (size_t app = 0; app < APPS_PER_GROUP; ++app) {
+            file << "A\t" << group << '\t' << GetAppName(app) << "\tprocess\t" << GetAppName(app) << ".exe\t0\n";
+        }
+    }
+    for (size_t i = 0; i < GROUP_COUNT; ++i) {
+        if (i % 2 == 0) {
+            file << "D\t" << GetGroupName(i) << '\n';
+        } else {
+            file << "R\t" << GetGroupName(i) << '\t' << GetAppName(0) << "\t0\n";
+        }
+    }
+}
+
+bool IsInOrder(const AppGroupsManager& groups) {
+    size_t previous = 0;
+    for (size_t i = 0; i < groups.GetGroups().size(); ++i) {
+        const AppGroup& group = groups.GetGroups()[i];
+        size_t number = std::stoul(group.name.substr(6));
+        if (i > 0 && number <= previous) return false;
+        previous = number;
+        for (size_t app = 1; app < group.apps.size(); ++app) {
+            if (std::stoul(group.apps[app].name.substr(4)) <= std::stoul(group.apps[app - 1].name.substr(4))) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(LoadAndMutate10kGroups) {
+    Test::TempDirectory directory;
+    WriteJournal(directory.GetPath());
+
+    AppGroupsManager groups;
+    groups.SetDataPath(directory.GetPath());
+    Test::Stopwatch stopwatch;
+    groups.Load();
+    double loadMs = stopwatch.GetElapsedMs();
+    printf("  load %zu groups x %zu apps with %zu deletes and removes: %.1f ms\n", GROUP_COUNT, APPS_PER_GROUP,
+           GROUP_COUNT, loadMs);
+    CHECK_EQ(groups.GetGroups().size(), GROUP_COUNT / 2);
+    CHECK_EQ(groups.GetGroups()[0].apps.size(), APPS_PER_GROUP - 1);
+    CHECK(IsInOrder(groups));
+
+    std::mt19937 random(33);
+    std::vector<std::string> names;
+    for (size_t i = 1; i < GROUP_COUNT; i += 2) names.push_back(GetGroupName(i));
+
+    size_t found = 0;
+    stopwatch = Test::Stopwatch();
+    for (size_t i = 0; i < 1000000; ++i) {
+        if (groups.FindGroup(names[random() % names.size()])) found++;
+    }
+    printf("  FindGroup: %.1f ns\n", stopwatch.GetElapsedNs() / 1e6);
+    CHECK_EQ(found, size_t(1000000));
+
+    // Each public mutation also appends to the journal and publishes a snapshot
+    constexpr size_t MUTATIONS = 1000;
+    stopwatch = Test::Stopwatch();
+    for (size_t i = 0; i < MUTATIONS; ++i) {
+        groups.RemoveApp(names[i], GetAppName(1 + i % (APPS_PER_GROUP - 1)));
+    }
+    printf("  RemoveApp: %.1f us\n", stopwatch.GetElapsedNs() / 1e3 / MUTATIONS);
+
+    stopwatch = Test::Stopwatch();
+    for (size_t i = 0; i < MUTATIONS; ++i) {
+        groups.DeleteGroup(names[names.size() / 2 + i]);
+    }
+    printf("  DeleteGroup: %.1f us\n", stopwatch.GetElapsedNs() / 1e3 / MUTATIONS);
+    CHECK_EQ(groups.GetGroups().size(), GROUP_COUNT / 2 - MUTATIONS);
+    CHECK(IsInOrder(groups));
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
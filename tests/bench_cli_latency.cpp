@@ -0,0 +1,172 @@
+#include "test_support.h"
+#include "core/app_groups.h"
+#include "core/meta_commands.h"
+#include "core/nircmd_commands.h"
+#include "utils/ipc_channel.h"
+#include "utils/latency_stats.h"
+#include <fstream>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace NirUI;
+
+namespace {
+
+constexpr int RUNS = 200;
+constexpr size_t GROUP_COUNT = 500;
+constexpr size_t APPS_PER_GROUP = 10;
+const char* const COMMAND = "group list";
+
+std::string GetChannelName() {
+    return "nirui-bench-" + std::to_string(getpid());
+}
+
+void WriteJournal(const std::filesystem::path& directory) {
+    std::ofstream file(directory / "app_groups.txt", std::ios::binary);
+    file << AppGroupsManager::JOURNAL_HEADER << '\n';
+    for (size_t i = 0; i < GROUP_COUNT; ++i) {
+        std::string group = "group " + std::to_string(i);
+        file << "C\t" << group << '\n';
+        for (size_t app = 0; app < APPS_PER_GROUP; ++app) {
+            file << "A\t" << group << "\tapp " << app << "\tprocess\tapp" << app << ".exe\t0\n";
+        }
+    }
+}
+
+std::string RunCommand(AppGroupsManager& groups, const std::string& command) {
+    MetaCommandHandlers handlers;
+    handlers.appGroups = &groups;
+    ExecutionResult result;
+    if (!DispatchMetaCommand(command, handlers, result) || !result.success) return std::string();
+    return result.output;
+}
+
+// What a CLI process does without the daemon: build the command registry and
+// load the app groups before running the command
+int RunDirect(const std::string& dataPath) {
+    NirCmdCommands::GetCategories();
+    AppGroupsManager groups;
+    groups.SetDataPath(dataPath);
+    groups.Load();
+    return RunCommand(groups, COMMAND).empty() ? 1 : 0;
+}
+
+// With the daemon: forward the command, falling back to running it directly
+int RunForwarded(const std::string& channel, const std::string& dataPath) {
+    std::string response;
+    if (IpcRequest(channel, COMMAND, response)) return response.empty() ? 1 : 0;
+    return RunDirect(dataPath);
+}
+
+// Starts this executable in one of the modes above and waits for it
+bool SpawnSelf(const char* mode, const std::string& channel, const std::string& dataPath) {
+    std::string self = std::filesystem::read_symlink("/proc/self/exe").string();
+    std::vector<char*> argv = {self.data(), const_cast<char*>(mode), const_cast<char*>(channel.c_str()),
+                               const_cast<char*>(dataPath.c_str()), nullptr};
+    pid_t pid = 0;
+    if (posix_spawn(&pid, self.c_str(), nullptr, nullptr, argv.data(), environ) != 0) return false;
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void Print(const char* label, const LatencyHistogram& histogram) {
+    printf("  %-34s avg %7.1f us, p50 %6llu us, p99 %6llu us\n", label,
+           static_cast<double>(histogram.GetSumUs()) / histogram.GetCount(),
+           static_cast<unsigned long long>(histogram.GetQuantileUs(0.5)),
+           static_cast<unsigned long long>(histogram.GetQuantileUs(0.99)));
+}
+
+// A daemon on its own thread, holding warm app groups
+class BenchDaemon {
+public:
+    BenchDaemon(const std::string& channel, const std::string& dataPath) {
+        m_groups.SetDataPath(dataPath);
+        m_groups.Load();
+        NirCmdCommands::GetCategories();
+        m_listening = m_server.Listen(channel);
+        m_thread = std::thread([this]() {
+            m_server.Serve([this](const std::string& request, bool& stop) {
+                stop = request == "stop";
+                return stop ? std::string() : RunCommand(m_groups, request);
+            });
+        });
+    }
+
+    ~BenchDaemon() {
+        std::string response;
+        if (m_listening) IpcRequest(m_channel, "stop", response);
+        m_thread.join();
+        m_server.Close();
+    }
+
+    bool IsListening() const { return m_listening; }
+
+private:
+    AppGroupsManager m_groups;
+    IpcServer m_server;
+    std::string m_channel = GetChannelName();
+    bool m_listening = false;
+    std::thread m_thread;
+};
+
+} // namespace
+
+TEST_CASE(CommandLatencyWithAndWithoutDaemon) {
+    Test::TempDirectory directory;
+    WriteJournal(directory.GetPath());
+    std::string dataPath = directory.GetPath().string();
+    std::string channel = GetChannelName();
+    printf("  \"%s\" over %zu groups of %zu apps, %d runs each\n", COMMAND, GROUP_COUNT, APPS_PER_GROUP, RUNS);
+
+    LatencyHistogram direct;
+    LatencyHistogram inProcessCold;
+    for (int i = 0; i < RUNS; ++i) {
+        Test::Stopwatch stopwatch;
+        CHECK(SpawnSelf("direct", channel, dataPath));
+        direct.Add(static_cast<uint64_t>(stopwatch.GetElapsedNs() / 1000));
+
+        stopwatch = Test::Stopwatch();
+        AppGroupsManager groups;
+        groups.SetDataPath(dataPath);
+        groups.Load();
+        CHECK(!RunCommand(groups, COMMAND).empty());
+        inProcessCold.Add(static_cast<uint64_t>(stopwatch.GetElapsedNs() / 1000));
+    }
+
+    LatencyHistogram forwarded;
+    LatencyHistogram roundTrip;
+    {
+        BenchDaemon daemon(channel, dataPath);
+        CHECK(daemon.IsListening());
+        for (int i = 0; i < RUNS; ++i) {
+            Test::Stopwatch stopwatch;
+            CHECK(SpawnSelf("forward", channel, dataPath));
+            forwarded.Add(static_cast<uint64_t>(stopwatch.GetElapsedNs() / 1000));
+
+            std::string response;
+            stopwatch = Test::Stopwatch();
+            CHECK(IpcRequest(channel, COMMAND, response));
+            roundTrip.Add(static_cast<uint64_t>(stopwatch.GetElapsedNs() / 1000));
+            CHECK(!response.empty());
+        }
+    }
+
+    Print("process, no daemon:", direct);
+    Print("process, forwarded to the daemon:", forwarded);
+    Print("  load and run in process:", inProcessCold);
+    Print("  daemon round trip in process:", roundTrip);
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4) {
+        std::string mode = argv[1];
+        return mode == "forward" ? RunForwarded(argv[2], argv[3]) : RunDirect(argv[3]);
+    }
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,70 @@
+#include "test_support.h"
+#include "core/command_tokenizer.h"
+#include "core/meta_commands.h"
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr size_t LINE_COUNT = 1000000;
+
+// Mix of the lines the GUI, scripts and the REPL send: plain words, quoted
+// paths, escaped quotes and long argument lists
+std::vector<std::string> MakeLines() {
+    const char* templates[] = {
+        "setsysvolume 32768",
+        "changesysvolume -2000 master",
+        "win close title \"Untitled - Notepad\"",
+        "win freeze folder \"C:\\Program Files\\Some App\" --recursive",
+        "exec show \"C:\\Program Files\\app.exe\" --flag \"value with \\\"quotes\\\"\"",
+        "sendkeypress ctrl+shift+esc",
+        "group add \"Coding Tools\" \"VS Code\" process Code.exe true",
+        "schedule every 5m win min process chrome.exe",
+        "regsetval sz \"HKCU\\Software\\Test\" \"MyValue\" \"Hello World\"",
+        "a b c d e f g h i j k l m n o p q r s t",
+    };
+    std::mt19937 random(1);
+    std::uniform_int_distribution<size_t> pick(0, std::size(templates) - 1);
+    std::vector<std::string> lines;
+    lines.reserve(LINE_COUNT);
+    for (size_t i = 0; i < LINE_COUNT; ++i) lines.emplace_back(templates[pick(random)]);
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE(ParseThroughput) {
+    std::vector<std::string> lines = MakeLines();
+    size_t bytes = 0;
+    for (const auto& line : lines) bytes += line.size();
+
+    size_t tokens = 0;
+    Test::Stopwatch stopwatch;
+    for (const auto& line : lines) {
+        CommandTokens parsed(line);
+        tokens += parsed.GetCount();
+        Test::DoNotOptimize(parsed);
+    }
+    double ns = stopwatch.GetElapsedNs();
+    printf("  %zu lines, %.1f MB, %zu tokens: %.1f ms, %.1f ns/line, %.0f MB/s\n", lines.size(), bytes / 1e6, tokens,
+           ns / 1e6, ns / lines.size(), bytes / (ns / 1e9) / 1e6);
+    CHECK(tokens > lines.size());
+}
+
+TEST_CASE(MetaCommandLookupThroughput) {
+    std::vector<std::string> lines = MakeLines();
+    size_t metaCount = 0;
+    Test::Stopwatch stopwatch;
+    for (const auto& line : lines) {
+        if (IsMetaCommand(line)) metaCount++;
+    }
+    double ns = stopwatch.GetElapsedNs();
+    printf("  %zu lookups, %zu meta-commands: %.1f ms, %.1f ns/line\n", lines.size(), metaCount, ns / 1e6,
+           ns / lines.size());
+    CHECK(metaCount > 0 && metaCount < lines.size());
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,110 @@
+#include "test_support.h"
+#include "core/history_store.h"
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr uint64_t ENTRY_COUNT = 1000000;
+constexpr int64_t START_TIME = 1700000000;
+
+const char* COMMANDS[] = {
+    "setsysvolume 32768",
+    "changesysvolume -2000",
+    "win close title \"Untitled - Notepad\"",
+    "exec show \"C:\\Program Files\\app.exe\"",
+    "sendkeypress ctrl+shift+esc",
+    "monitor off",
+    "clipboard set \"some text\"",
+};
+
+} // namespace
+
+TEST_CASE(InsertAndQueryOneMillionEntries) {
+    Test::TempDirectory directory;
+    HistoryStore store;
+    CHECK(store.Open(directory.GetPath()));
+
+    // Two entries a second; every 100th fails and every 10th has output
+    Test::Stopwatch stopwatch;
+    for (uint64_t i = 0; i < ENTRY_COUNT; ++i) {
+        HistoryEntry entry;
+        entry.command = COMMANDS[i % std::size(COMMANDS)];
+        if (i % 1000 == 0) entry.command += " --marker" + std::to_string(i);
+        entry.success = i % 100 != 0;
+        entry.executionTime = static_cast<double>(i % 50);
+        entry.unixTime = START_TIME + static_cast<int64_t>(i / 2);
+        entry.timestamp = "00:00:00";
+        if (i % 10 == 0) entry.output = "output of entry " + std::to_string(i);
+        store.Add(std::move(entry));
+    }
+    double insertNs = stopwatch.GetElapsedNs();
+    printf("  insert: %.2f s, %.2f us/entry\n", insertNs / 1e9, insertNs / 1e3 / ENTRY_COUNT);
+    CHECK_EQ(store.GetCount(), ENTRY_COUNT);
+    CHECK_EQ(store.GetRecent().GetSize(), HistoryStore::RECENT_CAPACITY);
+
+    // The reopened archive only needs its index, not the records
+    stopwatch = Test::Stopwatch();
+    HistoryStore reopened;
+    CHECK(reopened.Open(directory.GetPath()));
+    printf("  reopen: %.1f ms\n", stopwatch.GetElapsedMs());
+    CHECK_EQ(reopened.GetCount(), ENTRY_COUNT);
+
+    std::mt19937_64 random(36);
+    constexpr size_t PAGES = 10000;
+    constexpr size_t PAGE_SIZE = 50;
+    std::vector<HistoryEntry> page;
+    size_t pageErrors = 0;
+    stopwatch = Test::Stopwatch();
+    for (size_t i = 0; i < PAGES; ++i) {
+        uint64_t first = random() % (ENTRY_COUNT - PAGE_SIZE);
+        if (!reopened.Read(first, PAGE_SIZE, page) || page.size() != PAGE_SIZE || page[0].index != first ||
+            page[0].unixTime != START_TIME + static_cast<int64_t>(first / 2)) {
+            pageErrors++;
+        }
+    }
+    printf("  page of %zu at a random position: %.1f us\n", PAGE_SIZE, stopwatch.GetElapsedNs() / 1e3 / PAGES);
+    CHECK_EQ(pageErrors, size_t(0));
+
+    std::string output;
+    CHECK(reopened.ReadOutput(123450, output));
+    CHECK_EQ(output, std::string("output of entry 123450"));
+
+    constexpr size_t LOOKUPS = 100000;
+    size_t timeErrors = 0;
+    stopwatch = Test::Stopwatch();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        uint64_t target = random() % ENTRY_COUNT;
+        if (reopened.FindByTime(START_TIME + static_cast<int64_t>(target / 2)) != target - target % 2) timeErrors++;
+    }
+    printf("  FindByTime: %.0f ns\n", stopwatch.GetElapsedNs() / LOOKUPS);
+    CHECK_EQ(timeErrors, size_t(0));
+
+    // A full scan: the marker is on 1000 entries, spread over the whole archive
+    HistoryQuery query;
+    query.text = "--MARKER";
+    query.maxResults = ENTRY_COUNT;
+    stopwatch = Test::Stopwatch();
+    std::vector<uint64_t> matches = reopened.Search(query);
+    printf("  text search over %llu entries: %.1f ms\n", static_cast<unsigned long long>(ENTRY_COUNT),
+           stopwatch.GetElapsedMs());
+    CHECK_EQ(matches.size(), size_t(1000));
+    CHECK(!matches.empty() && matches.front() == 999000 && matches.back() == 0);
+
+    // Failures in one hour, the newest 20 of them
+    query = HistoryQuery();
+    query.failuresOnly = true;
+    query.fromTime = START_TIME + 100000;
+    query.toTime = START_TIME + 100000 + 3599;
+    query.maxResults = 20;
+    stopwatch = Test::Stopwatch();
+    matches = reopened.Search(query);
+    printf("  failures in one hour: %.1f ms\n", stopwatch.GetElapsedMs());
+    CHECK_EQ(matches.size(), size_t(20));
+    CHECK(!matches.empty() && matches.front() == 207100);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,104 @@
+#include "test_support.h"
+#include "ui/icon_atlas.h"
+#include "ui/icon_cache.h"
+#include "utils/thread_pool.h"
+#include <cmath>
+#include <thread>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr int ICON_COUNT = 27;
+constexpr int BASE_SIZE = 16;
+constexpr int ROUNDS = 20;
+
+// Stand-ins for the built-in icons, which live behind the Direct3D code: a
+// star and a ring of similar complexity, different for every icon
+std::vector<std::string> MakeSvgs() {
+    std::vector<std::string> svgs;
+    for (int i = 0; i < ICON_COUNT; ++i) {
+        int points = 5 + i % 7;
+        std::string path;
+        for (int p = 0; p < points * 2; ++p) {
+            double angle = 3.14159265358979 * p / points;
+            double radius = p % 2 == 0 ? 11.0 : 4.0 + i % 3;
+            char point[48];
+            snprintf(point, sizeof(point), "%s%.2f %.2f ", p == 0 ? "M" : "L", 12 + radius * std::sin(angle),
+                     12 - radius * std::cos(angle));
+            path += point;
+        }
+        svgs.push_back("<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 24 24\" width=\"24\" height=\"24\">"
+                       "<path d=\"" + path + "Z\" fill=\"none\" stroke=\"#fff\" stroke-width=\"1.5\"/>"
+                       "<circle cx=\"12\" cy=\"12\" r=\"" + std::to_string(2 + i % 4) + "\" fill=\"#fff\"/></svg>");
+    }
+    return svgs;
+}
+
+double BuildMs(IconAtlas& atlas, const std::vector<IconAtlas::SvgSource>& sources,
+               const std::filesystem::path& cachePath) {
+    Test::Stopwatch stopwatch;
+    atlas.Build(sources, BASE_SIZE, { 1.0f, 1.5f, 2.0f }, cachePath);
+    return stopwatch.GetElapsedMs();
+}
+
+} // namespace
+
+TEST_CASE(ColdVersusWarmLoad) {
+    std::vector<std::string> svgs = MakeSvgs();
+    std::vector<IconAtlas::SvgSource> sources;
+    for (int i = 0; i < ICON_COUNT; ++i) sources.emplace_back("icon" + std::to_string(i), svgs[i].c_str());
+
+    // Start the shared pool so the first round does not pay for its threads
+    ThreadPool::Shared();
+
+    // Cold: no cache file, every variant is rasterized and the cache written
+    double coldMs = 0;
+    double uncachedMs = 0;
+    IconAtlas cold;
+    for (int round = 0; round < ROUNDS; ++round) {
+        Test::TempDirectory directory;
+        coldMs += BuildMs(cold, sources, directory.GetPath() / "icons.cache");
+        uncachedMs += BuildMs(cold, sources, {});
+    }
+
+    // Serial rasterization, as before the thread pool
+    Test::Stopwatch stopwatch;
+    size_t rasterized = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (const auto& svg : svgs) {
+            for (int size : { 16, 24, 32 }) {
+                RasterizedIcon icon;
+                if (IconAtlas::RasterizeSvg(svg.c_str(), static_cast<int>(svg.size()), size, icon)) rasterized++;
+            }
+        }
+    }
+    double serialMs = stopwatch.GetElapsedMs();
+
+    // Warm: the same cache file every round, so nothing is rasterized
+    Test::TempDirectory directory;
+    std::filesystem::path cachePath = directory.GetPath() / "icons.cache";
+    IconAtlas warm;
+    BuildMs(warm, sources, cachePath);
+    double warmMs = 0;
+    for (int round = 0; round < ROUNDS; ++round) warmMs += BuildMs(warm, sources, cachePath);
+
+    printf("  %d icons x 3 sizes on %u threads\n", ICON_COUNT, std::thread::hardware_concurrency());
+    printf("  serial rasterize: %.2f ms\n", serialMs / ROUNDS);
+    printf("  cold (pool rasterize + pack + write cache): %.2f ms\n", coldMs / ROUNDS);
+    printf("  no cache (pool rasterize + pack): %.2f ms\n", uncachedMs / ROUNDS);
+    printf("  warm (mapped cache + pack): %.2f ms\n", warmMs / ROUNDS);
+
+    CHECK_EQ(rasterized, size_t(ROUNDS * ICON_COUNT * 3));
+    CHECK_EQ(warm.GetRegionCount(), size_t(ICON_COUNT * 3));
+    CHECK_EQ(warm.GetIconCount(), cold.GetIconCount());
+    CHECK(warm.GetPixels() == cold.GetPixels());
+
+    IconCache cache;
+    CHECK(cache.Load(cachePath));
+    CHECK_EQ(cache.GetEntryCount(), size_t(ICON_COUNT * 3));
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
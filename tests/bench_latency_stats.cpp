@@ -0,0 +1,114 @@
+#include "test_support.h"
+#include "utils/latency_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr size_t SAMPLES = 10000000;
+
+// Latencies from 50 us to about 2 s, weighted to the short end like real commands
+std::vector<uint64_t> MakeSamples(size_t count, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::lognormal_distribution<double> distribution(8.0, 1.5);
+    std::vector<uint64_t> samples(count);
+    for (auto& sample : samples) {
+        sample = static_cast<uint64_t>(std::clamp(distribution(random), 50.0, 2000000.0));
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST_CASE(RecordCost) {
+    LatencyStats& stats = LatencyStats::Get();
+    LatencyStats::SeriesId series = stats.Register("bench", "single");
+    std::vector<uint64_t> samples = MakeSamples(1 << 16, 49);
+
+    Test::Stopwatch stopwatch;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        stats.Record(series, LatencyPhase::Total, samples[i & 0xffff]);
+    }
+    double ns = stopwatch.GetElapsedNs() / SAMPLES;
+    printf("  Record, one thread: %.1f ns/sample\n", ns);
+    CHECK(ns < 50.0);
+
+    LatencyHistogram histogram;
+    CHECK(stats.GetHistogram(series, LatencyPhase::Total, histogram));
+    CHECK_EQ(histogram.GetCount(), uint64_t(SAMPLES));
+}
+
+// Each thread writes its own shard, so adding threads should not add cost per
+// sample even with a reader merging the shards the whole time
+TEST_CASE(RecordCostUnderContention) {
+    LatencyStats& stats = LatencyStats::Get();
+    LatencyStats::SeriesId series = stats.Register("bench", "shared");
+    std::vector<uint64_t> samples = MakeSamples(1 << 16, 50);
+    constexpr size_t THREADS = 4;
+    constexpr size_t PER_THREAD = SAMPLES / THREADS;
+
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> reads{ 0 };
+    std::thread reader([&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+            Test::DoNotOptimize(stats.GetSummaries());
+            reads++;
+        }
+    });
+
+    std::vector<double> threadNs(THREADS);
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&, t]() {
+            Test::Stopwatch stopwatch;
+            for (size_t i = 0; i < PER_THREAD; ++i) {
+                stats.Record(series, static_cast<LatencyPhase>(i & 3), samples[(i + t * 977) & 0xffff]);
+            }
+            threadNs[t] = stopwatch.GetElapsedNs() / PER_THREAD;
+        });
+    }
+    for (auto& writer : writers) writer.join();
+    done = true;
+    reader.join();
+
+    // On fewer cores than threads the writers share time slices, so the CPU
+    // time per sample is the wall time divided by the oversubscription
+    double oversubscribed = std::max(1.0, static_cast<double>(THREADS) / std::max(1u, std::thread::hardware_concurrency()));
+    double worstNs = *std::max_element(threadNs.begin(), threadNs.end()) / oversubscribed;
+    printf("  Record, %zu threads and a reader (%zu merges): %.1f ns/sample worst thread\n", THREADS, reads.load(),
+           worstNs);
+
+    uint64_t total = 0;
+    for (size_t phase = 0; phase < LATENCY_PHASE_COUNT; ++phase) {
+        LatencyHistogram histogram;
+        stats.GetHistogram(series, static_cast<LatencyPhase>(phase), histogram);
+        total += histogram.GetCount();
+    }
+    CHECK_EQ(total, uint64_t(PER_THREAD * THREADS));
+}
+
+TEST_CASE(QuantilesWithinBucketError) {
+    std::vector<uint64_t> samples = MakeSamples(1000000, 51);
+    LatencyHistogram histogram;
+    for (uint64_t sample : samples) histogram.Add(sample);
+    std::sort(samples.begin(), samples.end());
+
+    // A bucket spans at most 1/16 of its values, so the middle is within 1/32
+    double worstError = 0;
+    for (double q : { 0.5, 0.9, 0.99, 0.999 }) {
+        double exact = static_cast<double>(samples[static_cast<size_t>(q * samples.size()) - 1]);
+        double error = std::abs(histogram.GetQuantileUs(q) - exact) / exact;
+        worstError = std::max(worstError, error);
+    }
+    printf("  worst quantile error: %.2f%%\n", worstError * 100);
+    CHECK(worstError <= 1.0 / 32);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,132 @@
+#include "test_support.h"
+#include "utils/priority_executor.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <thread>
+
+using namespace NirUI;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr size_t WORKERS = 4;
+constexpr int BULK_TASKS = 200;
+constexpr int INTERACTIVE_TASKS = 50;
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double Percentile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(q * values.size()))];
+}
+
+// Queues a backlog of 10 ms bulk tasks, then submits 1 ms interactive tasks
+// every 10 ms and measures each from submit to finish
+template <typename SubmitBulk, typename SubmitInteractive>
+std::vector<double> MeasureInteractive(SubmitBulk submitBulk, SubmitInteractive submitInteractive) {
+    std::vector<std::future<void>> bulk;
+    for (int i = 0; i < BULK_TASKS; ++i) {
+        bulk.push_back(submitBulk([]() { std::this_thread::sleep_for(10ms); }));
+    }
+
+    std::vector<double> latencies(INTERACTIVE_TASKS);
+    std::vector<std::future<void>> interactive;
+    for (int i = 0; i < INTERACTIVE_TASKS; ++i) {
+        auto submitted = std::chrono::steady_clock::now();
+        interactive.push_back(submitInteractive([&latencies, i, submitted]() {
+            std::this_thread::sleep_for(1ms);
+            latencies[i] = ElapsedMs(submitted);
+        }));
+        std::this_thread::sleep_for(10ms);
+    }
+    for (auto& future : interactive) future.wait();
+    for (auto& future : bulk) future.wait();
+    return latencies;
+}
+
+} // namespace
+
+TEST_CASE(InteractiveLatencyUnderBulkLoad) {
+    std::vector<double> prioritized;
+    {
+        PriorityExecutor executor(WORKERS);
+        prioritized = MeasureInteractive(
+            [&](auto task) { return executor.Submit(WorkClass::Bulk, task); },
+            [&](auto task) { return executor.Submit(WorkClass::Interactive, task); });
+    }
+    std::vector<double> fifo;
+    {
+        ThreadPool pool(WORKERS);
+        fifo = MeasureInteractive([&](auto task) { return pool.Submit(task); },
+                                  [&](auto task) { return pool.Submit(task); });
+    }
+
+    double p50 = Percentile(prioritized, 0.50);
+    double p99 = Percentile(prioritized, 0.99);
+    printf("  interactive submit-to-finish: p50 %.1f ms, p99 %.1f ms; FIFO pool p50 %.1f ms, p99 %.1f ms\n", p50, p99,
+           Percentile(fifo, 0.50), Percentile(fifo, 0.99));
+    // A free worker is always held back, so an interactive task waits for
+    // nothing but the OS scheduler; the FIFO pool waits behind the bulk
+    // backlog. The bound leaves room for a busy CI machine.
+    CHECK(p99 < 100);
+    CHECK(p99 < Percentile(fifo, 0.99));
+}
+
+// Interactive work keeps every worker busy and its queue non-empty. Without
+// aging the bulk task would wait for the stream to end; with it, the task
+// must start once it has waited out its three classes.
+TEST_CASE(AgingLetsBulkProgress) {
+    PriorityExecutor executor(2);
+    executor.SetAgingStep(20ms);
+
+    std::atomic<bool> stop{ false };
+    std::thread producer([&]() {
+        while (!stop) {
+            if (executor.GetStats(WorkClass::Interactive).queued < 8) {
+                executor.Submit(WorkClass::Interactive, []() { std::this_thread::sleep_for(2ms); });
+            } else {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+    });
+    std::this_thread::sleep_for(50ms);
+
+    auto submitted = std::chrono::steady_clock::now();
+    std::atomic<double> startedAfterMs{ -1 };
+    auto bulk = executor.Submit(WorkClass::Bulk, [&]() { startedAfterMs = ElapsedMs(submitted); });
+    bool started = bulk.wait_for(3s) == std::future_status::ready;
+    PriorityExecutor::ClassStats interactive = executor.GetStats(WorkClass::Interactive);
+    stop = true;
+    producer.join();
+
+    printf("  bulk task started after %.1f ms; %llu interactive tasks ran meanwhile\n", startedAfterMs.load(),
+           static_cast<unsigned long long>(interactive.started));
+    CHECK(started);
+    CHECK(startedAfterMs >= 0 && startedAfterMs < 1000);
+}
+
+TEST_CASE(BulkLimitHolds) {
+    PriorityExecutor executor(WORKERS);
+    std::atomic<int> running{ 0 };
+    std::atomic<int> peak{ 0 };
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 40; ++i) {
+        futures.push_back(executor.Submit(WorkClass::Bulk, [&]() {
+            int now = ++running;
+            int seen = peak;
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(2ms);
+            running--;
+        }));
+    }
+    for (auto& future : futures) future.wait();
+    CHECK(peak > 0 && peak <= static_cast<int>(WORKERS / 2));
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,127 @@
+#include "test_support.h"
+#include "core/settings_store.h"
+
+using namespace NirUI;
+
+namespace {
+
+constexpr size_t HISTORY_ROWS = 10000;
+constexpr size_t GROUP_COUNT = 1000;
+constexpr size_t APPS_PER_GROUP = 5;
+constexpr int ROUNDS = 20;
+
+void FillStore(SettingsStore& store, int round = 0) {
+    std::vector<SettingsStore::Row> history;
+    history.reserve(HISTORY_ROWS);
+    for (size_t i = 0; i < HISTORY_ROWS; ++i) {
+        history.push_back({ "win close title \"Window " + std::to_string(i) + "\"", i % 100 ? "1" : "0",
+                            std::to_string(i % 250 + round) + ".5", "12:34:56", std::to_string(1700000000 + i) });
+    }
+    store.SetRows("history", SectionType::Table, std::move(history));
+
+    std::vector<SettingsStore::Row> groups;
+    groups.reserve(GROUP_COUNT * APPS_PER_GROUP);
+    for (size_t group = 0; group < GROUP_COUNT; ++group) {
+        for (size_t app = 0; app < APPS_PER_GROUP; ++app) {
+            std::string name = "app " + std::to_string(app);
+            groups.push_back({ "group " + std::to_string(group), name, "process", name + ".exe", round % 2 ? "1" : "0" });
+        }
+    }
+    store.SetRows("app_groups", SectionType::Table, std::move(groups));
+
+    std::vector<std::string> favorites;
+    for (int i = 0; i < 50; ++i) favorites.push_back("favorite command " + std::to_string(i));
+    store.SetList("favorites", favorites);
+
+    std::map<std::string, std::string> settings;
+    for (int i = 0; i < 30; ++i) settings["setting" + std::to_string(i)] = std::to_string(i);
+    store.SetKeyValues("settings", settings);
+}
+
+} // namespace
+
+TEST_CASE(LoadAndSave) {
+    Test::TempDirectory directory;
+    std::filesystem::path path = directory.GetPath() / "nirui.store";
+
+    SettingsStore store(path);
+    FillStore(store);
+    Test::Stopwatch stopwatch;
+    CHECK(store.Commit());
+    double firstMs = stopwatch.GetElapsedMs();
+
+    // The big sections changed and re-encoded, as the old Save*() functions
+    // did on every save
+    double fullMs = 0;
+    for (int round = 1; round <= ROUNDS; ++round) {
+        FillStore(store, round);
+        stopwatch = Test::Stopwatch();
+        store.Commit();
+        fullMs += stopwatch.GetElapsedMs();
+    }
+
+    // One setting changed: the history and groups reuse their encoded bytes
+    double incrementalMs = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        std::map<std::string, std::string> settings = store.GetKeyValues("settings");
+        settings["setting0"] = std::to_string(round);
+        store.SetKeyValues("settings", settings);
+        stopwatch = Test::Stopwatch();
+        CHECK(store.Commit());
+        incrementalMs += stopwatch.GetElapsedMs();
+    }
+
+    double loadMs = 0;
+    bool loaded = true;
+    for (int round = 0; round < ROUNDS; ++round) {
+        SettingsStore reader(path);
+        stopwatch = Test::Stopwatch();
+        loaded = reader.Load() && loaded;
+        loadMs += stopwatch.GetElapsedMs();
+    }
+
+    printf("  %zu history rows, %zu groups x %zu apps, %.2f MB file\n", HISTORY_ROWS, GROUP_COUNT, APPS_PER_GROUP,
+           std::filesystem::file_size(path) / 1e6);
+    printf("  first commit: %.2f ms\n", firstMs);
+    printf("  commit, history and groups changed: %.2f ms\n", fullMs / ROUNDS);
+    printf("  commit, one setting changed: %.2f ms\n", incrementalMs / ROUNDS);
+    printf("  load: %.2f ms\n", loadMs / ROUNDS);
+    CHECK(loaded);
+
+    SettingsStore reader(path);
+    CHECK(reader.Load());
+    std::vector<SettingsStore::Row> history = reader.GetRows("history");
+    CHECK_EQ(history.size(), HISTORY_ROWS);
+    CHECK(history.size() == HISTORY_ROWS && history[1234][0] == "win close title \"Window 1234\"");
+    CHECK_EQ(reader.GetRows("app_groups").size(), GROUP_COUNT * APPS_PER_GROUP);
+    CHECK_EQ(reader.GetList("favorites").size(), size_t(50));
+    CHECK_EQ(reader.GetKeyValues("settings")["setting0"], std::to_string(ROUNDS - 1));
+}
+
+TEST_CASE(ScheduledSavesAreBatched) {
+    Test::TempDirectory directory;
+    std::filesystem::path path = directory.GetPath() / "nirui.store";
+
+    SettingsStore store(path);
+    store.SetDebounce(std::chrono::milliseconds(50));
+    FillStore(store);
+
+    // A burst of changes, each scheduling a save, as the UI does while typing
+    Test::Stopwatch stopwatch;
+    for (int i = 0; i < 1000; ++i) {
+        store.SetList("recent", { "value " + std::to_string(i) });
+        store.ScheduleSave();
+    }
+    double scheduleUs = stopwatch.GetElapsedNs() / 1e3 / 1000;
+    store.Flush();
+    printf("  SetList + ScheduleSave: %.2f us, no write on the calling thread\n", scheduleUs);
+
+    CHECK(!store.IsDirty());
+    SettingsStore reader(path);
+    CHECK(reader.Load());
+    CHECK_EQ(reader.GetList("recent"), std::vector<std::string>{ "value 999" });
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
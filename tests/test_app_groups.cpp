@@ -0,0 +1,193 @@
+#include "test_support.h"
+#include "core/app_groups.h"
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace NirUI;
+
+TEST_CASE(ManagesGroupsAndApps) {
+    AppGroupsManager groups;
+    CHECK(groups.CreateGroup("Work"));
+    CHECK(!groups.CreateGroup("Work"));
+    CHECK(groups.AddApp("Work", "Editor", "process", "code.exe"));
+    CHECK(groups.AddApp("Work", "Browser", "ititle", "Chrome", false));
+    CHECK(!groups.AddApp("Missing", "Editor", "process", "code.exe"));
+
+    AppGroupHandle handle = groups.FindGroupHandle("Work");
+    CHECK(groups.RenameGroup("Work", "Job"));
+    CHECK(groups.FindGroup("Work") == nullptr);
+    CHECK(groups.Get(handle) == groups.FindGroup("Job"));
+
+    CHECK(groups.RemoveApp("Job", "Editor"));
+    CHECK(!groups.RemoveApp("Job", "Editor"));
+    CHECK(groups.DeleteGroup("Job"));
+    CHECK(groups.Get(handle) == nullptr);
+
+    // A reused slot must not revive the old handle
+    CHECK(groups.CreateGroup("Other"));
+    CHECK(groups.Get(handle) == nullptr);
+}
+
+TEST_CASE(SnapshotsAreImmutable) {
+    AppGroupsManager groups;
+    groups.CreateGroup("A");
+    groups.AddApp("A", "one", "process", "one.exe");
+    AppGroupsSnapshotPtr before = groups.GetSnapshot();
+
+    groups.AddApp("A", "two", "process", "two.exe");
+    groups.CreateGroup("B");
+    AppGroupsSnapshotPtr after = groups.GetSnapshot();
+
+    CHECK(after->version > before->version);
+    CHECK(before->groups.size() == 1 && before->Find("A")->apps.size() == 1);
+    CHECK(before->Find("B") == nullptr);
+    CHECK(after->groups.size() == 2 && after->Find("A")->apps.size() == 2);
+}
+
+namespace {
+
+std::vector<std::string> GetGroupNames(const AppGroupsManager& groups) {
+    std::vector<std::string> names;
+    for (const auto& group : groups.GetGroups()) names.push_back(group.name);
+    return names;
+}
+
+std::vector<std::string> GetAppNames(const AppGroupsManager& groups, const std::string& group) {
+    std::vector<std::string> names;
+    for (const auto& app : groups.FindGroup(group)->apps) names.push_back(app.name);
+    return names;
+}
+
+} // namespace
+
+TEST_CASE(DeletingKeepsGroupOrder) {
+    AppGroupsManager groups;
+    for (const char* name : { "a", "b", "c", "d", "e" }) groups.CreateGroup(name);
+    AppGroupHandle d = groups.FindGroupHandle("d");
+
+    groups.DeleteGroup("b");
+    groups.DeleteGroup("a");
+    CHECK_EQ(GetGroupNames(groups), (std::vector<std::string>{ "c", "d", "e" }));
+    CHECK(groups.Get(d) == groups.FindGroup("d"));
+    CHECK(groups.GetHandle(1) == d);
+
+    AppGroupsSnapshotPtr snapshot = groups.GetSnapshot();
+    CHECK(snapshot->groups.size() == 3 && snapshot->groups[1]->name == "d");
+    CHECK(snapshot->nameIndex->at("e") == 2);
+
+    groups.CreateGroup("b");
+    CHECK_EQ(GetGroupNames(groups), (std::vector<std::string>{ "c", "d", "e", "b" }));
+}
+
+TEST_CASE(RemovingKeepsAppOrder) {
+    AppGroupsManager groups;
+    groups.CreateGroup("g");
+    for (const char* name : { "one", "two", "dup", "three", "dup", "four" }) {
+        groups.AddApp("g", name, "process", std::string(name) + ".exe");
+    }
+
+    CHECK(groups.RemoveAppAt("g", 1));
+    CHECK(groups.RemoveApp("g", "one"));
+    CHECK_EQ(GetAppNames(groups, "g"), (std::vector<std::string>{ "dup", "three", "dup", "four" }));
+
+    // The name index still points at the shifted entries
+    CHECK(groups.RemoveApp("g", "four"));
+    CHECK(groups.RemoveApp("g", "dup"));
+    CHECK(groups.RemoveApp("g", "dup"));
+    CHECK_EQ(GetAppNames(groups, "g"), (std::vector<std::string>{ "three" }));
+}
+
+TEST_CASE(ReloadingKeepsOrder) {
+    Test::TempDirectory directory;
+    {
+        AppGroupsManager groups;
+        groups.SetDataPath(directory.GetPath());
+        for (const char* name : { "a", "b", "c", "d" }) groups.CreateGroup(name);
+        for (const char* name : { "x", "y", "z" }) groups.AddApp("c", name, "process", name);
+        groups.DeleteGroup("a");
+        groups.RemoveApp("c", "x");
+        groups.DeleteGroup("c");
+        groups.CreateGroup("c");
+        groups.AddApp("c", "w", "process", "w");
+        groups.DeleteGroup("b");
+    }
+
+    // Replays the journal with its tombstones, then compacts once
+    AppGroupsManager loaded;
+    loaded.SetDataPath(directory.GetPath());
+    loaded.Load();
+    CHECK_EQ(GetGroupNames(loaded), (std::vector<std::string>{ "d", "c" }));
+    CHECK_EQ(GetAppNames(loaded, "c"), (std::vector<std::string>{ "w" }));
+    CHECK(loaded.GetSnapshot()->groups.size() == 2);
+    CHECK(loaded.Get(loaded.GetHandle(1)) == loaded.FindGroup("c"));
+}
+
+// One writer mutates continuously while readers check every snapshot they
+// see. Run under -DNIRUI_TEST_SANITIZER=thread to check for races.
+TEST_CASE(ReadersSeeConsistentSnapshotsUnderWrites) {
+    AppGroupsManager groups;
+    groups.CreateGroup("log");
+
+    std::atomic<bool> done{ false };
+    std::atomic<int> inconsistencies{ 0 };
+    std::atomic<uint64_t> snapshotsRead{ 0 };
+
+    auto reader = [&]() {
+        uint64_t lastVersion = 0;
+        size_t lastLogSize = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            AppGroupsSnapshotPtr snapshot = groups.GetSnapshot();
+            bool ok = snapshot->version >= lastVersion && snapshot->nameIndex->size() == snapshot->groups.size();
+            for (size_t i = 0; i < snapshot->groups.size() && ok; ++i) {
+                const AppGroup& group = *snapshot->groups[i];
+                auto it = snapshot->nameIndex->find(group.name);
+                ok = it != snapshot->nameIndex->end() && it->second == i && snapshot->Find(group.name) == &group;
+                for (const auto& app : group.apps) {
+                    ok = ok && app.targetType == "process" && app.targetValue == app.name + ".exe";
+                }
+            }
+
+            // The log group only grows, one numbered app at a time
+            const AppGroup* log = snapshot->Find("log");
+            ok = ok && log && log->apps.size() >= lastLogSize;
+            for (size_t i = 0; ok && i < log->apps.size(); ++i) {
+                ok = log->apps[i].name == "e" + std::to_string(i);
+            }
+            if (!ok) inconsistencies++;
+            lastVersion = snapshot->version;
+            lastLogSize = log ? log->apps.size() : 0;
+            snapshotsRead.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) readers.emplace_back(reader);
+
+    std::mt19937 random(34);
+    for (int op = 0; op < 20000; ++op) {
+        std::string name = "g" + std::to_string(random() % 40);
+        std::string app = "a" + std::to_string(random() % 20);
+        switch (random() % 6) {
+        case 0: groups.CreateGroup(name); break;
+        case 1: groups.DeleteGroup(name); break;
+        case 2: groups.RenameGroup(name, "g" + std::to_string(random() % 40)); break;
+        case 3: groups.RemoveApp(name, app); break;
+        default: groups.AddApp(name, app, "process", app + ".exe"); break;
+        }
+        if (op % 20 == 0) {
+            std::string entry = "e" + std::to_string(op / 20);
+            groups.AddApp("log", entry, "process", entry + ".exe");
+        }
+    }
+    done = true;
+    for (auto& thread : readers) thread.join();
+
+    printf("  %llu snapshots read during 20000 writes\n", static_cast<unsigned long long>(snapshotsRead.load()));
+    CHECK_EQ(inconsistencies.load(), 0);
+    CHECK(snapshotsRead.load() > 0);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
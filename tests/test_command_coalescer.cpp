@@ -0,0 +1,131 @@
+#include "test_support.h"
+#include "core/command_coalescer.h"
+#include <mutex>
+
+using namespace NirUI;
+
+namespace {
+
+// Takes everything that can run now and finishes it, in order
+std::vector<std::string> Drain(CommandCoalescer& coalescer) {
+    std::vector<std::string> commands;
+    std::vector<std::string> targets;
+    std::string command;
+    std::string target;
+    while (coalescer.TakeNext(command, target)) {
+        commands.push_back(command);
+        targets.push_back(target);
+    }
+    for (const auto& taken : targets) coalescer.Finish(taken);
+    return commands;
+}
+
+} // namespace
+
+TEST_CASE(OnlyRegistryMarkedCommandsCoalesce) {
+    CHECK(CommandCoalescer::CanCoalesce("changesysvolume 2000"));
+    CHECK(CommandCoalescer::CanCoalesce("movecursor 10 -5"));
+    CHECK(CommandCoalescer::CanCoalesce("setsysvolume 100"));
+    CHECK(!CommandCoalescer::CanCoalesce("changesysvolume loud"));
+    CHECK(!CommandCoalescer::CanCoalesce("win close title Notepad"));
+    CHECK(!CommandCoalescer::CanCoalesce(""));
+
+    CommandCoalescer coalescer;
+    CHECK(!coalescer.Push("monitor off"));
+    CHECK_EQ(coalescer.GetPendingCount(), size_t(0));
+}
+
+TEST_CASE(SumsDeltasAndClampsToTheRange) {
+    CommandCoalescer coalescer;
+    CHECK(coalescer.Push("changesysvolume 2000"));
+    CHECK(coalescer.Push("changesysvolume 3000 master"));
+    CHECK(coalescer.Push("movecursor 10 -5"));
+    CHECK(coalescer.Push("movecursor 0 -5"));
+    CHECK_EQ(Drain(coalescer), (std::vector<std::string>{ "changesysvolume 5000", "movecursor 10 -10" }));
+
+    CHECK(coalescer.Push("changesysvolume 40000"));
+    CHECK(coalescer.Push("changesysvolume 40000"));
+    CHECK_EQ(Drain(coalescer), std::vector<std::string>{ "changesysvolume 65535" });
+}
+
+TEST_CASE(KeepsOppositeStepsApart) {
+    CommandCoalescer coalescer;
+    CHECK(coalescer.Push("changesysvolume 5000"));
+    CHECK(coalescer.Push("changesysvolume -1000"));
+    CHECK(coalescer.Push("changesysvolume -1000"));
+    CHECK(coalescer.Push("changesysvolume 500"));
+
+    // Same target, so one at a time, in order
+    std::vector<std::string> order;
+    for (int i = 0; i < 4; ++i) {
+        auto commands = Drain(coalescer);
+        order.insert(order.end(), commands.begin(), commands.end());
+    }
+    CHECK_EQ(order, (std::vector<std::string>{ "changesysvolume 5000", "changesysvolume -2000", "changesysvolume 500" }));
+}
+
+TEST_CASE(SetterReplacesQueuedSteps) {
+    CommandCoalescer coalescer;
+    CHECK(coalescer.Push("changesysvolume 1000"));
+    CHECK(coalescer.Push("setsysvolume 20000"));
+    CHECK(coalescer.Push("changesysvolume 1000 waveout"));
+    CHECK(coalescer.Push("setsysvolume 30000"));
+    CHECK(coalescer.Push("changesysvolume 500"));
+
+    // Setters and deltas share the sysvolume target; the waveout step does not
+    CHECK_EQ(Drain(coalescer), (std::vector<std::string>{ "changesysvolume 1000 waveout", "setsysvolume 30000" }));
+    CHECK_EQ(Drain(coalescer), std::vector<std::string>{ "changesysvolume 500" });
+}
+
+TEST_CASE(OneInFlightPerTarget) {
+    CommandCoalescer coalescer;
+    CHECK(coalescer.Push("changebrightness 5"));
+    CHECK(coalescer.Push("movecursor 1 1"));
+
+    std::string command;
+    std::string brightness;
+    CHECK(coalescer.TakeNext(command, brightness));
+    CHECK_EQ(command, std::string("changebrightness 5"));
+
+    // Steps that arrive while the first runs merge behind it and wait for it
+    CHECK(coalescer.Push("changebrightness 5"));
+    CHECK(coalescer.Push("changebrightness 5"));
+    std::string cursor;
+    CHECK(coalescer.TakeNext(command, cursor));
+    CHECK_EQ(command, std::string("movecursor 1 1"));
+    std::string other;
+    CHECK(!coalescer.TakeNext(command, other));
+
+    coalescer.Finish(brightness);
+    CHECK(coalescer.TakeNext(command, brightness));
+    CHECK_EQ(command, std::string("changebrightness 10"));
+    coalescer.Finish(brightness);
+    coalescer.Finish(cursor);
+    CHECK_EQ(coalescer.GetPendingCount(), size_t(0));
+
+    CommandCoalescer::Stats stats = coalescer.GetStats();
+    CHECK_EQ(stats.requested, uint64_t(4));
+    CHECK_EQ(stats.issued, uint64_t(3));
+}
+
+TEST_CASE(BackgroundThreadRunsEverything) {
+    std::mutex mutex;
+    int total = 0;
+    CommandCoalescer coalescer;
+    coalescer.Start([&](const std::string& command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        total += std::stoi(command.substr(command.find(' ') + 1));
+    });
+    for (int i = 0; i < 1000; ++i) CHECK(coalescer.Push("changesysvolume 10"));
+    coalescer.Flush();
+    coalescer.Stop();
+
+    CommandCoalescer::Stats stats = coalescer.GetStats();
+    CHECK_EQ(total, 10000);
+    CHECK_EQ(stats.requested, uint64_t(1000));
+    CHECK(stats.issued >= 1 && stats.issued <= 1000);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
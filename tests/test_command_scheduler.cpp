@@ -0,0 +1,141 @@
+#include "test_support.h"
+#include "core/command_scheduler.h"
+#include "utils/duration.h"
+#include <map>
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr uint64_t HOUR_MS = 3600 * 1000;
+// A Monday, 00:00 UTC
+constexpr int64_t EPOCH_MS = int64_t(1767571200) * 1000;
+
+struct VirtualClock {
+    uint64_t now = 0;
+};
+
+} // namespace
+
+TEST_CASE(ParsesDurations) {
+    uint64_t ms = 0;
+    CHECK(ParseDuration("500ms", ms) && ms == 500);
+    CHECK(ParseDuration("90s", ms) && ms == 90000);
+    CHECK(ParseDuration("1h30m", ms) && ms == 5400000);
+    CHECK(ParseDuration("15", ms) && ms == 15000);
+    CHECK(!ParseDuration("soon", ms));
+    CHECK(!ParseDuration("", ms));
+}
+
+TEST_CASE(ParsesCronExpressions) {
+    CronSpec spec;
+    std::string error;
+    CHECK(spec.Parse("*/15 9-17 * * 1-5", error));
+    CHECK(!spec.Parse("61 * * * *", error));
+    CHECK(!spec.Parse("* * *", error));
+    CHECK(spec.Parse("0 0 31 2 *", error));
+    CHECK_EQ(spec.NextAfter(EPOCH_MS / 1000), std::time_t(-1));
+}
+
+// A day of interval, one-shot and cron tasks on a virtual clock whose wakeups
+// come up to 2 ms late. Interval runs must stay on their original grid.
+TEST_CASE(RunsADayWithoutDrift) {
+    VirtualClock clock;
+    std::map<std::string, std::vector<uint64_t>> runs;
+    CommandScheduler scheduler(
+        [&](const std::string& command) { runs[command].push_back(clock.now); },
+        [&]() { return clock.now; },
+        [&]() { return EPOCH_MS + static_cast<int64_t>(clock.now); });
+
+    std::mt19937 random(24);
+    std::map<std::string, uint64_t> intervals;
+    for (int i = 0; i < 100; ++i) {
+        uint64_t interval = 1000 + random() % 300000;
+        std::string command = "every " + std::to_string(i);
+        intervals[command] = interval;
+        scheduler.ScheduleEvery(interval, command);
+    }
+    std::map<std::string, uint64_t> onceDue;
+    for (int i = 0; i < 200; ++i) {
+        uint64_t delay = random() % (24 * HOUR_MS);
+        std::string command = "once " + std::to_string(i);
+        onceDue[command] = delay;
+        scheduler.ScheduleOnce(delay, command);
+    }
+    CronSpec quarterHours;
+    std::string error;
+    CHECK(quarterHours.Parse("*/15 * * * *", error));
+    CHECK(scheduler.ScheduleCron(quarterHours, "*/15 * * * *", "cron") != 0);
+
+    const uint64_t end = 24 * HOUR_MS;
+    while (clock.now < end) {
+        uint64_t wait = scheduler.GetWaitMs();
+        clock.now = std::min(end, clock.now + std::min(wait, end)) + random() % 3;
+        scheduler.RunDue();
+    }
+
+    size_t total = 0;
+    for (const auto& [command, times] : runs) total += times.size();
+    printf("  %zu runs over 24 h of virtual time\n", total);
+
+    for (const auto& [command, interval] : intervals) {
+        const auto& times = runs[command];
+        CHECK_EQ(times.size(), size_t(clock.now / interval));
+        for (size_t k = 0; k < times.size(); ++k) {
+            uint64_t due = (k + 1) * interval;
+            if (times[k] < due || times[k] > due + 2) {
+                CHECK_EQ(times[k], due);
+                break;
+            }
+        }
+    }
+    for (const auto& [command, due] : onceDue) {
+        const auto& times = runs[command];
+        CHECK(times.size() == 1 && times[0] >= due && times[0] <= due + 2);
+    }
+
+    const auto& cron = runs["cron"];
+    CHECK_EQ(cron.size(), size_t(96));
+    for (uint64_t time : cron) {
+        CHECK_EQ((EPOCH_MS + static_cast<int64_t>(time)) / 1000 % 900 / 60, int64_t(0));
+    }
+    CHECK_EQ(scheduler.GetTaskCount(), size_t(101));
+}
+
+// A runner blocked far past several intervals skips the missed runs instead of
+// bursting, and the next run is still on the original grid
+TEST_CASE(SkipsMissedRunsWithoutShifting) {
+    VirtualClock clock;
+    std::vector<uint64_t> times;
+    CommandScheduler scheduler([&](const std::string&) { times.push_back(clock.now); }, [&]() { return clock.now; });
+    scheduler.ScheduleEvery(1000, "tick");
+
+    clock.now = 1000;
+    CHECK_EQ(scheduler.RunDue(), size_t(1));
+    clock.now = 5500;
+    CHECK_EQ(scheduler.RunDue(), size_t(1));
+    clock.now = 5999;
+    CHECK_EQ(scheduler.RunDue(), size_t(0));
+    clock.now = 6000;
+    CHECK_EQ(scheduler.RunDue(), size_t(1));
+    CHECK_EQ(times, (std::vector<uint64_t>{ 1000, 5500, 6000 }));
+}
+
+TEST_CASE(CancelStopsTasks) {
+    VirtualClock clock;
+    int count = 0;
+    CommandScheduler scheduler([&](const std::string&) { count++; }, [&]() { return clock.now; });
+    CommandScheduler::TaskId id = scheduler.ScheduleEvery(10, "a");
+    scheduler.ScheduleOnce(5, "b");
+    CHECK(scheduler.Cancel(id));
+    CHECK(!scheduler.Cancel(id));
+    clock.now = 1000;
+    CHECK_EQ(scheduler.RunDue(), size_t(1));
+    CHECK_EQ(count, 1);
+    CHECK_EQ(scheduler.GetWaitMs(), UINT64_MAX);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,99 @@
+#include "test_support.h"
+#include "core/command_template.h"
+#include "core/command_tokenizer.h"
+
+using namespace NirUI;
+
+namespace {
+
+std::string ExpandRow(const char* text, const std::vector<std::string_view>& fields) {
+    CommandTemplate commandTemplate;
+    std::string error;
+    CHECK(commandTemplate.Compile(text, error));
+    std::string out;
+    commandTemplate.Expand(fields.data(), fields.size(), out);
+    return out;
+}
+
+std::vector<std::string> Split(std::string_view line) {
+    CommandTokens tokens(line);
+    std::vector<std::string> args;
+    for (size_t i = 0; i < tokens.GetCount(); ++i) args.emplace_back(tokens[i]);
+    return args;
+}
+
+} // namespace
+
+TEST_CASE(PlainValuesAreNotQuoted) {
+    CHECK_EQ(ExpandRow("setappvolume {0} {1}", {"chrome.exe", "0.5"}), std::string("setappvolume chrome.exe 0.5"));
+    CHECK_EQ(ExpandRow("win close title {0}", {"Untitled - Notepad"}),
+             std::string("win close title \"Untitled - Notepad\""));
+}
+
+TEST_CASE(SurroundingQuotesAreKept) {
+    // A value wrapped in quotes is data, not a pre-quoted argument
+    std::string line = ExpandRow("win close title {0}", {"\"a\""});
+    CHECK_EQ(Split(line), (std::vector<std::string>{"win", "close", "title", "\"a\""}));
+}
+
+TEST_CASE(EmbeddedQuotesCannotAddArguments) {
+    std::string line = ExpandRow("win close title {0}", {"\"x\" \"y\""});
+    CHECK_EQ(Split(line), (std::vector<std::string>{"win", "close", "title", "\"x\" \"y\""}));
+
+    line = ExpandRow("exec hide app.exe --name={0} end", {"a\" \"b"});
+    CHECK_EQ(Split(line), (std::vector<std::string>{"exec", "hide", "app.exe", "--name=a\" \"b", "end"}));
+
+    line = ExpandRow("exec hide app.exe \"C:\\{0}\" end", {"x\" y \"z\\"});
+    CHECK_EQ(Split(line), (std::vector<std::string>{"exec", "hide", "app.exe", "C:\\x\" y \"z\\", "end"}));
+}
+
+TEST_CASE(ValuesRoundTrip) {
+    const char* values[] = {"", " ", "\"", "\"\"", "\\", "\\\"", "a\\\\\"b", "trailing\\", "\" \"", "tab\there"};
+    for (const char* value : values) {
+        std::vector<std::string_view> fields{value};
+        CHECK_EQ(Split(ExpandRow("cmd {0} end", fields)), (std::vector<std::string>{"cmd", value, "end"}));
+        CHECK_EQ(Split(ExpandRow("cmd x{0}y end", fields)),
+                 (std::vector<std::string>{"cmd", std::string("x") + value + "y", "end"}));
+        CHECK_EQ(Split(ExpandRow("cmd \"<{0}>\" end", fields)),
+                 (std::vector<std::string>{"cmd", std::string("<") + value + ">", "end"}));
+    }
+}
+
+TEST_CASE(NamedPlaceholdersBindToHeader) {
+    CommandTemplate commandTemplate;
+    std::string error;
+    CHECK(commandTemplate.Compile("setappvolume {proc} {level}", error));
+    CHECK(commandTemplate.HasNamedPlaceholders());
+    CHECK(!commandTemplate.Bind({"level", "other"}, error));
+    CHECK(commandTemplate.Bind({"level", "other", "proc"}, error));
+    CHECK_EQ(commandTemplate.GetRequiredFields(), size_t(3));
+
+    std::vector<std::string_view> row{"0.25", "-", "spotify.exe"};
+    std::string out;
+    commandTemplate.Expand(row.data(), row.size(), out);
+    CHECK_EQ(out, std::string("setappvolume spotify.exe 0.25"));
+}
+
+TEST_CASE(CsvRowsFeedExpansion) {
+    CsvReader reader("proc,title\nchrome.exe,\"Say \"\"hi\"\"\"\n\n\"a,b\",x\n");
+    std::vector<std::string_view> fields;
+    CHECK(reader.Next(fields));
+    CHECK_EQ(fields.size(), size_t(2));
+
+    CommandTemplate commandTemplate;
+    std::string error;
+    CHECK(commandTemplate.Compile("win close title {title}", error));
+    CHECK(commandTemplate.Bind(fields, error));
+
+    CHECK(reader.Next(fields));
+    std::string out;
+    commandTemplate.Expand(fields.data(), fields.size(), out);
+    CHECK_EQ(Split(out), (std::vector<std::string>{"win", "close", "title", "Say \"hi\""}));
+
+    CHECK(reader.Next(fields));
+    CHECK_EQ(reader.GetLineNumber(), size_t(4));
+    CHECK_EQ(fields[0], std::string_view("a,b"));
+    CHECK(!reader.Next(fields));
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,141 @@
+#include "test_support.h"
+#include "core/command_tokenizer.h"
+#include "core/nircmd_manager.h"
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+// Straight transcription of the CommandLineToArgvW rules for arguments after
+// the program name, one character at a time
+std::vector<std::string> ReferenceSplit(std::string_view line) {
+    std::vector<std::string> args;
+    size_t pos = 0;
+    while (true) {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) pos++;
+        if (pos >= line.size()) return args;
+
+        std::string arg;
+        bool inQuotes = false;
+        while (pos < line.size()) {
+            char c = line[pos];
+            if (c == '\\') {
+                size_t backslashes = 0;
+                while (pos < line.size() && line[pos] == '\\') {
+                    backslashes++;
+                    pos++;
+                }
+                if (pos < line.size() && line[pos] == '"') {
+                    arg.append(backslashes / 2, '\\');
+                    if (backslashes % 2 == 1) {
+                        arg += '"';
+                        pos++;
+                    }
+                } else {
+                    arg.append(backslashes, '\\');
+                }
+            } else if (c == '"') {
+                if (inQuotes && pos + 1 < line.size() && line[pos + 1] == '"') {
+                    arg += '"';
+                    pos += 2;
+                } else {
+                    inQuotes = !inQuotes;
+                    pos++;
+                }
+            } else if ((c == ' ' || c == '\t') && !inQuotes) {
+                break;
+            } else {
+                arg += c;
+                pos++;
+            }
+        }
+        args.push_back(std::move(arg));
+    }
+}
+
+std::vector<std::string> Split(std::string_view line) {
+    CommandTokens tokens(line);
+    std::vector<std::string> args;
+    for (size_t i = 0; i < tokens.GetCount(); ++i) {
+        args.emplace_back(tokens[i]);
+    }
+    return args;
+}
+
+std::string RandomLine(std::mt19937& random, size_t maxLength) {
+    static const char ALPHABET[] = { 'a', 'b', ' ', '\t', '"', '\\' };
+    std::uniform_int_distribution<size_t> length(0, maxLength);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(ALPHABET) - 1);
+    std::string line(length(random), ' ');
+    for (char& c : line) c = ALPHABET[pick(random)];
+    return line;
+}
+
+} // namespace
+
+TEST_CASE(SplitsKnownLines) {
+    CHECK_EQ(Split(""), std::vector<std::string>{});
+    CHECK_EQ(Split("  \t "), std::vector<std::string>{});
+    CHECK_EQ(Split("win close title Notepad"), (std::vector<std::string>{ "win", "close", "title", "Notepad" }));
+    CHECK_EQ(Split("exec show \"C:\\Program Files\\app.exe\""),
+             (std::vector<std::string>{ "exec", "show", "C:\\Program Files\\app.exe" }));
+    CHECK_EQ(Split("a\\\\\\\"b"), std::vector<std::string>{ "a\\\"b" });
+    CHECK_EQ(Split("a\\\\\"b c\""), std::vector<std::string>{ "a\\b c" });
+    CHECK_EQ(Split("\"a\"\"b\""), std::vector<std::string>{ "a\"b" });
+    CHECK_EQ(Split("\"\" x"), (std::vector<std::string>{ "", "x" }));
+    CHECK_EQ(Split("\"unterminated"), std::vector<std::string>{ "unterminated" });
+    CHECK_EQ(Split("trail\\"), std::vector<std::string>{ "trail\\" });
+}
+
+TEST_CASE(MatchesReferenceOnRandomLines) {
+    std::mt19937 random(41);
+    size_t mismatches = 0;
+    for (int i = 0; i < 200000; ++i) {
+        std::string line = RandomLine(random, 24);
+        if (Split(line) != ReferenceSplit(line) && ++mismatches <= 5) {
+            CHECK_EQ(Split(line), ReferenceSplit(line));
+            fprintf(stderr, "  line: [%s]\n", line.c_str());
+        }
+    }
+    CHECK_EQ(mismatches, size_t(0));
+}
+
+TEST_CASE(HandlesMoreThanInlineTokens) {
+    std::string line;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < CommandTokens::INLINE_TOKENS * 3; ++i) {
+        std::string word = i % 2 == 0 ? "w" + std::to_string(i) : "\"q\\\"" + std::to_string(i) + "\"";
+        line += word + ' ';
+        expected.push_back(i % 2 == 0 ? word : "q\"" + std::to_string(i));
+    }
+    CHECK_EQ(Split(line), expected);
+    CHECK_EQ(Split(line), ReferenceSplit(line));
+}
+
+// Whatever AppendQuotedArgument writes, the tokenizer reads back unchanged.
+// Arguments already wrapped in quotes are passed through by design and left out.
+TEST_CASE(RoundTripsQuotedArguments) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> argCount(0, 6);
+    for (int i = 0; i < 50000; ++i) {
+        std::vector<std::string> args;
+        std::string line;
+        for (int n = argCount(random); n > 0; --n) {
+            std::string arg = RandomLine(random, 10);
+            if (arg.size() >= 2 && arg.front() == '"' && arg.back() == '"') continue;
+            if (!line.empty()) line += ' ';
+            NirCmdManager::AppendQuotedArgument(line, arg);
+            args.push_back(std::move(arg));
+        }
+        if (Split(line) != args) {
+            CHECK_EQ(Split(line), args);
+            fprintf(stderr, "  line: [%s]\n", line.c_str());
+            break;
+        }
+    }
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
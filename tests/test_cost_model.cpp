@@ -0,0 +1,141 @@
+#include "test_support.h"
+#include "core/cost_model.h"
+#include "core/settings_store.h"
+#include "utils/duration.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+double ExactQuantile(std::vector<double> values, double q) {
+    std::sort(values.begin(), values.end());
+    size_t rank = std::max<size_t>(static_cast<size_t>(std::ceil(q * values.size())), 1);
+    return values[rank - 1];
+}
+
+} // namespace
+
+// The sketch keeps every quantile within half a bucket (about 5%) of the true
+// value as long as the window has not decayed
+TEST_CASE(SketchQuantilesStayWithinBucketError) {
+    std::mt19937 random(48);
+    std::lognormal_distribution<double> duration(std::log(40.0), 0.8);
+
+    CostModel model;
+    std::vector<double> samples;
+    for (int i = 0; i < 1000; ++i) {
+        double ms = duration(random);
+        samples.push_back(ms);
+        model.Record(CostBackend::NirCmd, "win close", ms);
+    }
+
+    CostEstimate estimate;
+    CHECK(model.GetEstimate(CostBackend::NirCmd, "win close", estimate));
+    CHECK_EQ(estimate.samples, uint64_t(1000));
+    const std::pair<double, double> quantiles[] = {
+        { 0.50, estimate.p50Ms }, { 0.90, estimate.p90Ms }, { 0.99, estimate.p99Ms }
+    };
+    for (const auto& [q, sketched] : quantiles) {
+        double exact = ExactQuantile(samples, q);
+        double error = std::fabs(sketched - exact) / exact;
+        printf("  p%.0f: exact %.2f ms, sketch %.2f ms, error %.1f%%\n", q * 100, exact, sketched, error * 100);
+        CHECK(error <= 0.05);
+    }
+}
+
+// Counts halve every 1024 samples and the average weights recent runs, so a
+// command that got ten times slower is estimated at its new cost
+TEST_CASE(FollowsACommandThatSlowsDown) {
+    CostModel model;
+    for (int i = 0; i < 5000; ++i) model.Record(CostBackend::NirCmd, "monitor", 10);
+    for (int i = 0; i < 3000; ++i) model.Record(CostBackend::NirCmd, "monitor", 100);
+
+    CostEstimate estimate;
+    CHECK(model.GetEstimate(CostBackend::NirCmd, "monitor", estimate));
+    CHECK(std::fabs(estimate.averageMs - 100) < 0.01);
+    CHECK(std::fabs(estimate.p50Ms - 100) / 100 <= 0.05);
+    CHECK(std::fabs(estimate.p90Ms - 100) / 100 <= 0.05);
+    CHECK_EQ(estimate.samples, uint64_t(8000));
+}
+
+TEST_CASE(FallsBackToTheBackendAverage) {
+    CostModel model;
+    CHECK_EQ(model.EstimateMs(CostBackend::NirCmd, "beep"), 50.0);
+    CHECK_EQ(model.EstimateMs(CostBackend::Builtin, "group run"), 1.0);
+
+    model.Record(CostBackend::NirCmd, "setsysvolume", 20);
+    model.Record(CostBackend::NirCmd, "", 1000);
+    model.Record(CostBackend::NirCmd, "monitor", -1);
+    CHECK_EQ(model.EstimateMs(CostBackend::NirCmd, "setsysvolume"), 20.0);
+    CHECK_EQ(model.EstimateMs(CostBackend::NirCmd, "beep"), 20.0);
+    CHECK_EQ(model.EstimateMs(CostBackend::Builtin, "group run"), 1.0);
+    CHECK_EQ(model.GetCommandCount(), size_t(1));
+}
+
+TEST_CASE(RoundTripsThroughTheStore) {
+    Test::TempDirectory directory;
+    std::filesystem::path path = directory.GetPath() / "command_costs.store";
+
+    CostModel original;
+    std::mt19937 random(2);
+    std::uniform_real_distribution<double> duration(1, 500);
+    for (int i = 0; i < 3000; ++i) {
+        original.Record(i % 3 == 0 ? CostBackend::Builtin : CostBackend::NirCmd,
+                        i % 2 == 0 ? "win close" : "group \"odd\"\tname", duration(random));
+    }
+    {
+        SettingsStore store(path);
+        original.Save(store);
+        CHECK(store.Commit());
+    }
+
+    SettingsStore store(path);
+    CHECK(store.Load());
+    CostModel loaded;
+    loaded.Record(CostBackend::NirCmd, "beep", 5);
+    loaded.Load(store);
+
+    CHECK_EQ(loaded.GetCommandCount(), size_t(5));
+    for (CostBackend backend : { CostBackend::NirCmd, CostBackend::Builtin }) {
+        for (const char* name : { "win close", "group \"odd\"\tname", "" }) {
+            CostEstimate before;
+            CostEstimate after;
+            CHECK(original.GetEstimate(backend, name, before));
+            // Entries recorded before the load win over the stored ones
+            CHECK(loaded.GetEstimate(backend, name, after));
+            if (backend == CostBackend::NirCmd && name[0] == '\0') continue;
+            CHECK_EQ(after.averageMs, before.averageMs);
+            CHECK_EQ(after.samples, before.samples);
+            CHECK_EQ(after.p50Ms, before.p50Ms);
+            CHECK_EQ(after.p99Ms, before.p99Ms);
+        }
+    }
+    CHECK_EQ(loaded.EstimateMs(CostBackend::NirCmd, "beep"), 5.0);
+}
+
+TEST_CASE(FormatsDurations) {
+    CHECK_EQ(FormatDuration(0), std::string("0s"));
+    CHECK_EQ(FormatDuration(5400000), std::string("1h30m"));
+    CHECK_EQ(FormatDuration(2500), std::string("2s500ms"));
+    CHECK_EQ(FormatEstimate(1234), std::string("1s"));
+    CHECK_EQ(FormatEstimate(250), std::string("300ms"));
+}
+
+TEST_CASE(ProgressScalesToTheObservedPace) {
+    ProgressTracker progress;
+    progress.Add(100);
+    progress.Add(300);
+    CHECK_EQ(progress.GetRemainingMs(0, 2), 200.0);
+    progress.Complete(100);
+    CHECK_EQ(progress.GetFraction(), 0.25);
+    // The first command took twice its estimate
+    CHECK_EQ(progress.GetRemainingMs(200, 2), 600.0);
+    CHECK(progress.IsActive());
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,152 @@
+#include "test_support.h"
+#include "core/app_groups.h"
+#include "utils/dir_watcher.h"
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr auto TIMEOUT = std::chrono::seconds(5);
+
+// Collects the names the watcher reports, from its thread
+class EventLog {
+public:
+    DirectoryWatcher::Callback GetCallback() {
+        return [this](const std::string& fileName) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_names.insert(fileName);
+            m_condition.notify_all();
+        };
+    }
+
+    bool WaitFor(const std::string& name) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, TIMEOUT, [&]() { return m_names.count(name) > 0; });
+    }
+
+    bool Contains(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_names.count(name) > 0;
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_names.clear();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::set<std::string> m_names;
+};
+
+void WriteFile(const std::filesystem::path& path, const std::string& text) {
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+} // namespace
+
+TEST_CASE(ReportsChangedFileNames) {
+    Test::TempDirectory directory;
+    EventLog log;
+    DirectoryWatcher watcher;
+    CHECK(watcher.Start(directory.GetPath(), log.GetCallback()));
+    CHECK(watcher.IsRunning());
+
+    WriteFile(directory.GetPath() / "created.txt", "one");
+    CHECK(log.WaitFor("created.txt"));
+
+    log.Clear();
+    std::ofstream(directory.GetPath() / "created.txt", std::ios::binary | std::ios::app) << "two";
+    CHECK(log.WaitFor("created.txt"));
+
+    // Replacing a file by rename, as WriteFileAtomically does, reports both names
+    WriteFile(directory.GetPath() / "temp.tmp", "three");
+    log.Clear();
+    std::filesystem::rename(directory.GetPath() / "temp.tmp", directory.GetPath() / "created.txt");
+    CHECK(log.WaitFor("created.txt"));
+    CHECK(log.WaitFor("temp.tmp"));
+
+    log.Clear();
+    std::filesystem::remove(directory.GetPath() / "created.txt");
+    CHECK(log.WaitFor("created.txt"));
+
+    watcher.Stop();
+    CHECK(!watcher.IsRunning());
+}
+
+TEST_CASE(DoesNotWatchSubdirectories) {
+    Test::TempDirectory directory;
+    std::filesystem::create_directory(directory.GetPath() / "sub");
+    EventLog log;
+    DirectoryWatcher watcher;
+    CHECK(watcher.Start(directory.GetPath(), log.GetCallback()));
+
+    WriteFile(directory.GetPath() / "sub" / "nested.txt", "x");
+    // Written after the nested file, so once it shows up the nested one would have too
+    WriteFile(directory.GetPath() / "marker.txt", "x");
+    CHECK(log.WaitFor("marker.txt"));
+    CHECK(!log.Contains("nested.txt"));
+}
+
+TEST_CASE(StartsAndStopsCleanly) {
+    Test::TempDirectory directory;
+    EventLog log;
+    DirectoryWatcher watcher;
+    CHECK(!watcher.Start(directory.GetPath() / "missing", log.GetCallback()));
+    CHECK(!watcher.IsRunning());
+
+    // Stopping an idle watcher returns at once, and a stopped one can restart
+    for (int i = 0; i < 3; ++i) {
+        CHECK(watcher.Start(directory.GetPath(), log.GetCallback()));
+        Test::Stopwatch stopwatch;
+        watcher.Stop();
+        CHECK(stopwatch.GetElapsedMs() < 1000);
+        watcher.Stop();
+    }
+
+    CHECK(watcher.Start(directory.GetPath(), log.GetCallback()));
+    WriteFile(directory.GetPath() / "after-restart.txt", "x");
+    CHECK(log.WaitFor("after-restart.txt"));
+}
+
+// The GUI's side of hot reload: the watcher reports app_groups.txt, the owner
+// thread refreshes and merges what another process appended
+TEST_CASE(ReloadsGroupsChangedByAnotherWriter) {
+    Test::TempDirectory directory;
+    AppGroupsManager gui;
+    gui.SetDataPath(directory.GetPath());
+    gui.CreateGroup("Work");
+    gui.AddApp("Work", "Editor", "process", "code.exe");
+
+    EventLog log;
+    DirectoryWatcher watcher;
+    CHECK(watcher.Start(directory.GetPath(), log.GetCallback()));
+
+    AppGroupsManager cli;
+    cli.SetDataPath(directory.GetPath());
+    cli.Load();
+    cli.AddApp("Work", "Browser", "process", "chrome.exe");
+    cli.CreateGroup("Games");
+
+    CHECK(log.WaitFor("app_groups.txt"));
+    CHECK(gui.Refresh());
+    CHECK(gui.FindGroup("Games") != nullptr);
+    CHECK(gui.FindGroup("Work") && gui.FindGroup("Work")->apps.size() == 2);
+
+    // A later GUI change keeps what the CLI wrote
+    gui.CreateGroup("Music");
+    AppGroupsManager reloaded;
+    reloaded.SetDataPath(directory.GetPath());
+    reloaded.Load();
+    CHECK_EQ(reloaded.GetGroups().size(), size_t(3));
+    CHECK(reloaded.FindGroup("Work") && reloaded.FindGroup("Work")->apps.size() == 2);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,135 @@
+#include "test_support.h"
+#include "ui/icon_atlas.h"
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+// Filled with a colour derived from the index so the copy into the atlas can be checked
+RasterizedIcon MakeIcon(const std::string& name, int size, int index) {
+    RasterizedIcon icon;
+    icon.name = name;
+    icon.width = size;
+    icon.height = size;
+    icon.pixels.resize(static_cast<size_t>(size) * size * 4);
+    for (size_t i = 0; i < icon.pixels.size(); i += 4) {
+        icon.pixels[i + 0] = static_cast<unsigned char>(index);
+        icon.pixels[i + 1] = static_cast<unsigned char>(index >> 8);
+        icon.pixels[i + 2] = static_cast<unsigned char>(size);
+        icon.pixels[i + 3] = 255;
+    }
+    return icon;
+}
+
+bool Overlaps(const AtlasRegion& a, const AtlasRegion& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+bool IsInside(const IconAtlas& atlas, const AtlasRegion& region) {
+    return region.x >= 0 && region.y >= 0 && region.x + region.width <= atlas.GetWidth() &&
+           region.y + region.height <= atlas.GetHeight() && region.u0 >= 0.0f && region.v0 >= 0.0f &&
+           region.u1 <= 1.0f && region.v1 <= 1.0f && region.u0 < region.u1 && region.v0 < region.v1 &&
+           region.u0 == static_cast<float>(region.x) / atlas.GetWidth() &&
+           region.v1 == static_cast<float>(region.y + region.height) / atlas.GetHeight();
+}
+
+bool HasPixels(const IconAtlas& atlas, const AtlasRegion& region, int index) {
+    const auto& pixels = atlas.GetPixels();
+    for (int row = 0; row < region.height; ++row) {
+        for (int column = 0; column < region.width; ++column) {
+            size_t at = (static_cast<size_t>(region.y + row) * atlas.GetWidth() + region.x + column) * 4;
+            if (pixels[at] != static_cast<unsigned char>(index) || pixels[at + 1] != static_cast<unsigned char>(index >> 8) ||
+                pixels[at + 2] != static_cast<unsigned char>(region.width) || pixels[at + 3] != 255) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE(FindPicksSmallestVariantThatFits) {
+    IconAtlas atlas;
+    std::vector<RasterizedIcon> icons;
+    // Out of order on purpose; Pack sorts the variants
+    icons.push_back(MakeIcon("star", 32, 0));
+    icons.push_back(MakeIcon("star", 16, 1));
+    icons.push_back(MakeIcon("star", 24, 2));
+    icons.push_back(MakeIcon("folder", 16, 3));
+    CHECK(atlas.Pack(std::move(icons)));
+    CHECK_EQ(atlas.GetIconCount(), size_t(2));
+    CHECK_EQ(atlas.GetRegionCount(), size_t(4));
+
+    CHECK_EQ(atlas.Find("star", 10.0f)->width, 16);
+    CHECK_EQ(atlas.Find("star", 16.0f)->width, 16);
+    CHECK_EQ(atlas.Find("star", 16.5f)->width, 24);
+    CHECK_EQ(atlas.Find("star", 24.0f)->width, 24);
+    CHECK_EQ(atlas.Find("star", 28.0f)->width, 32);
+    // Larger than every variant: the largest one is scaled up
+    CHECK_EQ(atlas.Find("star", 64.0f)->width, 32);
+    CHECK_EQ(atlas.Find("folder", 32.0f)->width, 16);
+    CHECK(atlas.Find("missing", 16.0f) == nullptr);
+    CHECK(HasPixels(atlas, *atlas.Find("star", 24.0f), 2));
+}
+
+TEST_CASE(PackedRegionsDoNotOverlap) {
+    std::mt19937 random(29);
+    std::vector<RasterizedIcon> icons;
+    for (int i = 0; i < 300; ++i) {
+        icons.push_back(MakeIcon("icon" + std::to_string(i), 4 + static_cast<int>(random() % 60), i));
+    }
+
+    for (int padding : { 0, 1, 3 }) {
+        IconAtlas atlas;
+        CHECK(atlas.Pack(icons, padding));
+        CHECK_EQ(atlas.GetIconCount(), icons.size());
+        CHECK((atlas.GetWidth() & (atlas.GetWidth() - 1)) == 0);
+        CHECK((atlas.GetHeight() & (atlas.GetHeight() - 1)) == 0);
+
+        std::vector<const AtlasRegion*> regions;
+        for (size_t i = 0; i < icons.size(); ++i) {
+            const AtlasRegion* region = atlas.Find(icons[i].name, 1.0f);
+            CHECK(region != nullptr);
+            if (!region) continue;
+            CHECK_EQ(region->width, icons[i].width);
+            CHECK(IsInside(atlas, *region));
+            CHECK(HasPixels(atlas, *region, static_cast<int>(i)));
+            regions.push_back(region);
+        }
+
+        // Padding also keeps neighbours apart, so bilinear filtering does not bleed
+        size_t overlaps = 0;
+        for (size_t a = 0; a < regions.size(); ++a) {
+            AtlasRegion grown = *regions[a];
+            grown.x -= padding;
+            grown.y -= padding;
+            grown.width += padding * 2;
+            grown.height += padding * 2;
+            for (size_t b = a + 1; b < regions.size(); ++b) {
+                if (Overlaps(grown, *regions[b])) overlaps++;
+            }
+        }
+        CHECK_EQ(overlaps, size_t(0));
+    }
+}
+
+TEST_CASE(EmptyAndReleasedAtlases) {
+    IconAtlas atlas;
+    CHECK(!atlas.Pack({}));
+    CHECK(atlas.IsEmpty());
+
+    std::vector<RasterizedIcon> icons;
+    icons.push_back(MakeIcon("wide", 200, 0));
+    CHECK(atlas.Pack(std::move(icons)));
+    CHECK(atlas.GetWidth() >= 202);
+
+    atlas.ReleasePixels();
+    CHECK(atlas.GetPixels().empty());
+    CHECK(atlas.Find("wide", 16.0f) != nullptr);
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
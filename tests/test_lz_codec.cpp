@@ -0,0 +1,100 @@
+#include "test_support.h"
+#include "utils/lz_codec.h"
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+bool RoundTrips(const std::string& input) {
+    std::string compressed = CompressBlock(input);
+    std::string output;
+    return DecompressBlock(compressed, input.size(), output) && output == input;
+}
+
+std::string MakeOutput(size_t lines) {
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += "  #" + std::to_string(i) + " process chrome.exe, volume 0.75, window \"New Tab - Google Chrome\"\n";
+    }
+    return text;
+}
+
+} // namespace
+
+TEST_CASE(RoundTripsEdgeCases) {
+    CHECK(RoundTrips(""));
+    CHECK(RoundTrips("a"));
+    CHECK(RoundTrips("abcd"));
+    CHECK(RoundTrips(std::string(15, 'x')));
+    CHECK(RoundTrips(std::string(16, 'x')));
+    CHECK(RoundTrips(std::string(100000, 'x')));
+    CHECK(RoundTrips("abcabcabcabcabcabcabcabc"));
+    CHECK(RoundTrips(std::string(300, 'a') + std::string(300, 'b') + "tail"));
+}
+
+TEST_CASE(CompressesRepetitiveText) {
+    std::string text = MakeOutput(1000);
+    std::string compressed = CompressBlock(text);
+    CHECK(compressed.size() < text.size() / 3);
+    std::string output;
+    CHECK(DecompressBlock(compressed, text.size(), output));
+    CHECK(output == text);
+}
+
+TEST_CASE(RoundTripsRandomData) {
+    // Matches further back than the 64 KB window must not be used
+    std::mt19937 random(7);
+    std::string noise(200000, '\0');
+    for (char& c : noise) c = static_cast<char>(random());
+    CHECK(RoundTrips(noise));
+    CHECK(RoundTrips(noise.substr(0, 70000) + noise.substr(0, 70000)));
+
+    for (int round = 0; round < 200; ++round) {
+        std::string text;
+        size_t length = random() % 2000;
+        while (text.size() < length) text += static_cast<char>('a' + random() % 3);
+        CHECK(RoundTrips(text));
+    }
+}
+
+TEST_CASE(RejectsWrongSize) {
+    std::string text = MakeOutput(50);
+    std::string compressed = CompressBlock(text);
+    std::string output;
+    CHECK(!DecompressBlock(compressed, text.size() - 1, output));
+    CHECK(!DecompressBlock(compressed, text.size() + 1, output));
+    CHECK(!DecompressBlock("", 1, output));
+}
+
+TEST_CASE(RejectsCorruptInput) {
+    std::string output;
+    // Truncated literal run and truncated match offset
+    CHECK(!DecompressBlock(std::string("\x50" "ab", 3), 5, output));
+    CHECK(!DecompressBlock(std::string("\x10" "a\x01", 3), 5, output));
+    // Offset of zero, and an offset before the start of the output
+    CHECK(!DecompressBlock(std::string("\x10" "a\x00\x00", 4), 5, output));
+    CHECK(!DecompressBlock(std::string("\x10" "a\x02\x00", 4), 5, output));
+    // Length bytes running off the end
+    CHECK(!DecompressBlock(std::string("\xF0\xFF\xFF", 3), 600, output));
+
+    // A truncated block fails unless only an empty final token was cut, and a
+    // changed byte either fails or yields exactly the promised size; neither
+    // reads out of bounds
+    std::string text = MakeOutput(20);
+    std::string compressed = CompressBlock(text);
+    for (size_t length = 0; length < compressed.size(); ++length) {
+        if (DecompressBlock(compressed.substr(0, length), text.size(), output)) {
+            CHECK_EQ(length, compressed.size() - 1);
+            CHECK(output == text);
+        }
+    }
+    std::mt19937 random(3);
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        std::string corrupt = compressed;
+        corrupt[i] = static_cast<char>(corrupt[i] ^ (1 + random() % 255));
+        if (DecompressBlock(corrupt, text.size(), output)) CHECK_EQ(output.size(), text.size());
+    }
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,148 @@
+#include "test_support.h"
+#include "core/meta_commands.h"
+
+using namespace NirUI;
+
+namespace {
+
+struct FreezeCall {
+    std::string type;
+    std::string value;
+    bool recursive = false;
+    int calls = 0;
+};
+
+MetaCommandHandlers MakeHandlers(AppGroupsManager& groups, FreezeCall& freeze) {
+    MetaCommandHandlers handlers;
+    handlers.appGroups = &groups;
+    handlers.freeze = [&freeze](const std::string& type, const std::string& value, bool recursive) {
+        freeze.type = type;
+        freeze.value = value;
+        freeze.recursive = recursive;
+        freeze.calls++;
+        return std::string("frozen");
+    };
+    handlers.unfreeze = handlers.freeze;
+    handlers.runGroup = [](const std::string& group, const std::string& action) { return group + ":" + action; };
+    return handlers;
+}
+
+} // namespace
+
+TEST_CASE(RecognizesMetaCommands) {
+    CHECK(IsMetaCommand("win freeze process app.exe"));
+    CHECK(IsMetaCommand("group list"));
+    CHECK(IsMetaCommand("group bogus"));
+    CHECK(IsMetaCommand("schedule list"));
+    CHECK(!IsMetaCommand("win close title Notepad"));
+    CHECK(!IsMetaCommand("setsysvolume 100"));
+    CHECK(!IsMetaCommand(""));
+}
+
+TEST_CASE(ParsesEveryRecursiveFlagForm) {
+    AppGroupsManager groups;
+    FreezeCall freeze;
+    MetaCommandHandlers handlers = MakeHandlers(groups, freeze);
+
+    const char* recursive[] = { "--recursive", "-r", "recursive=true", "recursive=1", "true", "yes", "on" };
+    for (const char* flag : recursive) {
+        ExecutionResult result;
+        CHECK(DispatchMetaCommand(std::string("win freeze folder \"C:\\Games\" ") + flag, handlers, result));
+        CHECK(result.success);
+        CHECK_EQ(freeze.value, std::string("C:\\Games"));
+        CHECK(freeze.recursive);
+    }
+
+    const char* flat[] = { "recursive=false", "0", "off" };
+    for (const char* flag : flat) {
+        ExecutionResult result;
+        CHECK(DispatchMetaCommand(std::string("win unfreeze folder x ") + flag, handlers, result));
+        CHECK(result.success);
+        CHECK(!freeze.recursive);
+    }
+
+    ExecutionResult result;
+    CHECK(DispatchMetaCommand("win freeze folder x maybe", handlers, result));
+    CHECK(!result.success);
+    CHECK_EQ(result.exitCode, 1);
+    CHECK_EQ(freeze.calls, 10);
+}
+
+TEST_CASE(ReportsUsageAndUnknownSubcommands) {
+    AppGroupsManager groups;
+    FreezeCall freeze;
+    MetaCommandHandlers handlers = MakeHandlers(groups, freeze);
+
+    ExecutionResult result;
+    CHECK(DispatchMetaCommand("win freeze process", handlers, result));
+    CHECK(!result.success);
+    CHECK(result.output.find("Usage: win freeze") == 0);
+
+    CHECK(DispatchMetaCommand("group frobnicate", handlers, result));
+    CHECK(!result.success);
+    CHECK(result.output.find("group create NAME") != std::string::npos);
+
+    CHECK(DispatchMetaCommand("schedule list", handlers, result));
+    CHECK(!result.success);
+    CHECK_EQ(freeze.calls, 0);
+}
+
+TEST_CASE(RunsGroupCommands) {
+    AppGroupsManager groups;
+    FreezeCall freeze;
+    MetaCommandHandlers handlers = MakeHandlers(groups, freeze);
+
+    ExecutionResult result;
+    CHECK(DispatchMetaCommand("group create \"My Apps\"", handlers, result));
+    CHECK(result.success);
+    CHECK(DispatchMetaCommand("group add \"My Apps\" Editor process code.exe", handlers, result));
+    CHECK(result.success);
+    CHECK(DispatchMetaCommand("group create \"My Apps\"", handlers, result));
+    CHECK(!result.success);
+    CHECK(DispatchMetaCommand("group run \"My Apps\" min", handlers, result));
+    CHECK_EQ(result.output, std::string("My Apps:min"));
+
+    const AppGroup* group = groups.FindGroup("My Apps");
+    CHECK(group && group->apps.size() == 1 && group->apps[0].targetValue == "code.exe");
+}
+
+TEST_CASE(CreatesSchedulerOnlyForScheduleCommands) {
+    AppGroupsManager groups;
+    FreezeCall freeze;
+    MetaCommandHandlers handlers = MakeHandlers(groups, freeze);
+    CommandScheduler scheduler([](const std::string&) {});
+    int created = 0;
+    handlers.getScheduler = [&]() {
+        created++;
+        return &scheduler;
+    };
+
+    ExecutionResult result;
+    CHECK(DispatchMetaCommand("group list", handlers, result));
+    CHECK(DispatchMetaCommand("win freeze process app.exe", handlers, result));
+    CHECK_EQ(created, 0);
+
+    CHECK(DispatchMetaCommand("schedule in 5m setsysvolume 0", handlers, result));
+    CHECK(result.success);
+    CHECK_EQ(created, 1);
+    CHECK_EQ(scheduler.GetTaskCount(), size_t(1));
+}
+
+TEST_CASE(MissingHandlersFail) {
+    AppGroupsManager groups;
+    MetaCommandHandlers handlers;
+    handlers.appGroups = &groups;
+
+    const char* commands[] = { "win freeze process app.exe", "win unfreeze process app.exe", "group run Games min",
+                               "schedule list" };
+    for (const char* command : commands) {
+        ExecutionResult result;
+        CHECK(DispatchMetaCommand(command, handlers, result));
+        CHECK(!result.success);
+        CHECK(result.output.find("not available here") != std::string::npos);
+    }
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
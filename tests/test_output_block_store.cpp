@@ -0,0 +1,70 @@
+#include "test_support.h"
+#include "core/output_block_store.h"
+
+using namespace NirUI;
+
+namespace {
+
+std::string MakeOutput(uint64_t id, size_t lines) {
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += "command " + std::to_string(id) + " line " + std::to_string(i) + ": exit code 0, 12.5 ms\n";
+    }
+    return text;
+}
+
+} // namespace
+
+TEST_CASE(ReadsBackEveryBlock) {
+    OutputBlockStore store;
+    for (uint64_t id = 1; id <= 100; ++id) store.Put(id, MakeOutput(id, id % 7 == 0 ? 0 : id));
+    store.Put(101, "short");
+
+    // Empty outputs are not stored
+    CHECK_EQ(store.GetCount(), size_t(100 - 100 / 7 + 1));
+    std::string output;
+    for (uint64_t id = 1; id <= 100; ++id) {
+        if (id % 7 == 0) {
+            CHECK(!store.Contains(id));
+            CHECK(!store.Get(id, output));
+            continue;
+        }
+        CHECK(store.Get(id, output));
+        CHECK(output == MakeOutput(id, id));
+    }
+    CHECK(store.Get(101, output));
+    CHECK_EQ(output, std::string("short"));
+    CHECK(!store.Get(102, output));
+    CHECK(store.GetStoredBytes() < store.GetRawBytes() / 2);
+}
+
+TEST_CASE(EvictsOldestOverBudget) {
+    OutputBlockStore store(64 * 1024);
+    for (uint64_t id = 1; id <= 2000; ++id) {
+        store.Put(id, MakeOutput(id, 40));
+        CHECK(store.GetStoredBytes() <= store.GetBudget());
+    }
+    CHECK(store.GetCount() < 2000);
+    CHECK(store.Contains(2000));
+    CHECK(!store.Contains(1));
+
+    // What is left is a contiguous run of the newest ids
+    uint64_t first = 2000 - store.GetCount() + 1;
+    CHECK(!store.Contains(first - 1));
+    std::string output;
+    for (uint64_t id = first; id <= 2000; ++id) {
+        CHECK(store.Get(id, output));
+        CHECK(output == MakeOutput(id, 40));
+    }
+
+    store.SetBudget(8 * 1024);
+    CHECK(store.GetStoredBytes() <= 8 * 1024);
+    CHECK(store.Contains(2000));
+
+    store.Clear();
+    CHECK_EQ(store.GetCount(), size_t(0));
+    CHECK_EQ(store.GetStoredBytes(), size_t(0));
+    CHECK_EQ(store.GetRawBytes(), size_t(0));
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,95 @@
+#include "test_support.h"
+#include "utils/output_buffer.h"
+
+using namespace NirUI;
+
+namespace {
+
+std::vector<std::string> Lines(const OutputBuffer& buffer) {
+    std::vector<std::string> lines;
+    buffer.VisitLines(0, buffer.GetLineCount(),
+                      [&](size_t, std::string_view text, OutputLineKind) { lines.emplace_back(text); });
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE(PartialAppendsJoinLines) {
+    OutputBuffer buffer;
+    buffer.Append("first ");
+    buffer.Append("line\r\nsecond");
+    buffer.Append(" line\n");
+    buffer.AppendLine("");
+    buffer.AppendLine("error", OutputLineKind::Error);
+    CHECK_EQ(Lines(buffer), (std::vector<std::string>{"first line", "second line", "", "error"}));
+    CHECK_EQ(buffer.GetText(), std::string("first line\nsecond line\n\nerror\n"));
+    CHECK_EQ(buffer.Search("LINE"), (std::vector<size_t>{0, 1}));
+    CHECK(buffer.Search("LINE", true).empty());
+}
+
+TEST_CASE(OldLinesAreEvicted) {
+    OutputBuffer buffer(OutputBuffer::CHUNK_SIZE * 2);
+    std::string line(99, 'x');
+    for (int i = 0; i < 10000; ++i) {
+        buffer.AppendLine(std::to_string(i) + line);
+        CHECK(buffer.GetByteCount() <= buffer.GetMaxBytes());
+    }
+    std::vector<std::string> lines = Lines(buffer);
+    CHECK(lines.size() < 10000);
+    CHECK(lines.size() > 1000);
+    CHECK_EQ(lines.back(), "9999" + line);
+    // What is left is the newest lines, in order
+    size_t first = std::stoul(lines.front());
+    for (size_t i = 0; i < lines.size(); ++i) CHECK_EQ(lines[i], std::to_string(first + i) + line);
+
+    buffer.SetMaxBytes(OutputBuffer::CHUNK_SIZE);
+    CHECK(buffer.GetByteCount() <= OutputBuffer::CHUNK_SIZE);
+    lines = Lines(buffer);
+    CHECK_EQ(lines.back(), "9999" + line);
+
+    buffer.Clear();
+    CHECK_EQ(buffer.GetLineCount(), size_t(0));
+    CHECK_EQ(buffer.GetByteCount(), size_t(0));
+}
+
+TEST_CASE(LongLineStaysUnderCap) {
+    // 8 MB without a newline, streamed in 1 KB reads, under a 64 KB cap
+    OutputBuffer buffer(64 * 1024);
+    std::string piece(1024, 'a');
+    Test::Stopwatch stopwatch;
+    for (int i = 0; i < 8 * 1024; ++i) {
+        piece[0] = static_cast<char>('a' + i % 26);
+        buffer.Append(piece);
+        CHECK(buffer.GetByteCount() <= buffer.GetMaxBytes());
+    }
+    double ms = stopwatch.GetElapsedMs();
+    printf("  8 MB line in 1 KB appends: %.1f ms, %zu bytes held\n", ms, buffer.GetByteCount());
+    CHECK(ms < 2000);
+
+    // Wrapped at half the budget; the newest text is kept
+    std::vector<std::string> lines = Lines(buffer);
+    CHECK(!lines.empty());
+    for (const auto& line : lines) CHECK(line.size() <= 32 * 1024);
+    CHECK_EQ(lines.back().size(), size_t(32 * 1024));
+    CHECK_EQ(lines.back().front(), static_cast<char>('a' + (8 * 1024 - 32) % 26));
+
+    buffer.AppendLine("after");
+    lines = Lines(buffer);
+    CHECK_EQ(lines.back(), std::string("after"));
+}
+
+TEST_CASE(LongLineIsSplitNotLost) {
+    OutputBuffer buffer(1024 * 1024);
+    std::string text;
+    for (int i = 0; i < 1200 * 1024; ++i) text += static_cast<char>('a' + i % 26);
+    buffer.Append(text.substr(0, 100));
+    buffer.Append(std::string_view(text).substr(100, 600 * 1024));
+    CHECK(buffer.GetByteCount() <= buffer.GetMaxBytes());
+
+    std::vector<std::string> lines = Lines(buffer);
+    CHECK_EQ(lines.size(), size_t(2));
+    CHECK_EQ(lines[0].size(), size_t(512 * 1024));
+    CHECK_EQ(lines[0] + lines[1], text.substr(0, 100 + 600 * 1024));
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,73 @@
+#include "test_support.h"
+#include "core/param_validator.h"
+
+using namespace NirUI;
+
+namespace {
+
+bool IsValid(std::string_view line) {
+    std::string error;
+    bool valid = ParamValidators::Validate(line, error);
+    if (!valid) printf("  %.*s: %s\n", static_cast<int>(line.size()), line.data(), error.c_str());
+    return valid;
+}
+
+} // namespace
+
+// Finders that name no window take no find_value argument
+TEST_CASE(AcceptsValuelessFinders) {
+    CHECK(IsValid("win close active"));
+    CHECK(IsValid("win min alltop"));
+    CHECK(IsValid("win activate foreground"));
+    CHECK(IsValid("win trans active 128"));
+    CHECK(IsValid("win trans title Calculator 128"));
+}
+
+TEST_CASE(ChecksArgumentsAfterValuelessFinders) {
+    CHECK(!IsValid("win trans active 300"));
+    CHECK(!IsValid("win trans active"));
+    CHECK(!IsValid("win trans title Calculator"));
+    CHECK(!IsValid("win close title"));
+    CHECK(!IsValid("win settopmost active 2"));
+    CHECK(IsValid("win settopmost active 1"));
+}
+
+TEST_CASE(PassesFindTypesOutsideTheList) {
+    CHECK(IsValid("win close stitle Notepad"));
+    CHECK(IsValid("win close etitle \" - Notepad\""));
+    CHECK(IsValid("win hide somefuturefinder value"));
+}
+
+TEST_CASE(EnforcesOnlyExhaustiveChoices) {
+    CHECK(IsValid("mutesysvolume 2"));
+    CHECK(!IsValid("mutesysvolume 3"));
+    CHECK(IsValid("setprocesspriority notepad.exe HIGH"));
+    CHECK(!IsValid("setprocesspriority notepad.exe urgent"));
+    CHECK(IsValid("setsysvolume 100 headphones"));
+    CHECK(!IsValid("setsysvolume 70000"));
+}
+
+TEST_CASE(DeduplicatesChoicesIgnoringCase) {
+    Command command("toggle", "", "", {
+        Parameter("state", "", ParamType::Choice, true, "on", { "On", "on", "ON", "off", "OFF" }).Exhaustive()
+    }, "Test");
+    CommandValidator validator(command);
+
+    std::string error;
+    CommandTokens on("toggle oN");
+    CHECK(validator.Validate(on, 1, error));
+    CommandTokens off("toggle Off");
+    CHECK(validator.Validate(off, 1, error));
+    CommandTokens other("toggle onn");
+    CHECK(!validator.Validate(other, 1, error));
+    CHECK(error.find("state must be one of") != std::string::npos);
+}
+
+TEST_CASE(PassesCommandsOutsideTheRegistry) {
+    CHECK(IsValid("notacommand 1 2 3"));
+    CHECK(IsValid(""));
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,131 @@
+#include "test_support.h"
+#include "cli/repl_shell.h"
+#include <iostream>
+#include <sstream>
+
+using namespace NirUI;
+
+namespace {
+
+// Records nircmd lines instead of running them
+class FakeBackend : public ReplBackend {
+public:
+    std::mutex& GetMutex() override { return m_mutex; }
+    void Prepare() override { prepareCalls++; }
+    MetaCommandHandlers GetMetaCommandHandlers() override {
+        MetaCommandHandlers handlers;
+        handlers.appGroups = &groups;
+        handlers.runGroup = [](const std::string& group, const std::string& action) {
+            return "ran " + action + " on " + group;
+        };
+        return handlers;
+    }
+    void RunOptions(const std::string& line) override { options.push_back(line); }
+    bool IsNirCmdAvailable() override { return available; }
+    ExecutionResult ExecuteNirCmd(const std::string& line) override {
+        commands.push_back(line);
+        ExecutionResult result;
+        result.exitCode = line == "fail" ? 1 : 0;
+        result.success = result.exitCode == 0;
+        result.executionTimeMs = 0;
+        return result;
+    }
+
+    AppGroupsManager groups;
+    std::vector<std::string> commands;
+    std::vector<std::string> options;
+    int prepareCalls = 0;
+    bool available = true;
+
+private:
+    std::mutex m_mutex;
+};
+
+size_t CountLatencyLines(const std::string& text) {
+    size_t count = 0;
+    for (size_t pos = text.find(" ms]\n"); pos != std::string::npos; pos = text.find(" ms]\n", pos + 1)) count++;
+    return count;
+}
+
+} // namespace
+
+TEST_CASE(PipedStdinRunsEveryLine) {
+    std::istringstream input(
+        "setsysvolume 100\n"
+        "\n"
+        "  group create Tools  \r\n"
+        "win trans active 300\n"
+        "--search mute\n"
+        "fail\n"
+        "exit\n"
+        "setsysvolume 5\n");
+    std::streambuf* original = std::cin.rdbuf(input.rdbuf());
+
+    FakeBackend backend;
+    std::ostringstream out;
+    std::ostringstream err;
+    ReplShell shell(backend, out, err);
+    StreamLineReader reader(std::cin);
+    shell.Run(reader);
+    std::cin.rdbuf(original);
+
+    // Nothing after exit runs, and no prompts are printed for piped input
+    CHECK_EQ(backend.commands, (std::vector<std::string>{"setsysvolume 100", "fail"}));
+    CHECK_EQ(backend.options, (std::vector<std::string>{"--search mute"}));
+    CHECK(backend.groups.FindGroup("Tools") != nullptr);
+    CHECK_EQ(backend.prepareCalls, 5);
+    CHECK_EQ(CountLatencyLines(out.str()), size_t(5));
+    CHECK(out.str().find("nirui>") == std::string::npos);
+    CHECK(err.str().find("Error: ") != std::string::npos);
+    CHECK(err.str().find("Command failed (exit code 1)") != std::string::npos);
+}
+
+TEST_CASE(EndOfInputEndsTheShell) {
+    std::istringstream input("setsysvolume 1\nsetsysvolume 2");
+    FakeBackend backend;
+    std::ostringstream out;
+    std::ostringstream err;
+    ReplShell shell(backend, out, err);
+    StreamLineReader reader(input, &out);
+    shell.Run(reader);
+    CHECK_EQ(backend.commands, (std::vector<std::string>{"setsysvolume 1", "setsysvolume 2"}));
+    CHECK_EQ(out.str().substr(0, 7), std::string("nirui> "));
+}
+
+TEST_CASE(MissingNirCmdIsReported) {
+    FakeBackend backend;
+    backend.available = false;
+    std::ostringstream out;
+    std::ostringstream err;
+    ReplShell shell(backend, out, err);
+    CHECK(shell.Execute("setsysvolume 100"));
+    CHECK(backend.commands.empty());
+    CHECK(err.str().find("NirCmd not found") != std::string::npos);
+    CHECK(!shell.Execute(" quit "));
+}
+
+TEST_CASE(CompletesCommandsAndGroups) {
+    FakeBackend backend;
+    std::ostringstream out;
+    std::ostringstream err;
+    ReplShell shell(backend, out, err);
+
+    std::vector<std::string> matches;
+    CHECK_EQ(shell.CompleteLine("--list-c", matches), std::string("--list-categories "));
+    CHECK_EQ(shell.CompleteLine("group run \"Coding Tools\" unf", matches),
+             std::string("group run \"Coding Tools\" unfreeze "));
+
+    CHECK(shell.Execute("group create Win"));
+    CHECK(shell.Execute("group create window"));
+    CHECK(shell.Execute("group create \"Coding Tools\""));
+    CHECK_EQ(shell.Complete("group run "), (std::vector<std::string>{"\"Coding Tools\"", "Win", "window"}));
+    CHECK_EQ(shell.Complete("group run \"cod"), (std::vector<std::string>{"\"Coding Tools\""}));
+
+    // Matching ignores case, so the common prefix must too
+    CHECK_EQ(shell.CompleteLine("group run w", matches), std::string("group run win"));
+    CHECK_EQ(matches, (std::vector<std::string>{"Win", "window"}));
+    CHECK_EQ(shell.CompleteLine("group run win", matches), std::string("group run win"));
+    CHECK_EQ(matches.size(), size_t(2));
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,208 @@
+#include "test_support.h"
+#include "core/cost_model.h"
+#include "core/script_runner.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace NirUI;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Stand-in for nircmd: "sleep N" takes N ms, "fail" exits with 1, and every
+// run is logged with its start and end so ordering can be checked afterwards
+class FakeNirCmd {
+public:
+    struct Run {
+        std::string command;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    ExecutionResult Execute(const std::string& command) {
+        Run run{ command, Clock::now(), {} };
+        int active = ++m_active;
+        int peak = m_peak.load();
+        while (active > peak && !m_peak.compare_exchange_weak(peak, active)) {}
+
+        if (command.rfind("sleep ", 0) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::stoi(command.substr(6))));
+        }
+        m_active--;
+        run.end = Clock::now();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runs.push_back(run);
+        bool success = command != "fail";
+        return { success ? 0 : 1, "ran " + command, success ? "" : "failed", success, 0.0 };
+    }
+
+    ScriptSummary RunScript(const ScriptRunner& runner, size_t jobs, std::vector<std::string>& reported,
+                            const CostModel* costs = nullptr) {
+        return runner.Run(
+            jobs, [this](const std::string& command) { return Execute(command); },
+            [this](const std::string& command, ExecutionResult& result) {
+                if (command.rfind("group ", 0) != 0) return false;
+                result = Execute(command);
+                return true;
+            },
+            [&reported](const ScriptLine& line, const ExecutionResult& result) {
+                reported.push_back(std::to_string(line.lineNumber) + ":" + result.output);
+            },
+            costs);
+    }
+
+    const Run* Find(const std::string& command) const {
+        for (const auto& run : m_runs) {
+            if (run.command == command) return &run;
+        }
+        return nullptr;
+    }
+
+    const std::vector<Run>& GetRuns() const { return m_runs; }
+    int GetPeak() const { return m_peak.load(); }
+
+private:
+    std::mutex m_mutex;
+    std::vector<Run> m_runs;
+    std::atomic<int> m_active{ 0 };
+    std::atomic<int> m_peak{ 0 };
+};
+
+} // namespace
+
+TEST_CASE(ParsesLinesAndBarriers) {
+    ScriptRunner runner;
+    runner.LoadText("\xEF\xBB\xBF# comment\r\n"
+                    "setsysvolume 100\r\n"
+                    "\n"
+                    "   \t\n"
+                    "! mutesysvolume 1\n"
+                    "!\n"
+                    "group create Work\n"
+                    "  win close active  ");
+
+    const auto& lines = runner.GetLines();
+    CHECK_EQ(lines.size(), size_t(5));
+    if (lines.size() != 5) return;
+    CHECK(lines[0].lineNumber == 2 && lines[0].command == "setsysvolume 100" && !lines[0].barrier);
+    CHECK(lines[1].lineNumber == 5 && lines[1].command == "mutesysvolume 1" && lines[1].barrier);
+    CHECK(lines[2].lineNumber == 6 && lines[2].command.empty() && lines[2].barrier);
+    // Meta-commands change state later lines may depend on
+    CHECK(lines[3].command == "group create Work" && lines[3].barrier);
+    CHECK(lines[4].lineNumber == 8 && lines[4].command == "win close active" && !lines[4].barrier);
+
+    runner.LoadText("a\n\nb\n", { 10, 11, 12 });
+    CHECK(runner.GetLines().size() == 2 && runner.GetLines()[1].lineNumber == 12);
+}
+
+TEST_CASE(LoadsFromAFile) {
+    Test::TempDirectory directory;
+    std::filesystem::path path = directory.GetPath() / "script.txt";
+    std::ofstream(path, std::ios::binary) << "setsysvolume 100\nmonitor off\n";
+
+    ScriptRunner runner;
+    std::string error;
+    CHECK(runner.Load(path, error));
+    CHECK_EQ(runner.GetLines().size(), size_t(2));
+    CHECK(!runner.Load(directory.GetPath() / "missing.txt", error));
+    CHECK(!error.empty() && runner.GetLines().empty());
+}
+
+TEST_CASE(ValidatesBeforeRunning) {
+    ScriptRunner runner;
+    runner.LoadText("setsysvolume 100\n"
+                    "mutesysvolume 3\n"
+                    "# fine\n"
+                    "notacommand 1\n"
+                    "win close active\n"
+                    "group create Work\n"
+                    "schedule in 5m monitor off\n");
+
+    std::vector<std::string> problems = runner.Validate();
+    CHECK_EQ(problems.size(), size_t(2));
+    CHECK(problems.size() == 2 && problems[0].rfind("line 2: ", 0) == 0);
+    CHECK(problems.size() == 2 && problems[1] == "line 4: unknown command 'notacommand'");
+}
+
+TEST_CASE(BarriersOrderTheLinesAroundThem) {
+    ScriptRunner runner;
+    runner.LoadText("sleep 30\nsleep 10\nsleep 20\nsleep 5\n"
+                    "! sleep 1\n"
+                    "sleep 15\nfail\nsleep 25\n"
+                    "group create Work\n"
+                    "sleep 2\n");
+
+    FakeNirCmd nircmd;
+    std::vector<std::string> reported;
+    ScriptSummary summary = nircmd.RunScript(runner, 4, reported);
+
+    CHECK_EQ(summary.commands, size_t(10));
+    CHECK_EQ(summary.failed, size_t(1));
+    CHECK_EQ(summary.latenciesMs.size(), size_t(10));
+    CHECK(nircmd.GetPeak() > 1 && nircmd.GetPeak() <= 4);
+
+    // Reported in line order, whatever order they finished in
+    std::vector<std::string> expected = { "1:ran sleep 30", "2:ran sleep 10", "3:ran sleep 20", "4:ran sleep 5",
+                                          "5:ran sleep 1", "6:ran sleep 15", "7:ran fail", "8:ran sleep 25",
+                                          "9:ran group create Work", "10:ran sleep 2" };
+    CHECK_EQ(reported, expected);
+
+    const auto* barrier = nircmd.Find("sleep 1");
+    const auto* group = nircmd.Find("group create Work");
+    CHECK(barrier && group);
+    if (!barrier || !group) return;
+    for (const char* before : { "sleep 30", "sleep 10", "sleep 20", "sleep 5" }) {
+        CHECK(nircmd.Find(before)->end <= barrier->start);
+    }
+    for (const char* between : { "sleep 15", "fail", "sleep 25" }) {
+        CHECK(nircmd.Find(between)->start >= barrier->end);
+        CHECK(nircmd.Find(between)->end <= group->start);
+    }
+    CHECK(nircmd.Find("sleep 2")->start >= group->end);
+}
+
+TEST_CASE(StartsTheSlowestLinesFirst) {
+    CostModel costs;
+    costs.Record(CostBackend::NirCmd, "monitor", 500);
+    costs.Record(CostBackend::NirCmd, "beep", 1);
+    costs.Record(CostBackend::NirCmd, "setsysvolume", 50);
+
+    ScriptRunner runner;
+    runner.LoadText("beep 1\nsetsysvolume 1\nmonitor off\nbeep 2\n");
+
+    FakeNirCmd nircmd;
+    std::vector<std::string> reported;
+    nircmd.RunScript(runner, 1, reported, &costs);
+
+    std::vector<std::string> started;
+    for (const auto& run : nircmd.GetRuns()) started.push_back(run.command);
+    CHECK_EQ(started, (std::vector<std::string>{ "monitor off", "setsysvolume 1", "beep 1", "beep 2" }));
+    CHECK_EQ(reported.front(), std::string("1:ran beep 1"));
+}
+
+TEST_CASE(ThroughputOfTenThousandLines) {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += i % 1000 == 999 ? "! setsysvolume 1\n" : "setsysvolume " + std::to_string(i) + "\n";
+    }
+    ScriptRunner runner;
+    runner.LoadText(std::move(text));
+    CHECK(runner.Validate().empty());
+
+    FakeNirCmd nircmd;
+    std::vector<std::string> reported;
+    ScriptSummary summary = nircmd.RunScript(runner, 8, reported);
+    printf("  %zu lines in %.1f ms, %.0f lines/s of runner overhead\n", summary.commands, summary.wallTimeMs,
+           summary.commands / (summary.wallTimeMs / 1000));
+    CHECK_EQ(summary.commands, size_t(10000));
+    CHECK(reported.size() == 10000 && reported[9998] == "9999:ran setsysvolume 9998");
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
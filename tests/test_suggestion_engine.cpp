@@ -0,0 +1,174 @@
+#include "test_support.h"
+#include "core/suggestion_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace NirUI;
+
+namespace {
+
+constexpr int64_t NOW = 1700000000;
+constexpr int64_t DAY = 86400;
+const std::string KEY = "window_process";
+
+std::vector<std::string> Values(const std::vector<Suggestion>& suggestions) {
+    std::vector<std::string> values;
+    for (const auto& suggestion : suggestions) values.push_back(suggestion.value);
+    return values;
+}
+
+bool Near(double a, double b) {
+    return std::fabs(a - b) < 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+} // namespace
+
+TEST_CASE(RanksByUseCount) {
+    SuggestionEngine engine;
+    for (int i = 0; i < 3; ++i) engine.Record(KEY, "chrome.exe", NOW);
+    engine.Record(KEY, "code.exe", NOW);
+    for (int i = 0; i < 2; ++i) engine.Record(KEY, "spotify.exe", NOW);
+
+    std::vector<Suggestion> results = engine.Lookup(KEY, "", 10, NOW);
+    CHECK_EQ(Values(results), (std::vector<std::string>{"chrome.exe", "spotify.exe", "code.exe"}));
+    CHECK(Near(results[0].score, 3.0));
+    CHECK(Near(results[2].score, 1.0));
+    CHECK_EQ(results[0].sources, static_cast<uint8_t>(SuggestionSource::Recent));
+    CHECK_EQ(engine.GetValueCount(KEY), size_t(3));
+    CHECK(!engine.HasValues("other_key"));
+}
+
+TEST_CASE(RecentUseOutranksOldUse) {
+    SuggestionEngine engine;
+    // Four uses four weeks ago weigh 4 / 16 of what they did
+    for (int i = 0; i < 4; ++i) engine.Record(KEY, "old.exe", NOW - 28 * DAY);
+    engine.Record(KEY, "new.exe", NOW);
+
+    std::vector<Suggestion> results = engine.Lookup(KEY, "", 10, NOW);
+    CHECK_EQ(Values(results), (std::vector<std::string>{"new.exe", "old.exe"}));
+    CHECK(Near(results[1].score, 0.25));
+
+    // The ranking holds as time passes; only the scores shrink
+    results = engine.Lookup(KEY, "", 10, NOW + 7 * DAY);
+    CHECK_EQ(Values(results), (std::vector<std::string>{"new.exe", "old.exe"}));
+    CHECK(Near(results[0].score, 0.5));
+}
+
+TEST_CASE(WeighsSources) {
+    SuggestionEngine engine;
+    engine.Record(KEY, "history.exe", NOW, SuggestionSource::History);
+    engine.SetLiveValues(KEY, {"live.exe", "both.exe"}, NOW);
+    engine.Record(KEY, "both.exe", NOW);
+
+    std::vector<Suggestion> results = engine.Lookup(KEY, "", 10, NOW);
+    CHECK_EQ(Values(results), (std::vector<std::string>{"both.exe", "history.exe", "live.exe"}));
+    CHECK(Near(results[0].score, 1.25));
+    CHECK(Near(results[1].score, SuggestionEngine::HISTORY_WEIGHT));
+    CHECK(Near(results[2].score, SuggestionEngine::LIVE_WEIGHT));
+    CHECK_EQ(results[0].sources,
+             static_cast<uint8_t>(static_cast<uint8_t>(SuggestionSource::Recent) | static_cast<uint8_t>(SuggestionSource::Live)));
+
+    // A refresh drops live values that are gone but keeps what else they scored
+    engine.SetLiveValues(KEY, {"new.exe"}, NOW);
+    results = engine.Lookup(KEY, "", 10, NOW);
+    CHECK_EQ(Values(results), (std::vector<std::string>{"both.exe", "history.exe", "new.exe"}));
+    CHECK(Near(results[0].score, 1.0));
+}
+
+TEST_CASE(FiltersByPrefixWithoutCase) {
+    SuggestionEngine engine;
+    engine.Record(KEY, "Chrome.exe", NOW);
+    engine.Record(KEY, "chrome_helper.exe", NOW);
+    engine.Record(KEY, "chrome_helper.exe", NOW);
+    engine.Record(KEY, "code.exe", NOW);
+    engine.Record(KEY, "Calculator.exe", NOW);
+
+    CHECK_EQ(Values(engine.Lookup(KEY, "CH", 10, NOW)), (std::vector<std::string>{"chrome_helper.exe", "Chrome.exe"}));
+    CHECK_EQ(Values(engine.Lookup(KEY, "chrome.", 10, NOW)), (std::vector<std::string>{"Chrome.exe"}));
+    CHECK_EQ(Values(engine.Lookup(KEY, "c", 2, NOW)).size(), size_t(2));
+    CHECK_EQ(engine.Lookup(KEY, "c", 10, NOW).size(), size_t(4));
+    CHECK(engine.Lookup(KEY, "chromium", 10, NOW).empty());
+    CHECK(engine.Lookup(KEY, "x", 10, NOW).empty());
+    CHECK(engine.Lookup(KEY, "", 0, NOW).empty());
+
+    CHECK(engine.Remove(KEY, "Chrome.exe"));
+    CHECK(!engine.Remove(KEY, "Chrome.exe"));
+    CHECK_EQ(Values(engine.Lookup(KEY, "ch", 10, NOW)), (std::vector<std::string>{"chrome_helper.exe"}));
+}
+
+TEST_CASE(ManyMatchesRankLikeFewMatches) {
+    // Above a few hundred matches the lookup walks the ranked set instead of
+    // sorting; both must give the same order
+    SuggestionEngine engine;
+    std::mt19937 random(5);
+    for (int i = 0; i < 2000; ++i) {
+        std::string value = (i % 2 ? "app" : "App") + std::to_string(i) + ".exe";
+        int uses = 1 + static_cast<int>(random() % 50);
+        for (int use = 0; use < uses; ++use) engine.Record(KEY, value, NOW - static_cast<int64_t>(i));
+    }
+    engine.Record("other", "apple.exe", NOW);
+
+    std::vector<Suggestion> results = engine.Lookup(KEY, "aPP", 50, NOW);
+    CHECK_EQ(results.size(), size_t(50));
+    for (size_t i = 1; i < results.size(); ++i) CHECK(results[i - 1].score >= results[i].score);
+
+    std::vector<Suggestion> all = engine.Lookup(KEY, "", 2000, NOW);
+    CHECK_EQ(all.size(), size_t(2000));
+    for (size_t i = 0; i < results.size(); ++i) CHECK_EQ(results[i].value, all[i].value);
+
+    // A narrow prefix takes the sorting path and agrees with the full ranking
+    std::vector<Suggestion> narrow = engine.Lookup(KEY, "app19", 2000, NOW);
+    std::vector<std::string> filtered;
+    for (const auto& suggestion : all) {
+        if (suggestion.value.compare(0, 5, "app19") == 0 || suggestion.value.compare(0, 5, "App19") == 0) {
+            filtered.push_back(suggestion.value);
+        }
+    }
+    CHECK_EQ(filtered.size(), size_t(111));
+    CHECK_EQ(Values(narrow), filtered);
+}
+
+TEST_CASE(ExportsAndRestoresUserValues) {
+    SuggestionEngine engine;
+    engine.Record(KEY, "chrome.exe", NOW - DAY);
+    engine.Record(KEY, "chrome.exe", NOW);
+    engine.Record(KEY, "history.exe", NOW, SuggestionSource::History);
+    engine.SetLiveValues(KEY, {"live.exe"}, NOW);
+
+    std::vector<StoredSuggestion> stored = engine.Export();
+    CHECK_EQ(stored.size(), size_t(1));
+    CHECK_EQ(stored[0].value, std::string("chrome.exe"));
+    CHECK_EQ(stored[0].useCount, uint32_t(2));
+    CHECK_EQ(stored[0].lastUsed, NOW);
+
+    SuggestionEngine restored;
+    for (const auto& suggestion : stored) restored.Restore(suggestion);
+    std::vector<Suggestion> before = engine.Lookup(KEY, "chrome", 1, NOW);
+    std::vector<Suggestion> after = restored.Lookup(KEY, "chrome", 1, NOW);
+    CHECK_EQ(after.size(), size_t(1));
+    CHECK(Near(after[0].score, before[0].score));
+}
+
+TEST_CASE(TrieCountsPrefixes) {
+    PrefixTrie trie;
+    CHECK(trie.Insert("chrome", 1));
+    CHECK(trie.Insert("chrome_helper", 2));
+    CHECK(trie.Insert("code", 3));
+    CHECK(!trie.Insert("code", 4));
+    CHECK_EQ(trie.CountUnder(trie.FindPrefix("")), uint32_t(3));
+    CHECK_EQ(trie.CountUnder(trie.FindPrefix("ch")), uint32_t(2));
+    CHECK_EQ(trie.CountUnder(trie.FindPrefix("chrome_")), uint32_t(1));
+    CHECK_EQ(trie.FindPrefix("cx"), PrefixTrie::NONE);
+
+    std::vector<uint32_t> ids;
+    trie.ForEachUnder(trie.FindPrefix("c"), [&ids](uint32_t id) { ids.push_back(id); });
+    std::sort(ids.begin(), ids.end());
+    CHECK_EQ(ids, (std::vector<uint32_t>{1, 2, 4}));
+
+    CHECK(trie.Erase("chrome"));
+    CHECK(!trie.Erase("chrome"));
+    CHECK_EQ(trie.CountUnder(trie.FindPrefix("ch")), uint32_t(1));
+}
+
+int main() { return NirUI::Test::RunAll(); }
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal test harness: TEST_CASE registers a function, CHECK and CHECK_EQ
+// report failures without stopping the case, and RunAll() runs every case and
+// returns the exit code for ctest.
+namespace NirUI::Test {
+
+struct TestCase {
+    const char* name;
+    void (*function)();
+};
+
+inline std::vector<TestCase>& GetTestCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& GetFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*function)()) { GetTestCases().push_back({ name, function }); }
+};
+
+inline void ReportFailure(const char* file, int line, const std::string& message) {
+    fprintf(stderr, "%s:%d: FAILED: %s\n", file, line, message.c_str());
+    GetFailureCount()++;
+}
+
+template <typename T>
+std::string Describe(const T& value) {
+    std::ostringstream stream;
+    if constexpr (requires { stream << value; }) {
+        stream << value;
+    } else if constexpr (requires { value.begin(); value.end(); }) {
+        stream << '{';
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            stream << (it == value.begin() ? "" : ", ") << '[' << Describe(*it) << ']';
+        }
+        stream << '}';
+    } else {
+        stream << "<value>";
+    }
+    return stream.str();
+}
+
+inline int RunAll() {
+    for (const auto& test : GetTestCases()) {
+        int before = GetFailureCount();
+        auto start = std::chrono::steady_clock::now();
+        test.function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        printf("[%s] %s (%.1f ms)\n", GetFailureCount() == before ? "pass" : "FAIL", test.name, ms);
+    }
+    printf("%zu cases, %d failed checks\n", GetTestCases().size(), GetFailureCount());
+    return GetFailureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Wall time of the scope in nanoseconds, for the benchmarks
+class Stopwatch {
+public:
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+    double GetElapsedNs() const {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+    }
+    double GetElapsedMs() const { return GetElapsedNs() / 1e6; }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Fresh directory under the system temp directory, removed with its contents
+class TempDirectory {
+public:
+    TempDirectory() {
+        std::random_device random;
+        auto base = std::filesystem::temp_directory_path();
+        do {
+            m_path = base / ("nirui-test-" + std::to_string(random()));
+        } while (!std::filesystem::create_directory(m_path));
+    }
+    ~TempDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_path, ec);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    const std::filesystem::path& GetPath() const { return m_path; }
+
+private:
+    std::filesystem::path m_path;
+};
+
+// Keeps the optimizer from dropping a benchmark's work: the compiler has to
+// assume the value, and anything reachable from it, is read here
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+    (void)sink;
+#endif
+}
+
+} // namespace NirUI::Test
+
+#define TEST_CASE(name)                                                   \
+    static void name();                                                   \
+    static ::NirUI::Test::Registrar name##_registrar(#name, name);        \
+    static void name()
+
+#define CHECK(expr)                                                       \
+    do {                                                                  \
+        if (!(expr)) ::NirUI::Test::ReportFailure(__FILE__, __LINE__, #expr); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                        \
+    do {                                                                  \
+        const auto& checkActual = (actual);                               \
+        const auto& checkExpected = (expected);                           \
+        if (!(checkActual == checkExpected)) {                            \
+            ::NirUI::Test::ReportFailure(__FILE__, __LINE__,              \
+                std::string(#actual " == " #expected " (got ") +          \
+                ::NirUI::Test::Describe(checkActual) + ", expected " +    \
+                ::NirUI::Test::Describe(checkExpected) + ")");            \
+        }                                                                 \
+    } while (0)
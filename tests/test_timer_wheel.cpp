@@ -0,0 +1,108 @@
+#include "test_support.h"
+#include "utils/timer_wheel.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace NirUI;
+
+TEST_CASE(FiresInTickOrder) {
+    TimerWheel wheel;
+    wheel.Add(5000, 3);
+    wheel.Add(10, 1);
+    wheel.Add(70, 2);
+    wheel.Add(uint64_t(1) << 40, 4);
+
+    std::vector<TimerWheel::Expired> expired;
+    wheel.Advance(5000, expired);
+    CHECK_EQ(expired.size(), size_t(3));
+    for (size_t i = 0; i < expired.size(); ++i) CHECK_EQ(expired[i].payload, uint64_t(i + 1));
+
+    CHECK_EQ(wheel.GetCount(), size_t(1));
+    expired.clear();
+    wheel.Advance(uint64_t(1) << 40, expired);
+    CHECK(expired.size() == 1 && expired[0].payload == 4 && expired[0].tick == (uint64_t(1) << 40));
+    CHECK_EQ(wheel.GetNextTick(), TimerWheel::NEVER);
+}
+
+TEST_CASE(CancelledTimersNeverFire) {
+    TimerWheel wheel;
+    TimerWheel::TimerId id = wheel.Add(100, 1);
+    CHECK(wheel.Cancel(id));
+    CHECK(!wheel.Cancel(id));
+
+    // The node is reused; the old id must not cancel the new timer
+    TimerWheel::TimerId reused = wheel.Add(100, 2);
+    CHECK(!wheel.Cancel(id));
+    std::vector<TimerWheel::Expired> expired;
+    wheel.Advance(1000, expired);
+    CHECK(expired.size() == 1 && expired[0].id == reused && expired[0].payload == 2);
+}
+
+// Random adds, cancels and advances across every level and the overflow list,
+// checked against a multimap
+TEST_CASE(MatchesReferenceUnderRandomOperations) {
+    std::mt19937_64 random(45);
+    const uint64_t spans[] = { 4, 64, 4096, 262144, 16777216, uint64_t(1) << 32, uint64_t(1) << 40 };
+
+    for (int round = 0; round < 100; ++round) {
+        uint64_t start = random() % 100000;
+        TimerWheel wheel(start);
+        std::map<TimerWheel::TimerId, uint64_t> live;
+        std::vector<TimerWheel::TimerId> ids;
+        uint64_t now = start;
+
+        for (int op = 0; op < 3000; ++op) {
+            int kind = static_cast<int>(random() % 10);
+            if (kind < 5) {
+                uint64_t span = spans[random() % std::size(spans)];
+                // Some timers land in the past and must fire on the next advance
+                uint64_t tick = now + random() % span - (random() % 8 == 0 ? std::min<uint64_t>(now, 3) : 0);
+                TimerWheel::TimerId id = wheel.Add(tick, op);
+                live[id] = tick;
+                ids.push_back(id);
+            } else if (kind < 7 && !ids.empty()) {
+                TimerWheel::TimerId id = ids[random() % ids.size()];
+                CHECK_EQ(wheel.Cancel(id), live.erase(id) == 1);
+            } else {
+                uint64_t span = spans[random() % std::size(spans)];
+                uint64_t target = now + random() % span;
+                if (random() % 4 == 0 && wheel.GetNextTick() != TimerWheel::NEVER) {
+                    target = std::max(now, wheel.GetNextTick());
+                }
+
+                std::vector<TimerWheel::Expired> expired;
+                wheel.Advance(target, expired);
+                now = std::max(now, target);
+
+                std::vector<TimerWheel::TimerId> expected;
+                for (auto it = live.begin(); it != live.end();) {
+                    if (it->second <= now) {
+                        expected.push_back(it->first);
+                        it = live.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                std::vector<TimerWheel::TimerId> actual;
+                for (const auto& timer : expired) actual.push_back(timer.id);
+                std::sort(actual.begin(), actual.end());
+                if (actual != expected) {
+                    CHECK_EQ(actual, expected);
+                    return;
+                }
+            }
+
+            CHECK_EQ(wheel.GetCount(), live.size());
+            uint64_t first = TimerWheel::NEVER;
+            for (const auto& [id, tick] : live) first = std::min(first, tick);
+            // The wheel may stop early to redistribute, never late
+            CHECK(wheel.GetNextTick() <= std::max(first, now) || first == TimerWheel::NEVER);
+            CHECK((wheel.GetNextTick() == TimerWheel::NEVER) == live.empty());
+        }
+    }
+}
+
+int main() {
+    return NirUI::Test::RunAll();
+}
@@ -0,0 +1,111 @@
+#include "test_support.h"
+#include "utils/trace_recorder.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace NirUI;
+
+namespace {
+
+std::string ReadFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+size_t CountOf(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) count++;
+    return count;
+}
+
+} // namespace
+
+// The recorder is process-wide, so the cases run in order against one instance
+
+TEST_CASE(RecordsNothingWhileDisabled) {
+    TraceRecorder& recorder = TraceRecorder::Get();
+    CHECK(!TraceRecorder::IsEnabled());
+    for (int i = 0; i < 100; ++i) {
+        TraceZone zone("disabled");
+        TraceZone withDetail("disabled", "detail");
+    }
+    {
+        // A zone opened while disabled stays empty even if recording starts
+        TraceZone zone("opened before start");
+        recorder.Start();
+    }
+    recorder.Stop();
+    CHECK_EQ(recorder.GetEventCount(), size_t(0));
+    CHECK_EQ(recorder.GetDroppedCount(), uint64_t(0));
+}
+
+TEST_CASE(WritesChromeTraceEvents) {
+    TraceRecorder& recorder = TraceRecorder::Get();
+    recorder.SetThreadName("main");
+    recorder.Start();
+    {
+        TraceZone outer("CliSession::Run", "win close title \"Notepad\"\n");
+        TraceZone inner("NirCmdManager::Execute");
+    }
+    recorder.AddZone("fixed", "", 1234567, 1234567 + 2500);
+    std::thread worker([&recorder]() {
+        recorder.SetThreadName("worker \"1\"");
+        TraceZone zone("worker zone");
+    });
+    worker.join();
+    {
+        // Still open at Stop(), so it is recorded when it ends
+        TraceZone zone("ends after stop");
+        recorder.Stop();
+    }
+    {
+        TraceZone zone("after stop");
+    }
+    CHECK_EQ(recorder.GetEventCount(), size_t(5));
+
+    Test::TempDirectory directory;
+    std::filesystem::path path = directory.GetPath() / "trace.json";
+    CHECK(recorder.WriteChromeTrace(path));
+    std::string json = ReadFile(path);
+
+    std::string header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    CHECK_EQ(json.substr(0, header.size()), header);
+    CHECK_EQ(json.substr(json.size() - 4), std::string("\n]}\n"));
+    CHECK(json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}") !=
+          std::string::npos);
+    CHECK(json.find("\"tid\":2,\"args\":{\"name\":\"worker \\\"1\\\"\"}}") != std::string::npos);
+    CHECK(json.find("{\"name\":\"fixed\",\"cat\":\"nirui\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1234.567,\"dur\":2.500}") !=
+          std::string::npos);
+    CHECK(json.find("\"args\":{\"detail\":\"win close title \\\"Notepad\\\"\\n\"}}") != std::string::npos);
+    CHECK(json.find("{\"name\":\"worker zone\",\"cat\":\"nirui\",\"ph\":\"X\",\"pid\":1,\"tid\":2,") != std::string::npos);
+    CHECK(json.find("ends after stop") != std::string::npos);
+    CHECK(json.find("\"after stop\"") == std::string::npos);
+    CHECK_EQ(CountOf(json, "\"ph\":\"X\""), size_t(5));
+    CHECK_EQ(CountOf(json, "\"ph\":\"M\""), size_t(2));
+    // The inner zone closes first, so it is written first
+    CHECK(json.find("NirCmdManager::Execute") < json.find("CliSession::Run"));
+}
+
+TEST_CASE(CountsEventsAcrossThreadsAndChunks) {
+    TraceRecorder& recorder = TraceRecorder::Get();
+    size_t before = recorder.GetEventCount();
+    recorder.Start();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 3000; ++i) TraceZone zone("loop");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    recorder.Stop();
+    CHECK_EQ(recorder.GetEventCount(), before + 4 * 3000);
+
+    Test::TempDirectory directory;
+    CHECK(recorder.WriteChromeTrace(directory.GetPath() / "trace.json"));
+    CHECK_EQ(CountOf(ReadFile(directory.GetPath() / "trace.json"), "{\"name\":\"loop\""), size_t(4 * 3000));
+}
+
+int main() { return NirUI::Test::RunAll(); }